@@ -41,6 +41,10 @@
 
 #include "Utils/FontLoader.h"
 #include <Utils/ToolboxUtils.h>
+#include <Utils/FrameProfiler.h>
+#include <Utils/AllocationTracker.h>
+#include <Utils/AgentIndex.h>
+#include <Utils/Scheduler.h>
 
 #include <EmbeddedResource.h>
 #include "resource.h"
@@ -64,6 +68,9 @@ namespace {
     bool must_self_destruct = false; // is true when toolbox should quit
     GW::HookEntry Update_Entry;
 
+    // Time per frame that Scheduler tasks get, after every module has updated
+    constexpr double SCHEDULER_BUDGET_MS = 2.0;
+
     std::recursive_mutex module_management_mutex;
 
 
@@ -334,6 +341,74 @@ namespace {
         return inifile;
     }
 
+    // Modules whose ini section has changed since the last save, and when the last one was marked
+    std::mutex settings_dirty_mutex;
+    std::unordered_set<ToolboxModule*> settings_dirty_modules;
+    bool settings_file_dirty = false;
+    std::chrono::steady_clock::time_point settings_dirty_at;
+    // Edits tend to come in bursts (dragging a slider, clicking through checkboxes); wait for them to settle before saving
+    constexpr auto SETTINGS_SAVE_DELAY = std::chrono::milliseconds(1500);
+
+    // Held for the whole of any write to the settings file, so a background write can't land after a synchronous save
+    std::mutex settings_file_mutex;
+    std::mutex settings_write_mutex;
+    struct PendingSettingsWrite {
+        std::filesystem::path path;
+        std::string data;
+    };
+    std::optional<PendingSettingsWrite> pending_settings_write;
+
+    bool WriteFileAtomic(const std::filesystem::path& path, const std::string& data)
+    {
+        auto tmp_file = path;
+        tmp_file += ".tmp";
+        FILE* fp = _wfopen(tmp_file.c_str(), L"wb");
+        if (!fp) {
+            return false;
+        }
+        const bool written = data.empty() || fwrite(data.data(), data.size(), 1, fp) == 1;
+        if (fclose(fp) != 0 || !written) {
+            return false;
+        }
+        std::error_code ec;
+        std::filesystem::rename(tmp_file, path, ec);
+        return !ec;
+    }
+
+    // Runs on a worker thread; writes whatever the latest snapshot is by the time it gets to run.
+    void WritePendingSettings()
+    {
+        std::lock_guard file_lock(settings_file_mutex);
+        std::optional<PendingSettingsWrite> write;
+        {
+            std::lock_guard lock(settings_write_mutex);
+            write.swap(pending_settings_write);
+        }
+        if (!write) {
+            return; // Superseded by a synchronous save
+        }
+        if (!WriteFileAtomic(write->path, write->data)) {
+            Log::Log("Failed to save settings to %ls\n", write->path.c_str());
+        }
+    }
+
+    void QueueSettingsWrite(const std::filesystem::path& path, std::string&& data)
+    {
+        std::lock_guard lock(settings_write_mutex);
+        const bool already_queued = pending_settings_write.has_value();
+        pending_settings_write = {path, std::move(data)};
+        if (!already_queued) {
+            Resources::EnqueueWorkerTask(WritePendingSettings);
+        }
+    }
+
+    // Drops any queued background write; the caller is about to write the file itself.
+    void CancelQueuedSettingsWrite()
+    {
+        std::lock_guard lock(settings_write_mutex);
+        pending_settings_write.reset();
+    }
+
     bool CanRenderToolbox()
     {
         return !gwtoolbox_disabled
@@ -353,6 +428,7 @@ namespace {
                 return true;
             }
             m.SaveSettings(OpenSettingsFile());
+            GWToolbox::MarkSettingsDirty(nullptr);
             modules_terminating.push_back(&m);
             m.SignalTerminate();
             vec.erase(found);
@@ -366,6 +442,8 @@ namespace {
         if (std::ranges::contains(modules_terminating, &m)) {
             return false; // Not finished terminating
         }
+        // Before anything can dispatch to it, so that its allocation scopes never need the tracker's lock
+        m.RegisterAllocationTag();
         vec.push_back(&m);
         m.Initialize();
         m.LoadSettings(OpenSettingsFile());
@@ -373,6 +451,37 @@ namespace {
         return true; // Added successfully
     }
 
+    // Render thread. Writes the sections of any dirty modules into the ini, then hands a snapshot of it to a worker to write out.
+    void SaveDirtySettings()
+    {
+        std::unordered_set<ToolboxModule*> dirty;
+        {
+            std::lock_guard lock(settings_dirty_mutex);
+            if (!settings_file_dirty || std::chrono::steady_clock::now() - settings_dirty_at < SETTINGS_SAVE_DELAY) {
+                return;
+            }
+            dirty.swap(settings_dirty_modules);
+            settings_file_dirty = false;
+        }
+        const auto ini = OpenSettingsFile();
+        if (ini->location_on_disk.empty()) {
+            return;
+        }
+        {
+            std::lock_guard lock(module_management_mutex);
+            for (const auto m : modules_enabled) {
+                if (dirty.contains(m)) {
+                    m->SaveSettings(ini);
+                }
+            }
+        }
+        std::string data;
+        if (ini->Save(data, true) < 0) {
+            return;
+        }
+        QueueSettingsWrite(ini->location_on_disk, std::move(data));
+    }
+
     void UpdateEnabledWidgetVectors(ToolboxModule* m, bool added)
     {
         const auto found = std::ranges::find(modules_enabled, m);
@@ -402,6 +511,13 @@ namespace {
 
 
 
+    bool ModuleWndProc(ToolboxModule* m, const UINT Message, const WPARAM wParam, const LPARAM lParam)
+    {
+        const FrameProfiler::Scope scope(m->Name(), FrameProfiler::Phase::WndProc);
+        const AllocationTracker::Scope alloc_scope(m->AllocationTag());
+        return m->WndProc(Message, wParam, lParam);
+    }
+
     LRESULT CALLBACK WndProc(const HWND hWnd, const UINT Message, const WPARAM wParam, const LPARAM lParam)
     {
         static bool right_mouse_down = false;
@@ -437,7 +553,7 @@ namespace {
                 io.MousePos = { (float)GET_X_LPARAM(right_click_lparam), (float)GET_Y_LPARAM(right_click_lparam) };
 #pragma warning( pop )
                 for (const auto m : tb.GetAllModules()) {
-                    m->WndProc(WM_GW_RBUTTONCLICK, 0, right_click_lparam);
+                    ModuleWndProc(m, WM_GW_RBUTTONCLICK, 0, right_click_lparam);
                 }
             }
             mouse_moved_whilst_right_clicking = 0;
@@ -490,7 +606,7 @@ namespace {
             }
 
             for (const auto m : tb.GetAllModules()) {
-                m->WndProc(Message, wParam, lParam);
+                ModuleWndProc(m, Message, wParam, lParam);
             }
         }
                      break;
@@ -513,7 +629,7 @@ namespace {
             }
             bool captured = false;
             for (const auto m : tb.GetAllModules()) {
-                if (m->WndProc(Message, wParam, lParam)) {
+                if (ModuleWndProc(m, Message, wParam, lParam)) {
                     captured = true;
                 }
             }
@@ -556,7 +672,7 @@ namespace {
         {
             bool captured = false;
             for (const auto m : tb.GetAllModules()) {
-                if (m->WndProc(Message, wParam, lParam)) {
+                if (ModuleWndProc(m, Message, wParam, lParam)) {
                     captured = true;
                 }
             }
@@ -577,7 +693,7 @@ namespace {
             // Custom messages registered via RegisterWindowMessage
             if (Message >= 0xC000 && Message <= 0xFFFF) {
                 for (const auto m : tb.GetAllModules()) {
-                    m->WndProc(Message, wParam, lParam);
+                    ModuleWndProc(m, Message, wParam, lParam);
                 }
             }
             break;
@@ -839,9 +955,25 @@ bool GWToolbox::SettingsFolderChanged()
     return settings_folder_changed;
 }
 
+void GWToolbox::MarkSettingsDirty(ToolboxModule* m)
+{
+    std::lock_guard lock(settings_dirty_mutex);
+    if (m) {
+        settings_dirty_modules.insert(m);
+    }
+    settings_file_dirty = true;
+    settings_dirty_at = std::chrono::steady_clock::now();
+}
+
 std::filesystem::path GWToolbox::SaveSettings()
 {
     const auto ini = OpenSettingsFile();
+    {
+        // Everything is about to be written; nothing left for the background saver to do
+        std::lock_guard lock(settings_dirty_mutex);
+        settings_dirty_modules.clear();
+        settings_file_dirty = false;
+    }
     for (const auto m : modules_enabled) {
         m->SaveSettings(ini);
     }
@@ -852,7 +984,11 @@ std::filesystem::path GWToolbox::SaveSettings()
         m->SaveSettings(ini);
     }
     ToolboxSettings::LoadModules(ini);
-    ASSERT(Resources::SaveIniToFile(ini->location_on_disk, ini) == 0);
+    {
+        std::lock_guard file_lock(settings_file_mutex);
+        CancelQueuedSettingsWrite();
+        ASSERT(Resources::SaveIniToFile(ini->location_on_disk, ini) == 0);
+    }
     const auto dir = ini->location_on_disk.parent_path();
     const auto dirstr = dir.wstring();
     const std::wstring printable = std::regex_replace(dirstr, std::wregex(L"\\\\"), L"/");
@@ -930,10 +1066,19 @@ void GWToolbox::Update(GW::HookStatus*)
 
     UpdateModulesTerminating(delta_f);
 
+    AgentIndex::Invalidate();
+
     // Update loop
     for (const auto m : modules_enabled) {
+        const FrameProfiler::Scope scope(m->Name(), FrameProfiler::Phase::Update);
+        const AllocationTracker::Scope alloc_scope(m->AllocationTag());
         m->Update(delta_f);
     }
+    {
+        const FrameProfiler::Scope scope("Scheduler", FrameProfiler::Phase::Update);
+        Scheduler::Update(SCHEDULER_BUDGET_MS);
+    }
+    FrameProfiler::EndFrame();
 
     if (!greeted && GW::Map::GetInstanceType() != GW::Constants::InstanceType::Loading) {
         const auto* c = GW::GetCharContext();
@@ -976,6 +1121,7 @@ void GWToolbox::Draw(IDirect3DDevice9* device)
     }
     // Draw loop
     Resources::DxUpdate(device);
+    SaveDirtySettings();
 
     if (!CanRenderToolbox())
         return;
@@ -988,6 +1134,8 @@ void GWToolbox::Draw(IDirect3DDevice9* device)
     const bool world_map_showing = GW::UI::GetIsWorldMapShowing();
 
     if (!world_map_showing && minimap_enabled) {
+        const FrameProfiler::Scope scope(Minimap::Instance().Name(), FrameProfiler::Phase::Draw);
+        const AllocationTracker::Scope alloc_scope(Minimap::Instance().AllocationTag());
         Minimap::Render(device);
     }
 
@@ -1014,6 +1162,8 @@ void GWToolbox::Draw(IDirect3DDevice9* device)
         if (world_map_showing && !uielement->ShowOnWorldMap()) {
             continue;
         }
+        const FrameProfiler::Scope scope(uielement->Name(), FrameProfiler::Phase::Draw);
+        const AllocationTracker::Scope alloc_scope(uielement->AllocationTag());
         uielement->Draw(device);
     }
 
@@ -1051,9 +1201,10 @@ void GWToolbox::DrawInitialising(IDirect3DDevice9* device)
     ASSERT(AttachImgui(device));
 
     if (!FontLoader::FontsLoaded()) {
-        Resources::Instance().Update(0.f); // necessary, because this won't be called in
+        // FontLoader hands its fonts over as dx tasks, and the draw loop only runs those once we're initialised. Main tasks queued
+        // in the meantime wait for GWToolbox::Update to reach Scheduler::Update.
         Resources::DxUpdate(device);
-        return; // GWToolbox::Update() until fonts are initialised
+        return;
     }
 
     gwtoolbox_state = GWToolboxState::Initialised;
@@ -1118,6 +1269,9 @@ void GWToolbox::UpdateTerminating(float delta_f)
 {
     ASSERT(gwtoolbox_state == GWToolboxState::Terminating);
 
+    // Nothing that's left should run against modules that are going away, and nothing should be left waiting on it
+    Scheduler::Terminate();
+
     while (modules_enabled.size()) {
         ASSERT(ToggleModule(*modules_enabled[0], false) == false);
     }
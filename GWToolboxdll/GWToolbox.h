@@ -39,6 +39,8 @@ public:
     static bool CanTerminate();
 
     static std::filesystem::path SaveSettings();
+    // Queue m's ini section to be saved (or just the ini as it stands, if m is null). Saves are debounced and written off the render thread.
+    static void MarkSettingsDirty(ToolboxModule* m);
     static std::filesystem::path LoadSettings();
     static bool SetSettingsFolder(const std::filesystem::path& path);
 
@@ -153,6 +153,11 @@ int IRC::start(const char* server, int port, const char* nick, const char* user,
     //We dont need this anymore
     freeaddrinfo(servinfo);
 
+    framer.Clear();
+    {
+        std::lock_guard lock(inbox_mutex);
+        inbox.clear();
+    }
     connected = true;
     t = std::thread([&] {
         message_loop();
@@ -207,25 +212,65 @@ int IRC::message_fetch()
     if (!connected) {
         return 1;
     }
-    message_buffer[0] = '\0';
-    const auto ret_len = recv(irc_socket, message_buffer, 1023, 0);
+    const auto space = framer.WriteSpace();
+    const auto ret_len = recv(irc_socket, space.data(), static_cast<int>(space.size()), 0);
     if (ret_len == SOCKET_ERROR) {
         printf("IRC::message_fetch recv failed, %d\n", WSAGetLastError());
         connected = false;
         closesocket(irc_socket);
         return 1;
     }
-    if (!message_buffer[0]) {
+    if (!ret_len) {
         printf("IRC::message_fetch message empty; graceful close?\n");
         connected = false;
         closesocket(irc_socket);
         return 1;
     }
-    message_buffer[ret_len] = '\0';
-    split_to_replies(message_buffer);
+    framer.Commit(static_cast<size_t>(ret_len));
+
+    // Keepalives are answered here so a busy main thread can't time us out; everything else goes to the main thread in one batch
+    received.clear();
+    std::string_view line;
+    IrcProtocol::Message message;
+    while (framer.NextLine(line)) {
+        if (!IrcProtocol::Parse(line, message) || line.find('\0') != std::string_view::npos) {
+            continue;
+        }
+        if (message.command == "PING") {
+            const auto token = message.Trailing();
+            raw("PONG :%.*s\r\n", static_cast<int>(token.size()), token.data());
+            continue;
+        }
+        if (message.command == "PONG") {
+            pong_recieved = clock();
+            continue;
+        }
+        received.append(line);
+        received.push_back('\0');
+    }
+    if (!received.empty()) {
+        std::lock_guard lock(inbox_mutex);
+        inbox.append(received);
+    }
     return 0;
 }
 
+int IRC::dispatch_messages()
+{
+    {
+        std::lock_guard lock(inbox_mutex);
+        std::swap(inbox, dispatching);
+    }
+    int count = 0;
+    for (size_t pos = 0; pos < dispatching.size(); count++) {
+        const auto len = strlen(&dispatching[pos]);
+        parse_irc_reply(&dispatching[pos], len);
+        pos += len + 1;
+    }
+    dispatching.clear();
+    return count;
+}
+
 int IRC::ping()
 {
     if (!connected) {
@@ -271,16 +316,6 @@ int IRC::message_loop()
     }
 }
 
-void IRC::split_to_replies(const char* data)
-{
-    const char* p;
-    while (p = strstr(data, "\r\n")) {
-        *const_cast<char*>(p) = '\0';
-        parse_irc_reply(data);
-        data = p + 2;
-    }
-}
-
 int IRC::is_op(const char* channel, const char* nick) const
 {
     const channel_user* cup = chan_users;
@@ -309,9 +344,8 @@ int IRC::is_voice(const char* channel, const char* nick) const
     return 0;
 }
 
-void IRC::parse_irc_reply(const char* data)
+void IRC::parse_irc_reply(char* data, const size_t len)
 {
-    char* hostd;
     char* cmd;
     char* params;
     //char buffer[514];
@@ -320,34 +354,29 @@ void IRC::parse_irc_reply(const char* data)
     char* p;
     char* chan_temp;
 
-    hostd_tmp.target = nullptr;
-
     printf("%s\n", data);
 
-    if (data[0] == ':') {
-        hostd = const_cast<char*>(&data[1]);
-        cmd = strchr(hostd, ' ');
-        if (!cmd) {
-            return;
-        }
-        *cmd = '\0';
-        cmd++;
-        params = strchr(cmd, ' ');
-        if (params) {
-            *params = '\0';
-            params++;
-        }
-        hostd_tmp.nick = hostd;
-        hostd_tmp.ident = strchr(hostd, '!');
-        if (hostd_tmp.ident) {
-            *hostd_tmp.ident = '\0';
-            hostd_tmp.ident++;
-            hostd_tmp.host = strchr(hostd_tmp.ident, '@');
-            if (hostd_tmp.host) {
-                *hostd_tmp.host = '\0';
-                hostd_tmp.host++;
-            }
+    IrcProtocol::Message message;
+    if (!IrcProtocol::Parse({data, len}, message)) {
+        return;
+    }
+    // Every view points into data and is followed by a delimiter or the end of the line, so they can be terminated in place
+    const auto terminate = [data](const std::string_view view) -> char* {
+        if (view.empty()) {
+            return nullptr;
         }
+        const auto str = data + (view.data() - data);
+        str[view.size()] = '\0';
+        return str;
+    };
+    hostd_tmp.tags = terminate(message.tags);
+    cmd = terminate(message.command);
+    params = data + (message.raw_params.data() - data);
+
+    if (!message.prefix.empty()) {
+        hostd_tmp.nick = terminate(message.nick);
+        hostd_tmp.ident = terminate(message.user);
+        hostd_tmp.host = terminate(message.host);
 
         if (!strcmp(cmd, "JOIN")) {
             cup = chan_users;
@@ -666,35 +695,8 @@ void IRC::parse_irc_reply(const char* data)
         call_hook(cmd, params, &hostd_tmp);
     }
     else {
-        cmd = const_cast<char*>(data);
-        data = strchr(cmd, ' ');
-        if (!data) {
-            return;
-        }
-        *const_cast<char*>(data) = '\0';
-        params = const_cast<char*>(data + 1);
-
-        if (!strcmp(cmd, "PING")) {
-            if (!params) {
-                return;
-            }
-            raw("PONG %s\r\n", &params[1]);
-#ifdef __IRC_DEBUG__
-            printf("Ping received, pong sent.\n");
-#endif
-            fflush(dataout);
-        }
-        else if (!strcmp(cmd, "PONG")) {
-            pong_recieved = clock();
-            fflush(dataout);
-        }
-        else {
-            hostd_tmp.host = nullptr;
-            hostd_tmp.ident = nullptr;
-            hostd_tmp.nick = nullptr;
-            hostd_tmp.target = nullptr;
-            call_hook(cmd, params, &hostd_tmp);
-        }
+        // PING and PONG are handled by message_fetch and never get here
+        call_hook(cmd, params, &hostd_tmp);
     }
 }
 
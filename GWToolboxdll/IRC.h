@@ -28,6 +28,9 @@
 #include <stdio.h>
 #include <WinSock2.h>
 #include <thread>
+#include <mutex>
+
+#include <Utils/IrcProtocol.h>
 
 #define __CPIRC_VERSION__   0.1
 #define __IRC_DEBUG__ 0
@@ -41,6 +44,8 @@ struct irc_reply_data {
     char* ident;
     char* host;
     char* target;
+    // IRCv3 tags, escaped, or nullptr if the line had none. See IrcProtocol::FindTag.
+    char* tags;
 };
 
 struct irc_command_hook {
@@ -81,6 +86,8 @@ public:
     void hook_irc_command(const char* cmd_name, int (*function_ptr)(const char*, irc_reply_data*, void*));
     int message_loop();
     int message_fetch();
+    // Runs the hooks for every line received since the last call; call from the main thread. Returns the number of lines.
+    int dispatch_messages();
     int ping();
     int is_op(const char* channel, const char* nick) const;
     int is_voice(const char* channel, const char* nick) const;
@@ -91,13 +98,18 @@ private:
     static void error(int err);
     void call_hook(const char* irc_command, const char* params, irc_reply_data* hostd);
     /*void call_the_hook(irc_command_hook* hook, char* irc_command, char*params, irc_host_data* hostd);*/
-    void parse_irc_reply(const char* data);
-    void split_to_replies(const char* data);
+    void parse_irc_reply(char* data, size_t len);
     static void insert_irc_command_hook(irc_command_hook* hook, const char* cmd_name, int (*function_ptr)(const char*, irc_reply_data*, void*));
     static void delete_irc_command_hook(const irc_command_hook* cmd_hook);
     // int irc_socket; // This fails when using winsock2.h in Windows. Define as SOCKET to fix?
     SOCKET irc_socket{};
-    char message_buffer[1024] = {0};
+    // Only touched by the receiving thread
+    IrcProtocol::LineFramer framer;
+    std::string received;
+    // Received lines waiting for dispatch_messages, each terminated by '\0'
+    std::mutex inbox_mutex;
+    std::string inbox;
+    std::string dispatching;
     bool connected;
     bool pending_disconnect;
     bool sentnick;
@@ -6,9 +6,12 @@
 
 #include <Logger.h>
 
+#include <atomic>
+
 #include <Modules/CrashHandler.h>
 // ReSharper disable once CppUnusedIncludeDirective
 #include <Modules/Resources.h>
+#include <Utils/RingBuffer.h>
 #include <Utils/TextUtils.h>
 
 namespace {
@@ -25,17 +28,247 @@ namespace {
     [[maybe_unused]] bool crash_dumped = false;
 
     bool log_transient = false;
+
+    // Producers format a line and push it onto the ring; the writer thread takes lines back out in order. Lines logged before the
+    // writer starts wait in the ring until it does.
+    constexpr size_t ring_lines = 4096;
+    constexpr size_t inline_line_bytes = 240;
+    constexpr size_t max_line_bytes = 16 * 1024;
+    constexpr long long max_log_file_size = 16 * 1024 * 1024;
+
+    struct LogLine {
+        __time64_t time = 0;
+        Log::Level level = Log::Level::Info;
+        bool wide = false;
+        uint16_t inline_length = 0;
+        char inline_data[inline_line_bytes];
+        // Lines too long for inline_data; rare enough to allocate for
+        std::string long_data;
+
+        [[nodiscard]] std::string_view Bytes() const
+        {
+            return long_data.empty() ? std::string_view(inline_data, inline_length) : std::string_view(long_data);
+        }
+    };
+
+    // Constructed on first use, so a line logged during another file's static initialisation still has somewhere to go
+    MpscRing<LogLine>& LogRing()
+    {
+        static MpscRing<LogLine> ring(ring_lines);
+        return ring;
+    }
+    std::atomic<uint32_t> dropped_lines = 0;
+#ifdef _DEBUG
+    std::atomic<Log::Level> min_level = Log::Level::Debug;
+#else
+    std::atomic<Log::Level> min_level = Log::Level::Info;
+#endif
+
+    // Writer side
+    std::atomic<HANDLE> wake_writer = nullptr;
+    std::atomic<bool> stop_writer = false;
+    std::thread writer_thread;
+    std::mutex drain_mutex;
+    std::string write_buffer;
+    __time64_t timestamp_time = -1;
+    char timestamp[16];
+
+    void WakeWriter()
+    {
+        if (const auto event = wake_writer.load()) {
+            SetEvent(event);
+        }
+    }
+
+    bool PushLine(const Log::Level level, const bool wide, const char* data, size_t bytes)
+    {
+        bytes = std::min(bytes, max_line_bytes);
+        LogLine line;
+        line.time = _time64(nullptr);
+        line.level = level;
+        line.wide = wide;
+        if (bytes <= inline_line_bytes) {
+            memcpy(line.inline_data, data, bytes);
+            line.inline_length = static_cast<uint16_t>(bytes);
+        }
+        else {
+            line.long_data.assign(data, bytes);
+        }
+        auto& ring = LogRing();
+        if (!ring.try_push(std::move(line))) {
+            dropped_lines.fetch_add(1, std::memory_order_relaxed);
+            WakeWriter();
+            return false;
+        }
+        // Otherwise the writer wakes up on its own timer
+        if (ring.size() > ring.capacity() / 2) {
+            WakeWriter();
+        }
+        return true;
+    }
+
+    void AppendLine(const Log::Level level, const __time64_t time, const bool wide, const std::string_view line)
+    {
+        if (time != timestamp_time) {
+            tm timeinfo{};
+            _localtime64_s(&timeinfo, &time);
+            strftime(timestamp, sizeof(timestamp), "[%H:%M:%S] ", &timeinfo);
+            timestamp_time = time;
+        }
+        write_buffer.append(timestamp);
+        switch (level) {
+            case Log::Level::Debug:
+                write_buffer.append("[Debug] ");
+                break;
+            case Log::Level::Warning:
+                write_buffer.append("[Warning] ");
+                break;
+            case Log::Level::Error:
+                write_buffer.append("[Error] ");
+                break;
+            default:
+                break;
+        }
+        if (wide) {
+            auto text = std::wstring_view(reinterpret_cast<const wchar_t*>(line.data()), line.size() / sizeof(wchar_t));
+            while (!text.empty() && text.back() == L'\n') {
+                text.remove_suffix(1);
+            }
+            const auto offset = write_buffer.size();
+            const auto len = WideCharToMultiByte(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), nullptr, 0, nullptr, nullptr);
+            write_buffer.resize(offset + len);
+            WideCharToMultiByte(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), write_buffer.data() + offset, len, nullptr, nullptr);
+        }
+        else {
+            auto text = line;
+            while (!text.empty() && text.back() == '\n') {
+                text.remove_suffix(1);
+            }
+            write_buffer.append(text);
+        }
+        write_buffer.push_back('\n');
+    }
+
+    // Keeps the previous file as log.1.txt. stdout is pointed elsewhere first because an open file can't be renamed.
+    [[maybe_unused]] void RotateLogFile()
+    {
+        const auto path = Resources::GetPath(L"log.txt");
+        _wfreopen(L"NUL", L"w", stdout);
+        MoveFileExW(path.c_str(), Resources::GetPath(L"log.1.txt").c_str(), MOVEFILE_REPLACE_EXISTING);
+        logfile = _wfreopen(path.c_str(), L"w", stdout);
+    }
+
+    // Call with drain_mutex held
+    void DrainLogRing()
+    {
+        LogLine line;
+        auto& ring = LogRing();
+        while (ring.try_pop(line)) {
+            AppendLine(line.level, line.time, line.wide, line.Bytes());
+        }
+
+        if (const auto dropped = dropped_lines.exchange(0, std::memory_order_relaxed)) {
+            AppendLine(Log::Level::Warning, _time64(nullptr), false, std::format("{} log lines dropped, log ring was full", dropped));
+        }
+        if (write_buffer.empty() || !logfile) {
+            write_buffer.clear();
+            return;
+        }
+        fwrite(write_buffer.data(), 1, write_buffer.size(), logfile);
+        fflush(logfile);
+        write_buffer.clear();
+#ifndef _DEBUG
+        if (_ftelli64(logfile) > max_log_file_size) {
+            RotateLogFile();
+        }
+#endif
+    }
+
+    void LogWriterThread()
+    {
+        while (!stop_writer) {
+            WaitForSingleObject(wake_writer, 50);
+            std::lock_guard lock(drain_mutex);
+            DrainLogRing();
+        }
+    }
+
+    void VLog(const Log::Level level, const char* tag, const char* format, va_list args)
+    {
+        if (level < min_level) {
+            return;
+        }
+        char buf[1024];
+        int prefix_len = tag ? snprintf(buf, sizeof(buf), "[%s] ", tag) : 0;
+        prefix_len = std::clamp(prefix_len, 0, 64);
+        va_list args_copy;
+        va_copy(args_copy, args);
+        const auto len = vsnprintf(buf + prefix_len, sizeof(buf) - prefix_len, format, args);
+        if (len >= 0 && static_cast<size_t>(prefix_len + len) < sizeof(buf)) {
+            PushLine(level, false, buf, static_cast<size_t>(prefix_len + len));
+        }
+        else if (len >= 0) {
+            // Rare enough to allocate for
+            std::string long_line(buf, prefix_len);
+            long_line.resize(static_cast<size_t>(prefix_len + len) + 1);
+            vsnprintf(long_line.data() + prefix_len, static_cast<size_t>(len) + 1, format, args_copy);
+            PushLine(level, false, long_line.data(), static_cast<size_t>(prefix_len + len));
+        }
+        va_end(args_copy);
+    }
+
+    void VLogW(const Log::Level level, const char* tag, const wchar_t* format, va_list args)
+    {
+        if (level < min_level) {
+            return;
+        }
+        wchar_t buf[512];
+        int prefix_len = tag ? swprintf(buf, _countof(buf), L"[%S] ", tag) : 0;
+        prefix_len = std::clamp(prefix_len, 0, 64);
+        // vswprintf only says that it didn't fit, so measuring and formatting again need a copy each
+        va_list measure_args;
+        va_list long_args;
+        va_copy(measure_args, args);
+        va_copy(long_args, args);
+        const auto len = vswprintf(buf + prefix_len, _countof(buf) - prefix_len, format, args);
+        if (len >= 0) {
+            PushLine(level, true, reinterpret_cast<const char*>(buf), static_cast<size_t>(prefix_len + len) * sizeof(wchar_t));
+        }
+        else if (const auto needed = _vscwprintf(format, measure_args); needed >= 0) {
+            // Rare enough to allocate for
+            std::wstring long_line(buf, prefix_len);
+            long_line.resize(static_cast<size_t>(prefix_len + needed) + 1);
+            vswprintf(long_line.data() + prefix_len, static_cast<size_t>(needed) + 1, format, long_args);
+            PushLine(level, true, reinterpret_cast<const char*>(long_line.data()), static_cast<size_t>(prefix_len + needed) * sizeof(wchar_t));
+        }
+        va_end(measure_args);
+        va_end(long_args);
+    }
 }
 
 static void GWCALogHandler(
     [[maybe_unused]] void* context,
-    [[maybe_unused]] const GW::LogLevel level,
+    const GW::LogLevel level,
     const char* msg,
     [[maybe_unused]] const char* file,
     [[maybe_unused]] const unsigned int line,
     [[maybe_unused]] const char* function)
 {
-    Log::Log("[GWCA] %s", msg);
+    const auto log_level = [level] {
+        switch (level) {
+            case GW::LEVEL_TRACE:
+            case GW::LEVEL_DEBUG:
+                return Log::Level::Debug;
+            case GW::LEVEL_WARN:
+                return Log::Level::Warning;
+            case GW::LEVEL_ERR:
+            case GW::LEVEL_CRITICAL:
+                return Log::Level::Error;
+            default:
+                return Log::Level::Info;
+        }
+    }();
+    Log::Log(log_level, "GWCA", "%s", msg);
 }
 
 void Log::FatalAssert(const char* expr, const char* file, const unsigned line)
@@ -81,6 +314,10 @@ bool Log::InitializeLog()
     }
 #endif
 
+    wake_writer = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    stop_writer = false;
+    // Its first pass writes out anything logged before now
+    writer_thread = std::thread(LogWriterThread);
     return true;
 }
 
@@ -100,6 +337,20 @@ void Log::Terminate()
     GW::RegisterLogHandler(nullptr, nullptr);
     GW::RegisterPanicHandler(nullptr, nullptr);
 
+    if (writer_thread.joinable()) {
+        stop_writer = true;
+        WakeWriter();
+        writer_thread.join();
+    }
+    {
+        // Anything logged from here on waits in the ring for the next InitializeLog, if there is one
+        std::lock_guard lock(drain_mutex);
+        DrainLogRing();
+    }
+    if (const auto event = wake_writer.exchange(nullptr)) {
+        CloseHandle(event);
+    }
+
 #ifdef _DEBUG
     if (stdout_file) {
         fclose(stdout_file);
@@ -119,49 +370,49 @@ void Log::Terminate()
 }
 
 // === File/console logging ===
-static void PrintTimestamp()
+void Log::SetLevel(const Level level)
 {
-    time_t rawtime{};
-    time(&rawtime);
-
-    tm timeinfo{};
-    localtime_s(&timeinfo, &rawtime);
-
-    char buffer[16];
-    strftime(buffer, sizeof(buffer), "%H:%M:%S", &timeinfo);
-
-    fprintf(logfile, "[%s] ", buffer);
+    min_level = level;
 }
 
 void Log::Log(const char* msg, ...)
 {
-    if (!logfile) {
-        return;
-    }
-    PrintTimestamp();
+    va_list args;
+    va_start(args, msg);
+    VLog(Level::Info, nullptr, msg, args);
+    va_end(args);
+}
 
+void Log::Log(const Level level, const char* tag, const char* msg, ...)
+{
     va_list args;
     va_start(args, msg);
-    vfprintf(logfile, msg, args);
+    VLog(level, tag, msg, args);
     va_end(args);
-    if (msg[strlen(msg) - 1] != '\n') {
-        fprintf(logfile, "\n");
-    }
 }
 
 void Log::LogW(const wchar_t* msg, ...)
 {
-    if (!logfile) {
-        return;
-    }
-    PrintTimestamp();
+    va_list args;
+    va_start(args, msg);
+    VLogW(Level::Info, nullptr, msg, args);
+    va_end(args);
+}
 
+void Log::LogW(const Level level, const char* tag, const wchar_t* msg, ...)
+{
     va_list args;
     va_start(args, msg);
-    vfwprintf(logfile, msg, args);
+    VLogW(level, tag, msg, args);
     va_end(args);
-    if (msg[wcslen(msg) - 1] != '\n') {
-        fprintf(logfile, "\n");
+}
+
+void Log::Flush()
+{
+    // try_lock; this is called from the crash handler, which may be running on the writer thread
+    std::unique_lock lock(drain_mutex, std::try_to_lock);
+    if (lock.owns_lock()) {
+        DrainLogSlots();
     }
 }
 
@@ -189,19 +440,17 @@ static void _chatlog(const LogType log_type, const wchar_t* message)
         delete[] to_send;
     });
 
-    const wchar_t* c = [](const LogType log_type) -> const wchar_t* {
+    const auto level = [](const LogType log_type) {
         switch (log_type) {
-            case LogType_Info:
-                return L"Info";
             case LogType_Warning:
-                return L"Warning";
+                return Log::Level::Warning;
             case LogType_Error:
-                return L"Error";
+                return Log::Level::Error;
             default:
-                return L"";
+                return Log::Level::Info;
         }
     }(log_type);
-    Log::LogW(L"[%s] %s\n", c, message);
+    Log::LogW(level, "Chat", L"%s", message);
 }
 
 static void _vchatlogW(const LogType log_type, const wchar_t* format, const va_list argv)
@@ -21,14 +21,29 @@ namespace Log {
     void Terminate();
 
     // === File/console logging ===
+    // Lines are copied into a ring buffer and written out in batches by a background thread, so logging from a hook is cheap.
+    // If the ring fills faster than it's written, new lines are dropped and counted.
+    enum class Level : uint8_t {
+        Debug,
+        Info,
+        Warning,
+        Error
+    };
+
+    // Lines below this level are dropped before being formatted. Default is Info, or Debug in debug builds.
+    void SetLevel(Level level);
+
     // printf-style log
     void Log(const char* msg, ...);
+    // printf-style log with a level and an optional tag naming the module, e.g. Log::Log(Log::Level::Warning, "Twitch", "...")
+    void Log(Level level, const char* tag, const char* msg, ...);
 
     // printf-style wide-string log
     void LogW(const wchar_t* msg, ...);
+    void LogW(Level level, const char* tag, const wchar_t* msg, ...);
 
-    // flushes log file.
-    //static void FlushFile() { fflush(logfile); }
+    // Writes out whatever the background thread hasn't got to yet, unless it's writing right now
+    void Flush();
 
     // === Game chat logging ===
     // Shows a message in chat in the form of a white chat message from toolbox
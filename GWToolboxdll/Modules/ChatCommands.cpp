@@ -38,6 +38,7 @@
 #include <GWCA/Utilities/Hooker.h>
 #include <GWCA/Utilities/Hook.h>
 
+#include <Utils/AgentIndex.h>
 #include <Utils/GuiUtils.h>
 #include <GWToolbox.h>
 #include <Keys.h>
@@ -117,44 +118,31 @@ namespace {
     void TargetVipers()
     {
         // target best vipers target (closest)
-        GW::AgentArray* agents = GW::Agents::GetAgentArray();
-        const GW::Agent* me = agents ? GW::Agents::GetControlledCharacter() : nullptr;
+        const GW::Agent* me = GW::Agents::GetControlledCharacter();
         if (me == nullptr) {
             return;
         }
 
         const auto wanted_angle = me->rotation_angle * 180.0f / DirectX::XM_PI;
         constexpr auto max_angle_diff = 22.5f; // Acceptable angle for vipers
-        float max_distance = GW::Constants::SqrRange::Spellcast;
 
-        auto closest = static_cast<size_t>(-1);
-        for (size_t i = 0, size = agents->size(); i < size; i++) {
-            const auto agent = static_cast<GW::AgentLiving*>(agents->at(i));
-            if (agent == nullptr || agent == me || !agent->GetIsLivingType() || agent->GetIsDead()) {
-                continue;
-            }
-            const float this_distance = GetSquareDistance(me->pos, agent->pos);
-            if (this_distance > max_distance) {
-                continue;
-            }
-            const float agent_angle = GetAngle(me->pos - agent->pos);
-            const float this_angle_diff = abs(wanted_angle - agent_angle);
-            if (this_angle_diff > max_angle_diff) {
-                continue;
-            }
-            closest = i;
-            max_distance = this_distance;
-        }
-        if (closest != static_cast<size_t>(-1)) {
-            SafeChangeTarget(agents->at(closest)->agent_id);
+        AgentIndex::Filter filter;
+        filter.type = AgentIndex::Filter::Type::Living;
+        filter.alive_only = true;
+        filter.exclude = me;
+        filter.predicate = [me, wanted_angle](const GW::Agent& agent) {
+            const float agent_angle = GetAngle(me->pos - agent.pos);
+            return abs(wanted_angle - agent_angle) <= max_angle_diff;
+        };
+        if (const auto closest = AgentIndex::FindNearest(me->pos, GW::Constants::Range::Spellcast, filter)) {
+            SafeChangeTarget(closest->agent_id);
         }
     }
 
     void TargetEE()
     {
         // target best ebon escape target
-        GW::AgentArray* agents = GW::Agents::GetAgentArray();
-        const GW::Agent* me = agents ? GW::Agents::GetControlledCharacter() : nullptr;
+        const GW::Agent* me = GW::Agents::GetControlledCharacter();
         if (me == nullptr) {
             return;
         }
@@ -162,32 +150,31 @@ namespace {
         const auto facing_angle = me->rotation_angle * 180.0f / DirectX::XM_PI;
         const auto wanted_angle = facing_angle > 0.0f ? facing_angle - 180.0f : facing_angle + 180.0f;
         constexpr auto max_angle_diff = 22.5f; // Acceptable angle for ebon escape
-        constexpr auto max_distance = GW::Constants::SqrRange::Spellcast;
-        float distance = 0.0f;
 
-        auto closest = static_cast<size_t>(-1);
-        for (size_t i = 0, size = agents->size(); i < size; i++) {
-            const auto agent = static_cast<GW::AgentLiving*>(agents->at(i));
-            if (agent == nullptr || agent == me
-                || !agent->GetIsLivingType() || agent->GetIsDead()
-                || agent->allegiance == GW::Constants::Allegiance::Enemy
-                || !GW::Agents::GetIsAgentTargettable(agent)) {
-                continue;
+        AgentIndex::Filter filter;
+        filter.type = AgentIndex::Filter::Type::Living;
+        filter.alive_only = true;
+        filter.targettable_only = true;
+        filter.exclude = me;
+        filter.predicate = [me, wanted_angle](const GW::Agent& agent) {
+            if (agent.GetAsAgentLiving()->allegiance == GW::Constants::Allegiance::Enemy) {
+                return false;
             }
+            const auto agent_angle = GetAngle(me->pos - agent.pos);
+            return abs(wanted_angle - agent_angle) <= max_angle_diff;
+        };
+        // Furthest away is best
+        const GW::Agent* furthest = nullptr;
+        float distance = 0.0f;
+        for (const auto agent : AgentIndex::FindInRadius(me->pos, GW::Constants::Range::Spellcast, filter)) {
             const float this_distance = GetSquareDistance(me->pos, agent->pos);
-            if (this_distance > max_distance || distance > this_distance) {
-                continue;
-            }
-            const auto agent_angle = GetAngle(me->pos - agent->pos);
-            const auto this_angle_diff = abs(wanted_angle - agent_angle);
-            if (this_angle_diff > max_angle_diff) {
-                continue;
+            if (this_distance >= distance) {
+                furthest = agent;
+                distance = this_distance;
             }
-            closest = i;
-            distance = this_distance;
         }
-        if (closest != static_cast<size_t>(-1)) {
-            SafeChangeTarget(agents->at(closest)->agent_id);
+        if (furthest) {
+            SafeChangeTarget(furthest->agent_id);
         }
     }
 
@@ -467,26 +454,18 @@ namespace {
         PrefLabel(const wchar_t* _enc_string = nullptr) : EncString(_enc_string, false) {};
         PrefLabel(const uint32_t _enc_string) : EncString(_enc_string, false) {};
     protected:
-        static void OnPrefLabelDecoded(void* param, const wchar_t* decoded);
-
         void decode() override
         {
             language(GW::Constants::Language::English);
-            if (!decoded && !decoding && !encoded_ws.empty()) {
-                decoding = true;
-                GW::GameThread::Enqueue([&] {
-                    GW::UI::AsyncDecodeStr(encoded_ws.c_str(), OnPrefLabelDecoded, this, language_id);
-                });
-            }
+            EncString::decode();
         }
-    };
 
-    void PrefLabel::OnPrefLabelDecoded(void* param, const wchar_t* decoded)
-    {
-        GuiUtils::EncString::OnStringDecoded(param, decoded);
-        const auto context = static_cast<PrefLabel*>(param);
-        context->decoded_ws = TextUtils::RemovePunctuation(TextUtils::RemoveDiacritics(TextUtils::ToSlug(context->decoded_ws)));
-    }
+        void on_decoded(const std::wstring& str) override
+        {
+            EncString::on_decoded(str);
+            decoded_ws = TextUtils::RemovePunctuation(TextUtils::RemoveDiacritics(TextUtils::ToSlug(decoded_ws)));
+        }
+    };
 
     struct PrefMapCommand {
         PrefMapCommand(GW::UI::EnumPreference p, uint32_t enc_string_id)
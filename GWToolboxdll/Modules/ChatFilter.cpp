@@ -171,7 +171,7 @@ namespace {
     {
         using namespace TextUtils;
         words.clear();
-        const auto text_ws = RemoveDiacritics(ToLower(StringToWString(text)));
+        const auto text_ws = FoldForSearch(StringToWString(text));
         std::wstringstream stream(text_ws.c_str());
         std::wstring word;
         while (std::getline(stream, word)) {
@@ -678,20 +678,24 @@ namespace {
         }
 
         using namespace TextUtils;
-        const auto str = std::wstring(start, end);
+        const std::wstring_view str(start, static_cast<size_t>(end - start));
         if (str.empty()) {
             return false;
         }
-        const auto sanitized = RemoveDiacritics(str);
-        const auto lowercase = ToLower(sanitized);
-        for (const auto& s : bycontent_words) {
-            if (lowercase.find(s) != std::wstring::npos) {
-                return true;
+        if (!bycontent_words.empty()) {
+            const auto lowercase = FoldForSearch(str);
+            for (const auto& s : bycontent_words) {
+                if (lowercase.find(s) != std::wstring::npos) {
+                    return true;
+                }
             }
         }
-        for (const auto& r : bycontent_regex) {
-            if (std::regex_search(sanitized, r)) {
-                return true;
+        if (!bycontent_regex.empty()) {
+            const auto sanitized = RemoveDiacritics(str);
+            for (const auto& r : bycontent_regex) {
+                if (std::regex_search(sanitized, r)) {
+                    return true;
+                }
             }
         }
         return false;
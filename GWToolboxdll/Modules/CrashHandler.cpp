@@ -107,6 +107,9 @@ void CrashHandler::FatalAssert(const char* expr, const char* file, const unsigne
 
 LONG WINAPI CrashHandler::Crash(EXCEPTION_POINTERS* pExceptionPointers)
 {
+    // The log is written in batches; get the last lines out before the process goes away
+    Log::Flush();
+
     const std::wstring crash_folder = Resources::GetPath(L"crashes");
 
     const DWORD ProcessId = GetCurrentProcessId();
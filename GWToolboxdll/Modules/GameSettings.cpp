@@ -49,6 +49,7 @@
 
 #include <Utils/GuiUtils.h>
 #include <Utils/ToolboxUtils.h>
+#include <Utils/Scheduler.h>
 
 #include <Modules/PartyWindowModule.h>
 
@@ -1241,12 +1242,9 @@ namespace {
     {
         if (!skip_entering_name_for_faction_donate) return;
         if (!immediate) {
-            Resources::EnqueueWorkerTask([]() {
-                // When a donation is complete, there are several different ui messages that come in varying sequence; give 500ms to ensure all are processed by the game first
-                Sleep(500);
-                GW::GameThread::Enqueue([]() {
-                    SkipCharacterNameEntryForFactionDonation(true);
-                });
+            // When a donation is complete, there are several different ui messages that come in varying sequence; give 500ms to ensure all are processed by the game first
+            Scheduler::After(std::chrono::milliseconds(500), [] {
+                SkipCharacterNameEntryForFactionDonation(true);
             });
             return;
         }
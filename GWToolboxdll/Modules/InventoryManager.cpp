@@ -27,6 +27,8 @@
 #include <Timer.h>
 #include <Logger.h>
 #include <Utils/GuiUtils.h>
+#include <Utils/InventoryMovePlanner.h>
+#include <Utils/RateLimiter.h>
 #include <Modules/InventoryManager.h>
 #include <Modules/GameSettings.h>
 
@@ -83,61 +85,31 @@ namespace {
         return GW::Map::GetInstanceType() != GW::Constants::InstanceType::Loading && !GW::Map::GetIsObserving() && GW::MemoryMgr::GetGWWindowHandle() == GetActiveWindow();
     }
 
-    struct PendingMove {
-        uint32_t item_id;
-        uint16_t quantity;
-        clock_t started_at;
-    };
-
-    std::unordered_map<uint32_t, PendingMove> pending_moves; // { bag_idx | slot, { quantity_to_move,move_started_at} }
-    uint16_t get_pending_move(const GW::Constants::Bag bag_id, const uint32_t slot)
-    {
-        const uint32_t bag_slot = ((size_t)bag_id) << 16 | slot;
-        const auto found = pending_moves.find(bag_slot);
-        if (found == pending_moves.end()) {
-            return 0;
-        }
-        if (TIMER_DIFF(found->second.started_at) > 3000) // 3 second timeout incase of hanging moves
-        {
-            return 0;
-        }
-        return found->second.quantity;
-    }
-    GW::Item* get_pending_move_item(const GW::Constants::Bag bag_id, const uint32_t slot) {
-        const uint32_t bag_slot = ((size_t)bag_id) << 16 | slot;
-        const auto found = pending_moves.find(bag_slot);
-        if (found == pending_moves.end()) {
-            return nullptr;
-        }
-        if (TIMER_DIFF(found->second.started_at) > 3000) // 3 second timeout incase of hanging moves
-        {
-            return nullptr;
-        }
-        return GW::Items::GetItemById(found->second.item_id);
-    }
-
-    void set_pending_move(const GW::Constants::Bag bag_id, const uint32_t slot, const uint16_t quantity_to_move, const uint32_t item_id)
-    {
-        const uint32_t bag_slot = ((size_t)bag_id) << 16 | slot;
-        pending_moves[bag_slot] = {
-            item_id,
-            static_cast<uint16_t>(get_pending_move(bag_id, slot) + quantity_to_move),
-            TIMER_INIT()
-        };
-    }
+    // Moves are planned against a snapshot of the bags all at once, then sent a few at a time as the rate limiter allows
+    constexpr uint32_t MOVE_ITEM_COST_MS = 25;
+    constexpr uint32_t MOVE_ITEM_MAX_COST_MS = 250;
+    std::deque<InventoryMovePlanner::Move> queued_moves;
+    RateLimiter move_item_rate_limiter;
 
-    void clear_pending_move(GW::Constants::Bag bag_idx, const uint32_t slot)
-    {
-        const uint32_t bag_slot = std::to_underlying(bag_idx) << 16 | slot;
-        pending_moves.erase(bag_slot);
-    }
+    // Sent, but the destination slot hasn't updated yet; replayed into every snapshot so the next plan doesn't count on room
+    // that a move already on its way will fill
+    constexpr clock_t IN_FLIGHT_MOVE_TIMEOUT_MS = 3000; // In case of hanging moves
+    struct InFlightMove {
+        InventoryMovePlanner::Move move;
+        clock_t sent_at;
+    };
+    std::vector<InFlightMove> in_flight_moves;
 
-    void clear_pending_move(const uint32_t item_id)
+    void clear_in_flight_moves(const uint32_t item_id)
     {
         const auto item = GW::Items::GetItemById(item_id);
-        if (item && item->bag) {
-            return clear_pending_move(item->bag->bag_id(), item->slot);
+        if (!(item && item->bag)) {
+            return;
         }
+        const auto bag_id = std::to_underlying(item->bag->bag_id());
+        std::erase_if(in_flight_moves, [bag_id, item](const InFlightMove& in_flight) {
+            return in_flight.move.bag_id == bag_id && in_flight.move.slot == item->slot;
+        });
     }
 
     uint16_t MaxSlotSize(const GW::Bag* bag)
@@ -145,197 +117,161 @@ namespace {
         return bag && bag->bag_type == GW::Constants::BagType::MaterialStorage ? (uint16_t)GW::Items::GetMaterialStorageStackSize() : 250;
     }
 
-    uint16_t move_materials_to_storage(const GW::Item* item)
+    // Same key for items that IsSameItem would match, 0 if the item doesn't stack
+    InventoryMovePlanner::StackKey GetStackKey(const GW::Item* item)
     {
-        const auto material_slot = GW::Items::GetMaterialSlot(item);
-        if (material_slot == GW::Constants::MaterialSlot::Count) {
+        if (!(item && item->GetIsStackable() && item->name_enc)) {
             return 0;
         }
-        const uint32_t slot = std::to_underlying(material_slot);
-        const auto materials_pane = GW::Items::GetBag(GW::Constants::Bag::Material_Storage);
-        uint16_t space_available = MaxSlotSize(materials_pane);
-        const GW::Item* existing_stack_in_storage = GW::Items::GetItemBySlot(materials_pane, slot + 1);
-        if (existing_stack_in_storage) {
-            ASSERT(existing_stack_in_storage->quantity <= space_available); // Could trigger if we failed to get the correct max slot size for materials
-            space_available -= existing_stack_in_storage->quantity;
-        }
-        const uint16_t pending_move = get_pending_move(GW::Constants::Bag::Material_Storage, slot);
-        space_available -= pending_move;
-        const uint16_t will_move = std::min<uint16_t>(item->quantity, space_available);
-        if (will_move) {
-            set_pending_move(GW::Constants::Bag::Material_Storage, slot, will_move, item->item_id);
-            GW::Items::MoveItem(item, GW::Constants::Bag::Material_Storage, slot, will_move);
-        }
-        return will_move;
-    }
-
-    size_t find_same_item_in_bag(const GW::Bag* bag, const GW::Item* item, const size_t start_slot = 0) {
-        if (!bag) return GW::Bag::npos;
-        const auto& items = bag->items;
-        for (size_t i = start_slot; i < items.size(); i++) {
-            if (!item) {
-                if (items[i])
-                    continue;
-                return i;
+        uint64_t hash = 0xcbf29ce484222325ull;
+        const auto add = [&hash](const void* data, const size_t len) {
+            for (size_t i = 0; i < len; i++) {
+                hash = (hash ^ static_cast<const uint8_t*>(data)[i]) * 0x100000001b3ull;
             }
-            if (item != items[i] && Instance().IsSameItem(item, items[i]))
-                return i;
+        };
+        add(&item->model_file_id, sizeof(item->model_file_id));
+        if (item->type == GW::Constants::ItemType::Dye) {
+            add(&item->dye, sizeof(item->dye));
         }
-        return GW::Bag::npos;
+        add(item->name_enc, wcslen(item->name_enc) * sizeof(wchar_t));
+        return hash ? hash : 1;
     }
 
-    // From bag_first to bag_last (included) i.e. [bag_first, bag_last]
-    // Returns the amount moved
-    uint16_t complete_existing_stack(const GW::Item* item, const GW::Constants::Bag bag_first, const GW::Constants::Bag bag_last, const uint16_t quantity = 1000u)
+    // Inventory, material storage and storage as they'll be once every sent and queued move has gone through
+    InventoryMovePlanner::Snapshot BuildInventorySnapshot()
     {
-        if (!item->GetIsStackable()) {
-            return 0;
-        }
-        const uint16_t to_move = std::min<uint16_t>(item->quantity, quantity);
-        uint16_t remaining = to_move;
-        for (auto bag_id = bag_first; bag_id <= bag_last; bag_id++) {
-            GW::Bag* bag = GW::Items::GetBag(bag_id);
-            if (!bag) {
+        std::vector<InventoryMovePlanner::BagState> bags;
+        for (auto bag_id = GW::Constants::Bag::Backpack; bag_id <= GW::Constants::Bag::Storage_14; bag_id++) {
+            const GW::Bag* bag = GW::Items::GetBag(bag_id);
+            if (!(bag && bag->items.valid())) {
                 continue;
             }
-            const uint16_t max_slot_size = MaxSlotSize(bag);
-            size_t slot = find_same_item_in_bag(bag,item);
-            while (slot != GW::Bag::npos) {
-                const GW::Item* b_item = bag->items[slot];
-                // b_item can be null in the case of birthday present for instance.
-
-                if (b_item != nullptr && b_item->quantity < max_slot_size) {
-                    uint16_t availaible = max_slot_size - get_pending_move(bag_id, slot) - b_item->quantity;
-                    const uint16_t will_move = std::min<uint16_t>(availaible, remaining);
-                    if (will_move > 0) {
-                        GW::Items::MoveItem(item, b_item, will_move);
-                        set_pending_move(bag_id, slot, will_move, item->item_id);
-                        remaining -= will_move;
-                    }
-                    if (remaining == 0) {
-                        return to_move;
-                    }
+            auto& state = bags.emplace_back();
+            state.bag_id = std::to_underlying(bag_id);
+            state.max_stack = MaxSlotSize(bag);
+            state.slots.resize(bag->items.size());
+            for (size_t slot = 0; slot < bag->items.size(); slot++) {
+                const GW::Item* item = bag->items[slot];
+                if (item) {
+                    state.slots[slot] = {item->item_id, GetStackKey(item), item->quantity};
                 }
-                slot = find_same_item_in_bag(bag,item,slot + 1);
             }
         }
-        return to_move - remaining;
+        InventoryMovePlanner::Snapshot snapshot(std::move(bags));
+        std::erase_if(in_flight_moves, [](const InFlightMove& in_flight) {
+            return TIMER_DIFF(in_flight.sent_at) > IN_FLIGHT_MOVE_TIMEOUT_MS;
+        });
+        for (const auto& in_flight : in_flight_moves) {
+            snapshot.Apply(in_flight.move);
+        }
+        for (const auto& move : queued_moves) {
+            snapshot.Apply(move);
+        }
+        return snapshot;
     }
 
-    uint16_t move_to_first_empty_slot(const GW::Item* item, const GW::Constants::Bag bag_first, const GW::Constants::Bag bag_last, uint16_t quantity = 1000u)
+    InventoryMovePlanner::Request MakeMoveRequest(const GW::Item* item, const uint16_t quantity)
     {
-        quantity = std::min<uint16_t>(item->quantity, quantity);
-        const auto stackable = item->GetIsStackable();
-        for (auto bag_id = bag_first; bag_id <= bag_last; bag_id++) {
-            GW::Bag* bag = GW::Items::GetBag(bag_id);
-            if (!bag) {
-                continue;
-            }
-            const uint16_t max_slot_size = MaxSlotSize(bag);
-            size_t slot = (size_t)-1;
-            
-            do {
-                slot = find_same_item_in_bag(bag, nullptr,slot + 1);
-                if (slot == GW::Bag::npos)
-                    break; // No empty slot found
-                if (bag->items[slot] != nullptr)
-                    break; // Slot isn't empty(?)
-                const auto pending_amount_for_slot = get_pending_move(bag_id, slot);
-                if (pending_amount_for_slot) {
-                    // Slot is currently empty, but we're pending a move for something into it
-                    if (!stackable)
-                        continue; // This item isn't stackable
-                    if (!Instance().IsSameItem(item, get_pending_move_item(bag_id, slot)))
-                        continue; // The pending item isn't the same as this item
-                }
-                uint16_t available = max_slot_size - pending_amount_for_slot;
-                const uint16_t will_move = std::min<uint16_t>(quantity, available);
-                if (will_move > 0) {
-                    set_pending_move(bag_id, slot, will_move, item->item_id);
-                    GW::Items::MoveItem(item, bag, slot, will_move);
-                    return will_move;
-                }
+        return {item->item_id, GetStackKey(item), std::min<uint16_t>(item->quantity, quantity), {}};
+    }
 
-            } while (true);
+    void AddBagRangeSteps(InventoryMovePlanner::Request& request, const GW::Constants::Bag bag_first, const GW::Constants::Bag bag_last)
+    {
+        using Step = InventoryMovePlanner::Step;
+        request.steps.push_back({Step::Type::ExistingStacks, std::to_underlying(bag_first), std::to_underlying(bag_last)});
+        request.steps.push_back({Step::Type::EmptySlots, std::to_underlying(bag_first), std::to_underlying(bag_last)});
+    }
+
+    void AddMaterialStorageStep(InventoryMovePlanner::Request& request, const GW::Item* item)
+    {
+        const auto material_slot = GW::Items::GetMaterialSlot(item);
+        if (material_slot == GW::Constants::MaterialSlot::Count) {
+            return;
         }
-        return 0;
+        constexpr auto material_storage = std::to_underlying(GW::Constants::Bag::Material_Storage);
+        request.steps.push_back({InventoryMovePlanner::Step::Type::FixedSlot, material_storage, material_storage, std::to_underlying(material_slot)});
     }
-    // page is 0 based from storage 1. Note that if material storage is on focus, 0 is returned.
-    uint16_t move_item_to_storage_page(const GW::Item* item, const GW::Constants::StoragePane page, const uint16_t quantity = 1000u)
+
+    // page is 0 based from storage 1.
+    void AddStoragePageSteps(InventoryMovePlanner::Request& request, const GW::Item* item, const GW::Constants::StoragePane page)
     {
-        ASSERT(item && item->quantity);
-        const uint16_t to_move = std::min<uint16_t>(item->quantity, quantity);
-        uint16_t remaining = to_move;
         if (page == GW::Constants::StoragePane::Material_Storage) {
-            if (!item->GetIsMaterial()) {
-                return 0;
+            if (item->GetIsMaterial()) {
+                AddMaterialStorageStep(request, item);
             }
-            remaining -= move_materials_to_storage(item);
+            return;
         }
-
         if (GW::Constants::StoragePane::Storage_14 < page) {
-            return to_move - remaining;
+            return;
         }
+        const auto bag_id = (GW::Constants::Bag)((size_t)GW::Constants::Bag::Storage_1 + (size_t)page);
+        AddBagRangeSteps(request, bag_id, bag_id);
+    }
 
-        const GW::Constants::Bag bag_id = (GW::Constants::Bag)((size_t)GW::Constants::Bag::Storage_1 + (size_t)page);
-        // if the item is stackable we try to complete stack that already exist in the current storage page
-        if (remaining) {
-            remaining -= complete_existing_stack(item, bag_id, bag_id, remaining);
-        }
-        if (remaining) {
-            remaining -= move_to_first_empty_slot(item, bag_id, bag_id, remaining);
+    // Plans the moves for request and queues them. Returns the amount that will be moved.
+    uint16_t QueueMoves(InventoryMovePlanner::Snapshot& snapshot, const InventoryMovePlanner::Request& request)
+    {
+        std::vector<InventoryMovePlanner::Move> moves;
+        const auto planned = snapshot.Plan(request, moves);
+        queued_moves.insert(queued_moves.end(), moves.begin(), moves.end());
+        return planned;
+    }
+
+    void DispatchQueuedMoves()
+    {
+        while (!queued_moves.empty() && move_item_rate_limiter.AddTime(MOVE_ITEM_COST_MS, MOVE_ITEM_MAX_COST_MS)) {
+            const auto move = queued_moves.front();
+            queued_moves.pop_front();
+            const GW::Item* item = GW::Items::GetItemById(move.item_id);
+            if (!(item && item->bag && item->quantity)) {
+                continue; // Used, sold or moved by something else since it was planned
+            }
+            const auto quantity = std::min<uint16_t>(move.quantity, item->quantity);
+            const GW::Item* onto = move.onto_item_id ? GW::Items::GetItemById(move.onto_item_id) : nullptr;
+            if (onto && onto->bag) {
+                GW::Items::MoveItem(item, onto, quantity);
+            }
+            else {
+                GW::Items::MoveItem(item, static_cast<GW::Constants::Bag>(move.bag_id), move.slot, quantity);
+            }
+            auto sent = move;
+            sent.quantity = quantity;
+            in_flight_moves.push_back({sent, TIMER_INIT()});
         }
-        return to_move - remaining;
     }
 
-    uint16_t move_item_to_storage(const GW::Item* item, const uint16_t quantity = 1000u)
+    uint16_t move_to_first_empty_slot(InventoryMovePlanner::Snapshot& snapshot, const GW::Item* item, const GW::Constants::Bag bag_first, const GW::Constants::Bag bag_last, const uint16_t quantity = 1000u)
+    {
+        auto request = MakeMoveRequest(item, quantity);
+        request.steps.push_back({InventoryMovePlanner::Step::Type::EmptySlots, std::to_underlying(bag_first), std::to_underlying(bag_last)});
+        return QueueMoves(snapshot, request);
+    }
+
+    uint16_t move_item_to_storage(InventoryMovePlanner::Snapshot& snapshot, const GW::Item* item, const uint16_t quantity = 1000u)
     {
         ASSERT(item && item->quantity);
-        const uint16_t to_move = std::min<uint16_t>(item->quantity, quantity);
-        uint16_t remaining = to_move;
+        auto request = MakeMoveRequest(item, quantity);
         const bool is_storage_open = GW::Items::GetIsStorageOpen();
-        if (remaining && is_storage_open && item->GetIsMaterial() && GameSettings::GetSettingBool("move_materials_to_current_storage_pane")) {
-            remaining -= move_item_to_storage_page(item, GW::Items::GetStoragePage(), remaining);
+        if (is_storage_open && item->GetIsMaterial() && GameSettings::GetSettingBool("move_materials_to_current_storage_pane")) {
+            AddStoragePageSteps(request, item, GW::Items::GetStoragePage());
         }
-        if (remaining && item->GetIsMaterial()) {
-            remaining -= move_materials_to_storage(item);
+        if (item->GetIsMaterial()) {
+            AddMaterialStorageStep(request, item);
         }
-
-        if (remaining && is_storage_open && GameSettings::GetSettingBool("move_item_to_current_storage_pane")) {
-            remaining -= move_item_to_storage_page(item, GW::Items::GetStoragePage(), remaining);
+        if (is_storage_open && GameSettings::GetSettingBool("move_item_to_current_storage_pane")) {
+            AddStoragePageSteps(request, item, GW::Items::GetStoragePage());
         }
-
-        if (remaining) {
-            remaining -= complete_existing_stack(item, GW::Constants::Bag::Storage_1, GW::Constants::Bag::Storage_14, remaining);
-        }
-        while (remaining) {
-            const uint16_t moved = move_to_first_empty_slot(item, GW::Constants::Bag::Storage_1, GW::Constants::Bag::Storage_14, remaining);
-            if (!moved) {
-                break;
-            }
-            remaining -= moved;
-        }
-
-        return to_move - remaining;
+        AddBagRangeSteps(request, GW::Constants::Bag::Storage_1, GW::Constants::Bag::Storage_14);
+        return QueueMoves(snapshot, request);
     }
 
-    uint16_t move_item_to_inventory(const GW::Item* item, const uint16_t quantity = 1000u)
+    uint16_t move_item_to_inventory(InventoryMovePlanner::Snapshot& snapshot, const GW::Item* item, const uint16_t quantity = 1000u)
     {
         ASSERT(item && item->quantity);
-
-        const uint16_t to_move = std::min<uint16_t>(item->quantity, quantity);
-        uint16_t remaining = to_move;
+        auto request = MakeMoveRequest(item, quantity);
         // If item is stackable, try to complete similar stack
-        remaining -= complete_existing_stack(item, GW::Constants::Bag::Backpack, GW::Constants::Bag::Bag_2, remaining);
-        while (remaining) {
-            const uint16_t moved = move_to_first_empty_slot(item, GW::Constants::Bag::Backpack, GW::Constants::Bag::Bag_2, remaining);
-            if (!moved) {
-                break;
-            }
-            remaining -= moved;
-        }
-
-        return to_move - remaining;
+        AddBagRangeSteps(request, GW::Constants::Bag::Backpack, GW::Constants::Bag::Bag_2);
+        return QueueMoves(snapshot, request);
     }
 
     std::vector<InventoryManager::Item*> filter_items(GW::Constants::Bag from, GW::Constants::Bag to, const std::function<bool(InventoryManager::Item*)>& cmp, const uint32_t limit = 0)
@@ -387,10 +323,10 @@ namespace {
         const std::vector<InventoryManager::Item*> items = filter_items(GW::Constants::Bag::Backpack, GW::Constants::Bag::Bag_2, [](const GW::Item* item) {
             return item && item->GetIsMaterial();
         });
+        auto snapshot = BuildInventorySnapshot();
         for (const auto& item : items) {
-            move_item_to_storage(item);
+            move_item_to_storage(snapshot, item);
         }
-        pending_moves.clear();
     }
 
     void store_all_tomes()
@@ -398,10 +334,10 @@ namespace {
         const std::vector<InventoryManager::Item*> items = filter_items(GW::Constants::Bag::Backpack, GW::Constants::Bag::Bag_2, [](const InventoryManager::Item* item) {
             return item && item->IsTome();
         });
+        auto snapshot = BuildInventorySnapshot();
         for (const auto& item : items) {
-            move_item_to_storage(item);
+            move_item_to_storage(snapshot, item);
         }
-        pending_moves.clear();
     }
 
     void move_all_item(InventoryManager::Item* like_item)
@@ -410,19 +346,19 @@ namespace {
         const auto is_same_item = [like_item](const InventoryManager::Item* cmp) {
             return cmp && InventoryManager::IsSameItem(like_item, cmp);
         };
+        auto snapshot = BuildInventorySnapshot();
         if (like_item->bag->IsInventoryBag()) {
             const std::vector<InventoryManager::Item*> items = filter_items(GW::Constants::Bag::Backpack, GW::Constants::Bag::Bag_2, is_same_item);
             for (const auto& item : items) {
-                move_item_to_storage(item);
+                move_item_to_storage(snapshot, item);
             }
         }
         else {
             const std::vector<InventoryManager::Item*> items = filter_items(GW::Constants::Bag::Material_Storage, GW::Constants::Bag::Storage_14, is_same_item);
             for (const auto& item : items) {
-                move_item_to_inventory(item);
+                move_item_to_inventory(snapshot, item);
             }
         }
-        pending_moves.clear();
     }
 
     void store_all_upgrades()
@@ -430,49 +366,49 @@ namespace {
         const std::vector<InventoryManager::Item*> items = filter_items(GW::Constants::Bag::Backpack, GW::Constants::Bag::Bag_2, [](const InventoryManager::Item* item) {
             return item && item->type == GW::Constants::ItemType::Rune_Mod;
         });
+        auto snapshot = BuildInventorySnapshot();
         for (const auto& item : items) {
-            move_item_to_storage(item);
+            move_item_to_storage(snapshot, item);
         }
-        pending_moves.clear();
     }
     void store_all_dyes()
     {
         const std::vector<InventoryManager::Item*> items = filter_items(GW::Constants::Bag::Backpack, GW::Constants::Bag::Bag_2, [](const InventoryManager::Item* item) {
             return item && item->type == GW::Constants::ItemType::Dye;
             });
+        auto snapshot = BuildInventorySnapshot();
         for (const auto& item : items) {
-            move_item_to_storage(item);
+            move_item_to_storage(snapshot, item);
         }
-        pending_moves.clear();
     }
     void withdraw_all_dyes()
     {
         const std::vector<InventoryManager::Item*> items = filter_items(GW::Constants::Bag::Storage_1, GW::Constants::Bag::Storage_14, [](const InventoryManager::Item* item) {
             return item && item->type == GW::Constants::ItemType::Dye;
             });
+        auto snapshot = BuildInventorySnapshot();
         for (const auto& item : items) {
-            move_item_to_inventory(item);
+            move_item_to_inventory(snapshot, item);
         }
-        pending_moves.clear();
     }
     void withdraw_all_tomes()
     {
         const std::vector<InventoryManager::Item*> items = filter_items(GW::Constants::Bag::Storage_1, GW::Constants::Bag::Storage_14, [](const InventoryManager::Item* item) {
             return item && item->IsTome();
             });
+        auto snapshot = BuildInventorySnapshot();
         for (const auto& item : items) {
-            move_item_to_inventory(item);
+            move_item_to_inventory(snapshot, item);
         }
-        pending_moves.clear();
     }
     void store_all_nicholas_items() {
         const std::vector<InventoryManager::Item*> items = filter_items(GW::Constants::Bag::Backpack, GW::Constants::Bag::Bag_2, [](const InventoryManager::Item* item) {
             return item && DailyQuests::GetNicholasItemInfo(item->name_enc);
             });
+        auto snapshot = BuildInventorySnapshot();
         for (const auto& item : items) {
-            move_item_to_storage(item);
+            move_item_to_storage(snapshot, item);
         }
-        pending_moves.clear();
     }
 
     void consume_all(InventoryManager::Item* like_item) {
@@ -508,13 +444,15 @@ namespace {
         }
         const bool is_inventory_item = item->IsInventoryItem();
         uint16_t remaining = std::min<uint16_t>(item->quantity, quantity);
+        auto snapshot = BuildInventorySnapshot();
         if (is_inventory_item) {
-            remaining -= move_item_to_storage(item, remaining);
+            remaining -= move_item_to_storage(snapshot, item, remaining);
         }
         else {
-            remaining -= move_item_to_inventory(item, remaining);
+            remaining -= move_item_to_inventory(snapshot, item, remaining);
         }
-        pending_moves.clear();
+        // Send it now rather than next frame; one click is rarely more than a couple of moves
+        DispatchQueuedMoves();
         return remaining;
     }
 
@@ -848,7 +786,7 @@ void InventoryManager::OnUIMessage(GW::HookStatus* status, const GW::UI::UIMessa
     auto& instance = Instance();
     switch (message_id) {
         case GW::UI::UIMessage::kItemUpdated: {
-            clear_pending_move((uint32_t)wparam);
+            clear_in_flight_moves((uint32_t)wparam);
         }
         break;
         case GW::UI::UIMessage::kVendorWindow: {
@@ -1121,6 +1059,8 @@ void InventoryManager::CancelAll()
     CancelSalvage();
     CancelIdentify();
     CancelTransaction();
+    queued_moves.clear();
+    in_flight_moves.clear();
 }
 
 void InventoryManager::AttachTransactionListeners()
@@ -1613,6 +1553,7 @@ std::pair<GW::Bag*, uint32_t> InventoryManager::GetAvailableInventorySlot(GW::It
 uint16_t InventoryManager::RefillUpToQuantity(const uint16_t wanted_quantity, const std::vector<uint32_t>& model_ids)
 {
     uint16_t moved = 0;
+    auto snapshot = BuildInventorySnapshot();
     for (const auto model_id : model_ids) {
         const auto is_same_item = [model_id](const Item* cmp) {
             return cmp && cmp->model_id == model_id;
@@ -1629,7 +1570,7 @@ uint16_t InventoryManager::RefillUpToQuantity(const uint16_t wanted_quantity, co
         }
         const auto storage_items = filter_items(GW::Constants::Bag::Material_Storage, GW::Constants::Bag::Storage_14, is_same_item);
         for (const auto item : storage_items) {
-            const auto this_move = move_item_to_inventory(item, to_move);
+            const auto this_move = move_item_to_inventory(snapshot, item, to_move);
             moved += this_move;
             to_move -= this_move;
             if (to_move < 1) {
@@ -1644,6 +1585,7 @@ uint16_t InventoryManager::RefillUpToQuantity(const uint16_t wanted_quantity, co
 uint16_t InventoryManager::StoreItems(uint16_t quantity, const std::vector<unsigned>& model_ids)
 {
     uint16_t moved = 0;
+    auto snapshot = BuildInventorySnapshot();
     for (const auto model_id : model_ids) {
         const auto is_same_item = [model_id](const Item* cmp) {
             return cmp && cmp->model_id == model_id;
@@ -1651,7 +1593,7 @@ uint16_t InventoryManager::StoreItems(uint16_t quantity, const std::vector<unsig
         const auto inventory_items = filter_items(GW::Constants::Bag::Backpack, GW::Constants::Bag::Bag_2, is_same_item);
         uint16_t to_move = quantity;
         for (const auto item : inventory_items) {
-            const auto this_move = move_item_to_storage(item, to_move);
+            const auto this_move = move_item_to_storage(snapshot, item, to_move);
             moved += this_move;
             to_move -= this_move;
             if (to_move < 1) {
@@ -1816,6 +1758,7 @@ void InventoryManager::DrawSettingsInternal()
 void InventoryManager::Update(float)
 {
     ProcessQueuedButtonPresses();
+    DispatchQueuedMoves();
 
     if (pending_item_move_for_trade) {
         const auto item = reinterpret_cast<Item*>(GW::Items::GetItemById(pending_item_move_for_trade));
@@ -2311,7 +2254,8 @@ void InventoryManager::ItemClickCallback(GW::HookStatus* status, const uint32_t
                     return;
                 }
                 if (!item->bag->IsInventoryBag()) {
-                    const uint16_t moved = move_to_first_empty_slot(item, GW::Constants::Bag::Backpack, GW::Constants::Bag::Bag_2);
+                    auto snapshot = BuildInventorySnapshot();
+                    const uint16_t moved = move_to_first_empty_slot(snapshot, item, GW::Constants::Bag::Backpack, GW::Constants::Bag::Bag_2);
                     if (!moved) {
                         Log::ErrorW(L"Failed to move item to inventory for trading");
                         return;
@@ -2329,7 +2273,8 @@ void InventoryManager::ItemClickCallback(GW::HookStatus* status, const uint32_t
                     return;
                 }
                 if (!item->bag->IsInventoryBag()) {
-                    const uint16_t moved = move_to_first_empty_slot(item, GW::Constants::Bag::Backpack, GW::Constants::Bag::Bag_2);
+                    auto snapshot = BuildInventorySnapshot();
+                    const uint16_t moved = move_to_first_empty_slot(snapshot, item, GW::Constants::Bag::Backpack, GW::Constants::Bag::Bag_2);
                     if (!moved) {
                         Log::ErrorW(L"Failed to move item to inventory for trading");
                         return;
@@ -22,6 +22,7 @@
 #include <Modules/ChatSettings.h>
 #include <Modules/Obfuscator.h>
 #include <Utils/GuiUtils.h>
+#include <Utils/StringReplacer.h>
 #include <Windows/FriendListWindow.h>
 
 #include <Defines.h>
@@ -261,6 +262,12 @@ namespace {
     std::map<std::wstring, std::wstring> obfuscated_by_obfuscation;
     // List of obfuscated names, keyed by original
     std::map<std::wstring, std::wstring> obfuscated_by_original;
+    // Bumped whenever either list changes, so the replacers below know to rebuild
+    uint32_t obfuscated_names_version = 0;
+    StringReplacer obfuscate_replacer;
+    StringReplacer unobfuscate_replacer;
+    uint32_t obfuscate_replacer_version = 0xFFFFFFFF;
+    uint32_t unobfuscate_replacer_version = 0xFFFFFFFF;
     // Current position in the list of obfuscated names
     size_t pool_index = 0;
 
@@ -353,6 +360,7 @@ namespace {
         if (!obfuscated_by_original.contains(original_name)) {
             obfuscated_by_obfuscation.emplace(tmp_out, original_name);
             obfuscated_by_original.emplace(original_name, tmp_out);
+            obfuscated_names_version++;
             out.assign(tmp_out);
             return true;
         }
@@ -373,26 +381,27 @@ namespace {
         return true;
     }
 
+    StringReplacer& GetMessageReplacer(const bool obfuscate)
+    {
+        auto& replacer = obfuscate ? obfuscate_replacer : unobfuscate_replacer;
+        auto& version = obfuscate ? obfuscate_replacer_version : unobfuscate_replacer_version;
+        if (version != obfuscated_names_version) {
+            replacer.Clear();
+            for (const auto& [from, to] : obfuscate ? obfuscated_by_original : obfuscated_by_obfuscation) {
+                replacer.Add(from, to);
+            }
+            replacer.Compile();
+            version = obfuscated_names_version;
+        }
+        return replacer;
+    }
+
     bool ObfuscateMessage(const std::wstring_view message, std::wstring& out, const bool obfuscate = true)
     {
         if (!wcschr(message.data(),0x107))
             return false; // Message contains no player names
-        std::wstring replacemsg{message};
-        const auto& to_search = obfuscate ? obfuscated_by_original : obfuscated_by_obfuscation;
-        bool was_changed = false;
-        for (const auto& [from, to] : to_search) {
-            if (from.empty()) {
-                break;
-            }
-            size_t start_pos = 0;
-            while ((start_pos = replacemsg.find(from, start_pos)) != std::string::npos) {
-                replacemsg.replace(start_pos, from.length(), to);
-                start_pos += to.length(); // In case 'to' contains 'from', like replacing 'x' with 'yx'
-                was_changed = true;
-            }
-        }
-        out.assign(replacemsg);
-        return !out.empty() && was_changed;
+        // One pass over the message for every name at once; where names overlap the longest wins, and replaced text isn't searched again
+        return GetMessageReplacer(obfuscate).Replace(message, out) && !out.empty();
     }
 
     bool UnobfuscateMessage(const wchar_t* message, std::wstring& out)
@@ -545,6 +554,7 @@ namespace {
         pool_index = 0;
         obfuscated_by_obfuscation.clear();
         obfuscated_by_original.clear();
+        obfuscated_names_version++;
         // Don't use clear() on this; the game uses the pointer so we don't want to mess with it
         account_info_obfuscated_name[0] = '\0';
         // Don't use clear() on this; the game uses the pointer so we don't want to mess with it
@@ -1934,11 +1934,11 @@ bool ObserverModule::ObservableParty::SynchroniseParty()
             const ObservableGuild* guild = parent.GetObservableGuildById(agent0->guild_id);
             if (guild) {
                 guild_id = guild->guild_id;
-                name = guild->name;
+                name = StringPool::Get(guild->name);
                 rank = guild->rank;
                 rank_str = guild->rank == NO_RANK ? "N/A" : std::to_string(guild->rank);
                 rating = guild->rating;
-                display_name = guild->name + " [" + guild->tag + "]";
+                display_name = StringPool::Get(guild->name) + " [" + guild->tag + "]";
             }
             else {
                 name = agent0->SanitizedName() + "'s team";
@@ -1996,7 +1996,7 @@ ObserverModule::ObservableGuild::ObservableGuild(ObserverModule& parent, const G
     : parent(parent)
     , guild_id(guild.index)
     , key(guild.key)
-    , name(TextUtils::WStringToString(guild.name))
+    , name(StringPool::Intern(guild.name))
     , tag(TextUtils::WStringToString(guild.tag))
     , wrapped_tag("[" + tag + "]")
     , rank(guild.rank)
@@ -2024,7 +2024,7 @@ ObserverModule::ObservableAgent::ObservableAgent(ObserverModule& parent, const G
     , is_npc(agent_living.IsNPC())
 {
     // async initialise the agents name now because we probably want it later
-    GW::UI::AsyncDecodeStr(GW::Agents::GetAgentEncName(&agent_living), &_raw_name_w);
+    GW::UI::AsyncDecodeInterned(GW::Agents::GetAgentEncName(&agent_living), &_raw_name);
 
     if (primary != GW::Constants::Profession::None) {
         std::string prof = GetProfessionAcronym(primary);
@@ -2045,99 +2045,67 @@ ObserverModule::ObservableAgent::~ObservableAgent()
 
 
 // Name of the Agent to display on HUD
-std::string ObserverModule::ObservableAgent::DisplayName()
+const std::string& ObserverModule::ObservableAgent::DisplayName()
 {
-    const bool is_initialised = _display_name.length() > 0;
+    const bool is_initialised = _display_name != StringPool::empty;
     // additional name modification settings can go here...
     const bool cache_busted = parent.trim_hench_names != trim_hench_name;
     if (is_initialised && !cache_busted) {
-        return _display_name;
+        return StringPool::Get(_display_name);
     }
 
     // generate and cache display_name
-    std::string next_display_name = RawName();
+    std::wstring next_display_name = RawNameW();
 
     // remove hench name
     if (parent.trim_hench_names) {
-        const size_t begin = next_display_name.find("[");
-        const size_t end = next_display_name.find_first_of("]");
-        if (std::string::npos != begin && std::string::npos != end && begin <= end) {
+        const size_t begin = next_display_name.find(L"[");
+        const size_t end = next_display_name.find_first_of(L"]");
+        if (std::wstring::npos != begin && std::wstring::npos != end && begin <= end) {
             next_display_name.erase(begin, end - begin + 1);
         }
     }
 
     // trim whitespace
-    const size_t w_first = next_display_name.find_first_not_of(' ');
-    const size_t w_last = next_display_name.find_last_not_of(' ');
-    if (w_first != std::string::npos) {
+    const size_t w_first = next_display_name.find_first_not_of(L' ');
+    const size_t w_last = next_display_name.find_last_not_of(L' ');
+    if (w_first != std::wstring::npos) {
         next_display_name = next_display_name.substr(w_first, w_last + 1);
     }
 
     trim_hench_name = parent.trim_hench_names;
-    _display_name = next_display_name;
-    return _display_name;
+    _display_name = StringPool::Intern(next_display_name);
+    return StringPool::Get(_display_name);
 }
 
 
 // Sanitized Name of the Agent (as std::string)
-std::string ObserverModule::ObservableAgent::SanitizedName()
+const std::string& ObserverModule::ObservableAgent::SanitizedName()
 {
-    // has been cached
-    if (_sanitized_name.length() > 0) {
-        return _sanitized_name;
-    }
-    const std::wstring sanitized_name_w = SanitizedNameW();
-    // can't be cached yet
-    if (sanitized_name_w.length() == 0) {
-        return "";
-    }
-    // can now be cached
-    _sanitized_name = TextUtils::WStringToString(sanitized_name_w);
-    return _sanitized_name;
+    // sanitized names are cached by the pool, and empty until the raw name is known
+    return StringPool::Get(StringPool::Sanitized(_raw_name));
 }
 
 
 // Sanitized Name of the Agent (as std::wstring)
-std::wstring ObserverModule::ObservableAgent::SanitizedNameW()
+const std::wstring& ObserverModule::ObservableAgent::SanitizedNameW()
 {
-    // has been cached
-    if (_sanitized_name_w.length() > 0) {
-        return _sanitized_name_w;
-    }
-    const std::wstring raw_name_w = RawNameW();
-    // can't be cached yet
-    if (raw_name_w.length() == 0) {
-        return L"";
-    }
-    // can now be cached
-    _sanitized_name_w = TextUtils::SanitizePlayerName(raw_name_w);
-    return _sanitized_name_w;
+    return StringPool::GetW(StringPool::Sanitized(_raw_name));
 }
 
 
 // Name of the Agent (as std::string)
-std::string ObserverModule::ObservableAgent::RawName()
+const std::string& ObserverModule::ObservableAgent::RawName()
 {
-    // has been cached
-    if (_raw_name.length() > 0) {
-        return _raw_name;
-    }
-    const std::wstring raw_name_w = RawNameW();
-    // can't be cached yet
-    if (raw_name_w.length() == 0) {
-        return "";
-    }
-    // can now be cached
-    _raw_name = TextUtils::WStringToString(raw_name_w);
-    return _raw_name;
+    return StringPool::Get(_raw_name);
 }
 
 
 // Name of the Agent (un-edited as wstring)
-std::wstring ObserverModule::ObservableAgent::RawNameW()
+const std::wstring& ObserverModule::ObservableAgent::RawNameW()
 {
     // rely on the constructor initialising the name...
-    return _raw_name_w;
+    return StringPool::GetW(_raw_name);
 }
 
 
@@ -2161,7 +2129,7 @@ ObserverModule::ObservableMap::ObservableMap(const GW::AreaInfo& area_info)
 {
     // async initialise the name
     if (GW::UI::UInt32ToEncStr(area_info.name_id, name_enc, 8)) {
-        GW::UI::AsyncDecodeStr(name_enc, &name_w);
+        GW::UI::AsyncDecodeInterned(name_enc, &name);
     }
 
     // async initialise the description
@@ -2170,14 +2138,10 @@ ObserverModule::ObservableMap::ObservableMap(const GW::AreaInfo& area_info)
     }
 }
 
-// Cache & return name
-std::string ObserverModule::ObservableMap::Name()
+// Name, once it's decoded
+const std::string& ObserverModule::ObservableMap::Name()
 {
-    if (name.length() > 0) {
-        return name;
-    }
-    name = TextUtils::WStringToString(name_w);
-    return name;
+    return StringPool::Get(name);
 }
 
 // Cache & return description
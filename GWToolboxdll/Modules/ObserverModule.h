@@ -13,6 +13,7 @@
 #include <GWCA/Utilities/Hook.h>
 
 #include <ToolboxModule.h>
+#include <Utils/StringPool.h>
 
 constexpr auto NO_SKILL = static_cast<GW::Constants::SkillID>(0);
 constexpr auto NO_AGENT = 0;
@@ -289,25 +290,21 @@ public:
         ObservableAgentStats stats;;
 
         // name fns with excessive caching & lazy loading
-        std::string DisplayName();
-        std::string RawName();
-        std::wstring RawNameW();
+        const std::string& DisplayName();
+        const std::string& RawName();
+        const std::wstring& RawNameW();
         std::string DebugName();
-        std::string SanitizedName();
-        std::wstring SanitizedNameW();
+        const std::string& SanitizedName();
+        const std::wstring& SanitizedNameW();
 
     private:
         bool trim_hench_name = false;
 
-        std::string _display_name = "";
+        StringPool::Handle _display_name = StringPool::empty;
 
         // raw_name is inially unknown for NPC's
         // raw_name is asynchronously initialized
-        std::wstring _raw_name_w = L"";
-        std::string _raw_name = "";
-
-        std::wstring _sanitized_name_w = L"";
-        std::string _sanitized_name = "";
+        StringPool::Handle _raw_name = StringPool::empty;
     };
 
     class ObservableGuild {
@@ -317,7 +314,7 @@ public:
         ObserverModule& parent;
         uint32_t guild_id;
         GW::GHKey key;
-        std::string name;
+        StringPool::Handle name;
         std::string tag;
         std::string wrapped_tag;
         uint32_t rank;
@@ -406,14 +403,13 @@ public:
         uint32_t name_id;
         uint32_t description_id;
 
-        std::string Name();
+        const std::string& Name();
         std::string Description();
         [[nodiscard]] bool GetIsPvP() const { return (flags & 0x1) != 0; }
         [[nodiscard]] bool GetIsGuildHall() const { return (flags & 0x800000) != 0; }
 
     private:
-        std::string name = "";
-        std::wstring name_w = L"";
+        StringPool::Handle name = StringPool::empty;
         std::string description = "";
         std::wstring description_w = L"";
         wchar_t name_enc[8]{};
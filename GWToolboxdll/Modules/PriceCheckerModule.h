@@ -24,6 +24,18 @@ public:
     void DrawSettingsInternal() override;
     void SaveSettings(ToolboxIni* ini) override;
 
-    // Returns a list of prices by identifier. Materials have identifiers are "model_id", but runes and mods are "model_id-mod_struct"
-    static const std::unordered_map<std::string,uint32_t>& FetchPrices();
+    // Prices from the last download. Never changed once published; a new download swaps in a whole new index.
+    struct PriceIndex {
+        // Identifiers for materials are "model_id", but runes and mods are "model_id-mod_struct"
+        std::unordered_map<std::string, uint32_t> by_identifier;
+        // (model_id << 32 | mod identifier) sorted, for tooltips. Materials use 0 as the mod identifier;
+        // runes and mods have an entry for every word of their mod struct.
+        std::vector<std::pair<uint64_t, uint32_t>> by_model_and_mod;
+
+        // 0 if there's no price
+        [[nodiscard]] uint32_t GetPrice(uint32_t model_id, uint32_t mod_identifier = 0) const;
+    };
+
+    // Starts a download if the prices are stale, and returns the current index (never null)
+    static std::shared_ptr<const PriceIndex> FetchPrices();
 };
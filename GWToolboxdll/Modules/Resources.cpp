@@ -34,6 +34,8 @@
 #include <Modules/GwDatTextureModule.h>
 #include <Constants/EncStrings.h>
 #include <Utils/TextUtils.h>
+#include <Utils/DecodeCache.h>
+#include <Utils/Scheduler.h>
 
 namespace {
     bool initialised_curl = false;
@@ -93,6 +95,9 @@ namespace {
     std::unordered_map<GW::Constants::Language, std::unordered_map<uint32_t, GuiUtils::EncString*>> encoded_string_ids;
     std::filesystem::path current_settings_folder;
     constexpr size_t MAX_WORKERS = 5;
+    // Encoded strings sent to the game's decoder per frame, and the most time to spend doing it
+    constexpr size_t MAX_DECODES_PER_FRAME = 256;
+    constexpr double DECODE_BUDGET_MS = 1.0;
     const wchar_t* GUILD_WARS_WIKI_FILES_PATH = L"img\\gww_files";
     const wchar_t* SKILL_IMAGES_PATH = L"img\\skills";
     const wchar_t* ITEM_IMAGES_PATH = L"img\\items";
@@ -100,15 +105,12 @@ namespace {
     const wchar_t* DMGTYPE_ICONS_PATH = L"img\\damagetypes";
 
     std::recursive_mutex worker_mutex;
-    std::recursive_mutex main_mutex;
     std::recursive_mutex dx_mutex;
 
     // tasks to be done async by the worker thread
     std::queue<std::function<void()>> thread_jobs;
     // tasks to be done in the render thread
     std::queue<std::function<void(IDirect3DDevice9*)>> dx_jobs;
-    // tasks to be done in main thread
-    std::queue<std::function<void()>> main_jobs;
 
 
     IDirect3DTexture9* empty_texture_ptr = 0;
@@ -140,6 +142,13 @@ namespace {
                 if (wparam && *static_cast<GW::UI::EnumPreference*>(wparam) == GW::UI::EnumPreference::InterfaceSize) {
                     Resources::GetGWScaleMultiplier(true); // Re-fetch ui scale indicator
                 }
+                if (wparam && *static_cast<GW::UI::EnumPreference*>(wparam) == GW::UI::EnumPreference::TextLanguage) {
+                    // Strings in the old language are only wanted by whatever still shows them
+                    Resources::EnqueueWorkerTask([] {
+                        DecodeCache::Save();
+                        DecodeCache::Trim();
+                    });
+                }
                 break;
         }
     }
@@ -220,9 +229,10 @@ void Resources::EnqueueWorkerTask(const std::function<void()>& f)
 
 void Resources::EnqueueMainTask(const std::function<void()>& f)
 {
-    main_mutex.lock();
-    main_jobs.push(f);
-    main_mutex.unlock();
+    Scheduler::Start([f] {
+        f();
+        return Scheduler::Step::Done();
+    });
 }
 
 void Resources::EnqueueDxTask(const std::function<void(IDirect3DDevice9*)>& f)
@@ -409,6 +419,9 @@ void Resources::Terminate()
     GW::UI::RemoveUIMessageCallback(&OnUIMessage_Hook);
 
     Cleanup();
+    // Workers have stopped, so any load of decoded strings has finished
+    DecodeCache::Save();
+    DecodeCache::Clear();
     if (initialised_curl)
         ShutdownCurl();
     initialised_curl = false;
@@ -919,15 +932,7 @@ void Resources::DxUpdate(IDirect3DDevice9* device)
 
 void Resources::Update(float)
 {
-    main_mutex.lock();
-    if (main_jobs.empty()) {
-        main_mutex.unlock();
-        return;
-    }
-    const auto func = std::move(main_jobs.front());
-    main_jobs.pop();
-    main_mutex.unlock();
-    func();
+    DecodeCache::Update(MAX_DECODES_PER_FRAME, DECODE_BUDGET_MS);
 }
 
 IDirect3DTexture9** Resources::GetProfessionIcon(GW::Constants::Profession p)
@@ -1241,6 +1246,7 @@ GuiUtils::EncString* Resources::DecodeStringId(const uint32_t enc_str_id, GW::Co
             return found->second;
     }
     const auto enc_string = new GuiUtils::EncString(enc_str_id, false);
+    enc_string->language(language);
     encoded_string_ids[language][enc_str_id] = enc_string;
     return enc_string;
 }
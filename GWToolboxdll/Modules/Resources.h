@@ -43,7 +43,8 @@ public:
 
     // Enqueue instruction to be called on worker thread, away from the render loop e.g. curl requests
     static void EnqueueWorkerTask(const std::function<void()>& f);
-    // Enqueue instruction to be called on the main update loop of GW
+    // Enqueue instruction to be called on the main update loop of GW, as a one step Scheduler task.
+    // Tasks still queued at shutdown are cancelled without running, so f must free whatever it owns through its captures, not its body.
     static void EnqueueMainTask(const std::function<void()>& f);
     // Enqueue instruction to be called on the draw loop of GW e.g. messing with DirectX9 device
     static void EnqueueDxTask(const std::function<void(IDirect3DDevice9*)>& f);
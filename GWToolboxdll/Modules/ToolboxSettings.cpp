@@ -60,6 +60,8 @@
 #include <Windows/ArmoryWindow.h>
 #include <Windows/EnemyWindow.h>
 #include <Windows/Pathfinding/PathfindingWindow.h>
+#include <Windows/ProfilerWindow.h>
+#include <Windows/AllocationTrackerWindow.h>
 #ifdef _DEBUG
 #include <Windows/PacketLoggerWindow.h>
 #include <Windows/DoorMonitorWindow.h>
@@ -202,7 +204,9 @@ namespace {
         DupingWindow::Instance(),
         ArmoryWindow::Instance(),
         EnemyWindow::Instance(),
-        TargetInfoWindow::Instance()
+        TargetInfoWindow::Instance(),
+        {ProfilerWindow::Instance(), false},
+        {AllocationTrackerWindow::Instance(), false}
     };
 
     bool modules_sorted = false;
@@ -270,7 +274,7 @@ void ToolboxSettings::DrawSettingsInternal()
     ImGui::Columns(static_cast<int>(cols), "global_enable_cols", false);
     for (auto& m : optional_modules) {
         if (ImGui::Checkbox(m.name, &m.enabled)) {
-            GWToolbox::SaveSettings();
+            MarkSettingsDirty();
             const auto p = &m;
             GW::GameThread::Enqueue([p]() {
                 GWToolbox::ToggleModule(*p->toolbox_module, p->enabled);
@@ -296,7 +300,7 @@ void ToolboxSettings::DrawSettingsInternal()
     items_per_col = static_cast<size_t>(ceil(optional_windows.size() / static_cast<float>(cols)));
     for (auto& m : optional_windows) {
         if (ImGui::Checkbox(m.name, &m.enabled)) {
-            GWToolbox::SaveSettings();
+            MarkSettingsDirty();
             const auto p = &m;
             GW::GameThread::Enqueue([p]() {
                 GWToolbox::ToggleModule(*p->toolbox_module, p->enabled);
@@ -321,7 +325,7 @@ void ToolboxSettings::DrawSettingsInternal()
     items_per_col = static_cast<size_t>(ceil(optional_widgets.size() / static_cast<float>(cols)));
     for (auto& m : optional_widgets) {
         if (ImGui::Checkbox(m.name, &m.enabled)) {
-            GWToolbox::SaveSettings();
+            MarkSettingsDirty();
             const auto p = &m;
             GW::GameThread::Enqueue([p]() {
                 GWToolbox::ToggleModule(*p->toolbox_module, p->enabled);
@@ -210,7 +210,7 @@ namespace {
         Log::Log("%s: Connected %s", irc_alias.c_str(), params);
         sprintf(buf, "#%s", irc_channel.c_str());
         conn->join(buf);
-        conn->raw("CAP REQ :twitch.tv/membership twitch.tv/commands\r\n");
+        conn->raw("CAP REQ :twitch.tv/membership twitch.tv/commands twitch.tv/tags\r\n");
         return 0;
     }
 
@@ -220,8 +220,13 @@ namespace {
         if (!params[0] || !show_messages) {
             return 0; // Empty msg
         }
+        // Twitch sends the capitalised (or localised) name as a tag; the nick is always lower case
+        std::string display_name;
+        if (hostd->tags) {
+            IrcProtocol::UnescapeTagValue(IrcProtocol::FindTag(hostd->tags, "display-name"), display_name);
+        }
         const std::wstring message_ws = TextUtils::StringToWString(&params[1]);
-        WriteChat(message_ws.c_str(), hostd->nick);
+        WriteChat(message_ws.c_str(), display_name.empty() ? hostd->nick : display_name.c_str());
         Log::Log("Message from %s: %s", hostd->nick, &params[1]);
         return 0;
     }
@@ -400,6 +405,8 @@ void TwitchModule::Update(const float)
         Connect();
         pending_connect = pending_disconnect = false;
     }
+    // Lines received before a disconnect are still worth showing
+    irc_conn.dispatch_messages();
     if (connected) {
         irc_conn.ping();
     }
@@ -1,6 +1,8 @@
 #include "stdafx.h"
 
+#include <GWToolbox.h>
 #include <ToolboxModule.h>
+#include <Utils/AllocationTracker.h>
 
 namespace {
     // static function to register content
@@ -43,6 +45,18 @@ void ToolboxModule::Terminate()
     }
 }
 
+void ToolboxModule::MarkSettingsDirty()
+{
+    GWToolbox::MarkSettingsDirty(this);
+}
+
+void ToolboxModule::RegisterAllocationTag()
+{
+    if (!allocation_tag) {
+        allocation_tag = AllocationTracker::RegisterTag(Name());
+    }
+}
+
 void ToolboxModule::RegisterSettingsContent()
 {
     if (!HasSettings()) {
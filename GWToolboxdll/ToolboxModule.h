@@ -76,6 +76,13 @@ public:
     // Save what is needed to ini
     virtual void SaveSettings(ToolboxIni*) { }
 
+    // Ask for SaveSettings() to be written out to disk soon, without waiting for the next full save
+    void MarkSettingsDirty();
+
+    // Id AllocationTracker charges this module's allocations to. Registered when the module is first enabled, 0 until then.
+    [[nodiscard]] uint16_t AllocationTag() const { return allocation_tag; }
+    void RegisterAllocationTag();
+
     // Draw settings interface. Will be called if the setting panel is visible, calls DrawSettingsInternal()
     //virtual void DrawSettings();
     virtual void DrawSettingsInternal() { }
@@ -87,4 +94,7 @@ public:
 protected:
     // Weighting used to decide where to position the DrawSettingInternal() for this module. Useful when more than 1 module has the same SettingsName().
     virtual float SettingsWeighting() { return 1.0f; }
+
+private:
+    uint16_t allocation_tag = 0;
 };
@@ -1,10 +1,232 @@
 #include "stdafx.h"
 
+#include <bit>
+#include <emmintrin.h>
+
 #include <Utf8.h>
 
+namespace {
+    static_assert(sizeof(wchar_t) == 2, "wchar_t is assumed to be a UTF-16 code unit");
+
+    constexpr bool IsHighSurrogate(const uint32_t c) { return c >= 0xD800 && c <= 0xDBFF; }
+    constexpr bool IsLowSurrogate(const uint32_t c) { return c >= 0xDC00 && c <= 0xDFFF; }
+
+    // With Write false this only counts, and out isn't touched
+    template <bool Write>
+    size_t EncodeImpl(const std::wstring_view str, [[maybe_unused]] char* out)
+    {
+        const auto in = str.data();
+        const auto n = str.size();
+        const auto zero = _mm_setzero_si128();
+        const auto non_ascii = _mm_set1_epi16(static_cast<short>(0xFF80));
+        size_t i = 0;
+        size_t o = 0;
+        const auto put = [&](const uint32_t byte) {
+            if constexpr (Write) {
+                out[o] = static_cast<char>(byte);
+            }
+            o++;
+        };
+        while (i < n) {
+            // Narrow runs of ASCII 8 characters at a time
+            for (; i + 8 <= n; i += 8, o += 8) {
+                const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+                if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, non_ascii), zero)) != 0xFFFF) {
+                    break;
+                }
+                if constexpr (Write) {
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(out + o), _mm_packus_epi16(v, v));
+                }
+            }
+            if (i == n) {
+                break;
+            }
+            const uint32_t c = in[i++];
+            if (c < 0x80) {
+                put(c);
+            }
+            else if (c < 0x800) {
+                put(0xC0 | (c >> 6));
+                put(0x80 | (c & 0x3F));
+            }
+            else if (IsHighSurrogate(c)) {
+                if (i == n || !IsLowSurrogate(in[i])) {
+                    return utf8::invalid;
+                }
+                const auto code_point = 0x10000 + ((c - 0xD800) << 10) + (static_cast<uint32_t>(in[i++]) - 0xDC00);
+                put(0xF0 | (code_point >> 18));
+                put(0x80 | ((code_point >> 12) & 0x3F));
+                put(0x80 | ((code_point >> 6) & 0x3F));
+                put(0x80 | (code_point & 0x3F));
+            }
+            else if (IsLowSurrogate(c)) {
+                return utf8::invalid;
+            }
+            else {
+                put(0xE0 | (c >> 12));
+                put(0x80 | ((c >> 6) & 0x3F));
+                put(0x80 | (c & 0x3F));
+            }
+        }
+        return o;
+    }
+
+    template <bool Write>
+    size_t DecodeImpl(const std::string_view str, [[maybe_unused]] wchar_t* out)
+    {
+        const auto in = reinterpret_cast<const uint8_t*>(str.data());
+        const auto n = str.size();
+        const auto zero = _mm_setzero_si128();
+        size_t i = 0;
+        size_t o = 0;
+        const auto put = [&](const uint32_t unit) {
+            if constexpr (Write) {
+                out[o] = static_cast<wchar_t>(unit);
+            }
+            o++;
+        };
+        while (i < n) {
+            // Widen runs of ASCII 16 bytes at a time
+            for (; i + 16 <= n; i += 16, o += 16) {
+                const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+                if (_mm_movemask_epi8(v)) {
+                    break;
+                }
+                if constexpr (Write) {
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + o), _mm_unpacklo_epi8(v, zero));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + o + 8), _mm_unpackhi_epi8(v, zero));
+                }
+            }
+            if (i == n) {
+                break;
+            }
+            const uint32_t lead = in[i];
+            if (lead < 0x80) {
+                put(lead);
+                i++;
+                continue;
+            }
+            // Range of the first continuation byte, which is narrower after some lead bytes to rule out overlong forms,
+            // surrogates and anything past U+10FFFF
+            uint32_t code_point;
+            size_t length;
+            uint32_t min_next = 0x80;
+            uint32_t max_next = 0xBF;
+            if (lead >= 0xC2 && lead <= 0xDF) {
+                code_point = lead & 0x1F;
+                length = 2;
+            }
+            else if (lead >= 0xE0 && lead <= 0xEF) {
+                code_point = lead & 0x0F;
+                length = 3;
+                min_next = lead == 0xE0 ? 0xA0 : min_next;
+                max_next = lead == 0xED ? 0x9F : max_next;
+            }
+            else if (lead >= 0xF0 && lead <= 0xF4) {
+                code_point = lead & 0x07;
+                length = 4;
+                min_next = lead == 0xF0 ? 0x90 : min_next;
+                max_next = lead == 0xF4 ? 0x8F : max_next;
+            }
+            else {
+                return utf8::invalid;
+            }
+            if (n - i < length) {
+                return utf8::invalid;
+            }
+            for (size_t k = 1; k < length; k++) {
+                const uint32_t next = in[i + k];
+                if (next < min_next || next > max_next) {
+                    return utf8::invalid;
+                }
+                min_next = 0x80;
+                max_next = 0xBF;
+                code_point = (code_point << 6) | (next & 0x3F);
+            }
+            i += length;
+            if (code_point >= 0x10000) {
+                put(0xD800 + ((code_point - 0x10000) >> 10));
+                put(0xDC00 + ((code_point - 0x10000) & 0x3FF));
+            }
+            else {
+                put(code_point);
+            }
+        }
+        return o;
+    }
+}
+
+namespace utf8 {
+    size_t AsciiPrefix(const std::string_view str)
+    {
+        const auto in = str.data();
+        const auto n = str.size();
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            const auto mask = _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)));
+            if (mask) {
+                return i + std::countr_zero(static_cast<uint32_t>(mask));
+            }
+        }
+        while (i < n && !(in[i] & 0x80)) {
+            i++;
+        }
+        return i;
+    }
+
+    size_t AsciiPrefix(const std::wstring_view str)
+    {
+        const auto in = str.data();
+        const auto n = str.size();
+        const auto zero = _mm_setzero_si128();
+        const auto non_ascii = _mm_set1_epi16(static_cast<short>(0xFF80));
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            const auto mask = _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, non_ascii), zero)) ^ 0xFFFF;
+            if (mask) {
+                return i + std::countr_zero(static_cast<uint32_t>(mask)) / 2;
+            }
+        }
+        while (i < n && in[i] < 0x80) {
+            i++;
+        }
+        return i;
+    }
+
+    size_t EncodedLength(const std::wstring_view str)
+    {
+        return EncodeImpl<false>(str, nullptr);
+    }
+
+    size_t Encode(const std::wstring_view str, char* out)
+    {
+        return EncodeImpl<true>(str, out);
+    }
+
+    size_t DecodedLength(const std::string_view str)
+    {
+        return DecodeImpl<false>(str, nullptr);
+    }
+
+    size_t Decode(const std::string_view str, wchar_t* out)
+    {
+        return DecodeImpl<true>(str, out);
+    }
+}
+
 utf8::string Unicode16ToUtf8(const wchar_t* str)
 {
     utf8::string res;
+    const std::wstring_view view = str;
+    if (const auto length = utf8::EncodedLength(view); length != utf8::invalid) {
+        // Counts the terminator, same as WideCharToMultiByte does below
+        res.bytes = static_cast<char*>(malloc(length + 2));
+        res.count = length + 1;
+        res.allocated = true;
+        res.bytes[utf8::Encode(view, res.bytes)] = 0;
+        return res;
+    }
     const auto isize = WideCharToMultiByte(CP_UTF8, 0, str, -1, nullptr, 0, nullptr, nullptr);
     if (isize < 0) {
         return res;
@@ -20,6 +242,14 @@ utf8::string Unicode16ToUtf8(const wchar_t* str)
 utf8::string Unicode16ToUtf8(const wchar_t* start, const wchar_t* end)
 {
     utf8::string res;
+    const std::wstring_view view(start, static_cast<size_t>(end - start));
+    if (const auto length = utf8::EncodedLength(view); length != utf8::invalid) {
+        res.bytes = static_cast<char*>(malloc(length + 1));
+        res.count = length;
+        res.allocated = true;
+        res.bytes[utf8::Encode(view, res.bytes)] = 0;
+        return res;
+    }
     const auto isize = WideCharToMultiByte(CP_UTF8, 0, start, end - start, nullptr, 0,
                                            nullptr, nullptr);
     if (isize < 0) {
@@ -38,12 +268,20 @@ utf8::string Unicode16ToUtf8(const wchar_t* start, const wchar_t* end)
 utf8::string Unicode16ToUtf8(char* buffer, const size_t n_buffer, const wchar_t* start, const wchar_t* end)
 {
     utf8::string res;
-    const auto isize = WideCharToMultiByte(CP_UTF8, 0, start, end - start, buffer,
-                                           static_cast<int>(n_buffer), nullptr, nullptr);
-    if (isize < 0) {
-        return res;
+    const std::wstring_view view(start, static_cast<size_t>(end - start));
+    auto size = utf8::EncodedLength(view);
+    if (size == utf8::invalid) {
+        const auto isize = WideCharToMultiByte(CP_UTF8, 0, start, end - start, buffer,
+                                               static_cast<int>(n_buffer), nullptr, nullptr);
+        if (isize < 0) {
+            return res;
+        }
+        size = static_cast<size_t>(isize);
+    }
+    else if (n_buffer) {
+        // Same as WideCharToMultiByte: fail if it doesn't fit, and only measure when there's no buffer
+        size = size <= n_buffer ? utf8::Encode(view, buffer) : 0;
     }
-    const auto size = static_cast<size_t>(isize);
     res.bytes = buffer;
     res.count = size;
     if (size + 1 < n_buffer) {
@@ -54,6 +292,15 @@ utf8::string Unicode16ToUtf8(char* buffer, const size_t n_buffer, const wchar_t*
 
 size_t Utf8ToUnicode(const char* str, wchar_t* buffer, const size_t count)
 {
+    const std::string_view view = str;
+    if (const auto length = utf8::DecodedLength(view); length != utf8::invalid) {
+        // Counts the terminator, and fails if it doesn't fit, same as MultiByteToWideChar
+        if (length + 1 > count) {
+            return 0;
+        }
+        buffer[utf8::Decode(view, buffer)] = 0;
+        return length + 1;
+    }
     const auto iret = MultiByteToWideChar(CP_UTF8, 0, str, -1, buffer, static_cast<int>(count));
     if (iret < 0) {
         return 0;
@@ -37,6 +37,30 @@ namespace utf8 {
             return *this;
         }
     };
+
+    /*
+    Transcoding between UTF-16 and UTF-8 without going through the OS, for the strings that are converted back and forth on
+    every chat message and frame. Runs of ASCII, which is most of what GW sends, are checked and converted 16 bytes at a time.
+
+    Only well formed input is converted; unpaired surrogates in UTF-16, and overlong forms, encoded surrogates or code points
+    past U+10FFFF in UTF-8, make the Length functions return invalid so that callers can fall back to the OS and its handling
+    of bad input. For well formed input the output is the same as WideCharToMultiByte/MultiByteToWideChar with CP_UTF8.
+    */
+    constexpr size_t invalid = static_cast<size_t>(-1);
+
+    // Number of characters at the start of str that are 7 bit ASCII
+    size_t AsciiPrefix(std::string_view str);
+    size_t AsciiPrefix(std::wstring_view str);
+
+    // Bytes needed to encode str as UTF-8, or invalid
+    size_t EncodedLength(std::wstring_view str);
+    // Writes EncodedLength(str) bytes to out, which must have room for them; returns the number written
+    size_t Encode(std::wstring_view str, char* out);
+
+    // UTF-16 code units needed to decode str, or invalid
+    size_t DecodedLength(std::string_view str);
+    // Writes DecodedLength(str) code units to out, which must have room for them; returns the number written
+    size_t Decode(std::string_view str, wchar_t* out);
 }
 
 // encode a unicode16 to utf8 using a allocated buffer (malloc).
@@ -0,0 +1,257 @@
+#include "stdafx.h"
+
+#include <GWCA/GameContainers/Array.h>
+#include <GWCA/GameEntities/Agent.h>
+#include <GWCA/Managers/AgentMgr.h>
+
+#include <Utils/AgentIndex.h>
+
+namespace {
+    // Roughly spellcast range, so most queries touch a 2x2 or 3x3 block of cells
+    constexpr float CELL_SIZE = 1024.f;
+    constexpr uint32_t BUCKET_COUNT = 1024;
+
+    // Queries come from WndProc as well as the game thread
+    std::mutex mutex;
+    bool stale = true;
+    const GW::AgentArray* indexed_array = nullptr;
+    // Agent ids and their positions at build time, grouped by bucket; bucket b is [bucket_start[b], bucket_start[b + 1])
+    std::vector<uint32_t> agent_ids;
+    std::vector<GW::Vec2f> positions;
+    std::array<uint32_t, BUCKET_COUNT + 1> bucket_start{};
+    std::vector<uint32_t> agent_buckets;
+
+    int32_t CellOf(const float coord)
+    {
+        return static_cast<int32_t>(std::floor(coord / CELL_SIZE));
+    }
+
+    uint32_t BucketOf(const int32_t cell_x, const int32_t cell_y)
+    {
+        return (static_cast<uint32_t>(cell_x) * 73856093u ^ static_cast<uint32_t>(cell_y) * 19349663u) & (BUCKET_COUNT - 1);
+    }
+
+    void Build()
+    {
+        const auto* array = GW::Agents::GetAgentArray();
+        stale = false;
+        indexed_array = array;
+        agent_ids.clear();
+        positions.clear();
+        agent_buckets.clear();
+        bucket_start.fill(0);
+        if (!array) {
+            return;
+        }
+
+        std::array<uint32_t, BUCKET_COUNT> counts{};
+        for (const GW::Agent* agent : *array) {
+            if (!agent) {
+                continue;
+            }
+            const auto bucket = BucketOf(CellOf(agent->pos.x), CellOf(agent->pos.y));
+            agent_buckets.push_back(bucket);
+            counts[bucket]++;
+        }
+        for (uint32_t b = 0; b < BUCKET_COUNT; b++) {
+            bucket_start[b + 1] = bucket_start[b] + counts[b];
+        }
+        agent_ids.resize(agent_buckets.size());
+        positions.resize(agent_buckets.size());
+        auto next = bucket_start;
+        size_t i = 0;
+        for (const GW::Agent* agent : *array) {
+            if (!agent) {
+                continue;
+            }
+            const auto slot = next[agent_buckets[i++]]++;
+            agent_ids[slot] = agent->agent_id;
+            positions[slot] = {agent->pos.x, agent->pos.y};
+        }
+    }
+
+    void EnsureBuilt()
+    {
+        if (stale || indexed_array != GW::Agents::GetAgentArray()) {
+            Build();
+        }
+    }
+
+    // With the lock held; ids of indexed agents whose position at build time is inside the box
+    void CollectInBox(const GW::Vec2f min, const GW::Vec2f max, std::vector<uint32_t>& out)
+    {
+        EnsureBuilt();
+        const auto visit_bucket = [&](const uint32_t bucket) {
+            for (auto i = bucket_start[bucket]; i < bucket_start[bucket + 1]; i++) {
+                const auto& p = positions[i];
+                if (p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y) {
+                    out.push_back(agent_ids[i]);
+                }
+            }
+        };
+
+        const auto x0 = CellOf(min.x), x1 = CellOf(max.x);
+        const auto y0 = CellOf(min.y), y1 = CellOf(max.y);
+        if (static_cast<int64_t>(x1 - x0 + 1) * (y1 - y0 + 1) >= BUCKET_COUNT) {
+            // The box covers more cells than there are buckets; quicker to check everything
+            for (uint32_t b = 0; b < BUCKET_COUNT; b++) {
+                visit_bucket(b);
+            }
+            return;
+        }
+        // Distinct cells can share a bucket; only visit each bucket once
+        std::bitset<BUCKET_COUNT> visited;
+        for (auto cx = x0; cx <= x1; cx++) {
+            for (auto cy = y0; cy <= y1; cy++) {
+                const auto bucket = BucketOf(cx, cy);
+                if (visited.test(bucket)) {
+                    continue;
+                }
+                visited.set(bucket);
+                visit_bucket(bucket);
+            }
+        }
+    }
+
+    // Calls fn(agent, position) for every agent in the box that still exists, at its current position, until fn returns false.
+    // The index can be a frame old by the time a query from WndProc reaches it, so only ids are kept, and each one is looked up
+    // again instead of trusting a pointer to an agent that may have gone since.
+    template <typename Fn>
+    void ForEachInBox(const GW::Vec2f min, const GW::Vec2f max, Fn&& fn)
+    {
+        std::vector<uint32_t> candidates;
+        {
+            std::lock_guard lock(mutex);
+            CollectInBox(min, max, candidates);
+        }
+        // Filters can run arbitrary predicates, so they're called without the lock
+        for (const auto agent_id : candidates) {
+            const auto agent = GW::Agents::GetAgentByID(agent_id);
+            if (!agent) {
+                continue;
+            }
+            if (!fn(*agent, GW::Vec2f{agent->pos.x, agent->pos.y})) {
+                return;
+            }
+        }
+    }
+
+    // Even-odd rule
+    bool IsInPolygon(const GW::Vec2f p, const std::span<const GW::Vec2f> polygon)
+    {
+        bool inside = false;
+        for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+            const auto& a = polygon[i];
+            const auto& b = polygon[j];
+            if ((a.y > p.y) != (b.y > p.y) && p.x < (b.x - a.x) * (p.y - a.y) / (b.y - a.y) + a.x) {
+                inside = !inside;
+            }
+        }
+        return inside;
+    }
+}
+
+bool AgentIndex::Filter::Matches(const GW::Agent& agent) const
+{
+    if (&agent == exclude) {
+        return false;
+    }
+    switch (type) {
+        case Type::Living:
+            if (!agent.GetIsLivingType()) {
+                return false;
+            }
+            break;
+        case Type::Item:
+            if (!agent.GetIsItemType()) {
+                return false;
+            }
+            break;
+        case Type::Gadget:
+            if (!agent.GetIsGadgetType()) {
+                return false;
+            }
+            break;
+        default:
+            break;
+    }
+    const auto living = agent.GetAsAgentLiving();
+    if (allegiance && !(living && living->allegiance == *allegiance)) {
+        return false;
+    }
+    if (alive_only && living && living->GetIsDead()) {
+        return false;
+    }
+    if (model_id && !(living && living->player_number == model_id)) {
+        return false;
+    }
+    if (targettable_only && !GW::Agents::GetIsAgentTargettable(&agent)) {
+        return false;
+    }
+    return !predicate || predicate(agent);
+}
+
+void AgentIndex::Invalidate()
+{
+    std::lock_guard lock(mutex);
+    stale = true;
+}
+
+const GW::Agent* AgentIndex::FindNearest(const GW::Vec2f pos, const float max_distance, const Filter& filter)
+{
+    const GW::Agent* nearest = nullptr;
+    auto best = max_distance * max_distance;
+    ForEachInBox({pos.x - max_distance, pos.y - max_distance}, {pos.x + max_distance, pos.y + max_distance}, [&](const GW::Agent& agent, const GW::Vec2f p) {
+        const auto distance = GW::GetSquareDistance(pos, p);
+        if (distance < best && filter.Matches(agent)) {
+            best = distance;
+            nearest = &agent;
+        }
+        return true;
+    });
+    return nearest;
+}
+
+bool AgentIndex::AnyInRadius(const GW::Vec2f pos, const float radius, const Filter& filter)
+{
+    bool found = false;
+    const auto sqr_radius = radius * radius;
+    ForEachInBox({pos.x - radius, pos.y - radius}, {pos.x + radius, pos.y + radius}, [&](const GW::Agent& agent, const GW::Vec2f p) {
+        found = GW::GetSquareDistance(pos, p) < sqr_radius && filter.Matches(agent);
+        return !found;
+    });
+    return found;
+}
+
+std::vector<const GW::Agent*> AgentIndex::FindInRadius(const GW::Vec2f pos, const float radius, const Filter& filter)
+{
+    std::vector<const GW::Agent*> found;
+    const auto sqr_radius = radius * radius;
+    ForEachInBox({pos.x - radius, pos.y - radius}, {pos.x + radius, pos.y + radius}, [&](const GW::Agent& agent, const GW::Vec2f p) {
+        if (GW::GetSquareDistance(pos, p) < sqr_radius && filter.Matches(agent)) {
+            found.push_back(&agent);
+        }
+        return true;
+    });
+    return found;
+}
+
+std::vector<const GW::Agent*> AgentIndex::FindInPolygon(const std::span<const GW::Vec2f> polygon, const Filter& filter)
+{
+    std::vector<const GW::Agent*> found;
+    if (polygon.size() < 3) {
+        return found;
+    }
+    GW::Vec2f min = polygon[0], max = polygon[0];
+    for (const auto& p : polygon) {
+        min = {std::min(min.x, p.x), std::min(min.y, p.y)};
+        max = {std::max(max.x, p.x), std::max(max.y, p.y)};
+    }
+    ForEachInBox(min, max, [&](const GW::Agent& agent, const GW::Vec2f p) {
+        if (IsInPolygon(p, polygon) && filter.Matches(agent)) {
+            found.push_back(&agent);
+        }
+        return true;
+    });
+    return found;
+}
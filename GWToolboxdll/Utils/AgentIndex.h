@@ -0,0 +1,48 @@
+#pragma once
+
+#include <GWCA/Constants/Constants.h>
+#include <GWCA/GameContainers/GamePos.h>
+
+namespace GW {
+    struct Agent;
+}
+
+/*
+Spatial index over the current agent array, shared by everything that asks "which agents are near here?".
+
+Agents are bucketed into a uniform grid, hashed into a fixed number of buckets, with one counting-sort pass. GWToolbox::Update
+marks the index stale at the start of every frame, and the first query after that rebuilds it, so the O(n) build is paid at most
+once per frame no matter how many modules query. Queries only touch the buckets under their bounding box.
+
+The index holds agent ids and their positions as of the build, not pointers, so a query made between frames (from WndProc, say)
+never touches an agent that's despawned since: every hit is looked up again with GetAgentByID and tested at its current
+position. Safe from the game thread and WndProc; the returned pointers are only good until the agent array changes, like those
+from GetAgentByID.
+*/
+namespace AgentIndex {
+    struct Filter {
+        enum class Type : uint8_t { Any, Living, Item, Gadget };
+        Type type = Type::Any;
+        // Living agents only, when set
+        std::optional<GW::Constants::Allegiance> allegiance;
+        bool alive_only = false;
+        bool targettable_only = false;
+        // Living agents' player_number (npc model id) when non-zero
+        uint16_t model_id = 0;
+        const GW::Agent* exclude = nullptr;
+        // Anything the fields above can't express
+        std::function<bool(const GW::Agent&)> predicate;
+
+        [[nodiscard]] bool Matches(const GW::Agent& agent) const;
+    };
+
+    // Called once per frame before modules update.
+    void Invalidate();
+
+    // Closest matching agent within max_distance of pos, or nullptr.
+    const GW::Agent* FindNearest(GW::Vec2f pos, float max_distance, const Filter& filter = {});
+    bool AnyInRadius(GW::Vec2f pos, float radius, const Filter& filter = {});
+    std::vector<const GW::Agent*> FindInRadius(GW::Vec2f pos, float radius, const Filter& filter = {});
+    // Agents inside a closed polygon (even-odd rule).
+    std::vector<const GW::Agent*> FindInPolygon(std::span<const GW::Vec2f> polygon, const Filter& filter = {});
+}
@@ -0,0 +1,318 @@
+#include "stdafx.h"
+
+#include <intrin.h>
+
+#include <Utils/AllocationTracker.h>
+
+namespace {
+    constexpr uint16_t MAX_TAGS = 512;
+    constexpr uint16_t UNTAGGED = 0;
+
+    // Created on first enable and never destroyed; allocations from here don't go through operator new, so the tracker can't recurse.
+    HANDLE tracker_heap = nullptr;
+
+    template <typename T>
+    struct TrackerAllocator {
+        using value_type = T;
+
+        TrackerAllocator() = default;
+        template <typename U>
+        TrackerAllocator(const TrackerAllocator<U>&) noexcept { }
+
+        T* allocate(const size_t n)
+        {
+            void* p = HeapAlloc(tracker_heap, 0, n * sizeof(T));
+            if (!p) {
+                throw std::bad_alloc();
+            }
+            return static_cast<T*>(p);
+        }
+
+        void deallocate(T* p, size_t) noexcept
+        {
+            HeapFree(tracker_heap, 0, p);
+        }
+
+        template <typename U>
+        bool operator==(const TrackerAllocator<U>&) const noexcept { return true; }
+    };
+
+    template <typename K, typename V>
+    using TrackerMap = std::unordered_map<K, V, std::hash<K>, std::equal_to<K>, TrackerAllocator<std::pair<const K, V>>>;
+
+    struct Allocation {
+        size_t size;
+        void* site;
+        uint16_t tag;
+    };
+
+    struct Counters {
+        size_t live_bytes = 0;
+        size_t live_count = 0;
+        uint64_t total_bytes = 0;
+        uint64_t total_count = 0;
+
+        void Add(const size_t size)
+        {
+            live_bytes += size;
+            live_count++;
+            total_bytes += size;
+            total_count++;
+        }
+
+        void Remove(const size_t size)
+        {
+            live_bytes -= size;
+            live_count--;
+        }
+    };
+
+    std::atomic<bool> tracking = false;
+    // Guards everything below. SRW locks don't allocate, unlike some std::mutex implementations.
+    SRWLOCK tracker_lock = SRWLOCK_INIT;
+    // Index is the tag id; slot 0 is UNTAGGED
+    std::array<const char*, MAX_TAGS> tag_names = {"(untagged)"};
+    std::array<Counters, MAX_TAGS> tag_counters{};
+    uint16_t tag_count = 1;
+    TrackerMap<void*, Allocation>* allocations = nullptr;
+    // (tag << 32) | call site
+    TrackerMap<uint64_t, Counters>* call_sites = nullptr;
+
+    thread_local uint16_t current_tag = UNTAGGED;
+
+    struct LockGuard {
+        LockGuard() { AcquireSRWLockExclusive(&tracker_lock); }
+        ~LockGuard() { ReleaseSRWLockExclusive(&tracker_lock); }
+        LockGuard(const LockGuard&) = delete;
+        LockGuard& operator=(const LockGuard&) = delete;
+    };
+
+    uint64_t CallSiteKey(const uint16_t tag, void* site)
+    {
+        return (static_cast<uint64_t>(tag) << 32) | static_cast<uint64_t>(reinterpret_cast<uintptr_t>(site));
+    }
+
+    // Lock must be held
+    uint16_t FindTag(const char* tag)
+    {
+        for (uint16_t i = 0; i < tag_count; i++) {
+            if (tag_names[i] == tag) {
+                return i;
+            }
+        }
+        if (tag_count == MAX_TAGS) {
+            return UNTAGGED;
+        }
+        tag_names[tag_count] = tag;
+        return tag_count++;
+    }
+
+    void OnAllocate(void* p, const size_t size, void* site)
+    {
+        const LockGuard lock;
+        if (!allocations || !tracking) {
+            return;
+        }
+        const auto tag = current_tag < tag_count ? current_tag : UNTAGGED;
+        try {
+            (*allocations)[p] = {size, site, tag};
+            (*call_sites)[CallSiteKey(tag, site)].Add(size);
+        }
+        catch (const std::bad_alloc&) {
+            return; // Tracker heap exhausted; leave this one uncounted
+        }
+        tag_counters[tag].Add(size);
+    }
+
+    void OnFree(void* p)
+    {
+        const LockGuard lock;
+        if (!allocations) {
+            return;
+        }
+        const auto found = allocations->find(p);
+        if (found == allocations->end()) {
+            return; // Allocated before tracking was enabled
+        }
+        const auto& [size, site, tag] = found->second;
+        tag_counters[tag].Remove(size);
+        (*call_sites)[CallSiteKey(tag, site)].Remove(size);
+        allocations->erase(found);
+    }
+
+    __declspec(noinline) void* TrackedAlloc(const size_t size, void* site)
+    {
+        void* p = malloc(size ? size : 1);
+        if (p && tracking.load(std::memory_order_relaxed)) {
+            OnAllocate(p, size, site);
+        }
+        return p;
+    }
+
+    __declspec(noinline) void* TrackedAlignedAlloc(const size_t size, const size_t alignment, void* site)
+    {
+        void* p = _aligned_malloc(size ? size : 1, alignment);
+        if (p && tracking.load(std::memory_order_relaxed)) {
+            OnAllocate(p, size, site);
+        }
+        return p;
+    }
+
+    bool symbols_initialised = false;
+}
+
+// MSVC's runtime routes the array, nothrow and sized forms through these four, so they're all we need to replace.
+void* operator new(const size_t size)
+{
+    void* p = TrackedAlloc(size, _ReturnAddress());
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    if (p && tracking.load(std::memory_order_relaxed)) {
+        OnFree(p);
+    }
+    free(p);
+}
+
+void* operator new(const size_t size, const std::align_val_t alignment)
+{
+    void* p = TrackedAlignedAlloc(size, static_cast<size_t>(alignment), _ReturnAddress());
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+    if (p && tracking.load(std::memory_order_relaxed)) {
+        OnFree(p);
+    }
+    _aligned_free(p);
+}
+
+void AllocationTracker::SetEnabled(const bool enabled)
+{
+    const LockGuard lock;
+    if (enabled == tracking) {
+        return;
+    }
+    if (enabled) {
+        if (!tracker_heap) {
+            tracker_heap = HeapCreate(0, 0, 0);
+            if (!tracker_heap) {
+                return;
+            }
+        }
+        allocations = new (HeapAlloc(tracker_heap, 0, sizeof(*allocations))) TrackerMap<void*, Allocation>();
+        call_sites = new (HeapAlloc(tracker_heap, 0, sizeof(*call_sites))) TrackerMap<uint64_t, Counters>();
+        tag_counters.fill({});
+    }
+    else {
+        // Names stay registered so that scopes already holding an id remain valid
+        std::destroy_at(allocations);
+        HeapFree(tracker_heap, 0, allocations);
+        allocations = nullptr;
+        std::destroy_at(call_sites);
+        HeapFree(tracker_heap, 0, call_sites);
+        call_sites = nullptr;
+    }
+    tracking = enabled;
+}
+
+bool AllocationTracker::IsEnabled()
+{
+    return tracking;
+}
+
+std::vector<AllocationTracker::ModuleStats> AllocationTracker::GetModuleStats()
+{
+    // Copy out under the lock without touching operator new, then build the result once it's released.
+    std::array<ModuleStats, MAX_TAGS> snapshot;
+    uint16_t count;
+    {
+        const LockGuard lock;
+        count = tag_count;
+        for (uint16_t i = 0; i < count; i++) {
+            const auto& c = tag_counters[i];
+            snapshot[i] = {tag_names[i], c.live_bytes, c.live_count, c.total_bytes, c.total_count};
+        }
+    }
+    return {snapshot.begin(), snapshot.begin() + count};
+}
+
+std::vector<AllocationTracker::CallSite> AllocationTracker::GetCallSites(const char* tag, const size_t max_results)
+{
+    std::vector<CallSite, TrackerAllocator<CallSite>> snapshot;
+    {
+        const LockGuard lock;
+        if (!call_sites) {
+            return {};
+        }
+        const auto tag_id = FindTag(tag);
+        snapshot.reserve(64);
+        for (const auto& [key, c] : *call_sites) {
+            if (key >> 32 == tag_id && c.live_count) {
+                snapshot.push_back({reinterpret_cast<void*>(static_cast<uintptr_t>(key & 0xffffffff)), c.live_bytes, c.live_count, c.total_bytes, c.total_count});
+            }
+        }
+    }
+    const auto count = std::min(max_results, snapshot.size());
+    std::ranges::partial_sort(snapshot, snapshot.begin() + count, std::greater{}, &CallSite::live_bytes);
+    return {snapshot.begin(), snapshot.begin() + count};
+}
+
+std::string AllocationTracker::DescribeAddress(void* address)
+{
+    const auto process = GetCurrentProcess();
+    if (!symbols_initialised) {
+        SymSetOptions(SymGetOptions() | SYMOPT_UNDNAME | SYMOPT_LOAD_LINES | SYMOPT_DEFERRED_LOADS);
+        symbols_initialised = SymInitialize(process, nullptr, TRUE) != FALSE;
+    }
+    const auto addr = static_cast<DWORD64>(reinterpret_cast<uintptr_t>(address));
+    if (symbols_initialised) {
+        alignas(SYMBOL_INFO) char buffer[sizeof(SYMBOL_INFO) + MAX_SYM_NAME];
+        const auto symbol = reinterpret_cast<SYMBOL_INFO*>(buffer);
+        symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+        symbol->MaxNameLen = MAX_SYM_NAME;
+        DWORD64 displacement = 0;
+        if (SymFromAddr(process, addr, &displacement, symbol)) {
+            IMAGEHLP_LINE64 line{};
+            line.SizeOfStruct = sizeof(line);
+            DWORD line_displacement = 0;
+            if (SymGetLineFromAddr64(process, addr, &line_displacement, &line)) {
+                return std::format("{} ({}:{})", symbol->Name, std::filesystem::path(line.FileName).filename().string(), line.LineNumber);
+            }
+            return symbol->Name;
+        }
+    }
+    HMODULE module = nullptr;
+    if (GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, static_cast<LPCWSTR>(address), &module)) {
+        wchar_t module_path[MAX_PATH];
+        GetModuleFileNameW(module, module_path, _countof(module_path));
+        return std::format("{}+0x{:x}", std::filesystem::path(module_path).filename().string(), reinterpret_cast<uintptr_t>(address) - reinterpret_cast<uintptr_t>(module));
+    }
+    return std::format("0x{:x}", reinterpret_cast<uintptr_t>(address));
+}
+
+AllocationTracker::TagId AllocationTracker::RegisterTag(const char* tag)
+{
+    const LockGuard lock;
+    return FindTag(tag);
+}
+
+AllocationTracker::Scope::Scope(const TagId tag)
+    : previous(current_tag)
+{
+    current_tag = tag;
+}
+
+AllocationTracker::Scope::~Scope()
+{
+    current_tag = previous;
+}
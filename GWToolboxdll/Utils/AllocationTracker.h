@@ -0,0 +1,60 @@
+#pragma once
+
+/*
+Opt-in accounting of toolbox's heap allocations, attributed to whichever module is running.
+
+GWToolbox.cpp tags each module's Update/Draw/WndProc dispatch with an AllocationTracker::Scope; anything allocated through
+operator new while tracking is enabled is charged to the innermost scope on that thread (or "(untagged)"). Each module's tag is
+registered once, when it's enabled, so entering a scope only swaps a thread local id.
+The bookkeeping lives on its own Win32 heap so it never shows up in its own numbers, and costs one branch per new/delete while disabled.
+
+Direct malloc calls and allocations made by other dlls (gwca, plugins) aren't seen.
+*/
+namespace AllocationTracker {
+    // 0 is "(untagged)"
+    using TagId = uint16_t;
+
+    struct ModuleStats {
+        const char* tag;
+        size_t live_bytes;
+        size_t live_count;
+        // Running totals since tracking was enabled; diff two snapshots for a rate.
+        uint64_t total_bytes;
+        uint64_t total_count;
+    };
+
+    struct CallSite {
+        void* address;
+        size_t live_bytes;
+        size_t live_count;
+        uint64_t total_bytes;
+        uint64_t total_count;
+    };
+
+    // Enabling starts from zero; only allocations made from then on are counted. Disabling drops everything recorded.
+    void SetEnabled(bool enabled);
+    [[nodiscard]] bool IsEnabled();
+
+    std::vector<ModuleStats> GetModuleStats();
+    // Heaviest call sites for a tag, by live bytes.
+    std::vector<CallSite> GetCallSites(const char* tag, size_t max_results = 20);
+    // "function (file:line)" if symbols are available, otherwise "module.dll+0x1234". Call from one thread only.
+    std::string DescribeAddress(void* address);
+
+    // Id for tag, registering it on first use; returns the same id for the same pointer every time. Takes the tracker's lock, so
+    // resolve an id once and keep it. tag must outlive the tracker; module names are fine. Once every id is taken, returns 0.
+    TagId RegisterTag(const char* tag);
+
+    // Charge allocations on this thread to tag until the scope ends
+    class Scope {
+    public:
+        explicit Scope(TagId tag);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        TagId previous;
+    };
+}
@@ -0,0 +1,195 @@
+#include "stdafx.h"
+
+#include <GWCA/Constants/Constants.h>
+#include <GWCA/Managers/MapMgr.h>
+
+#include <Utils/AltitudeCache.h>
+
+namespace {
+    // QueryAltitude is asked for a 5 unit tolerance everywhere in toolbox; a 2 unit grid is well inside that.
+    constexpr float GRID_SIZE = 2.f;
+    constexpr uint32_t TABLE_SIZE = 1 << 15;
+    constexpr uint32_t MAX_ENTRIES = TABLE_SIZE / 4 * 3;
+    constexpr uint32_t MAX_PROBES = 16;
+    constexpr auto FRAME_BUDGET = std::chrono::microseconds(3000);
+    // How many queries to run between clock reads
+    constexpr size_t BUDGET_CHECK_INTERVAL = 32;
+
+    // Written by the game thread only. A slot's key is published after its value, and is parked on REPLACING_KEY while the value
+    // under it changes, so a reader that sees the same key before and after reading the value has a matching value.
+    struct Slot {
+        std::atomic<uint64_t> key = 0;
+        std::atomic<float> value = 0.f;
+    };
+
+    // Epoch 0 is never current, so this matches nothing; being non-zero, it doesn't end a probe run either
+    constexpr uint64_t REPLACING_KEY = 1;
+
+    Slot table[TABLE_SIZE];
+    uint32_t entry_count = 0;
+    // Entries thrown out to make room, so Prefetch can tell whether what it inserted is still there
+    uint32_t evicted_count = 0;
+    uint32_t next_victim = 0;
+    // Part of every key so that entries from the previous map can never match; never 0, which marks an empty slot
+    std::atomic<uint8_t> epoch = 1;
+    GW::Constants::MapID cached_map_id{};
+    std::chrono::steady_clock::time_point frame_deadline{};
+
+    uint64_t MakeKey(const GW::GamePos& pos, const uint8_t key_epoch)
+    {
+        const auto qx = static_cast<uint32_t>(static_cast<int32_t>(std::floor(pos.x / GRID_SIZE))) & 0xFFFFFF;
+        const auto qy = static_cast<uint32_t>(static_cast<int32_t>(std::floor(pos.y / GRID_SIZE))) & 0xFFFFFF;
+        return static_cast<uint64_t>(key_epoch) << 56 | static_cast<uint64_t>(pos.zplane & 0xFF) << 48 | static_cast<uint64_t>(qx) << 24 | qy;
+    }
+
+    uint32_t HashKey(uint64_t key)
+    {
+        // splitmix64 finaliser
+        key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ull;
+        key = (key ^ (key >> 27)) * 0x94d049bb133111ebull;
+        return static_cast<uint32_t>(key ^ (key >> 31)) & (TABLE_SIZE - 1);
+    }
+
+    bool Find(const uint64_t key, float& altitude)
+    {
+        for (uint32_t probe = 0, i = HashKey(key); probe < MAX_PROBES; probe++, i = (i + 1) & (TABLE_SIZE - 1)) {
+            const auto& slot = table[i];
+            const auto found = slot.key.load(std::memory_order_acquire);
+            if (found == 0) {
+                return false;
+            }
+            if (found != key) {
+                continue;
+            }
+            altitude = slot.value.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return slot.key.load(std::memory_order_relaxed) == key;
+        }
+        return false;
+    }
+
+    // Empties the table under a new epoch, so that a reader racing the clear can't match a stale slot
+    void Reset()
+    {
+        auto next_epoch = static_cast<uint8_t>(epoch.load(std::memory_order_relaxed) + 1);
+        if (next_epoch == 0) {
+            next_epoch = 1;
+        }
+        epoch.store(next_epoch, std::memory_order_relaxed);
+        for (auto& slot : table) {
+            slot.key.store(0, std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        evicted_count += entry_count;
+        entry_count = 0;
+    }
+
+    // Always caches the altitude. When the probe run is full one of its entries makes way, and once the whole table is full it
+    // starts again empty; either beats turning every later miss into a query, and big maps (Pathing walks every trapezoid
+    // corner) can get there on their own.
+    void Insert(const GW::GamePos& pos, const float altitude)
+    {
+        if (entry_count >= MAX_ENTRIES) {
+            Reset();
+        }
+        const auto key = MakeKey(pos, epoch.load(std::memory_order_relaxed));
+        const auto home = HashKey(key);
+        for (uint32_t probe = 0, i = home; probe < MAX_PROBES; probe++, i = (i + 1) & (TABLE_SIZE - 1)) {
+            auto& slot = table[i];
+            const auto found = slot.key.load(std::memory_order_relaxed);
+            if (found == key) {
+                return;
+            }
+            if (found == 0) {
+                slot.value.store(altitude, std::memory_order_relaxed);
+                slot.key.store(key, std::memory_order_release);
+                entry_count++;
+                return;
+            }
+        }
+        // Taken in turn, so one hot run doesn't keep evicting the same entry
+        auto& victim = table[(home + next_victim++ % MAX_PROBES) & (TABLE_SIZE - 1)];
+        victim.key.store(REPLACING_KEY, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        victim.value.store(altitude, std::memory_order_relaxed);
+        victim.key.store(key, std::memory_order_release);
+        evicted_count++;
+    }
+
+    // Game thread only. Returns false while there's no map to cache against.
+    bool CheckMap()
+    {
+        if (GW::Map::GetInstanceType() == GW::Constants::InstanceType::Loading) {
+            return false;
+        }
+        const auto map_id = GW::Map::GetMapID();
+        if (map_id == cached_map_id) {
+            return true;
+        }
+        cached_map_id = map_id;
+        Reset();
+        return true;
+    }
+
+    float Query(const GW::GamePos& pos)
+    {
+        float altitude = 0.f;
+        GW::Map::QueryAltitude(pos, 5.f, altitude);
+        return altitude;
+    }
+}
+
+void AltitudeCache::BeginFrame()
+{
+    frame_deadline = std::chrono::steady_clock::now() + FRAME_BUDGET;
+}
+
+float AltitudeCache::Get(const GW::GamePos& pos)
+{
+    if (!CheckMap()) {
+        return Query(pos);
+    }
+    const auto key = MakeKey(pos, epoch.load(std::memory_order_relaxed));
+    float altitude;
+    if (!Find(key, altitude)) {
+        altitude = Query(pos);
+        Insert(pos, altitude);
+    }
+    return altitude;
+}
+
+bool AltitudeCache::TryGet(const GW::GamePos& pos, float& altitude)
+{
+    return Find(MakeKey(pos, epoch.load(std::memory_order_acquire)), altitude);
+}
+
+size_t AltitudeCache::Prefetch(const std::span<const GW::GamePos> points)
+{
+    if (!CheckMap()) {
+        return points.size();
+    }
+    const auto evicted_before = evicted_count;
+    size_t queried = 0;
+    size_t unresolved = 0;
+    float altitude;
+    for (const auto& pos : points) {
+        if (Find(MakeKey(pos, epoch.load(std::memory_order_relaxed)), altitude)) {
+            continue;
+        }
+        if (unresolved || (queried % BUDGET_CHECK_INTERVAL == 0 && std::chrono::steady_clock::now() > frame_deadline)) {
+            unresolved++;
+            continue;
+        }
+        Insert(pos, Query(pos));
+        queried++;
+    }
+    if (evicted_count == evicted_before) {
+        return unresolved;
+    }
+    // Making room may have thrown out some of the earlier points; they go on the next call's bill
+    const auto current_epoch = epoch.load(std::memory_order_relaxed);
+    return static_cast<size_t>(std::ranges::count_if(points, [current_epoch](const GW::GamePos& pos) {
+        float cached;
+        return !Find(MakeKey(pos, current_epoch), cached);
+    }));
+}
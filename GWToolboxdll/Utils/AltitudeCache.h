@@ -0,0 +1,24 @@
+#pragma once
+
+#include <GWCA/GameContainers/GamePos.h>
+
+/*
+Terrain altitude lookups for the current map, cached by (x, y, z plane) on a 2 unit grid.
+
+GW::Map::QueryAltitude walks the pathing map every call, and callers like GameWorldRenderer and Pathing ask for the same
+points over and over (every marker resync, every shared trapezoid corner). Misses are resolved on the game thread, either one
+at a time through Get or in batches through Prefetch, which stops once this frame's budget is spent.
+Reads through TryGet never block and are safe from any thread; the cache empties itself when the map changes, and starts
+again when it fills up.
+*/
+namespace AltitudeCache {
+    // Start a new frame's query budget; call once per frame from the render thread.
+    void BeginFrame();
+
+    // Game thread only: cached altitude, querying the game on a miss.
+    float Get(const GW::GamePos& pos);
+    // Any thread: false if pos isn't cached yet.
+    bool TryGet(const GW::GamePos& pos, float& altitude);
+    // Game thread only: resolve as many of points as this frame's budget allows. Returns how many are still unresolved.
+    size_t Prefetch(std::span<const GW::GamePos> points);
+}
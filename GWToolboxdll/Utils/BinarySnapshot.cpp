@@ -0,0 +1,141 @@
+#include "stdafx.h"
+
+#include <Utils/BinarySnapshot.h>
+
+namespace {
+    struct SnapshotHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t payload_size;
+        uint32_t crc;
+    };
+
+    constexpr auto crc_table = [] {
+        std::array<uint32_t, 256> table{};
+        for (uint32_t i = 0; i < table.size(); i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            table[i] = c;
+        }
+        return table;
+    }();
+}
+
+void BinarySnapshot::Writer::WriteBytes(const void* bytes, const size_t size)
+{
+    const auto begin = static_cast<const uint8_t*>(bytes);
+    data.insert(data.end(), begin, begin + size);
+}
+
+void BinarySnapshot::Writer::WriteString(const std::string_view str)
+{
+    WriteArray(std::span(str.data(), str.size()));
+}
+
+void BinarySnapshot::Writer::WriteString(const std::wstring_view str)
+{
+    WriteArray(std::span(str.data(), str.size()));
+}
+
+bool BinarySnapshot::Reader::ReadBytes(void* bytes, const size_t size)
+{
+    if (!ok || size > Remaining()) {
+        ok = false;
+        return false;
+    }
+    if (size) {
+        memcpy(bytes, data.data() + offset, size);
+    }
+    offset += size;
+    return true;
+}
+
+bool BinarySnapshot::Reader::ReadString(std::string& str)
+{
+    uint32_t len = 0;
+    if (!Read(len) || len > Remaining()) {
+        ok = false;
+        return false;
+    }
+    str.assign(reinterpret_cast<const char*>(data.data() + offset), len);
+    offset += len;
+    return true;
+}
+
+bool BinarySnapshot::Reader::ReadString(std::wstring& str)
+{
+    uint32_t len = 0;
+    if (!Read(len) || len > Remaining() / sizeof(wchar_t)) {
+        ok = false;
+        return false;
+    }
+    str.resize(len);
+    return ReadBytes(str.data(), len * sizeof(wchar_t));
+}
+
+uint32_t BinarySnapshot::Crc32(const std::span<const uint8_t> data)
+{
+    uint32_t crc = 0xFFFFFFFFu;
+    for (const auto byte : data) {
+        crc = crc_table[(crc ^ byte) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+bool BinarySnapshot::Load(const std::filesystem::path& path, const uint32_t magic, const uint32_t version, std::vector<uint8_t>& payload)
+{
+    payload.clear();
+    std::error_code ec;
+    const auto file_size = std::filesystem::file_size(path, ec);
+    if (ec || file_size < sizeof(SnapshotHeader)) {
+        return false;
+    }
+    std::vector<uint8_t> contents(static_cast<size_t>(file_size));
+    FILE* fp = _wfopen(path.c_str(), L"rb");
+    if (!fp) {
+        return false;
+    }
+    const bool read = fread(contents.data(), contents.size(), 1, fp) == 1;
+    fclose(fp);
+    if (!read) {
+        return false;
+    }
+    SnapshotHeader header;
+    memcpy(&header, contents.data(), sizeof(header));
+    if (header.magic != magic || header.version != version || header.payload_size != contents.size() - sizeof(header)) {
+        return false;
+    }
+    const auto body = std::span(contents).subspan(sizeof(header));
+    if (Crc32(body) != header.crc) {
+        Log::Log("[BinarySnapshot] %ls failed its checksum\n", path.c_str());
+        return false;
+    }
+    contents.erase(contents.begin(), contents.begin() + sizeof(header));
+    payload = std::move(contents);
+    return true;
+}
+
+bool BinarySnapshot::Save(const std::filesystem::path& path, const uint32_t magic, const uint32_t version, const std::span<const uint8_t> payload)
+{
+    auto tmp_file = path;
+    tmp_file += ".tmp";
+    FILE* fp = _wfopen(tmp_file.c_str(), L"wb");
+    if (!fp) {
+        return false;
+    }
+    const SnapshotHeader header = {magic, version, static_cast<uint32_t>(payload.size()), Crc32(payload)};
+    bool written = fwrite(&header, sizeof(header), 1, fp) == 1
+                   && (payload.empty() || fwrite(payload.data(), payload.size(), 1, fp) == 1);
+    written = fclose(fp) == 0 && written;
+    std::error_code ec;
+    if (written) {
+        std::filesystem::rename(tmp_file, path, ec);
+        written = !ec;
+    }
+    if (!written) {
+        std::filesystem::remove(tmp_file, ec);
+    }
+    return written;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+/*
+Versioned, checksummed binary files for settings stores that outgrow an ini (friends, character completion).
+
+A snapshot is a small header (magic, format version, payload size and a CRC-32 of the payload) followed by the payload,
+which Writer builds and Reader walks back in the same order. Loading is one read and a checksum; nothing is tokenised or
+parsed as text. Saves go to a temp file that's renamed over the old one, so a crash mid-save leaves the last snapshot intact.
+*/
+namespace BinarySnapshot {
+    class Writer {
+    public:
+        template <typename T>
+        void Write(const T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            WriteBytes(&value, sizeof(value));
+        }
+
+        // Length prefixed
+        void WriteString(std::string_view str);
+        void WriteString(std::wstring_view str);
+
+        // Length prefixed
+        template <typename T>
+        void WriteArray(const std::span<const T> values)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            Write(static_cast<uint32_t>(values.size()));
+            WriteBytes(values.data(), values.size_bytes());
+        }
+
+        [[nodiscard]] const std::vector<uint8_t>& Data() const { return data; }
+
+    private:
+        void WriteBytes(const void* bytes, size_t size);
+        std::vector<uint8_t> data;
+    };
+
+    // Every read fails once one has run past the end of the data, so callers can check Ok() once at the end.
+    class Reader {
+    public:
+        explicit Reader(const std::span<const uint8_t> _data)
+            : data(_data) {}
+
+        template <typename T>
+        bool Read(T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            return ReadBytes(&value, sizeof(value));
+        }
+
+        bool ReadString(std::string& str);
+        bool ReadString(std::wstring& str);
+
+        template <typename T>
+        bool ReadArray(std::vector<T>& values)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            uint32_t count = 0;
+            if (!Read(count) || count > Remaining() / sizeof(T)) {
+                ok = false;
+                return false;
+            }
+            values.resize(count);
+            return ReadBytes(values.data(), count * sizeof(T));
+        }
+
+        [[nodiscard]] bool Ok() const { return ok; }
+        [[nodiscard]] size_t Remaining() const { return data.size() - offset; }
+
+    private:
+        bool ReadBytes(void* bytes, size_t size);
+        std::span<const uint8_t> data;
+        size_t offset = 0;
+        bool ok = true;
+    };
+
+    uint32_t Crc32(std::span<const uint8_t> data);
+
+    // False if the file is missing, truncated, of another format or version, or fails its checksum.
+    bool Load(const std::filesystem::path& path, uint32_t magic, uint32_t version, std::vector<uint8_t>& payload);
+    bool Save(const std::filesystem::path& path, uint32_t magic, uint32_t version, std::span<const uint8_t> payload);
+}
@@ -0,0 +1,365 @@
+#include "stdafx.h"
+
+#include <GWCA/Managers/MemoryMgr.h>
+#include <GWCA/Managers/UIMgr.h>
+
+#include <Modules/Resources.h>
+#include <Utils/DecodeCache.h>
+
+namespace {
+    using GW::Constants::Language;
+    using DecodeCache::Result;
+
+    constexpr uint32_t CACHE_FILE_MAGIC = 0x44425447; // "GTBD"
+    constexpr uint32_t CACHE_FILE_VERSION = 1;
+    // Saves in a row a string can go without being requested before it's left out of the file
+    constexpr uint8_t MAX_UNUSED_SAVES = 8;
+    // Strings taken off the queue per lock, so the lock isn't held while the game decodes
+    constexpr size_t BATCH_SIZE = 16;
+    // Strings kept per language; past this, the least recently requested ones that nothing holds are dropped
+    constexpr size_t MAX_ENTRIES = 32768;
+    // Dropped in batches, so the scan isn't paid for every new string
+    constexpr size_t EVICT_BATCH = MAX_ENTRIES / 8;
+
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+        // Decoded text changes with game updates, so a file from another build is thrown away
+        uint32_t gw_version;
+        uint32_t count;
+    };
+
+    // Followed by encoded_length wchar_ts, then decoded_length wchar_ts
+    struct FileEntry {
+        uint32_t encoded_length;
+        uint32_t decoded_length;
+        uint32_t unused_saves;
+    };
+
+    struct Entry {
+        std::shared_ptr<Result> result;
+        // request_clock when it was last asked for; 0 if only loaded from disk
+        uint64_t last_requested = 0;
+        uint8_t unused_saves = 0;
+        // Asked for this session, as opposed to only loaded from disk
+        bool requested = false;
+        bool queued = false;
+    };
+
+    struct LanguageCache {
+        // Keys point into the results
+        std::unordered_map<std::wstring_view, Entry> entries;
+        bool load_started = false;
+        bool loaded = false;
+        // Decoded something since the last save
+        bool dirty = false;
+        uint64_t request_clock = 0;
+        // Entry count that triggers the next eviction pass
+        size_t evict_at = MAX_ENTRIES + EVICT_BATCH;
+    };
+
+    std::mutex mutex;
+    std::unordered_map<Language, LanguageCache> caches;
+    // Entries are map nodes, which stay put until evicted, trimmed or cleared; eviction and Trim leave queued ones alone and Clear empties the queue
+    std::deque<Entry*> queue;
+
+    std::filesystem::path GetCachePath(const Language language)
+    {
+        return Resources::GetPath(L"decoded_strings", std::format(L"{}.cache", std::to_underlying(language)));
+    }
+
+    // With the lock held; drops the least recently requested entries nothing holds until the cache is back down to MAX_ENTRIES
+    void Evict(LanguageCache& cache)
+    {
+        if (cache.entries.size() < cache.evict_at) {
+            return;
+        }
+        const auto evictable = [](const Entry& entry) {
+            return !entry.queued && entry.result.use_count() == 1;
+        };
+        std::vector<uint64_t> ages;
+        for (const auto& entry : cache.entries | std::views::values) {
+            if (evictable(entry)) {
+                ages.push_back(entry.last_requested);
+            }
+        }
+        size_t excess = std::min(cache.entries.size() - MAX_ENTRIES, ages.size());
+        if (excess) {
+            std::ranges::nth_element(ages, ages.begin() + (excess - 1));
+            const auto cutoff = ages[excess - 1];
+            std::erase_if(cache.entries, [&](const auto& it) {
+                if (!excess || it.second.last_requested > cutoff || !evictable(it.second)) {
+                    return false;
+                }
+                excess--;
+                return true;
+            });
+        }
+        // If too much is still held to get back under the cap, wait for another batch of new strings before scanning again
+        cache.evict_at = std::max(cache.entries.size(), MAX_ENTRIES) + EVICT_BATCH;
+    }
+
+    // With the lock held; whichever of the game and the file comes back first wins
+    void SetDecoded(Result& result, const std::wstring_view decoded)
+    {
+        if (result.IsReady()) {
+            return;
+        }
+        result.decoded = decoded;
+        result.ready.store(true, std::memory_order_release);
+    }
+
+    // ReSharper disable once CppParameterMayBeConst
+    void OnDecoded(void* param, const wchar_t* decoded)
+    {
+        const auto result = static_cast<std::shared_ptr<Result>*>(param);
+        {
+            std::lock_guard lock(mutex);
+            SetDecoded(**result, decoded ? decoded : L"");
+            if (const auto cache = caches.find((*result)->language); cache != caches.end()) {
+                cache->second.dirty = true;
+            }
+        }
+        delete result;
+    }
+
+    bool ReadCacheFile(const std::filesystem::path& path, std::vector<uint8_t>& bytes)
+    {
+        std::error_code ec;
+        const auto size = std::filesystem::file_size(path, ec);
+        if (ec || size < sizeof(FileHeader)) {
+            return false;
+        }
+        FILE* fp = _wfopen(path.c_str(), L"rb");
+        if (!fp) {
+            return false;
+        }
+        bytes.resize(static_cast<size_t>(size));
+        const bool ok = fread(bytes.data(), bytes.size(), 1, fp) == 1;
+        fclose(fp);
+        return ok;
+    }
+
+    // Worker thread
+    void Load(const Language language)
+    {
+        struct Loaded {
+            std::wstring encoded;
+            std::wstring decoded;
+            uint8_t unused_saves;
+        };
+        std::vector<Loaded> loaded;
+        std::vector<uint8_t> bytes;
+        if (ReadCacheFile(GetCachePath(language), bytes)) {
+            FileHeader header;
+            memcpy(&header, bytes.data(), sizeof(header));
+            // Every entry takes at least its FileEntry and one encoded wchar_t, which caps how many a file this size can hold
+            const auto max_count = (bytes.size() - sizeof(header)) / (sizeof(FileEntry) + sizeof(wchar_t));
+            const bool same_build = header.magic == CACHE_FILE_MAGIC && header.version == CACHE_FILE_VERSION && header.gw_version == GW::MemoryMgr::GetGWVersion();
+            if (same_build && header.count > max_count) {
+                Log::Log("Decoded strings file for language %d claims %u entries but only has room for %zu; ignoring it\n",
+                         std::to_underlying(language), header.count, max_count);
+            }
+            else if (same_build) {
+                loaded.reserve(header.count);
+                size_t offset = sizeof(header);
+                const auto read_string = [&](std::wstring& out, const size_t length) {
+                    out.resize(length);
+                    memcpy(out.data(), bytes.data() + offset, length * sizeof(wchar_t));
+                    offset += length * sizeof(wchar_t);
+                };
+                for (uint32_t i = 0; i < header.count && bytes.size() - offset >= sizeof(FileEntry); i++) {
+                    FileEntry entry;
+                    memcpy(&entry, bytes.data() + offset, sizeof(entry));
+                    offset += sizeof(entry);
+                    const auto length = (static_cast<uint64_t>(entry.encoded_length) + entry.decoded_length) * sizeof(wchar_t);
+                    if (!entry.encoded_length || length > bytes.size() - offset) {
+                        break;
+                    }
+                    auto& out = loaded.emplace_back();
+                    read_string(out.encoded, entry.encoded_length);
+                    read_string(out.decoded, entry.decoded_length);
+                    out.unused_saves = static_cast<uint8_t>(std::min<uint32_t>(entry.unused_saves, MAX_UNUSED_SAVES));
+                }
+            }
+        }
+
+        std::lock_guard lock(mutex);
+        auto& cache = caches[language];
+        for (const auto& it : loaded) {
+            auto found = cache.entries.find(it.encoded);
+            if (found == cache.entries.end()) {
+                auto result = std::make_shared<Result>(it.encoded, language);
+                found = cache.entries.emplace(result->encoded, Entry{result}).first;
+            }
+            found->second.unused_saves = it.unused_saves;
+            SetDecoded(*found->second.result, it.decoded);
+        }
+        cache.loaded = true;
+        Evict(cache);
+    }
+
+    bool WriteCacheFile(const std::filesystem::path& path, const std::span<const std::pair<std::shared_ptr<const Result>, uint8_t>> results)
+    {
+        Resources::EnsureFolderExists(path.parent_path());
+        auto tmp_path = path;
+        tmp_path += L".tmp";
+        FILE* fp = _wfopen(tmp_path.c_str(), L"wb");
+        if (!fp) {
+            return false;
+        }
+        const FileHeader header = {CACHE_FILE_MAGIC, CACHE_FILE_VERSION, GW::MemoryMgr::GetGWVersion(), static_cast<uint32_t>(results.size())};
+        bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+        for (const auto& [result, unused_saves] : results) {
+            if (!ok) {
+                break;
+            }
+            const FileEntry entry = {static_cast<uint32_t>(result->encoded.size()), static_cast<uint32_t>(result->decoded.size()), unused_saves};
+            ok = fwrite(&entry, sizeof(entry), 1, fp) == 1
+                 && fwrite(result->encoded.data(), sizeof(wchar_t), result->encoded.size(), fp) == result->encoded.size()
+                 && (result->decoded.empty() || fwrite(result->decoded.data(), sizeof(wchar_t), result->decoded.size(), fp) == result->decoded.size());
+        }
+        ok = fclose(fp) == 0 && ok;
+        std::error_code ec;
+        if (ok) {
+            std::filesystem::rename(tmp_path, path, ec);
+            ok = !ec;
+        }
+        if (!ok) {
+            std::filesystem::remove(tmp_path, ec);
+        }
+        return ok;
+    }
+}
+
+namespace DecodeCache {
+    Ref Request(const std::wstring_view encoded, Language language)
+    {
+        if (language == Language::Unknown) {
+            language = GW::UI::GetTextLanguage();
+        }
+        bool start_load = false;
+        Ref out;
+        {
+            std::lock_guard lock(mutex);
+            auto& cache = caches[language];
+            start_load = !cache.load_started;
+            cache.load_started = true;
+            auto found = cache.entries.find(encoded);
+            if (found == cache.entries.end()) {
+                auto result = std::make_shared<Result>(encoded, language);
+                found = cache.entries.emplace(result->encoded, Entry{result}).first;
+            }
+            auto& entry = found->second;
+            entry.requested = true;
+            entry.last_requested = ++cache.request_clock;
+            if (!entry.result->IsReady() && !entry.queued) {
+                entry.queued = true;
+                queue.push_back(&entry);
+            }
+            out = entry.result;
+            Evict(cache);
+        }
+        if (start_load) {
+            Resources::EnqueueWorkerTask([language] {
+                Load(language);
+            });
+        }
+        return out;
+    }
+
+    void Update(const size_t max_count, const double budget_ms)
+    {
+        const auto started = std::chrono::steady_clock::now();
+        std::vector<std::shared_ptr<Result>> batch;
+        size_t sent = 0;
+        while (sent < max_count) {
+            {
+                std::lock_guard lock(mutex);
+                while (batch.size() < std::min(BATCH_SIZE, max_count - sent) && !queue.empty()) {
+                    const auto entry = queue.front();
+                    queue.pop_front();
+                    entry->queued = false;
+                    // Already loaded from disk, or everyone who asked for it has let go
+                    if (entry->result->IsReady() || entry->result.use_count() == 1) {
+                        continue;
+                    }
+                    batch.push_back(entry->result);
+                }
+            }
+            if (batch.empty()) {
+                break;
+            }
+            for (const auto& result : batch) {
+                // The callback owns a reference until the game answers, so Trim and Clear can't pull the result out from under it
+                GW::UI::AsyncDecodeStr(result->encoded.c_str(), OnDecoded, new std::shared_ptr(result), result->language);
+            }
+            sent += batch.size();
+            batch.clear();
+            if (std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count() >= budget_ms) {
+                break;
+            }
+        }
+    }
+
+    void Save()
+    {
+        using Snapshot = std::vector<std::pair<std::shared_ptr<const Result>, uint8_t>>;
+        std::vector<std::pair<Language, Snapshot>> snapshots;
+        {
+            std::lock_guard lock(mutex);
+            for (auto& [language, cache] : caches) {
+                // Writing before the load finishes would lose whatever was in the file
+                if (!(cache.loaded && cache.dirty)) {
+                    continue;
+                }
+                cache.dirty = false;
+                auto& snapshot = snapshots.emplace_back(language, Snapshot{}).second;
+                snapshot.reserve(cache.entries.size());
+                for (const auto& entry : cache.entries | std::views::values) {
+                    const auto unused_saves = static_cast<uint8_t>(entry.requested ? 0 : entry.unused_saves + 1);
+                    if (entry.result->IsReady() && unused_saves <= MAX_UNUSED_SAVES) {
+                        snapshot.emplace_back(entry.result, unused_saves);
+                    }
+                }
+            }
+        }
+        // Results are immutable once ready, so they can be written out without the lock
+        for (const auto& [language, snapshot] : snapshots) {
+            if (!WriteCacheFile(GetCachePath(language), snapshot)) {
+                Log::Log("Failed to save decoded strings for language %d\n", std::to_underlying(language));
+            }
+        }
+    }
+
+    size_t Trim()
+    {
+        const auto current_language = GW::UI::GetTextLanguage();
+        size_t trimmed = 0;
+        std::lock_guard lock(mutex);
+        for (auto& [language, cache] : caches) {
+            if (language == current_language || !cache.loaded) {
+                continue;
+            }
+            trimmed += std::erase_if(cache.entries, [](const auto& it) {
+                return !it.second.queued && it.second.result.use_count() == 1;
+            });
+            // Load again when it's next asked for, so the next save doesn't lose what was trimmed
+            cache.load_started = cache.loaded = cache.dirty = false;
+        }
+        return trimmed;
+    }
+
+    void Clear()
+    {
+        std::lock_guard lock(mutex);
+        queue.clear();
+        caches.clear();
+    }
+
+    size_t QueuedCount()
+    {
+        std::lock_guard lock(mutex);
+        return queue.size();
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+
+#include <GWCA/Constants/Constants.h>
+
+/*
+One decode per encoded string per language, shared by every EncString that asks for it.
+
+Request hands back the cached result for an encoded string, or a new one that's queued for decoding; it never calls into the
+game itself, so it's safe from any thread and costs a hash lookup however many windows ask at once. Update, on the game thread,
+sends the queue to the game's decoder a batch at a time, and stops for the frame once the batch or the time budget runs out,
+so opening a window that wants thousands of strings spreads the work over a few frames instead of stalling one.
+
+Results are shared_ptrs: the cache holds one, and anything still holding another keeps the result alive through Trim. Decoded
+strings are saved per language and loaded back in the background the first time a language is asked for, so the next session
+starts with them already decoded. The files are dropped when the game is patched, and strings nobody asked for in a few
+sessions aren't saved again. Each language keeps at most a few tens of thousands of strings; past that, the least recently
+requested ones that nothing holds are dropped, so a long session can't grow the cache without bound.
+*/
+namespace DecodeCache {
+    struct Result {
+        Result(std::wstring_view _encoded, GW::Constants::Language _language)
+            : encoded(_encoded), language(_language) { }
+
+        const std::wstring encoded;
+        const GW::Constants::Language language;
+        // Only read once IsReady(); never changes after that
+        std::wstring decoded;
+        std::atomic<bool> ready = false;
+
+        [[nodiscard]] bool IsReady() const { return ready.load(std::memory_order_acquire); }
+    };
+
+    using Ref = std::shared_ptr<const Result>;
+
+    // Cached result for this encoded string, queued for decoding if it isn't ready. Unknown language means the game's text language.
+    Ref Request(std::wstring_view encoded, GW::Constants::Language language = GW::Constants::Language::Unknown);
+
+    // Game thread only; sends queued strings to the game's decoder until max_count have gone or budget_ms has passed
+    void Update(size_t max_count, double budget_ms);
+
+    // Blocking file io; writes each loaded language that has new decodes since the last save
+    void Save();
+    // Drops results for every language but the game's current one that nobody holds any more; Save first to keep them on disk
+    size_t Trim();
+    // Forgets everything without saving; results still held elsewhere stay valid
+    void Clear();
+
+    [[nodiscard]] size_t QueuedCount();
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <bit>
+#include <span>
+
+/*
+Fixed size bit array laid out as 32 bit words, the same way the game stores unlocked skills, completed missions and the like,
+so a game buffer can be OR'd straight in and the words written straight out.
+
+Bits past the end are ignored on set and read back as unset. Counting and the set operations work a word at a time.
+*/
+template <size_t Bits>
+class FixedBitset {
+    static_assert(Bits > 0 && Bits % 32 == 0, "FixedBitset size must be a multiple of 32");
+
+public:
+    static constexpr size_t bit_count = Bits;
+    static constexpr size_t word_count = Bits / 32;
+
+    [[nodiscard]] bool test(const size_t index) const
+    {
+        return index < Bits && (words[index / 32] & (1u << (index % 32))) != 0;
+    }
+
+    void set(const size_t index, const bool value = true)
+    {
+        if (index >= Bits) {
+            return;
+        }
+        const uint32_t flag = 1u << (index % 32);
+        if (value) {
+            words[index / 32] |= flag;
+        }
+        else {
+            words[index / 32] &= ~flag;
+        }
+    }
+
+    void reset() { words.fill(0); }
+
+    // Number of bits set
+    [[nodiscard]] size_t count() const
+    {
+        size_t total = 0;
+        for (const auto word : words) {
+            total += std::popcount(word);
+        }
+        return total;
+    }
+
+    [[nodiscard]] bool none() const
+    {
+        return std::ranges::all_of(words, [](const uint32_t word) { return word == 0; });
+    }
+
+    // OR in a buffer of words, e.g. straight from the game. Words past the end are dropped.
+    void merge_words(const std::span<const uint32_t> in)
+    {
+        const auto n = std::min(in.size(), word_count);
+        for (size_t i = 0; i < n; i++) {
+            words[i] |= in[i];
+        }
+    }
+
+    // All words, for handing to code that expects the game's layout
+    [[nodiscard]] std::span<const uint32_t> all_words() const { return words; }
+
+    // Words up to the last one with anything set, for storage
+    [[nodiscard]] std::span<const uint32_t> used_words() const
+    {
+        size_t n = word_count;
+        while (n && !words[n - 1]) {
+            n--;
+        }
+        return std::span(words).first(n);
+    }
+
+    // Calls fn(index) for every set bit, lowest first
+    template <typename Fn>
+    void for_each_set(Fn&& fn) const
+    {
+        for (size_t i = 0; i < word_count; i++) {
+            for (auto word = words[i]; word; word &= word - 1) {
+                fn(i * 32 + std::countr_zero(word));
+            }
+        }
+    }
+
+    FixedBitset& operator&=(const FixedBitset& other)
+    {
+        for (size_t i = 0; i < word_count; i++) {
+            words[i] &= other.words[i];
+        }
+        return *this;
+    }
+
+    // Clear every bit that's set in other
+    FixedBitset& and_not(const FixedBitset& other)
+    {
+        for (size_t i = 0; i < word_count; i++) {
+            words[i] &= ~other.words[i];
+        }
+        return *this;
+    }
+
+    bool operator==(const FixedBitset&) const = default;
+
+private:
+    std::array<uint32_t, word_count> words{};
+};
@@ -306,18 +306,52 @@ namespace {
     }
 
 
-    ImFont* BuildFont(const float size, bool default_only = false)
+    // A font file from disk, read once and shared by every atlas that's built from it
+    struct FontFile {
+        const FontData* font = nullptr;
+        void* data = nullptr;
+        size_t data_size = 0;
+    };
+
+    std::vector<FontFile> LoadFontFiles()
     {
-        const auto atlas = IM_NEW(ImFontAtlas);
+        std::vector<FontFile> files;
+        for (const auto& font : GetFontData()) {
+            ASSERT(!font.font_name.empty() && "Font name is empty, this shouldn't happen. Contact the developers.");
+            const auto font_name_str = TextUtils::WStringToString(font.font_name);
+            size_t data_size = 0;
+            void* data = ImFileLoadToMemory(font_name_str.c_str(), "rb", &data_size, 0);
+            if (!data)
+                continue; // Failed to load data from disk
+            files.push_back({&font, data, data_size});
+        }
+        return files;
+    }
+
+    void FreeFontFiles(std::vector<FontFile>& files)
+    {
+        for (const auto& file : files) {
+            IM_FREE(file.data);
+        }
+        files.clear();
+    }
 
+    ImFontAtlasFlags GetAtlasFlags()
+    {
         ImFontAtlasFlags flags = 0;
         flags |= ImFontAtlasFlags_NoPowerOfTwoHeight;
         flags |= ImFontAtlasFlags_NoMouseCursors;
         flags |= ImFontAtlasFlags_NoBakedLines;
+        return flags;
+    }
 
-        atlas->Flags = flags;
+    // Thread safe; each call builds its own atlas. Only the default font is loaded when files is empty.
+    ImFont* BuildFont(const float size, const std::span<const FontFile> files)
+    {
+        const auto atlas = IM_NEW(ImFontAtlas);
+        atlas->Flags = GetAtlasFlags();
 
-        static ImFontConfig cfg;
+        ImFontConfig cfg;
         cfg.PixelSnapH = true;
         cfg.OversampleH = 1; // OversampleH = 2 for base text size (harder to read if OversampleH < 2)
         cfg.OversampleV = 1;
@@ -326,21 +360,13 @@ namespace {
         cfg.MergeMode = false;
         atlas->AddFontFromMemoryCompressedTTF(toolbox_default_font_compressed_data, toolbox_default_font_compressed_size, size, &cfg, toolbox_default_font_glyph_ranges);
 
-        if (!default_only) {
-            // Load more fonts from disk, overriding glyph ranges from original
-            for (const auto& [glyph_ranges, font_name] : GetFontData()) {
-                size_t data_size;
-
-                ASSERT(!font_name.empty() && "Font name is empty, this shouldn't happen. Contact the developers.");
-                const auto font_name_str = TextUtils::WStringToString(font_name);
-                void* data = ImFileLoadToMemory(font_name_str.c_str(), "rb", &data_size, 0);
-
-                if (!data)
-                    continue; // Failed to load data from disk
-                cfg.MergeMode = true;
-                atlas->AddFontFromMemoryTTF(data, data_size, size, &cfg, glyph_ranges.data());
-            }
+        // Load more fonts from disk, overriding glyph ranges from original
+        for (const auto& file : files) {
+            cfg.MergeMode = true;
+            cfg.FontDataOwnedByAtlas = false; // Shared between sizes, freed by the caller
+            atlas->AddFontFromMemoryTTF(file.data, static_cast<int>(file.data_size), size, &cfg, file.font->glyph_ranges.data());
         }
+        cfg.FontDataOwnedByAtlas = true;
         if (size <= 20.f) {
             cfg.MergeMode = true;
             atlas->AddFontFromMemoryCompressedTTF(fontawesome5_compressed_data, fontawesome5_compressed_size, size, &cfg, fontawesome5_glyph_ranges.data());
@@ -349,9 +375,192 @@ namespace {
         unsigned char* unused = nullptr;
         // Preload the data for this font
         atlas->GetTexDataAsRGBA32(&unused, nullptr, nullptr, nullptr);
+        // The glyphs are rasterized; drop the source TTF data rather than holding onto it for every size
+        atlas->ClearInputData();
         return atlas->Fonts.back();
     }
 
+    /*
+    Rasterized atlas cache. Building the CJK glyph ranges takes seconds, so the finished atlases (alpha pixels, texture metrics
+    and glyph tables) are written to disk and read back on the next launch. The key covers everything that goes into a build:
+    font file contents, glyph ranges, sizes, embedded fonts and the imgui version; any change just misses and rebuilds.
+    */
+    constexpr uint32_t ATLAS_CACHE_MAGIC = 0x46544247; // "GBTF"
+    constexpr uint32_t ATLAS_CACHE_VERSION = 1;
+
+    std::filesystem::path GetAtlasCachePath()
+    {
+        return Resources::GetPath(L"font_atlas.cache");
+    }
+
+    // FNV-1a
+    uint64_t HashBytes(const void* data, const size_t size, uint64_t hash = 0xcbf29ce484222325ull)
+    {
+        const auto bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    template <typename T>
+    uint64_t HashValue(const T& value, const uint64_t hash)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return HashBytes(&value, sizeof(value), hash);
+    }
+
+    uint64_t GetAtlasCacheKey(const std::span<const FontLoader::FontSize> sizes, const std::span<const FontFile> files)
+    {
+        auto key = HashValue(ATLAS_CACHE_VERSION, 0xcbf29ce484222325ull);
+        key = HashValue(IMGUI_VERSION_NUM, key);
+        key = HashValue(sizeof(ImFontGlyph), key);
+        key = HashValue(GetAtlasFlags(), key);
+        key = HashBytes(toolbox_default_font_compressed_data, toolbox_default_font_compressed_size, key);
+        key = HashBytes(fontawesome5_compressed_data, fontawesome5_compressed_size, key);
+        for (const auto size : sizes) {
+            key = HashValue(size, key);
+        }
+        for (const auto& file : files) {
+            key = HashBytes(file.data, file.data_size, key);
+            key = HashBytes(file.font->glyph_ranges.data(), file.font->glyph_ranges.size() * sizeof(ImWchar), key);
+        }
+        return key;
+    }
+
+    // Layout of one atlas in the cache file; followed by glyph_count ImFontGlyphs, then tex_width * tex_height alpha bytes.
+    struct CachedAtlasHeader {
+        float font_size;
+        float ascent;
+        float descent;
+        uint32_t fallback_char;
+        uint32_t ellipsis_char;
+        int32_t ellipsis_char_count;
+        float ellipsis_width;
+        float ellipsis_char_step;
+        int32_t tex_width;
+        int32_t tex_height;
+        ImVec2 tex_uv_scale;
+        ImVec2 tex_uv_white_pixel;
+        uint32_t glyph_count;
+    };
+
+    bool WriteAtlasCache(const uint64_t key, const std::span<ImFont* const> fonts)
+    {
+        const auto path = GetAtlasCachePath();
+        auto tmp_path = path;
+        tmp_path += L".tmp";
+        FILE* fp = _wfopen(tmp_path.c_str(), L"wb");
+        if (!fp) {
+            return false;
+        }
+        const uint32_t header[] = {ATLAS_CACHE_MAGIC, ATLAS_CACHE_VERSION, static_cast<uint32_t>(fonts.size())};
+        bool ok = fwrite(header, sizeof(header), 1, fp) == 1 && fwrite(&key, sizeof(key), 1, fp) == 1;
+        for (const auto font : fonts) {
+            if (!ok) {
+                break;
+            }
+            const auto atlas = font->ContainerAtlas;
+            if (atlas->Fonts.Size != 1 || !atlas->TexPixelsAlpha8) {
+                ok = false;
+                break;
+            }
+            const CachedAtlasHeader cached = {
+                font->FontSize, font->Ascent, font->Descent,
+                font->FallbackChar, font->EllipsisChar, font->EllipsisCharCount, font->EllipsisWidth, font->EllipsisCharStep,
+                atlas->TexWidth, atlas->TexHeight, atlas->TexUvScale, atlas->TexUvWhitePixel,
+                static_cast<uint32_t>(font->Glyphs.Size)
+            };
+            ok = fwrite(&cached, sizeof(cached), 1, fp) == 1
+                 && (!cached.glyph_count || fwrite(font->Glyphs.Data, sizeof(ImFontGlyph), cached.glyph_count, fp) == cached.glyph_count)
+                 && fwrite(atlas->TexPixelsAlpha8, static_cast<size_t>(atlas->TexWidth) * atlas->TexHeight, 1, fp) == 1;
+        }
+        ok = fclose(fp) == 0 && ok;
+        std::error_code ec;
+        if (ok) {
+            // Readers only ever see a complete file
+            std::filesystem::rename(tmp_path, path, ec);
+            ok = !ec;
+        }
+        if (!ok) {
+            std::filesystem::remove(tmp_path, ec);
+        }
+        return ok;
+    }
+
+    ImFont* ReadCachedAtlas(FILE* fp)
+    {
+        CachedAtlasHeader cached;
+        if (fread(&cached, sizeof(cached), 1, fp) != 1 || cached.tex_width <= 0 || cached.tex_height <= 0) {
+            return nullptr;
+        }
+        const auto atlas = IM_NEW(ImFontAtlas);
+        atlas->Flags = GetAtlasFlags();
+        const auto font = IM_NEW(ImFont);
+        font->ContainerAtlas = atlas;
+        atlas->Fonts.push_back(font);
+
+        font->Glyphs.resize(static_cast<int>(cached.glyph_count));
+        const size_t pixels_size = static_cast<size_t>(cached.tex_width) * cached.tex_height;
+        atlas->TexPixelsAlpha8 = static_cast<unsigned char*>(IM_ALLOC(pixels_size));
+        if ((cached.glyph_count && fread(font->Glyphs.Data, sizeof(ImFontGlyph), cached.glyph_count, fp) != cached.glyph_count)
+            || fread(atlas->TexPixelsAlpha8, pixels_size, 1, fp) != 1) {
+            IM_DELETE(atlas);
+            return nullptr;
+        }
+        atlas->TexWidth = cached.tex_width;
+        atlas->TexHeight = cached.tex_height;
+        atlas->TexUvScale = cached.tex_uv_scale;
+        atlas->TexUvWhitePixel = cached.tex_uv_white_pixel;
+
+        font->FontSize = cached.font_size;
+        font->Ascent = cached.ascent;
+        font->Descent = cached.descent;
+        font->FallbackChar = static_cast<ImWchar>(cached.fallback_char);
+        font->EllipsisChar = static_cast<ImWchar>(cached.ellipsis_char);
+        font->BuildLookupTable();
+        // BuildLookupTable only fills these in when they're unset; make sure they match what was built
+        font->EllipsisCharCount = static_cast<short>(cached.ellipsis_char_count);
+        font->EllipsisWidth = cached.ellipsis_width;
+        font->EllipsisCharStep = cached.ellipsis_char_step;
+        atlas->TexReady = true;
+
+        unsigned char* unused = nullptr;
+        // Preload the data for this font
+        atlas->GetTexDataAsRGBA32(&unused, nullptr, nullptr, nullptr);
+        return font;
+    }
+
+    // Returns an empty vector unless the cache holds exactly expected_count atlases built with this key.
+    std::vector<ImFont*> ReadAtlasCache(const uint64_t key, const size_t expected_count)
+    {
+        std::vector<ImFont*> fonts;
+        FILE* fp = _wfopen(GetAtlasCachePath().c_str(), L"rb");
+        if (!fp) {
+            return fonts;
+        }
+        uint32_t header[3] = {};
+        uint64_t cached_key = 0;
+        if (fread(header, sizeof(header), 1, fp) == 1 && fread(&cached_key, sizeof(cached_key), 1, fp) == 1
+            && header[0] == ATLAS_CACHE_MAGIC && header[1] == ATLAS_CACHE_VERSION && header[2] == expected_count && cached_key == key) {
+            for (size_t i = 0; i < expected_count; i++) {
+                const auto font = ReadCachedAtlas(fp);
+                if (!font) {
+                    break;
+                }
+                fonts.push_back(font);
+            }
+        }
+        fclose(fp);
+        if (fonts.size() != expected_count) {
+            for (const auto font : fonts) {
+                IM_DELETE(font->ContainerAtlas);
+            }
+            fonts.clear();
+        }
+        return fonts;
+    }
+
     // Load fonts into memory; run on a separate thread.
     void LoadFontsThread()
     {
@@ -378,9 +587,9 @@ namespace {
                 : dst_font(dst_font),
                   font_size(font_size) {}
 
-            void build(const bool default_font_only = false)
+            void build(const std::span<const FontFile> files = {})
             {
-                src_font = BuildFont(static_cast<float>(font_size), default_font_only);
+                src_font = BuildFont(static_cast<float>(font_size), files);
             }
         };
 
@@ -396,8 +605,38 @@ namespace {
             ImGui::GetIO().Fonts = fonts_built.at(0).src_font->ContainerAtlas;
         };
 
+        auto all_fonts = std::vector<FontPending>{
+            {&font_text, FontLoader::FontSize::text},
+            {&font_header2, FontLoader::FontSize::header2},
+            {&font_header1, FontLoader::FontSize::header1},
+            {&font_widget_label, FontLoader::FontSize::widget_label},
+            {&font_widget_small, FontLoader::FontSize::widget_small},
+            {&font_widget_large, FontLoader::FontSize::widget_large}
+        };
+        auto files = LoadFontFiles();
+        std::vector<FontLoader::FontSize> sizes;
+        for (const auto& pending : all_fonts) {
+            sizes.push_back(pending.font_size);
+        }
+        const auto cache_key = GetAtlasCacheKey(sizes, files);
+
+        const auto cached = ReadAtlasCache(cache_key, all_fonts.size());
+        if (!cached.empty()) {
+            FreeFontFiles(files);
+            for (size_t i = 0; i < all_fonts.size(); i++) {
+                all_fonts[i].src_font = cached[i];
+            }
+            Resources::EnqueueDxTask([assign_fonts, fonts = std::move(all_fonts)](IDirect3DDevice9*) {
+                assign_fonts(fonts);
+                printf("Loaded all fonts from cache\n");
+                fonts_loaded = true;
+                fonts_loading = false;
+            });
+            return;
+        }
+
         FontPending default_font = {&font_text, FontLoader::FontSize::text};
-        default_font.build(true);
+        default_font.build();
 
         Resources::EnqueueDxTask([assign_fonts, default_font](IDirect3DDevice9*) {
             assign_fonts({default_font});
@@ -406,16 +645,24 @@ namespace {
             fonts_loading = false;
         });
 
-        auto all_fonts = std::vector<FontPending>{
-            {&font_text, FontLoader::FontSize::text},
-            {&font_header2, FontLoader::FontSize::header2},
-            {&font_header1, FontLoader::FontSize::header1},
-            {&font_widget_label, FontLoader::FontSize::widget_label},
-            {&font_widget_small, FontLoader::FontSize::widget_small},
-            {&font_widget_large, FontLoader::FontSize::widget_large}
-        };
+        // Each size is its own atlas, so they can be rasterized side by side
+        std::vector<std::thread> builders;
         for (auto& pending : all_fonts) {
-            pending.build();
+            builders.emplace_back([&pending, &files] {
+                pending.build(files);
+            });
+        }
+        for (auto& builder : builders) {
+            builder.join();
+        }
+        FreeFontFiles(files);
+
+        std::vector<ImFont*> built;
+        for (const auto& pending : all_fonts) {
+            built.push_back(pending.src_font);
+        }
+        if (!WriteAtlasCache(cache_key, built)) {
+            Log::Log("[FontLoader] Failed to write %ls\n", GetAtlasCachePath().c_str());
         }
 
         Resources::EnqueueDxTask([assign_fonts, fonts = std::move(all_fonts)](IDirect3DDevice9*) {
@@ -0,0 +1,362 @@
+#include "stdafx.h"
+
+#include <GWCA/Packets/Opcodes.h>
+#include <GWCA/Managers/StoCMgr.h>
+
+#include <Logger.h>
+#include <Timer.h>
+#include <Modules/Resources.h>
+#include <Utils/FrameProfiler.h>
+#include <Utils/RingBuffer.h>
+
+namespace {
+    using FrameProfiler::Phase;
+
+    // ~4 seconds at 60fps
+    constexpr size_t HISTORY_FRAMES = 256;
+    constexpr clock_t STATS_REFRESH_MS = 500;
+    constexpr uint32_t STOC_HEADER_COUNT = GAME_SMSG_PARTY_SEARCH_TYPE + 1;
+
+    struct Entry {
+        const char* label;
+        Phase phase;
+        uint64_t frame_ticks = 0;
+        Ring<float> history{HISTORY_FRAMES};
+    };
+
+    struct TraceEvent {
+        const char* label;
+        Phase phase;
+        uint64_t start;
+        uint64_t end;
+        DWORD thread_id;
+    };
+
+    struct FrameTotal {
+        const char* label = nullptr;
+        Phase phase = Phase::Update;
+        uint64_t ticks = 0;
+    };
+
+    // What one thread has recorded since the last EndFrame. Its lock is only contended while EndFrame collects.
+    struct ThreadBuffer {
+        DWORD thread_id = 0;
+        std::mutex mutex;
+        std::unordered_map<uint64_t, FrameTotal> frame_totals;
+        std::vector<TraceEvent> trace_events;
+    };
+
+    // Every thread that has recorded anything; kept until the dll unloads, there are only ever a handful
+    std::mutex buffers_mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    thread_local ThreadBuffer* thread_buffer = nullptr;
+
+    // Guards the totals, stats and capture state below; taken before buffers_mutex and a buffer's lock, never after
+    std::mutex state_mutex;
+    // Keyed by label pointer and phase; labels are module names or literals, so the pointer is stable for the lifetime of the dll.
+    std::unordered_map<uint64_t, Entry> entries;
+    double ms_per_tick = 0.0;
+    DWORD game_thread_id = 0;
+    float last_frame_total_ms = 0.f;
+
+    std::vector<FrameProfiler::Stats> stats;
+    clock_t stats_refreshed = 0;
+
+    std::vector<TraceEvent> trace_events;
+    std::filesystem::path trace_path;
+    size_t capture_frames_left = 0;
+    // Read by Record on any thread without the lock
+    std::atomic<bool> capturing = false;
+
+    GW::HookEntry packet_hook_entry;
+    bool packet_hooks_registered = false;
+    std::array<std::array<char, 16>, STOC_HEADER_COUNT> packet_labels{};
+    std::array<uint64_t, STOC_HEADER_COUNT> packet_started{};
+
+    uint64_t EntryKey(const char* label, const Phase phase)
+    {
+        return (static_cast<uint64_t>(reinterpret_cast<uintptr_t>(label)) << 8) | static_cast<uint64_t>(phase);
+    }
+
+    float Percentile(std::vector<float>& samples, const float pct)
+    {
+        if (samples.empty()) {
+            return 0.f;
+        }
+        const auto nth = samples.begin() + static_cast<ptrdiff_t>(pct * static_cast<float>(samples.size() - 1));
+        std::nth_element(samples.begin(), nth, samples.end());
+        return *nth;
+    }
+
+    ThreadBuffer& GetThreadBuffer()
+    {
+        if (!thread_buffer) {
+            auto buffer = std::make_unique<ThreadBuffer>();
+            buffer->thread_id = GetCurrentThreadId();
+            thread_buffer = buffer.get();
+            std::lock_guard lock(buffers_mutex);
+            buffers.push_back(std::move(buffer));
+        }
+        return *thread_buffer;
+    }
+
+    // With state_mutex held. Moves every thread's recordings into entries and, while capturing, trace_events; returns the frame's total.
+    uint64_t CollectThreadBuffers()
+    {
+        uint64_t total_ticks = 0;
+        std::lock_guard buffers_lock(buffers_mutex);
+        for (const auto& buffer : buffers) {
+            std::lock_guard lock(buffer->mutex);
+            for (const auto& [key, total] : buffer->frame_totals) {
+                auto found = entries.find(key);
+                if (found == entries.end()) {
+                    found = entries.emplace(key, Entry{total.label, total.phase}).first;
+                }
+                found->second.frame_ticks += total.ticks;
+                total_ticks += total.ticks;
+            }
+            buffer->frame_totals.clear();
+            if (capture_frames_left) {
+                trace_events.insert(trace_events.end(), buffer->trace_events.begin(), buffer->trace_events.end());
+            }
+            buffer->trace_events.clear();
+        }
+        return total_ticks;
+    }
+
+    void ClearThreadBuffers()
+    {
+        std::lock_guard buffers_lock(buffers_mutex);
+        for (const auto& buffer : buffers) {
+            std::lock_guard lock(buffer->mutex);
+            buffer->frame_totals.clear();
+            buffer->trace_events.clear();
+        }
+    }
+
+    void WriteTrace(std::vector<TraceEvent> events, const std::filesystem::path& path, const double tick_ms, const DWORD main_thread_id)
+    {
+        nlohmann::json trace_json;
+        auto& out = trace_json["traceEvents"] = nlohmann::json::array();
+        const auto pid = GetCurrentProcessId();
+        // Gathered a thread at a time each frame; put them back in time order
+        std::ranges::sort(events, {}, &TraceEvent::start);
+        const auto origin = events.empty() ? 0 : events.front().start;
+        out.push_back({
+            {"name", "thread_name"},
+            {"ph", "M"},
+            {"pid", pid},
+            {"tid", main_thread_id},
+            {"args", {{"name", "Game thread"}}}
+        });
+        for (const auto& e : events) {
+            out.push_back({
+                {"name", e.label},
+                {"cat", FrameProfiler::GetPhaseName(e.phase)},
+                {"ph", "X"},
+                {"ts", static_cast<double>(e.start - origin) * tick_ms * 1000.0},
+                {"dur", static_cast<double>(e.end - e.start) * tick_ms * 1000.0},
+                {"pid", pid},
+                {"tid", e.thread_id}
+            });
+        }
+        trace_json["displayTimeUnit"] = "ms";
+
+        std::ofstream file(path);
+        if (!file) {
+            Log::Error("Failed to write profiler trace to %s", path.string().c_str());
+            return;
+        }
+        file << trace_json.dump();
+        Log::Info("Profiler trace saved to %s", path.string().c_str());
+    }
+
+    void OnPacketStart(const uint32_t header)
+    {
+        if (header < STOC_HEADER_COUNT) {
+            packet_started[header] = FrameProfiler::Now();
+        }
+    }
+
+    void OnPacketEnd(const uint32_t header)
+    {
+        if (header < STOC_HEADER_COUNT && packet_started[header]) {
+            FrameProfiler::Record(packet_labels[header].data(), Phase::Packet, packet_started[header], FrameProfiler::Now());
+            packet_started[header] = 0;
+        }
+    }
+
+    // Callbacks at or below altitude 0 run before gw handles the packet, positive ones after; bracket both groups so gw's own work isn't counted.
+    void RegisterPacketHooks()
+    {
+        if (packet_hooks_registered) {
+            return;
+        }
+        for (uint32_t header = 0; header < STOC_HEADER_COUNT; header++) {
+            snprintf(packet_labels[header].data(), packet_labels[header].size(), "StoC 0x%03X", header);
+            GW::StoC::RegisterPacketCallback(&packet_hook_entry, header, [header](GW::HookStatus*, GW::Packet::StoC::PacketBase*) {
+                OnPacketStart(header);
+            }, INT_MIN);
+            GW::StoC::RegisterPacketCallback(&packet_hook_entry, header, [header](GW::HookStatus*, GW::Packet::StoC::PacketBase*) {
+                OnPacketEnd(header);
+            }, 0);
+            GW::StoC::RegisterPacketCallback(&packet_hook_entry, header, [header](GW::HookStatus*, GW::Packet::StoC::PacketBase*) {
+                OnPacketStart(header);
+            }, 1);
+            GW::StoC::RegisterPacketCallback(&packet_hook_entry, header, [header](GW::HookStatus*, GW::Packet::StoC::PacketBase*) {
+                OnPacketEnd(header);
+            }, INT_MAX);
+        }
+        packet_hooks_registered = true;
+    }
+
+    void RemovePacketHooks()
+    {
+        if (!packet_hooks_registered) {
+            return;
+        }
+        for (uint32_t header = 0; header < STOC_HEADER_COUNT; header++) {
+            GW::StoC::RemoveCallback(header, &packet_hook_entry);
+        }
+        packet_started.fill(0);
+        packet_hooks_registered = false;
+    }
+}
+
+void FrameProfiler::SetEnabled(const bool enabled)
+{
+    if (enabled == Internal::enabled) {
+        return;
+    }
+    if (enabled) {
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        std::lock_guard lock(state_mutex);
+        ms_per_tick = 1000.0 / static_cast<double>(frequency.QuadPart);
+        game_thread_id = GetCurrentThreadId();
+        RegisterPacketHooks();
+    }
+    else {
+        RemovePacketHooks();
+        Reset();
+    }
+    Internal::enabled = enabled;
+}
+
+void FrameProfiler::Record(const char* label, const Phase phase, const uint64_t start_ticks, const uint64_t end_ticks)
+{
+    if (!IsEnabled()) {
+        return;
+    }
+    auto& buffer = GetThreadBuffer();
+    std::lock_guard lock(buffer.mutex);
+    auto& total = buffer.frame_totals[EntryKey(label, phase)];
+    total.label = label;
+    total.phase = phase;
+    total.ticks += end_ticks - start_ticks;
+    if (capturing.load(std::memory_order_relaxed)) {
+        buffer.trace_events.push_back({label, phase, start_ticks, end_ticks, buffer.thread_id});
+    }
+}
+
+void FrameProfiler::EndFrame()
+{
+    if (!IsEnabled()) {
+        return;
+    }
+    std::lock_guard lock(state_mutex);
+    const auto total_ticks = CollectThreadBuffers();
+    for (auto& entry : entries | std::views::values) {
+        // A module that didn't run this frame (e.g. a hidden window) still counts as a zero so percentiles stay per-frame.
+        entry.history.add(static_cast<float>(static_cast<double>(entry.frame_ticks) * ms_per_tick));
+        entry.frame_ticks = 0;
+    }
+    last_frame_total_ms = static_cast<float>(static_cast<double>(total_ticks) * ms_per_tick);
+
+    if (capture_frames_left && --capture_frames_left == 0) {
+        capturing = false;
+        Resources::EnqueueWorkerTask([events = std::move(trace_events), path = trace_path, ms = ms_per_tick, tid = game_thread_id]() mutable {
+            WriteTrace(std::move(events), path, ms, tid);
+        });
+        trace_events.clear();
+    }
+}
+
+void FrameProfiler::Reset()
+{
+    std::lock_guard lock(state_mutex);
+    ClearThreadBuffers();
+    entries.clear();
+    stats.clear();
+    stats_refreshed = 0;
+    last_frame_total_ms = 0.f;
+}
+
+const std::vector<FrameProfiler::Stats>& FrameProfiler::GetStats()
+{
+    if (stats_refreshed && TIMER_DIFF(stats_refreshed) < STATS_REFRESH_MS) {
+        return stats;
+    }
+    std::lock_guard lock(state_mutex);
+    stats_refreshed = TIMER_INIT();
+    stats.clear();
+    std::vector<float> samples;
+    for (auto& entry : entries | std::views::values) {
+        if (entry.history.empty()) {
+            continue;
+        }
+        const auto [first, second] = entry.history.spans();
+        samples.assign(first.begin(), first.end());
+        samples.insert(samples.end(), second.begin(), second.end());
+        const float last = samples.back();
+        const float max = std::ranges::max(samples);
+        const float p50 = Percentile(samples, 0.5f);
+        const float p99 = Percentile(samples, 0.99f);
+        stats.push_back({entry.label, entry.phase, last, p50, p99, max});
+    }
+    std::ranges::sort(stats, std::greater{}, &Stats::p99_ms);
+    return stats;
+}
+
+float FrameProfiler::GetLastFrameTotal()
+{
+    std::lock_guard lock(state_mutex);
+    return last_frame_total_ms;
+}
+
+const char* FrameProfiler::GetPhaseName(const Phase phase)
+{
+    switch (phase) {
+        case Phase::Update:
+            return "Update";
+        case Phase::Draw:
+            return "Draw";
+        case Phase::WndProc:
+            return "WndProc";
+        case Phase::Packet:
+            return "Packet";
+        default:
+            return "Unknown";
+    }
+}
+
+void FrameProfiler::StartCapture(const size_t frame_count, const std::filesystem::path& path)
+{
+    if (!IsEnabled() || !frame_count) {
+        return;
+    }
+    std::lock_guard lock(state_mutex);
+    if (capture_frames_left) {
+        return;
+    }
+    trace_events.clear();
+    trace_events.reserve(frame_count * (entries.size() + 16));
+    trace_path = path;
+    capture_frames_left = frame_count;
+    capturing = true;
+}
+
+bool FrameProfiler::IsCapturing()
+{
+    return capturing;
+}
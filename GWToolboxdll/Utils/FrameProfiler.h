@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+
+/*
+Per-frame timing of toolbox's own work, broken down by module and phase.
+
+Call sites wrap work in a FrameProfiler::Scope; while profiling is disabled a scope costs one branch.
+Each frame's total per label is kept for the last few hundred frames so the profiler window can show p50/p99/max,
+and a capture records every scope for a number of frames and writes them out as Chrome trace json (chrome://tracing or ui.perfetto.dev).
+
+Scopes are recorded on whichever thread they run on (game thread, render thread, WndProc), each into that thread's own buffer,
+and EndFrame gathers them all; the trace puts each thread on its own track.
+*/
+namespace FrameProfiler {
+    enum class Phase : uint8_t { Update, Draw, WndProc, Packet, Count };
+
+    struct Stats {
+        const char* label;
+        Phase phase;
+        float last_ms;
+        float p50_ms;
+        float p99_ms;
+        float max_ms;
+    };
+
+    namespace Internal {
+        inline std::atomic<bool> enabled = false;
+    }
+
+    [[nodiscard]] inline bool IsEnabled() { return Internal::enabled.load(std::memory_order_relaxed); }
+    // Also brackets every StoC packet's callbacks while enabled; call from the game thread.
+    void SetEnabled(bool enabled);
+
+    [[nodiscard]] inline uint64_t Now()
+    {
+        LARGE_INTEGER ticks;
+        QueryPerformanceCounter(&ticks);
+        return static_cast<uint64_t>(ticks.QuadPart);
+    }
+
+    // label must outlive the profiler; module names and string literals are fine. Any thread.
+    void Record(const char* label, Phase phase, uint64_t start_ticks, uint64_t end_ticks);
+
+    // Close off this frame's totals, from every thread. Called once per frame from GWToolbox::Update.
+    void EndFrame();
+    // Clear the rolling history, e.g. after a map load spike.
+    void Reset();
+
+    // Sorted by p99, slowest first. Recomputed at most twice a second.
+    const std::vector<Stats>& GetStats();
+    // Sum of every label's time for the last finished frame.
+    float GetLastFrameTotal();
+    const char* GetPhaseName(Phase phase);
+
+    // Record every scope for the next frame_count frames, then write them to path on a worker thread.
+    void StartCapture(size_t frame_count, const std::filesystem::path& path);
+    bool IsCapturing();
+
+    class Scope {
+    public:
+        Scope(const char* label, const Phase phase)
+            : label(label)
+            , phase(phase)
+            , start(IsEnabled() ? Now() : 0) { }
+
+        ~Scope()
+        {
+            if (start) {
+                Record(label, phase, start, Now());
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* label;
+        Phase phase;
+        uint64_t start;
+    };
+}
+
+#define TBPROFILE_CONCAT_INNER(a, b) a##b
+#define TBPROFILE_CONCAT(a, b) TBPROFILE_CONCAT_INNER(a, b)
+// Time the rest of the enclosing block, e.g. TBPROFILE_SCOPE("ChatFilter::OnMessage", Packet);
+#define TBPROFILE_SCOPE(label, phase) const FrameProfiler::Scope TBPROFILE_CONCAT(tbprofile_scope_, __LINE__)(label, FrameProfiler::Phase::phase)
@@ -457,10 +457,10 @@ namespace GuiUtils {
         if (language_id == l) {
             return this;
         }
-        ASSERT(!decoding);
         language_id = l;
         decoded_ws.clear();
         decoded_s.clear();
+        pending.reset();
         decoding = decoded = false;
         return this;
     }
@@ -470,10 +470,10 @@ namespace GuiUtils {
         if (_enc_string && wcscmp(_enc_string, encoded_ws.c_str()) == 0) {
             return this;
         }
-        ASSERT(!decoding);
         encoded_ws.clear();
         decoded_ws.clear();
         decoded_s.clear();
+        pending.reset();
         decoding = decoded = false;
         sanitised = !sanitise;
         if (_enc_string) {
@@ -485,15 +485,18 @@ namespace GuiUtils {
     void EncString::decode() {
         if (!decoded && !decoding && !encoded_ws.empty()) {
             decoding = true;
-            GW::GameThread::Enqueue([&] {
-                GW::UI::AsyncDecodeStr(encoded_ws.c_str(), OnStringDecoded, this, language_id);
-                });
+            pending = DecodeCache::Request(encoded_ws, language_id);
         }
     }
 
     std::wstring& EncString::wstring()
     {
         decode();
+        // Strings decoded before, by anyone, are ready straight away
+        if (decoding && pending && pending->IsReady()) {
+            on_decoded(pending->decoded);
+            pending.reset();
+        }
         sanitise();
         return decoded_ws;
     }
@@ -508,19 +511,13 @@ namespace GuiUtils {
         }
     }
 
-    // ReSharper disable once CppParameterMayBeConst
-    // ReSharper disable once CppParameterMayBeConstPtrOrRef
-    void EncString::OnStringDecoded(void* param, const wchar_t* decoded)
+    void EncString::on_decoded(const std::wstring& str)
     {
-        const auto context = static_cast<EncString*>(param);
-        if (!(context && context->decoding && !context->decoded)) {
-            return; // Not expecting a decoded string; may have been reset() before response was received.
-        }
-        if (decoded && decoded[0]) {
-            context->decoded_ws = decoded;
+        if (!str.empty()) {
+            decoded_ws = str;
         }
-        context->decoded = true;
-        context->decoding = false;
+        decoded = true;
+        decoding = false;
     }
 
     std::string& EncString::string()
@@ -4,6 +4,7 @@
 #include <ImGuiAddons.h>
 #include <nlohmann/json.hpp>
 #include <ToolboxIni.h>
+#include <Utils/DecodeCache.h>
 
 namespace GW::Constants {
     enum class Language;
@@ -97,15 +98,18 @@ namespace GuiUtils {
         bool decoding = false;
         bool decoded = false;
         bool sanitised = false;
+        // Shared with every other EncString decoding the same string; let go of once copied into decoded_ws
+        DecodeCache::Ref pending;
         virtual void sanitise();
         virtual void decode();
+        // Called once with the decoded string; overrides can post-process decoded_ws after calling this
+        virtual void on_decoded(const std::wstring& str);
         GW::Constants::Language language_id = static_cast<GW::Constants::Language>(0xff);
-        static void OnStringDecoded(void* param, const wchar_t* decoded);
 
     public:
         // Set the language for decoding this encoded string. If the language has changed, resets the decoded result. Returns this for chaining.
         EncString* language(GW::Constants::Language l);
-        bool IsDecoding() const { return decoding && decoded_ws.empty(); };
+        bool IsDecoding() const { return decoding && !(pending && pending->IsReady()); };
         // Recycle this EncString by passing a new encoded string id to decode.
         // Set sanitise to true to automatically remove guild tags etc from the string
         EncString* reset(uint32_t _enc_string_id = 0, bool sanitise = true);
@@ -131,7 +135,7 @@ namespace GuiUtils {
             reset(_enc_string, sanitise);
         }
 
-        // Disable object copying; decoded_ws is passed to GW by reference and would be bad to do this. Pass by pointer instead.
+        // Disable object copying; subclasses hold state about their own decode. Pass by pointer instead.
         EncString(const EncString& temp_obj) = delete;
         EncString& operator=(const EncString& temp_obj) = delete;
         virtual ~EncString() = default;
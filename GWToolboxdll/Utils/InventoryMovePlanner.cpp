@@ -0,0 +1,215 @@
+#include "stdafx.h"
+
+#include <Utils/InventoryMovePlanner.h>
+
+namespace {
+    template <typename T>
+    void InsertSorted(std::vector<T>& vec, const T& value)
+    {
+        const auto it = std::ranges::lower_bound(vec, value);
+        if (it == vec.end() || *it != value) {
+            vec.insert(it, value);
+        }
+    }
+
+    template <typename T>
+    void EraseSorted(std::vector<T>& vec, const T& value)
+    {
+        const auto it = std::ranges::lower_bound(vec, value);
+        if (it != vec.end() && *it == value) {
+            vec.erase(it);
+        }
+    }
+}
+
+namespace InventoryMovePlanner {
+    Snapshot::Snapshot(std::vector<BagState> in_bags)
+        : bags(std::move(in_bags))
+    {
+        std::ranges::sort(bags, {}, &BagState::bag_id);
+        empty_slots.resize(bags.size());
+        for (uint32_t bag_index = 0; bag_index < bags.size(); bag_index++) {
+            const auto& bag = bags[bag_index];
+            for (uint32_t slot = 0; slot < bag.slots.size(); slot++) {
+                const auto& state = bag.slots[slot];
+                const SlotRef ref = {bag_index, slot};
+                if (!state.quantity) {
+                    empty_slots[bag_index].push_back(slot);
+                    continue;
+                }
+                if (state.item_id) {
+                    item_slots[state.item_id] = ref;
+                }
+                if (state.stack_key && state.quantity < bag.max_stack) {
+                    stacks_with_room[state.stack_key].push_back(ref);
+                }
+            }
+        }
+    }
+
+    std::optional<Snapshot::SlotRef> Snapshot::FindSlot(const uint32_t bag_id, const uint32_t slot) const
+    {
+        const auto it = std::ranges::lower_bound(bags, bag_id, {}, &BagState::bag_id);
+        if (it == bags.end() || it->bag_id != bag_id || slot >= it->slots.size()) {
+            return std::nullopt;
+        }
+        return SlotRef{static_cast<uint32_t>(it - bags.begin()), slot};
+    }
+
+    const SlotState* Snapshot::GetSlot(const uint32_t bag_id, const uint32_t slot) const
+    {
+        const auto ref = FindSlot(bag_id, slot);
+        return ref ? &bags[ref->bag_index].slots[ref->slot] : nullptr;
+    }
+
+    uint16_t Snapshot::RoomFor(const SlotRef ref, const StackKey stack_key) const
+    {
+        const auto& bag = bags[ref.bag_index];
+        const auto& state = bag.slots[ref.slot];
+        if (!state.quantity) {
+            return bag.max_stack;
+        }
+        if (!stack_key || state.stack_key != stack_key || state.quantity >= bag.max_stack) {
+            return 0;
+        }
+        return static_cast<uint16_t>(bag.max_stack - state.quantity);
+    }
+
+    void Snapshot::SetSlot(const SlotRef ref, const SlotState& state)
+    {
+        const auto& bag = bags[ref.bag_index];
+        auto& current = bags[ref.bag_index].slots[ref.slot];
+        const auto has_room = [&bag](const SlotState& s) {
+            return s.quantity && s.stack_key && s.quantity < bag.max_stack;
+        };
+        if (has_room(current)) {
+            EraseSorted(stacks_with_room[current.stack_key], ref);
+        }
+        if (has_room(state)) {
+            InsertSorted(stacks_with_room[state.stack_key], ref);
+        }
+        if (current.quantity && !state.quantity) {
+            InsertSorted(empty_slots[ref.bag_index], ref.slot);
+        }
+        else if (!current.quantity && state.quantity) {
+            EraseSorted(empty_slots[ref.bag_index], ref.slot);
+        }
+        if (current.item_id) {
+            item_slots.erase(current.item_id);
+        }
+        if (state.item_id) {
+            item_slots[state.item_id] = ref;
+        }
+        current = state;
+    }
+
+    void Snapshot::Transfer(const std::optional<SlotRef> source, const uint32_t item_id, const StackKey stack_key, const SlotRef dest, const uint16_t quantity, std::vector<Move>* out)
+    {
+        const auto dest_state = bags[dest.bag_index].slots[dest.slot];
+        if (out) {
+            out->push_back({item_id, bags[dest.bag_index].bag_id, dest.slot, quantity, dest_state.item_id});
+        }
+        bool moves_whole_item = false;
+        if (source) {
+            auto source_state = bags[source->bag_index].slots[source->slot];
+            moves_whole_item = source_state.quantity <= quantity;
+            if (moves_whole_item) {
+                source_state = {};
+            }
+            else {
+                source_state.quantity -= quantity;
+            }
+            SetSlot(*source, source_state);
+        }
+        SlotState new_dest = dest_state;
+        if (!new_dest.quantity) {
+            // Moving a whole item keeps its id; moving part of a stack makes a new item we don't know the id of yet
+            new_dest.item_id = moves_whole_item ? item_id : 0;
+            new_dest.stack_key = stack_key;
+        }
+        new_dest.quantity += quantity;
+        SetSlot(dest, new_dest);
+    }
+
+    uint16_t Snapshot::Plan(const Request& request, std::vector<Move>& out)
+    {
+        const auto found = item_slots.find(request.item_id);
+        const std::optional<SlotRef> source = found != item_slots.end() ? std::optional(found->second) : std::nullopt;
+        uint16_t remaining = request.quantity;
+        if (source) {
+            remaining = std::min(remaining, bags[source->bag_index].slots[source->slot].quantity);
+        }
+        const uint16_t to_move = remaining;
+
+        const auto place = [&](const SlotRef dest) {
+            if (source && dest == *source) {
+                return;
+            }
+            const auto will_move = std::min(remaining, RoomFor(dest, request.stack_key));
+            if (will_move) {
+                Transfer(source, request.item_id, request.stack_key, dest, will_move, &out);
+                remaining -= will_move;
+            }
+        };
+
+        for (const auto& step : request.steps) {
+            if (!remaining) {
+                break;
+            }
+            switch (step.type) {
+                case Step::Type::FixedSlot:
+                    if (const auto dest = FindSlot(step.bag_first, step.slot)) {
+                        place(*dest);
+                    }
+                    break;
+                case Step::Type::ExistingStacks: {
+                    if (!request.stack_key) {
+                        break;
+                    }
+                    const auto stacks = stacks_with_room.find(request.stack_key);
+                    if (stacks == stacks_with_room.end()) {
+                        break;
+                    }
+                    // Copied; placing onto a stack can fill it and take it out of the list
+                    const auto candidates = stacks->second;
+                    for (const auto& dest : candidates) {
+                        const auto bag_id = bags[dest.bag_index].bag_id;
+                        if (bag_id < step.bag_first || bag_id > step.bag_last) {
+                            continue;
+                        }
+                        place(dest);
+                        if (!remaining) {
+                            break;
+                        }
+                    }
+                } break;
+                case Step::Type::EmptySlots: {
+                    const auto first = std::ranges::lower_bound(bags, step.bag_first, {}, &BagState::bag_id);
+                    for (auto bag = first; remaining && bag != bags.end() && bag->bag_id <= step.bag_last; ++bag) {
+                        const auto bag_index = static_cast<uint32_t>(bag - bags.begin());
+                        auto& free_list = empty_slots[bag_index];
+                        while (remaining && !free_list.empty() && bag->max_stack) {
+                            place({bag_index, free_list.front()});
+                        }
+                    }
+                } break;
+            }
+        }
+        return to_move - remaining;
+    }
+
+    void Snapshot::Apply(const Move& move)
+    {
+        const auto dest = FindSlot(move.bag_id, move.slot);
+        if (!dest) {
+            return;
+        }
+        const auto found = item_slots.find(move.item_id);
+        const std::optional<SlotRef> source = found != item_slots.end() ? std::optional(found->second) : std::nullopt;
+        if (source && *source == *dest) {
+            return; // A whole item that's already arrived
+        }
+        const auto stack_key = source ? bags[source->bag_index].slots[source->slot].stack_key : bags[dest->bag_index].slots[dest->slot].stack_key;
+        Transfer(source, move.item_id, stack_key, *dest, move.quantity, nullptr);
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <optional>
+
+/*
+Plans item moves (store all materials, withdraw all dyes, ctrl+click a stack...) against a snapshot of the bags rather than the
+live game state.
+
+The snapshot indexes stacks that still have room by stack key, and keeps a free list of empty slots per bag, so placing an item
+never rescans a bag. Every planned move is applied to the snapshot straight away, so each item sees the slots that earlier items
+filled; the game's own bags don't catch up until the server confirms each move.
+
+Nothing in here touches the game: InventoryManager builds the snapshot from GW::Bag and sends the moves.
+*/
+namespace InventoryMovePlanner {
+    // Items with the same key stack together; 0 for items that don't stack
+    using StackKey = uint64_t;
+
+    struct SlotState {
+        // 0 when the slot is empty, or holds a stack that a planned move has created
+        uint32_t item_id = 0;
+        StackKey stack_key = 0;
+        uint16_t quantity = 0;
+    };
+
+    struct BagState {
+        uint32_t bag_id = 0;
+        uint16_t max_stack = 250;
+        std::vector<SlotState> slots;
+    };
+
+    struct Move {
+        uint32_t item_id = 0;
+        uint32_t bag_id = 0;
+        uint32_t slot = 0;
+        uint16_t quantity = 0;
+        // Existing stack being topped up, 0 when the destination was empty when planned
+        uint32_t onto_item_id = 0;
+    };
+
+    // One place to try to put an item; a request's steps are tried in order until all of it is placed
+    struct Step {
+        enum class Type : uint8_t {
+            // bag_first's slot only, if it's empty or holds the same item
+            FixedSlot,
+            // Top up stacks of the same item in [bag_first, bag_last]
+            ExistingStacks,
+            // Empty slots in [bag_first, bag_last], lowest first
+            EmptySlots
+        };
+        Type type = Type::EmptySlots;
+        uint32_t bag_first = 0;
+        uint32_t bag_last = 0;
+        uint32_t slot = 0;
+    };
+
+    struct Request {
+        uint32_t item_id = 0;
+        StackKey stack_key = 0;
+        uint16_t quantity = 0;
+        std::vector<Step> steps;
+    };
+
+    class Snapshot {
+    public:
+        explicit Snapshot(std::vector<BagState> bags);
+
+        // Appends the moves for request to out and applies them to the snapshot. Returns the quantity placed.
+        uint16_t Plan(const Request& request, std::vector<Move>& out);
+        // Applies a move planned against an earlier snapshot, e.g. one that's queued or still in flight; a no-op for a whole item
+        // that has already arrived
+        void Apply(const Move& move);
+
+        [[nodiscard]] const SlotState* GetSlot(uint32_t bag_id, uint32_t slot) const;
+
+    private:
+        struct SlotRef {
+            uint32_t bag_index = 0;
+            uint32_t slot = 0;
+            auto operator<=>(const SlotRef&) const = default;
+        };
+
+        [[nodiscard]] std::optional<SlotRef> FindSlot(uint32_t bag_id, uint32_t slot) const;
+        [[nodiscard]] uint16_t RoomFor(SlotRef ref, StackKey stack_key) const;
+        void Transfer(std::optional<SlotRef> source, uint32_t item_id, StackKey stack_key, SlotRef dest, uint16_t quantity, std::vector<Move>* out);
+        void SetSlot(SlotRef ref, const SlotState& state);
+
+        std::vector<BagState> bags; // Sorted by bag_id
+        std::unordered_map<StackKey, std::vector<SlotRef>> stacks_with_room; // Each list sorted
+        std::vector<std::vector<uint32_t>> empty_slots; // Per bag, sorted
+        std::unordered_map<uint32_t, SlotRef> item_slots;
+    };
+}
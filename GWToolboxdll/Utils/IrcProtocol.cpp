@@ -0,0 +1,191 @@
+#include "stdafx.h"
+
+#include <Utils/IrcProtocol.h>
+
+namespace {
+    size_t SkipSpaces(const std::string_view line, size_t pos)
+    {
+        while (pos < line.size() && line[pos] == ' ') {
+            pos++;
+        }
+        return pos;
+    }
+
+    // Up to the next space, or the end of the line
+    size_t TokenEnd(const std::string_view line, const size_t pos)
+    {
+        const auto end = line.find(' ', pos);
+        return end == std::string_view::npos ? line.size() : end;
+    }
+}
+
+namespace IrcProtocol {
+    std::string_view Message::GetTag(const std::string_view key) const
+    {
+        return FindTag(tags, key);
+    }
+
+    bool Parse(const std::string_view line, Message& out)
+    {
+        out = {};
+        size_t pos = 0;
+        if (!line.empty() && line[0] == '@') {
+            const auto end = TokenEnd(line, 1);
+            out.tags = line.substr(1, end - 1);
+            pos = SkipSpaces(line, end);
+        }
+        if (pos < line.size() && line[pos] == ':') {
+            const auto end = TokenEnd(line, pos + 1);
+            out.prefix = line.substr(pos + 1, end - pos - 1);
+            const auto user_at = out.prefix.find('!');
+            const auto host_at = out.prefix.find('@', user_at == std::string_view::npos ? 0 : user_at);
+            out.nick = out.prefix.substr(0, std::min(user_at, host_at));
+            if (out.nick.empty()) {
+                return false;
+            }
+            if (user_at != std::string_view::npos) {
+                out.user = out.prefix.substr(user_at + 1, host_at == std::string_view::npos ? std::string_view::npos : host_at - user_at - 1);
+            }
+            if (host_at != std::string_view::npos) {
+                out.host = out.prefix.substr(host_at + 1);
+            }
+            pos = SkipSpaces(line, end);
+        }
+        const auto command_end = TokenEnd(line, pos);
+        out.command = line.substr(pos, command_end - pos);
+        if (out.command.empty()) {
+            return false;
+        }
+        pos = SkipSpaces(line, command_end);
+        out.raw_params = line.substr(pos);
+
+        while (pos < line.size()) {
+            // The last of 15 params takes the rest of the line, same as a trailing one
+            if (line[pos] == ':' || out.param_count == Message::max_params - 1) {
+                out.params[out.param_count++] = line.substr(line[pos] == ':' ? pos + 1 : pos);
+                break;
+            }
+            const auto end = TokenEnd(line, pos);
+            out.params[out.param_count++] = line.substr(pos, end - pos);
+            pos = SkipSpaces(line, end);
+        }
+        return true;
+    }
+
+    std::string_view FindTag(std::string_view tags, const std::string_view key)
+    {
+        while (!tags.empty()) {
+            const auto tag_end = tags.find(';');
+            const auto tag = tags.substr(0, tag_end);
+            const auto value_at = tag.find('=');
+            if (tag.substr(0, value_at) == key) {
+                return value_at == std::string_view::npos ? std::string_view{} : tag.substr(value_at + 1);
+            }
+            if (tag_end == std::string_view::npos) {
+                break;
+            }
+            tags.remove_prefix(tag_end + 1);
+        }
+        return {};
+    }
+
+    void UnescapeTagValue(const std::string_view value, std::string& out)
+    {
+        out.clear();
+        out.reserve(value.size());
+        for (size_t i = 0; i < value.size(); i++) {
+            if (value[i] != '\\') {
+                out.push_back(value[i]);
+                continue;
+            }
+            // A lone backslash at the end is dropped
+            if (++i == value.size()) {
+                break;
+            }
+            switch (value[i]) {
+                case ':':
+                    out.push_back(';');
+                    break;
+                case 's':
+                    out.push_back(' ');
+                    break;
+                case 'r':
+                    out.push_back('\r');
+                    break;
+                case 'n':
+                    out.push_back('\n');
+                    break;
+                default:
+                    out.push_back(value[i]);
+                    break;
+            }
+        }
+    }
+
+    LineFramer::LineFramer()
+        : buffer(max_line_length * 2) {}
+
+    std::span<char> LineFramer::WriteSpace()
+    {
+        if (read_pos == write_pos) {
+            read_pos = scan_pos = write_pos = 0;
+        }
+        if (write_pos == buffer.size()) {
+            if (read_pos) {
+                const auto unread = write_pos - read_pos;
+                memmove(buffer.data(), buffer.data() + read_pos, unread);
+                scan_pos -= read_pos;
+                write_pos = unread;
+                read_pos = 0;
+            }
+            else {
+                // The whole buffer is one line with no end in sight; drop it and skip the rest of it as it arrives
+                read_pos = scan_pos = write_pos = 0;
+                discarding = true;
+            }
+        }
+        return std::span(buffer).subspan(write_pos);
+    }
+
+    void LineFramer::Commit(const size_t length)
+    {
+        write_pos = std::min(write_pos + length, buffer.size());
+    }
+
+    bool LineFramer::NextLine(std::string_view& line)
+    {
+        while (scan_pos < write_pos) {
+            const auto found = static_cast<const char*>(memchr(buffer.data() + scan_pos, '\n', write_pos - scan_pos));
+            if (!found) {
+                // Still inside a dropped line; nothing here is worth keeping
+                scan_pos = write_pos;
+                if (discarding) {
+                    read_pos = write_pos;
+                }
+                break;
+            }
+            const auto line_start = read_pos;
+            auto line_end = static_cast<size_t>(found - buffer.data());
+            read_pos = scan_pos = line_end + 1;
+            if (discarding) {
+                discarding = false;
+                continue;
+            }
+            if (line_end > line_start && buffer[line_end - 1] == '\r') {
+                line_end--;
+            }
+            if (line_end == line_start) {
+                continue;
+            }
+            line = {buffer.data() + line_start, line_end - line_start};
+            return true;
+        }
+        return false;
+    }
+
+    void LineFramer::Clear()
+    {
+        read_pos = scan_pos = write_pos = 0;
+        discarding = false;
+    }
+}
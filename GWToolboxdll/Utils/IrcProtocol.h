@@ -0,0 +1,68 @@
+#pragma once
+
+#include <span>
+
+/*
+Framing and parsing for the IRC wire protocol, including the IRCv3 message tags that Twitch sends ahead of each line.
+
+LineFramer buffers whatever recv hands it and yields complete lines, so a line split across two reads comes out whole. Unread
+bytes are only moved back to the front of the buffer when the write space runs out, so each line is one contiguous view and the
+buffer never grows. A line too long for the buffer, twice max_line_length, is dropped rather than cut in two.
+
+Parse splits a line into tags, prefix, command and params as views into the line; nothing is copied or allocated, so the views
+are only good for as long as the line is.
+*/
+namespace IrcProtocol {
+    struct Message {
+        static constexpr size_t max_params = 15;
+
+        // Raw "key=value;key2" list without the leading '@'; values are still escaped
+        std::string_view tags;
+        // Everything between ':' and the first space, and the nick!user@host parts of it
+        std::string_view prefix;
+        std::string_view nick;
+        std::string_view user;
+        std::string_view host;
+        std::string_view command;
+        // Everything after the command as sent, e.g. "#channel :hello there"
+        std::string_view raw_params;
+        // Split params; the trailing one has its ':' removed and may contain spaces
+        std::array<std::string_view, max_params> params{};
+        size_t param_count = 0;
+
+        [[nodiscard]] std::string_view Param(const size_t index) const { return index < param_count ? params[index] : std::string_view{}; }
+        [[nodiscard]] std::string_view Trailing() const { return param_count ? params[param_count - 1] : std::string_view{}; }
+        [[nodiscard]] std::string_view GetTag(std::string_view key) const;
+    };
+
+    // Returns false if the line has no command
+    bool Parse(std::string_view line, Message& out);
+
+    // Escaped value of key in a raw tag list, or empty if it isn't there or has no value
+    std::string_view FindTag(std::string_view tags, std::string_view key);
+    void UnescapeTagValue(std::string_view value, std::string& out);
+
+    class LineFramer {
+    public:
+        // 8191 bytes of tags plus a 512 byte message, per the IRCv3 spec
+        static constexpr size_t max_line_length = 8191 + 512;
+
+        LineFramer();
+
+        // Space to recv into; call Commit with the number of bytes written. Invalidates lines returned by NextLine.
+        std::span<char> WriteSpace();
+        void Commit(size_t length);
+        // Next complete line without its "\r\n", skipping empty ones. Returns false once no complete line is buffered.
+        bool NextLine(std::string_view& line);
+        void Clear();
+
+    private:
+        std::vector<char> buffer;
+        size_t read_pos = 0;
+        // Where to resume looking for '\n'; everything in [read_pos, scan_pos) is known not to contain one
+        size_t scan_pos = 0;
+        size_t write_pos = 0;
+        // Set after an overlong line was thrown away, until the end of it has been skipped
+        bool discarding = false;
+    };
+}
@@ -0,0 +1,537 @@
+// Standard headers only, rather than stdafx.h, so this builds outside the dll too; see tests/PacketCapture
+#include <Utils/PacketCapture.h>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+    enum class FieldType {
+        Ignore,
+        AgentId,
+        Float,
+        Vect2,
+        Vect3,
+        Byte,
+        Word,
+        Dword,
+        Blob,
+        String16,
+        Array8,
+        Array16,
+        Array32,
+        NestedStruct,
+        Count
+    };
+
+    FieldType GetField(const uint32_t type, const uint32_t size, const uint32_t count)
+    {
+        switch (type) {
+            case 0:
+                return FieldType::AgentId;
+            case 1:
+                return FieldType::Float;
+            case 2:
+                return FieldType::Vect2;
+            case 3:
+                return FieldType::Vect3;
+            case 4:
+            case 8:
+                switch (count) {
+                    case 1:
+                        return FieldType::Byte;
+                    case 2:
+                        return FieldType::Word;
+                    case 4:
+                        return FieldType::Dword;
+                }
+                [[fallthrough]];
+            case 5:
+            case 9:
+                return FieldType::Blob;
+            case 6:
+            case 10:
+                return FieldType::Ignore;
+            case 7:
+                return FieldType::String16;
+            case 11:
+                switch (size) {
+                    case 1:
+                        return FieldType::Array8;
+                    case 2:
+                        return FieldType::Array32;
+                    case 4:
+                        return FieldType::Array32;
+                }
+                [[fallthrough]];
+            case 12:
+                return FieldType::NestedStruct;
+        }
+        return FieldType::Count;
+    }
+
+    // Reads through packet bytes without running off the end; anything past the end reads as 0
+    struct Cursor {
+        const uint8_t* pos;
+        const uint8_t* end;
+        bool overrun = false;
+
+        template <typename T>
+        T Read()
+        {
+            T val{};
+            if (static_cast<size_t>(end - pos) < sizeof(T)) {
+                overrun = true;
+                pos = end;
+                return val;
+            }
+            memcpy(&val, pos, sizeof(T));
+            pos += sizeof(T);
+            return val;
+        }
+
+        // Moves to target, or to the end if target is past it. Arrays jump to their declared end, whatever they held.
+        void SkipTo(const uint8_t* target)
+        {
+            if (target > end) {
+                overrun = true;
+                pos = end;
+            }
+            else {
+                pos = target;
+            }
+        }
+    };
+
+    void Appendf(std::string* out, const uint32_t indent, const char* format, ...)
+    {
+        if (!out) {
+            return;
+        }
+        out->append(indent, ' ');
+        char buf[256];
+        va_list args;
+        va_start(args, format);
+        const auto len = vsnprintf(buf, sizeof(buf), format, args);
+        va_end(args);
+        if (len > 0) {
+            out->append(buf, std::min(static_cast<size_t>(len), sizeof(buf) - 1));
+        }
+    }
+
+    // Walks one field, printing it to out if out isn't null
+    void WalkField(const FieldType field, const uint32_t count, Cursor& cursor, const uint32_t indent, std::string* out)
+    {
+        switch (field) {
+            case FieldType::AgentId:
+                Appendf(out, indent, "AgentId(%u)\n", cursor.Read<uint32_t>());
+                break;
+            case FieldType::Float:
+                Appendf(out, indent, "Float(%f)\n", cursor.Read<float>());
+                break;
+            case FieldType::Vect2: {
+                const auto x = cursor.Read<float>();
+                const auto y = cursor.Read<float>();
+                Appendf(out, indent, "Vect2(%f, %f)\n", x, y);
+            } break;
+            case FieldType::Vect3: {
+                const auto x = cursor.Read<float>();
+                const auto y = cursor.Read<float>();
+                const auto z = cursor.Read<float>();
+                Appendf(out, indent, "Vect3(%f, %f, %f)\n", x, y, z);
+            } break;
+            case FieldType::Byte:
+                Appendf(out, indent, "Byte(%u)\n", cursor.Read<uint32_t>());
+                break;
+            case FieldType::Word:
+                Appendf(out, indent, "Word(%u)\n", cursor.Read<uint32_t>());
+                break;
+            case FieldType::Dword:
+                Appendf(out, indent, "Dword(%u)\n", cursor.Read<uint32_t>());
+                break;
+            case FieldType::Blob:
+                if (!out) {
+                    cursor.SkipTo(cursor.pos + count);
+                    break;
+                }
+                Appendf(out, indent, "Blob(%u) => ", count);
+                for (auto i = 0u; i < count && !cursor.overrun; i++) {
+                    Appendf(out, 0, "%02X ", cursor.Read<uint8_t>());
+                }
+                Appendf(out, 0, "\n");
+                break;
+            case FieldType::String16: {
+                const auto str = cursor.pos;
+                cursor.SkipTo(cursor.pos + count * 2);
+                if (!out) {
+                    break;
+                }
+                size_t length = 0;
+                while (length < count && str + length * 2 + 2 <= cursor.pos && (str[length * 2] || str[length * 2 + 1])) {
+                    length++;
+                }
+                Appendf(out, indent, "String(%zu) \"", length);
+                for (size_t i = 0; i < length; i++) {
+                    Appendf(out, 0, i > 0 ? " %04x" : "%04x", str[i * 2] | str[i * 2 + 1] << 8);
+                }
+                Appendf(out, 0, "\"\n");
+            } break;
+            case FieldType::Array8: {
+                const auto end = cursor.pos + count;
+                const auto length = cursor.Read<uint32_t>();
+                Appendf(out, indent, "Array8(%u) {\n", length);
+                for (size_t i = 0; out && i < length && !cursor.overrun; i++) {
+                    const auto val = cursor.Read<uint8_t>();
+                    Appendf(out, indent + 4, "[%zu] => %u,\n", i, val);
+                }
+                Appendf(out, 0, "}\n");
+                cursor.SkipTo(end);
+            } break;
+            case FieldType::Array16: {
+                const auto length = cursor.Read<uint32_t>();
+                const auto end = cursor.pos + count * 2;
+                Appendf(out, indent, "Array16(%u of %u) {\n", length, count);
+                for (size_t i = 0; out && length < 64 && i < length && !cursor.overrun; i++) {
+                    const auto val = cursor.Read<uint16_t>();
+                    Appendf(out, indent + 4, "[%zu] => %u,\n", i, val);
+                }
+                Appendf(out, 0, "}\n");
+                cursor.SkipTo(end);
+            } break;
+            case FieldType::Array32: {
+                const auto length = cursor.Read<uint32_t>();
+                const auto end = cursor.pos + count * 4;
+                Appendf(out, indent, "Array32(%u of %u) {\n", length, count);
+                for (size_t i = 0; out && length < 128 && i < length && !cursor.overrun; i++) {
+                    const auto val = cursor.Read<uint32_t>();
+                    Appendf(out, indent + 4, "[%zu] => %u,\n", i, val);
+                }
+                Appendf(out, 0, "}\n");
+                cursor.SkipTo(end);
+            } break;
+            default:
+                break;
+        }
+    }
+
+    void WalkNestedFields(const std::span<const uint32_t> fields, const uint32_t repeat, Cursor& cursor, const uint32_t indent, std::string* out)
+    {
+        for (uint32_t rep = 0; rep < repeat && !cursor.overrun; rep++) {
+            Appendf(out, indent, "[%u] => {\n", rep);
+            for (size_t i = 0; i < fields.size(); i++) {
+                const uint32_t field = fields[i];
+                const uint32_t type = field >> 0 & 0xF;
+                const uint32_t size = field >> 4 & 0xF;
+                const uint32_t count = field >> 8 & 0xFFFF;
+
+                const FieldType field_type = GetField(type, size, count);
+                // e.g. the end of an array
+                if (field_type == FieldType::Ignore) {
+                    continue;
+                }
+                if (field_type != FieldType::NestedStruct) {
+                    WalkField(field_type, count, cursor, indent + 4, out);
+                    continue;
+                }
+                const auto struct_count = cursor.Read<uint32_t>();
+                Appendf(out, indent + 4, "NextedStruct(%u) {\n", struct_count);
+                WalkNestedFields(fields.subspan(i + 1), struct_count, cursor, indent + 8, out);
+                Appendf(out, indent + 4, "}\n");
+                // Guild Wars always has the nested struct last, and only one of them
+                break;
+            }
+            Appendf(out, indent, "}\n");
+        }
+    }
+}
+
+namespace PacketCapture {
+    void Schema::Clear()
+    {
+        ranges.clear();
+        fields.clear();
+    }
+
+    void Schema::Add(const uint32_t packet_header, const std::span<const uint32_t> packet_fields)
+    {
+        if (packet_header >= ranges.size()) {
+            ranges.resize(packet_header + 1);
+        }
+        ranges[packet_header] = {static_cast<uint32_t>(fields.size()), static_cast<uint32_t>(packet_fields.size())};
+        fields.insert(fields.end(), packet_fields.begin(), packet_fields.end());
+    }
+
+    std::span<const uint32_t> Schema::GetFields(const uint32_t packet_header) const
+    {
+        if (packet_header >= ranges.size()) {
+            return {};
+        }
+        const auto [offset, count] = ranges[packet_header];
+        return std::span(fields).subspan(offset, count);
+    }
+
+    void Schema::Serialize(std::vector<uint8_t>& out) const
+    {
+        const auto append = [&out](const uint32_t value) {
+            const auto bytes = reinterpret_cast<const uint8_t*>(&value);
+            out.insert(out.end(), bytes, bytes + sizeof(value));
+        };
+        append(static_cast<uint32_t>(ranges.size()));
+        for (uint32_t packet_header = 0; packet_header < ranges.size(); packet_header++) {
+            const auto packet_fields = GetFields(packet_header);
+            append(static_cast<uint32_t>(packet_fields.size()));
+            for (const auto field : packet_fields) {
+                append(field);
+            }
+        }
+    }
+
+    bool Schema::Deserialize(const std::span<const uint8_t> in)
+    {
+        Clear();
+        Cursor cursor{in.data(), in.data() + in.size()};
+        const auto packet_count = cursor.Read<uint32_t>();
+        std::vector<uint32_t> packet_fields;
+        for (uint32_t packet_header = 0; packet_header < packet_count && !cursor.overrun; packet_header++) {
+            const auto field_count = cursor.Read<uint32_t>();
+            if (field_count > static_cast<size_t>(cursor.end - cursor.pos) / sizeof(uint32_t)) {
+                cursor.overrun = true;
+                break;
+            }
+            packet_fields.resize(field_count);
+            for (auto& field : packet_fields) {
+                field = cursor.Read<uint32_t>();
+            }
+            Add(packet_header, packet_fields);
+        }
+        if (cursor.overrun) {
+            Clear();
+            return false;
+        }
+        return true;
+    }
+
+    bool Filter::Matches(const RecordHeader& header) const
+    {
+        if (!(header.direction == Direction::StoC ? show_stoc : show_ctos)) {
+            return false;
+        }
+        if (header.time_ms < min_time_ms || header.time_ms > max_time_ms) {
+            return false;
+        }
+        return packet_headers.empty() || (header.packet_header < packet_headers.size() && packet_headers[header.packet_header]);
+    }
+
+    bool Filter::SetPacketHeaders(std::string_view list)
+    {
+        std::vector<bool> headers;
+        const auto parse_number = [](std::string_view str, uint32_t& out) {
+            while (!str.empty() && str.front() == ' ') {
+                str.remove_prefix(1);
+            }
+            while (!str.empty() && str.back() == ' ') {
+                str.remove_suffix(1);
+            }
+            int base = 10;
+            if (str.starts_with("0x") || str.starts_with("0X")) {
+                str.remove_prefix(2);
+                base = 16;
+            }
+            const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), out, base);
+            return !str.empty() && ec == std::errc() && ptr == str.data() + str.size() && out < 0x10000;
+        };
+        while (!list.empty()) {
+            const auto comma = list.find(',');
+            const auto item = list.substr(0, comma);
+            list = comma == std::string_view::npos ? std::string_view{} : list.substr(comma + 1);
+            if (item.find_first_not_of(' ') == std::string_view::npos) {
+                continue;
+            }
+            const auto dash = item.find('-');
+            uint32_t first = 0;
+            uint32_t last = 0;
+            if (!parse_number(item.substr(0, dash), first)) {
+                return false;
+            }
+            last = first;
+            if (dash != std::string_view::npos && (!parse_number(item.substr(dash + 1), last) || last < first)) {
+                return false;
+            }
+            if (last >= headers.size()) {
+                headers.resize(last + 1);
+            }
+            for (auto i = first; i <= last; i++) {
+                headers[i] = true;
+            }
+        }
+        packet_headers = std::move(headers);
+        return true;
+    }
+
+    bool Reader::Open(const std::span<const uint8_t> file)
+    {
+        bytes = {};
+        schema.Clear();
+        if (file.size() < sizeof(FileHeader)) {
+            return false;
+        }
+        memcpy(&file_header, file.data(), sizeof(file_header));
+        if (memcmp(file_header.magic, file_magic, sizeof(file_magic)) != 0 || file_header.version != file_version) {
+            return false;
+        }
+        if (file_header.schema_offset > file.size() || file_header.schema_size > file.size() - file_header.schema_offset || file_header.records_offset > file.size()) {
+            return false;
+        }
+        if (!schema.Deserialize(file.subspan(file_header.schema_offset, file_header.schema_size))) {
+            return false;
+        }
+        bytes = file;
+        return true;
+    }
+
+    bool Reader::Read(const size_t offset, Record& out) const
+    {
+        const auto start = file_header.records_offset + offset;
+        if (start > bytes.size() || bytes.size() - start < sizeof(RecordHeader)) {
+            return false;
+        }
+        memcpy(&out.header, bytes.data() + start, sizeof(RecordHeader));
+        if (!out.header.size || out.header.size > bytes.size() - start - sizeof(RecordHeader)) {
+            return false;
+        }
+        out.data = bytes.subspan(start + sizeof(RecordHeader), out.header.size);
+        out.offset = offset;
+        return true;
+    }
+
+    bool Reader::Next(size_t& offset, Record& out) const
+    {
+        if (!Read(offset, out)) {
+            return false;
+        }
+        offset += RecordSpan(out.header.size);
+        return true;
+    }
+
+    std::vector<size_t> Reader::Index(const Filter& filter) const
+    {
+        std::vector<size_t> offsets;
+        Record record;
+        for (size_t offset = 0; Next(offset, record);) {
+            if (filter.Matches(record.header)) {
+                offsets.push_back(record.offset);
+            }
+        }
+        return offsets;
+    }
+
+    uint32_t MeasurePacket(const std::span<const uint32_t> fields, const uint8_t* packet, bool* truncated)
+    {
+        Cursor cursor{packet, packet + max_packet_size};
+        cursor.Read<uint32_t>();
+        if (!fields.empty()) {
+            WalkNestedFields(fields.subspan(1), 1, cursor, 0, nullptr);
+        }
+        if (truncated) {
+            *truncated = cursor.overrun;
+        }
+        return static_cast<uint32_t>(cursor.pos - packet);
+    }
+
+    void FormatPacket(const std::span<const uint32_t> fields, const std::span<const uint8_t> packet, std::string& out, const uint32_t indent)
+    {
+        Cursor cursor{packet.data(), packet.data() + packet.size()};
+        cursor.Read<uint32_t>();
+        if (!fields.empty()) {
+            WalkNestedFields(fields.subspan(1), 1, cursor, indent, &out);
+        }
+        if (cursor.overrun) {
+            Appendf(&out, indent, "<packet ends early>\n");
+        }
+    }
+
+    void FormatHex(const std::span<const uint8_t> packet, std::string& out)
+    {
+        for (size_t i = 0; i < packet.size(); i++) {
+            Appendf(&out, 0, i % 16 == 15 || i + 1 == packet.size() ? "%02X\n" : "%02X ", packet[i]);
+        }
+    }
+
+#ifdef _WIN32
+    bool Writer::Open(const wchar_t* path, const Schema& schema, const size_t file_capacity)
+    {
+        Close();
+        std::vector<uint8_t> schema_bytes;
+        schema.Serialize(schema_bytes);
+        const auto records_offset = (sizeof(FileHeader) + schema_bytes.size() + 3) & ~static_cast<size_t>(3);
+        if (file_capacity < records_offset + sizeof(RecordHeader)) {
+            return false;
+        }
+
+        file = CreateFileW(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        const auto size = static_cast<uint64_t>(file_capacity);
+        mapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(size >> 32), static_cast<DWORD>(size), nullptr);
+        view = mapping ? static_cast<uint8_t*>(MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, file_capacity)) : nullptr;
+        if (!view) {
+            Close();
+            return false;
+        }
+        capacity = file_capacity;
+        start_time_ms = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+
+        FileHeader header{};
+        memcpy(header.magic, file_magic, sizeof(file_magic));
+        header.version = file_version;
+        header.schema_offset = sizeof(FileHeader);
+        header.schema_size = static_cast<uint32_t>(schema_bytes.size());
+        header.records_offset = static_cast<uint32_t>(records_offset);
+        header.start_time_ms = start_time_ms;
+        memcpy(view, &header, sizeof(header));
+        memcpy(view + header.schema_offset, schema_bytes.data(), schema_bytes.size());
+        used = records_offset;
+        return true;
+    }
+
+    bool Writer::Append(const RecordHeader& header, const uint8_t* data)
+    {
+        const auto span = RecordSpan(header.size);
+        // Keep room for the zeroed header that ends the records
+        if (!view || !header.size || capacity - used < span + sizeof(RecordHeader)) {
+            return false;
+        }
+        // Data first, so a reader looking at the file mid-write sees a size of 0 and stops
+        memcpy(view + used + sizeof(RecordHeader), data, header.size);
+        memcpy(view + used, &header, sizeof(header));
+        used += span;
+        return true;
+    }
+
+    void Writer::Close()
+    {
+        if (view) {
+            UnmapViewOfFile(view);
+            view = nullptr;
+        }
+        if (mapping) {
+            CloseHandle(mapping);
+            mapping = nullptr;
+        }
+        if (file != INVALID_HANDLE_VALUE) {
+            // The mapping made the file its full capacity; cut off what wasn't used, keeping one empty header as the terminator
+            LARGE_INTEGER end;
+            end.QuadPart = static_cast<LONGLONG>(used ? used + sizeof(RecordHeader) : 0);
+            SetFilePointerEx(file, end, nullptr, FILE_BEGIN);
+            SetEndOfFile(file);
+            CloseHandle(file);
+            file = INVALID_HANDLE_VALUE;
+        }
+        capacity = used = 0;
+    }
+#endif
+}
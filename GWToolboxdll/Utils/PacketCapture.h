@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+/*
+Binary capture of game packets, for when printing every packet as text as it arrives is too slow.
+
+A capture file is a FileHeader, then the field layout of every StoC packet as the game describes it (the Schema), then one
+record per packet: a RecordHeader followed by the packet's raw bytes, padded to 4. A record with size 0, or the end of the file,
+ends the records. Because the layout travels with the file, captures can be decoded long after the game has been patched.
+
+The reader and the formatter only need the standard library, so they build anywhere (tests/PacketCapture checks them on the
+host); the Writer is Windows only and appends records to a memory mapped file, so capturing a packet costs a walk over its field
+layout to size it and a memcpy.
+*/
+namespace PacketCapture {
+    constexpr char file_magic[8] = {'G', 'W', 'T', 'B', 'P', 'C', 'A', 'P'};
+    constexpr uint32_t file_version = 1;
+    // Packets bigger than this are cut short and flagged
+    constexpr uint32_t max_packet_size = 0x10000;
+
+    enum class Direction : uint8_t {
+        StoC,
+        CtoS
+    };
+
+    enum RecordFlags : uint8_t {
+        RecordFlag_Truncated = 1
+    };
+
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t schema_offset;
+        uint32_t schema_size;
+        uint32_t records_offset;
+        // Unix time in ms when the capture started; record times are relative to this
+        uint64_t start_time_ms;
+    };
+
+    struct RecordHeader {
+        // Bytes of packet data that follow, not counting padding. 0 ends the records.
+        uint32_t size;
+        uint32_t time_ms;
+        uint16_t packet_header;
+        Direction direction;
+        uint8_t flags;
+    };
+
+    static_assert(sizeof(FileHeader) == 32 && sizeof(RecordHeader) == 12);
+
+    constexpr size_t RecordSpan(const size_t size) { return sizeof(RecordHeader) + ((size + 3) & ~static_cast<size_t>(3)); }
+
+    struct Record {
+        RecordHeader header;
+        // The whole packet as it was in memory, starting with its header dword
+        std::span<const uint8_t> data;
+        size_t offset;
+    };
+
+    // Field layout of each StoC packet, indexed by packet header
+    class Schema {
+    public:
+        void Clear();
+        void Add(uint32_t packet_header, std::span<const uint32_t> fields);
+        [[nodiscard]] std::span<const uint32_t> GetFields(uint32_t packet_header) const;
+        [[nodiscard]] size_t size() const { return ranges.size(); }
+
+        void Serialize(std::vector<uint8_t>& out) const;
+        bool Deserialize(std::span<const uint8_t> in);
+
+    private:
+        // Offset and count into fields per packet header
+        std::vector<std::pair<uint32_t, uint32_t>> ranges;
+        std::vector<uint32_t> fields;
+    };
+
+    struct Filter {
+        // Empty to show every packet header
+        std::vector<bool> packet_headers;
+        bool show_stoc = true;
+        bool show_ctos = true;
+        uint32_t min_time_ms = 0;
+        uint32_t max_time_ms = 0xFFFFFFFF;
+
+        [[nodiscard]] bool Matches(const RecordHeader& header) const;
+        // Parses e.g. "12, 30-35, 0x94"; returns false and leaves the filter alone on a syntax error
+        bool SetPacketHeaders(std::string_view list);
+    };
+
+    class Reader {
+    public:
+        // The bytes must outlive the reader
+        bool Open(std::span<const uint8_t> file);
+
+        [[nodiscard]] const FileHeader& GetFileHeader() const { return file_header; }
+        [[nodiscard]] const Schema& GetSchema() const { return schema; }
+
+        // Reads the record at offset and moves offset on to the next one. Start with offset = 0.
+        bool Next(size_t& offset, Record& out) const;
+        [[nodiscard]] bool Read(size_t offset, Record& out) const;
+        // Offsets of every record that matches
+        [[nodiscard]] std::vector<size_t> Index(const Filter& filter) const;
+
+    private:
+        std::span<const uint8_t> bytes;
+        FileHeader file_header{};
+        Schema schema;
+    };
+
+    // Size in bytes of a packet with the given layout, including its header dword; reads array and struct counts from packet
+    [[nodiscard]] uint32_t MeasurePacket(std::span<const uint32_t> fields, const uint8_t* packet, bool* truncated = nullptr);
+    // Appends one line per field, nested the same way the packet logger prints packet content
+    void FormatPacket(std::span<const uint32_t> fields, std::span<const uint8_t> packet, std::string& out, uint32_t indent = 4);
+    // Appends the packet as rows of hex bytes
+    void FormatHex(std::span<const uint8_t> packet, std::string& out);
+
+#ifdef _WIN32
+    // Appends records to a memory mapped file of fixed capacity, which is trimmed to what was used on Close
+    class Writer {
+    public:
+        Writer() = default;
+        Writer(const Writer&) = delete;
+        ~Writer() { Close(); }
+
+        bool Open(const wchar_t* path, const Schema& schema, size_t capacity);
+        // Returns false without writing anything if the record doesn't fit; Close and Open the next file
+        bool Append(const RecordHeader& header, const uint8_t* data);
+        void Close();
+
+        [[nodiscard]] bool IsOpen() const { return view != nullptr; }
+        [[nodiscard]] size_t GetUsed() const { return used; }
+        [[nodiscard]] uint64_t GetStartTime() const { return start_time_ms; }
+
+    private:
+        HANDLE file = INVALID_HANDLE_VALUE;
+        HANDLE mapping = nullptr;
+        uint8_t* view = nullptr;
+        size_t capacity = 0;
+        size_t used = 0;
+        uint64_t start_time_ms = 0;
+    };
+#endif
+}
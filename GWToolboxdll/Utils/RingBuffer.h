@@ -0,0 +1,244 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <span>
+
+#pragma warning(push)
+#pragma warning(disable : 4324) // structure was padded due to alignment specifier
+
+/*
+Ring buffers for the three ways toolbox moves streams of data around:
+
+Ring<T>      - single threaded history (e.g. the last N trade messages). Overwrites the oldest element once full.
+SpscRing<T>  - bounded lock-free queue between exactly one producer thread and one consumer thread.
+MpscRing<T>  - bounded lock-free queue for any number of producer threads (e.g. hooks or logging) and one consumer thread.
+
+Ring holds exactly the capacity it's given, since that's how much history callers see. The two queues round theirs up to a power
+of two so that their free-running cursors can be masked rather than taken modulo; they only promise at least that much room.
+*/
+
+template <typename T>
+class Ring {
+public:
+    explicit Ring(const size_t capacity)
+        : cap(capacity < 1 ? size_t{1} : capacity)
+        , slots(std::make_unique<T[]>(cap)) { }
+
+    Ring(Ring&&) noexcept = default;
+    Ring& operator=(Ring&&) noexcept = default;
+
+    // Append, overwriting the oldest element if the ring is full
+    T& add(const T& val)
+    {
+        T copy = val;
+        return add(std::move(copy));
+    }
+
+    T& add(T&& val)
+    {
+        T& slot = slots[Wrap(head + count)];
+        slot = std::move(val);
+        if (count == cap) {
+            head = Wrap(head + 1);
+        }
+        else {
+            count++;
+        }
+        return slot;
+    }
+
+    // Index 0 is the oldest element, size() - 1 the newest
+    T& operator[](const size_t index)
+    {
+        ASSERT(index < count);
+        return slots[Wrap(head + index)];
+    }
+
+    const T& operator[](const size_t index) const
+    {
+        ASSERT(index < count);
+        return slots[Wrap(head + index)];
+    }
+
+    // The contents, oldest first, as at most two contiguous runs. Handy for ImGuiListClipper, which wants random access by row.
+    [[nodiscard]] std::pair<std::span<T>, std::span<T>> spans()
+    {
+        const size_t first_len = std::min(count, capacity() - head);
+        return {std::span<T>(slots.get() + head, first_len), std::span<T>(slots.get(), count - first_len)};
+    }
+
+    void clear() { head = 0, count = 0; }
+    [[nodiscard]] size_t size() const { return count; }
+    [[nodiscard]] bool empty() const { return count == 0; }
+    [[nodiscard]] bool full() const { return count == capacity(); }
+    [[nodiscard]] size_t capacity() const { return cap; }
+
+private:
+    // i is less than twice the capacity
+    [[nodiscard]] size_t Wrap(const size_t i) const { return i >= cap ? i - cap : i; }
+
+    size_t cap;
+    std::unique_ptr<T[]> slots;
+    size_t head = 0;  // slot of the oldest element
+    size_t count = 0; // number of elements
+};
+
+/*
+Bounded lock-free queue for exactly one producer thread and one consumer thread.
+Read and write cursors live on separate cache lines so the two threads don't false-share.
+*/
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(const size_t capacity)
+        : mask(std::bit_ceil(capacity < 2 ? size_t{2} : capacity) - 1)
+        , slots(new T[mask + 1]) { }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    ~SpscRing() noexcept
+    {
+        delete[] slots;
+    }
+
+    // Producer only. Returns false if the ring is full.
+    bool try_push(T&& val)
+    {
+        const size_t w = write_pos.load(std::memory_order_relaxed);
+        if (w - read_pos.load(std::memory_order_acquire) > mask) {
+            return false;
+        }
+        slots[w & mask] = std::move(val);
+        write_pos.store(w + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(const T& val)
+    {
+        T copy = val;
+        return try_push(std::move(copy));
+    }
+
+    // Consumer only. Returns false if the ring is empty.
+    bool try_pop(T& out)
+    {
+        const size_t r = read_pos.load(std::memory_order_relaxed);
+        if (r == write_pos.load(std::memory_order_acquire)) {
+            return false;
+        }
+        out = std::move(slots[r & mask]);
+        read_pos.store(r + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate when called from a thread other than the producer or consumer.
+    [[nodiscard]] size_t size() const
+    {
+        return write_pos.load(std::memory_order_acquire) - read_pos.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] bool empty() const { return size() == 0; }
+    [[nodiscard]] size_t capacity() const { return mask + 1; }
+
+private:
+    const size_t mask;
+    T* const slots;
+    alignas(64) std::atomic<size_t> write_pos = 0;
+    alignas(64) std::atomic<size_t> read_pos = 0;
+};
+
+/*
+Bounded lock-free queue for many producer threads and one consumer thread.
+
+Each slot carries a sequence number that tells producers whether it is free for this lap of the ring, and the consumer whether it has been
+published yet, so producers only contend on the write cursor and never wait on each other's copies.
+*/
+template <typename T>
+class MpscRing {
+public:
+    explicit MpscRing(const size_t capacity)
+        : mask(std::bit_ceil(capacity < 2 ? size_t{2} : capacity) - 1)
+        , slots(new Slot[mask + 1])
+    {
+        for (size_t i = 0; i <= mask; i++) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    ~MpscRing() noexcept
+    {
+        delete[] slots;
+    }
+
+    // Any thread. Returns false if the ring is full.
+    bool try_push(T&& val)
+    {
+        Slot* slot;
+        size_t pos = write_pos.load(std::memory_order_relaxed);
+        while (true) {
+            slot = &slots[pos & mask];
+            const auto diff = static_cast<intptr_t>(slot->sequence.load(std::memory_order_acquire)) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (write_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            else if (diff < 0) {
+                return false; // Consumer hasn't freed this slot since the last lap
+            }
+            else {
+                pos = write_pos.load(std::memory_order_relaxed); // Another producer claimed it
+            }
+        }
+        slot->value = std::move(val);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(const T& val)
+    {
+        T copy = val;
+        return try_push(std::move(copy));
+    }
+
+    // Consumer only. Returns false if the ring is empty, or the next element is still being written.
+    bool try_pop(T& out)
+    {
+        const size_t pos = read_pos.load(std::memory_order_relaxed);
+        Slot& slot = slots[pos & mask];
+        if (slot.sequence.load(std::memory_order_acquire) != pos + 1) {
+            return false;
+        }
+        out = std::move(slot.value);
+        slot.sequence.store(pos + mask + 1, std::memory_order_release);
+        read_pos.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate; includes elements that are claimed but not yet published.
+    [[nodiscard]] size_t size() const
+    {
+        return write_pos.load(std::memory_order_acquire) - read_pos.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] bool empty() const { return size() == 0; }
+    [[nodiscard]] size_t capacity() const { return mask + 1; }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    const size_t mask;
+    Slot* const slots;
+    alignas(64) std::atomic<size_t> write_pos = 0;
+    alignas(64) std::atomic<size_t> read_pos = 0;
+};
+
+#pragma warning(pop)
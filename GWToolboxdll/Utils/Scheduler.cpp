@@ -0,0 +1,206 @@
+#include "stdafx.h"
+
+#include <condition_variable>
+
+#include <GWCA/Managers/GameThreadMgr.h>
+
+#include <Utils/Scheduler.h>
+
+namespace {
+    using Scheduler::Clock;
+    using Scheduler::Status;
+    using Scheduler::TaskPtr;
+
+    // Guards incoming, accepting, task status changes and continuations
+    std::mutex mutex;
+    std::condition_variable finished_cv;
+    // Started since the last Update
+    std::vector<TaskPtr> incoming;
+    bool accepting = true;
+    // Game thread only
+    std::deque<TaskPtr> run_queue;
+
+    // Steps of finished tasks, held until the lock is let go of. Whatever a step captured is destroyed with it, and a destructor
+    // that starts or chains a task would otherwise deadlock on the lock. Declare one before the lock_guard so it's destroyed after.
+    using ReleasedSteps = std::vector<Scheduler::StepFunction>;
+}
+
+namespace Scheduler {
+    struct Internal {
+        // With the lock held
+        static void Activate(const TaskPtr& task)
+        {
+            const auto now = Clock::now();
+            task->resume_at = now + task->options.delay;
+            if (task->options.timeout > Clock::duration::zero()) {
+                task->deadline = now + task->options.timeout;
+            }
+            incoming.push_back(task);
+        }
+
+        // With the lock held
+        static void Finish(const TaskPtr& task, const Status status, ReleasedSteps& released)
+        {
+            if (task->step) {
+                released.push_back(std::move(task->step));
+                task->step = nullptr;
+            }
+            task->status.store(status, std::memory_order_release);
+            const auto continuations = std::move(task->continuations);
+            task->continuations.clear();
+            for (const auto& next : continuations) {
+                if (status == Status::Done) {
+                    Activate(next);
+                }
+                else {
+                    Finish(next, status, released);
+                }
+            }
+            finished_cv.notify_all();
+        }
+
+        // With the lock held; what happens to a task that's just been made, or chained onto one that may have finished
+        static void Schedule(const TaskPtr& task, const Status after, ReleasedSteps& released)
+        {
+            if (!accepting) {
+                Finish(task, Status::Cancelled, released);
+            }
+            else if (after == Status::Done) {
+                Activate(task);
+            }
+            else {
+                Finish(task, after, released);
+            }
+        }
+
+        // Game thread; returns the status the task finished with, or Pending if it's to be called again
+        static Status RunStep(Task& task, const Clock::time_point now)
+        {
+            if (task.cancel_requested.load(std::memory_order_acquire)) {
+                return Status::Cancelled;
+            }
+            if (now >= task.deadline) {
+                return Status::TimedOut;
+            }
+            if (now < task.resume_at) {
+                return Status::Pending;
+            }
+            const auto step = task.step();
+            switch (step.kind) {
+                case Step::Kind::Done:
+                    return Status::Done;
+                case Step::Kind::Failed:
+                    return Status::Failed;
+                default:
+                    task.resume_at = step.resume_at;
+                    return Status::Pending;
+            }
+        }
+    };
+
+    Status Task::Wait() const
+    {
+        std::unique_lock lock(mutex);
+        finished_cv.wait(lock, [this] { return IsFinished(); });
+        return GetStatus();
+    }
+
+    Status Task::Wait(const Clock::duration timeout) const
+    {
+        std::unique_lock lock(mutex);
+        finished_cv.wait_for(lock, timeout, [this] { return IsFinished(); });
+        return GetStatus();
+    }
+
+    TaskPtr Task::Then(StepFunction next, const Options next_options)
+    {
+        auto task = std::make_shared<Task>(std::move(next), next_options);
+        ReleasedSteps released;
+        std::lock_guard lock(mutex);
+        if (!IsFinished() && accepting) {
+            continuations.push_back(task);
+        }
+        else {
+            Internal::Schedule(task, GetStatus(), released);
+        }
+        return task;
+    }
+
+    TaskPtr Start(StepFunction step, const Options options)
+    {
+        auto task = std::make_shared<Task>(std::move(step), options);
+        ReleasedSteps released;
+        std::lock_guard lock(mutex);
+        Internal::Schedule(task, Status::Done, released);
+        return task;
+    }
+
+    TaskPtr After(const Clock::duration delay, std::function<void()> f)
+    {
+        Options options;
+        options.delay = delay;
+        return Start([f = std::move(f)] {
+            f();
+            return Step::Done();
+        }, options);
+    }
+
+    bool RunAndWait(const std::function<void()>& f)
+    {
+        if (GW::GameThread::IsInGameThread()) {
+            f();
+            return true;
+        }
+        // f outlives the task, since a finished task never runs again and this doesn't return until it's finished
+        const auto task = Start([&f] {
+            f();
+            return Step::Done();
+        });
+        return task->Wait() == Status::Done;
+    }
+
+    void Update(const double budget_ms)
+    {
+        const auto started = Clock::now();
+        {
+            std::lock_guard lock(mutex);
+            run_queue.insert(run_queue.end(), incoming.begin(), incoming.end());
+            incoming.clear();
+        }
+        // Each task gets at most one step per frame; whatever the budget doesn't reach goes first next frame
+        const auto count = run_queue.size();
+        // A step can call Terminate, which empties the queue
+        for (size_t i = 0; i < count && !run_queue.empty(); i++) {
+            const auto now = Clock::now();
+            if (i && std::chrono::duration<double, std::milli>(now - started).count() >= budget_ms) {
+                break;
+            }
+            auto task = std::move(run_queue.front());
+            run_queue.pop_front();
+            const auto status = Internal::RunStep(*task, now);
+            if (status == Status::Pending) {
+                run_queue.push_back(std::move(task));
+                continue;
+            }
+            ReleasedSteps released;
+            std::lock_guard lock(mutex);
+            Internal::Finish(task, status, released);
+        }
+    }
+
+    void Terminate()
+    {
+        // Cancelled tasks never run again, so their captures are all that frees what they own
+        ReleasedSteps released;
+        std::lock_guard lock(mutex);
+        accepting = false;
+        for (const auto& task : run_queue) {
+            Internal::Finish(task, Status::Cancelled, released);
+        }
+        for (const auto& task : incoming) {
+            Internal::Finish(task, Status::Cancelled, released);
+        }
+        run_queue.clear();
+        incoming.clear();
+    }
+}
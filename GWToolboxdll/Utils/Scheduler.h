@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+
+/*
+Cooperative tasks on the game thread, run from GWToolbox::Update within a time budget per frame.
+
+A task is a step function that's called once per frame until it says it's finished; between steps it can yield to the next
+frame or sleep, so a job with many steps, or one that has to wait on the game, is written as a state machine that returns
+instead of a loop that blocks. Once the frame's budget is spent the remaining tasks wait for the next frame, picking up where
+this one stopped, so no frame pays for more than the budget plus one step.
+
+Tasks can be started from any thread. A task given a timeout is finished as TimedOut if it hasn't finished by then. Then()
+starts another task when one finishes successfully, and passes any other outcome down the chain instead. Threads other than the
+game thread can block on a task with Wait(), which is released when the task finishes, is cancelled, or the scheduler shuts down.
+*/
+namespace Scheduler {
+    using Clock = std::chrono::steady_clock;
+
+    enum class Status : uint8_t {
+        Pending,
+        Done,
+        Failed,
+        TimedOut,
+        Cancelled
+    };
+
+    // What a step function wants after this step
+    struct Step {
+        enum class Kind : uint8_t { Done, Failed, Yield };
+
+        Kind kind = Kind::Done;
+        Clock::time_point resume_at{};
+
+        static Step Done() { return {Kind::Done}; }
+        static Step Failed() { return {Kind::Failed}; }
+        // Call again next frame
+        static Step Yield() { return {Kind::Yield}; }
+        // Call again once this much time has passed
+        static Step Sleep(const Clock::duration duration) { return {Kind::Yield, Clock::now() + duration}; }
+    };
+
+    using StepFunction = std::function<Step()>;
+
+    struct Options {
+        // Finished as TimedOut if still running this long after it started; zero for no limit
+        Clock::duration timeout = Clock::duration::zero();
+        // First step no sooner than this
+        Clock::duration delay = Clock::duration::zero();
+    };
+
+    class Task {
+    public:
+        Task(StepFunction step, Options options)
+            : step(std::move(step)), options(options) { }
+
+        [[nodiscard]] Status GetStatus() const { return status.load(std::memory_order_acquire); }
+        [[nodiscard]] bool IsFinished() const { return GetStatus() != Status::Pending; }
+
+        // From any thread; the task is finished as Cancelled before its next step
+        void Cancel() { cancel_requested.store(true, std::memory_order_release); }
+        // Blocks until the task is finished; never call from the game thread, which is what runs it
+        Status Wait() const;
+        // As above, or until timeout has passed; Pending if it timed out
+        Status Wait(Clock::duration timeout) const;
+        // Starts next once this task is Done; if it ends any other way, next ends the same way without running
+        std::shared_ptr<Task> Then(StepFunction next, Options next_options = {});
+
+    private:
+        friend struct Internal;
+
+        StepFunction step;
+        Options options;
+        Clock::time_point resume_at{};
+        Clock::time_point deadline = Clock::time_point::max();
+        std::atomic<Status> status = Status::Pending;
+        std::atomic<bool> cancel_requested = false;
+        // Tasks waiting on this one; guarded by the scheduler's lock
+        std::vector<std::shared_ptr<Task>> continuations;
+    };
+
+    using TaskPtr = std::shared_ptr<Task>;
+
+    TaskPtr Start(StepFunction step, Options options = {});
+    // Runs f once on the game thread, after the delay
+    TaskPtr After(Clock::duration delay, std::function<void()> f);
+    // Runs f on the game thread and blocks until it has; runs it straight away if called from the game thread.
+    // False if it never ran because the scheduler shut down first.
+    bool RunAndWait(const std::function<void()>& f);
+
+    // Game thread, once per frame: runs steps that are due until budget_ms has passed; always runs at least one
+    void Update(double budget_ms);
+    // Game thread: cancels every task and refuses new ones, releasing anything waiting on them. Cancelled steps are destroyed without
+    // being called again.
+    void Terminate();
+}
@@ -0,0 +1,273 @@
+#pragma once
+
+#include <bit>
+#include <span>
+
+/*
+Lookup tables for fixed game data that the compiler builds, so they need no initialisation at startup and never touch the heap.
+
+PerfectHashMap takes a list of key/value pairs and finds a hash that sends every key to a slot of its own (hash and displace:
+keys are put in buckets by one hash, then each bucket, biggest first, gets the first seed that lands all of its keys in free
+slots). A lookup is one hash of the key, two array reads and one key compare, whether the key is there or not. Keys can be
+integers, enums or strings; where a key is listed twice the first entry wins, same as a find_if over the list would.
+
+CharMap is a flat two level table from one wchar_t to another, for remapping characters: the high byte picks a page of 256
+characters, and characters without a page or without an entry map to themselves.
+
+Building either is a compile time cost that grows with the number of keys, so keep them for tables of hundreds of entries, not
+tens of thousands. Check the result with a static_assert on Covers(), which also fails if a table couldn't be built.
+*/
+namespace StaticTable {
+    // Murmur3 finaliser
+    constexpr uint32_t Mix(uint32_t h)
+    {
+        h ^= h >> 16;
+        h *= 0x85EBCA6B;
+        h ^= h >> 13;
+        h *= 0xC2B2AE35;
+        h ^= h >> 16;
+        return h;
+    }
+
+    template <typename Key>
+    constexpr uint32_t KeyHash(const Key& key)
+    {
+        if constexpr (std::is_convertible_v<const Key&, std::string_view>) {
+            // FNV-1a
+            uint32_t h = 0x811C9DC5;
+            for (const auto c : std::string_view(key)) {
+                h = (h ^ static_cast<uint8_t>(c)) * 0x01000193;
+            }
+            return Mix(h);
+        }
+        else {
+            static_assert(std::is_integral_v<Key> || std::is_enum_v<Key>, "Keys must be integers, enums or strings");
+            const auto value = static_cast<uint64_t>(key);
+            return Mix(static_cast<uint32_t>(value) ^ Mix(static_cast<uint32_t>(value >> 32)));
+        }
+    }
+
+    template <typename Key, typename Value, size_t N>
+    class PerfectHashMap {
+        static_assert(N > 0 && N < 0x8000, "Slot indices are 16 bit");
+
+    public:
+        using Entry = std::pair<Key, Value>;
+
+        // At most half full, so most buckets find a seed within a few tries
+        static constexpr size_t slot_count = std::bit_ceil(N * 2);
+        // About 4 keys per bucket
+        static constexpr size_t bucket_count = std::bit_ceil(N / 4 + 1);
+
+        constexpr explicit PerfectHashMap(const std::array<Entry, N>& list)
+            : entries(list)
+        {
+            // Group entry indices by bucket, keeping list order within each bucket
+            std::array<uint32_t, N> hashes{};
+            std::array<uint32_t, bucket_count + 1> bucket_start{};
+            for (size_t i = 0; i < N; i++) {
+                hashes[i] = KeyHash(entries[i].first);
+                bucket_start[BucketOf(hashes[i]) + 1]++;
+            }
+            for (size_t b = 0; b < bucket_count; b++) {
+                bucket_start[b + 1] += bucket_start[b];
+            }
+            std::array<uint32_t, N> by_bucket{};
+            auto bucket_fill = bucket_start;
+            for (size_t i = 0; i < N; i++) {
+                by_bucket[bucket_fill[BucketOf(hashes[i])]++] = static_cast<uint32_t>(i);
+            }
+
+            // Duplicate keys always share a bucket; only the first of them gets a slot
+            std::array<bool, N> duplicate{};
+            for (size_t b = 0; b < bucket_count; b++) {
+                for (auto i = bucket_start[b]; i < bucket_start[b + 1]; i++) {
+                    for (auto j = bucket_start[b]; j < i && !duplicate[i]; j++) {
+                        duplicate[i] = hashes[by_bucket[i]] == hashes[by_bucket[j]] && entries[by_bucket[i]].first == entries[by_bucket[j]].first;
+                    }
+                }
+            }
+
+            // Biggest buckets first, while there's the most room for them; the rest are empty and need no seed
+            std::array<uint32_t, bucket_count> order{};
+            size_t bucket_order_count = 0;
+            uint32_t biggest_bucket = 0;
+            for (size_t b = 0; b < bucket_count; b++) {
+                biggest_bucket = std::max(biggest_bucket, bucket_start[b + 1] - bucket_start[b]);
+            }
+            for (auto size = biggest_bucket; size; size--) {
+                for (size_t b = 0; b < bucket_count; b++) {
+                    if (bucket_start[b + 1] - bucket_start[b] == size) {
+                        order[bucket_order_count++] = static_cast<uint32_t>(b);
+                    }
+                }
+            }
+
+            std::array<bool, slot_count> taken{};
+            std::array<size_t, N> placed{};
+            for (size_t o = 0; o < bucket_order_count; o++) {
+                const auto bucket = order[o];
+                const auto first = bucket_start[bucket];
+                const auto last = bucket_start[bucket + 1];
+                bool found = false;
+                for (uint32_t seed = 0; seed <= 0xFFFF && !found; seed++) {
+                    size_t placed_count = 0;
+                    found = true;
+                    for (auto i = first; i < last && found; i++) {
+                        if (duplicate[i]) {
+                            continue;
+                        }
+                        const auto slot = SlotOf(hashes[by_bucket[i]], seed);
+                        found = !taken[slot];
+                        if (found) {
+                            taken[slot] = true;
+                            placed[placed_count++] = slot;
+                        }
+                    }
+                    if (!found) {
+                        for (size_t p = 0; p < placed_count; p++) {
+                            taken[placed[p]] = false;
+                        }
+                        continue;
+                    }
+                    size_t p = 0;
+                    for (auto i = first; i < last; i++) {
+                        if (!duplicate[i]) {
+                            slots[placed[p++]] = static_cast<uint16_t>(by_bucket[i]);
+                        }
+                    }
+                    seeds[bucket] = static_cast<uint16_t>(seed);
+                }
+                if (!found) {
+                    return;
+                }
+            }
+            built = true;
+        }
+
+        // nullptr if the key isn't in the table
+        [[nodiscard]] constexpr const Value* find(const Key& key) const
+        {
+            const auto h = KeyHash(key);
+            // Empty slots point at entry 0, which only matches if key is entry 0's key, in which case it's the right answer
+            const auto& entry = entries[slots[SlotOf(h, seeds[BucketOf(h)])]];
+            return entry.first == key ? &entry.second : nullptr;
+        }
+
+        [[nodiscard]] constexpr bool contains(const Key& key) const { return find(key) != nullptr; }
+
+        // True if the table was built and every key in it can be found
+        [[nodiscard]] constexpr bool Covers() const
+        {
+            if (!built) {
+                return false;
+            }
+            for (const auto& entry : entries) {
+                if (!find(entry.first)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Entries in the order they were listed, duplicates included
+        [[nodiscard]] constexpr auto begin() const { return entries.begin(); }
+        [[nodiscard]] constexpr auto end() const { return entries.end(); }
+        [[nodiscard]] static constexpr size_t size() { return N; }
+
+    private:
+        static constexpr size_t BucketOf(const uint32_t h) { return h & (bucket_count - 1); }
+        static constexpr size_t SlotOf(const uint32_t h, const uint32_t seed) { return Mix(h ^ (seed * 0x9E3779B9)) & (slot_count - 1); }
+
+        std::array<Entry, N> entries;
+        std::array<uint16_t, bucket_count> seeds{};
+        std::array<uint16_t, slot_count> slots{};
+        bool built = false;
+    };
+
+    // Number of pages a CharMap needs for these rows
+    constexpr size_t CountPages(const std::span<const wchar_t* const> rows)
+    {
+        std::array<bool, 256> used{};
+        size_t count = 0;
+        for (const auto row : rows) {
+            for (auto c = row + 1; *c; c++) {
+                const auto page = static_cast<size_t>(*c) >> 8;
+                if (page < used.size() && !used[page]) {
+                    used[page] = true;
+                    count++;
+                }
+            }
+        }
+        return count;
+    }
+
+    template <size_t PageCount>
+    class CharMap {
+        static_assert(PageCount < 256, "Page numbers are 8 bit");
+
+    public:
+        constexpr CharMap() = default;
+
+        // Each row maps every character after its first to its first, e.g. L"aàá" maps à and á to a. Later rows win.
+        constexpr explicit CharMap(const std::span<const wchar_t* const> rows)
+        {
+            for (const auto row : rows) {
+                for (auto c = row + 1; *c; c++) {
+                    Set(*c, row[0]);
+                }
+            }
+        }
+
+        constexpr void Set(const wchar_t from, const wchar_t to)
+        {
+            auto& page = page_of[static_cast<size_t>(from) >> 8];
+            // Page 0 stays empty for every high byte that has no mappings
+            if (!page) {
+                page = ++used_pages;
+            }
+            pages[page][from & 0xFF] = to;
+        }
+
+        [[nodiscard]] constexpr wchar_t operator()(const wchar_t c) const
+        {
+            if constexpr (sizeof(wchar_t) > 2) {
+                if (static_cast<uint32_t>(c) > 0xFFFF) {
+                    return c;
+                }
+            }
+            const auto mapped = pages[page_of[static_cast<size_t>(c) >> 8]][c & 0xFF];
+            return mapped ? mapped : c;
+        }
+
+        // True if every character in rows maps to the first character of the last row it appears in
+        [[nodiscard]] constexpr bool Covers(const std::span<const wchar_t* const> rows) const
+        {
+            for (size_t i = 0; i < rows.size(); i++) {
+                for (auto c = rows[i] + 1; *c; c++) {
+                    if ((*this)(*c) != rows[i][0] && !InLaterRow(rows, i, *c)) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+    private:
+        static constexpr bool InLaterRow(const std::span<const wchar_t* const> rows, const size_t row, const wchar_t c)
+        {
+            for (auto i = row + 1; i < rows.size(); i++) {
+                for (auto other = rows[i] + 1; *other; other++) {
+                    if (*other == c) {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        std::array<uint8_t, 256> page_of{};
+        std::array<std::array<wchar_t, 256>, PageCount + 1> pages{};
+        uint8_t used_pages = 0;
+    };
+}
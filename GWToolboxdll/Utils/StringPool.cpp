@@ -0,0 +1,122 @@
+#include "stdafx.h"
+
+#include <atomic>
+
+#include <Utils/StringPool.h>
+#include <Utils/TextUtils.h>
+
+namespace {
+    using StringPool::Handle;
+
+    constexpr size_t chunk_size = 1024;
+    // 4 million names, far more than a session ever sees
+    constexpr size_t max_chunks = 4096;
+    constexpr Handle not_sanitized = 0xFFFFFFFF;
+
+    struct Entry {
+        std::wstring name_w;
+        std::string name;
+        std::atomic<Handle> sanitized = not_sanitized;
+    };
+
+    using Chunk = std::array<Entry, chunk_size>;
+
+    // Entries are filled in chunks that never move, so readers can index them while Intern adds more
+    struct Pool {
+        std::array<std::atomic<Chunk*>, max_chunks> chunks{};
+        // Handles below this are filled in; handle 0 is the empty name and never is
+        std::atomic<Handle> count = 1;
+        std::mutex mutex;
+        // Keys point into the entries
+        std::unordered_map<std::wstring_view, Handle> handles_by_name;
+
+        ~Pool()
+        {
+            for (auto& chunk : chunks) {
+                delete chunk.load();
+            }
+        }
+    } pool;
+
+    Entry* GetEntry(const Handle handle)
+    {
+        if (handle == StringPool::empty || handle >= pool.count.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &(*pool.chunks[handle / chunk_size].load(std::memory_order_acquire))[handle % chunk_size];
+    }
+}
+
+namespace StringPool {
+    Handle Intern(const std::wstring_view name)
+    {
+        if (name.empty()) {
+            return empty;
+        }
+        std::lock_guard lock(pool.mutex);
+        if (const auto found = pool.handles_by_name.find(name); found != pool.handles_by_name.end()) {
+            return found->second;
+        }
+        const auto handle = pool.count.load(std::memory_order_relaxed);
+        if (handle == chunk_size * max_chunks) {
+            return empty;
+        }
+        auto& chunk = pool.chunks[handle / chunk_size];
+        if (!chunk.load(std::memory_order_relaxed)) {
+            chunk.store(new Chunk(), std::memory_order_release);
+        }
+        auto& entry = (*chunk.load(std::memory_order_relaxed))[handle % chunk_size];
+        entry.name_w = name;
+        TextUtils::WStringToString(name, entry.name);
+        pool.handles_by_name.emplace(entry.name_w, handle);
+        pool.count.store(handle + 1, std::memory_order_release);
+        return handle;
+    }
+
+    Handle Find(const std::wstring_view name)
+    {
+        if (name.empty()) {
+            return empty;
+        }
+        std::lock_guard lock(pool.mutex);
+        const auto found = pool.handles_by_name.find(name);
+        return found == pool.handles_by_name.end() ? empty : found->second;
+    }
+
+    const std::wstring& GetW(const Handle handle)
+    {
+        static const std::wstring empty_name;
+        const auto entry = GetEntry(handle);
+        return entry ? entry->name_w : empty_name;
+    }
+
+    const std::string& Get(const Handle handle)
+    {
+        static const std::string empty_name;
+        const auto entry = GetEntry(handle);
+        return entry ? entry->name : empty_name;
+    }
+
+    Handle Sanitized(const Handle handle)
+    {
+        const auto entry = GetEntry(handle);
+        if (!entry) {
+            return empty;
+        }
+        auto sanitized = entry->sanitized.load(std::memory_order_acquire);
+        if (sanitized != not_sanitized) {
+            return sanitized;
+        }
+        // Two threads may both get here; they'll both come up with the same handle
+        std::wstring sanitized_name;
+        TextUtils::SanitizePlayerName(entry->name_w, sanitized_name);
+        sanitized = sanitized_name == entry->name_w ? handle : Intern(sanitized_name);
+        entry->sanitized.store(sanitized, std::memory_order_release);
+        return sanitized;
+    }
+
+    size_t Count()
+    {
+        return pool.count.load(std::memory_order_acquire);
+    }
+}
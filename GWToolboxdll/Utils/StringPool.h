@@ -0,0 +1,30 @@
+#pragma once
+
+/*
+One shared copy of each player, guild and map name, for modules that would otherwise each keep their own wstring and string of
+the same few thousand names for as long as the game runs.
+
+Intern hands out a 32-bit handle per distinct name; the same name always gets the same handle, so comparing two names is
+comparing two integers, and the empty name is always handle 0. The UTF-8 copy of a name is made once when it's interned, and
+the sanitized one (no guild tag, no trailing number) the first time anyone asks for it.
+
+Interning takes a lock, reading a name by handle doesn't. Names are never removed, so a handle and the strings it gives back
+stay good until the dll unloads. A handle passed to another thread needs the same synchronisation as any other value would.
+*/
+namespace StringPool {
+    using Handle = uint32_t;
+    constexpr Handle empty = 0;
+
+    Handle Intern(std::wstring_view name);
+    // The handle if the name has been interned already, otherwise empty; never adds anything
+    Handle Find(std::wstring_view name);
+
+    const std::wstring& GetW(Handle handle);
+    // UTF-8
+    const std::string& Get(Handle handle);
+    // Handle of TextUtils::SanitizePlayerName of this name
+    Handle Sanitized(Handle handle);
+
+    // Number of names interned, counting the empty one
+    size_t Count();
+}
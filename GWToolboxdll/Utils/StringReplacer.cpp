@@ -0,0 +1,142 @@
+#include "stdafx.h"
+
+#include <Utils/StringReplacer.h>
+
+void StringReplacer::Clear()
+{
+    replacements.clear();
+    nodes.clear();
+    edge_chars.clear();
+    edge_targets.clear();
+    compiled = false;
+}
+
+void StringReplacer::Add(const std::wstring_view from, const std::wstring_view to)
+{
+    if (from.empty()) {
+        return;
+    }
+    replacements.emplace_back(from, to);
+    compiled = false;
+}
+
+void StringReplacer::Compile()
+{
+    nodes.clear();
+    edge_chars.clear();
+    edge_targets.clear();
+
+    // Build the trie with ordered children first, then lay the edges out flat per node
+    std::vector<std::map<wchar_t, uint32_t>> children(1);
+    std::vector<uint32_t> keys(1, NONE);
+    for (uint32_t i = 0; i < replacements.size(); i++) {
+        uint32_t node = 0;
+        for (const auto c : replacements[i].first) {
+            const auto found = children[node].find(c);
+            if (found != children[node].end()) {
+                node = found->second;
+                continue;
+            }
+            const auto next = static_cast<uint32_t>(children.size());
+            children[node].emplace(c, next);
+            children.emplace_back();
+            keys.push_back(NONE);
+            node = next;
+        }
+        if (keys[node] == NONE) {
+            keys[node] = i;
+        }
+    }
+
+    nodes.resize(children.size());
+    for (uint32_t i = 0; i < children.size(); i++) {
+        auto& node = nodes[i];
+        node.key = keys[i];
+        node.first_edge = static_cast<uint32_t>(edge_chars.size());
+        node.edge_count = static_cast<uint32_t>(children[i].size());
+        for (const auto& [c, target] : children[i]) {
+            edge_chars.push_back(c);
+            edge_targets.push_back(target);
+        }
+    }
+
+    // Breadth first, so a node's fail target is always done before the node itself
+    std::deque<uint32_t> queue;
+    for (uint32_t e = nodes[0].first_edge; e < nodes[0].first_edge + nodes[0].edge_count; e++) {
+        nodes[edge_targets[e]].fail = 0;
+        queue.push_back(edge_targets[e]);
+    }
+    while (!queue.empty()) {
+        const auto parent = queue.front();
+        queue.pop_front();
+        for (uint32_t e = nodes[parent].first_edge; e < nodes[parent].first_edge + nodes[parent].edge_count; e++) {
+            const auto child = edge_targets[e];
+            auto fail = nodes[parent].fail;
+            uint32_t next;
+            while ((next = Next(fail, edge_chars[e])) == NONE && fail != 0) {
+                fail = nodes[fail].fail;
+            }
+            nodes[child].fail = next != NONE ? next : 0;
+            const auto& fail_node = nodes[nodes[child].fail];
+            nodes[child].dictionary = fail_node.key != NONE ? nodes[child].fail : fail_node.dictionary;
+            queue.push_back(child);
+        }
+    }
+    compiled = true;
+}
+
+uint32_t StringReplacer::Next(const uint32_t node, const wchar_t c) const
+{
+    const auto& n = nodes[node];
+    const auto first = edge_chars.begin() + n.first_edge;
+    const auto last = first + n.edge_count;
+    const auto found = std::lower_bound(first, last, c);
+    return found != last && *found == c ? edge_targets[found - edge_chars.begin()] : NONE;
+}
+
+bool StringReplacer::Replace(const std::wstring_view input, std::wstring& out)
+{
+    if (!compiled) {
+        Compile();
+    }
+    if (replacements.empty() || input.empty()) {
+        return false;
+    }
+
+    match_keys.assign(input.size(), NONE);
+    bool matched = false;
+    uint32_t node = 0;
+    for (size_t i = 0; i < input.size(); i++) {
+        uint32_t next;
+        while ((next = Next(node, input[i])) == NONE && node != 0) {
+            node = nodes[node].fail;
+        }
+        node = next != NONE ? next : 0;
+        for (auto found = nodes[node].key != NONE ? node : nodes[node].dictionary; found != NONE; found = nodes[found].dictionary) {
+            const auto key = nodes[found].key;
+            const auto length = replacements[key].first.size();
+            auto& longest = match_keys[i + 1 - length];
+            if (longest == NONE || replacements[longest].first.size() < length) {
+                longest = key;
+            }
+            matched = true;
+        }
+    }
+    if (!matched) {
+        return false;
+    }
+
+    // Leftmost, then longest; skip over whatever a replacement covers
+    buffer.clear();
+    for (size_t i = 0; i < input.size();) {
+        const auto key = match_keys[i];
+        if (key == NONE) {
+            buffer.push_back(input[i++]);
+            continue;
+        }
+        buffer.append(replacements[key].second);
+        i += replacements[key].first.size();
+    }
+    out.assign(buffer);
+    return true;
+}
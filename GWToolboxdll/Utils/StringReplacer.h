@@ -0,0 +1,49 @@
+#pragma once
+
+/*
+Replaces every occurrence of any of a set of strings in a single pass over the input (Aho-Corasick).
+
+Where matches overlap, the one starting first wins, then the longest, so with both "Foo" and "Foo Bar" in the set "Foo Bar" is
+replaced whole. Replaced text is never searched again, so a replacement that contains another key is left alone.
+
+Add the strings then Compile; adding more after that needs another Compile before Replace will see them.
+Once the internal buffers have grown to the size of the longest message, Replace doesn't allocate.
+*/
+class StringReplacer {
+public:
+    void Clear();
+    void Add(std::wstring_view from, std::wstring_view to);
+    void Compile();
+
+    [[nodiscard]] bool empty() const { return replacements.empty(); }
+
+    // Writes the rewritten input to out and returns true, or returns false without touching out if nothing matched.
+    // input may point into out.
+    bool Replace(std::wstring_view input, std::wstring& out);
+
+private:
+    static constexpr uint32_t NONE = 0xFFFFFFFF;
+
+    struct Node {
+        // This node's edges are edge_chars/edge_targets[first_edge, first_edge + edge_count), sorted by char
+        uint32_t first_edge = 0;
+        uint32_t edge_count = 0;
+        uint32_t fail = 0;
+        // Index into replacements of the key that ends here, or NONE
+        uint32_t key = NONE;
+        // Nearest node along the fail links that ends a key, or NONE
+        uint32_t dictionary = NONE;
+    };
+
+    [[nodiscard]] uint32_t Next(uint32_t node, wchar_t c) const;
+
+    std::vector<std::pair<std::wstring, std::wstring>> replacements;
+    std::vector<Node> nodes;
+    std::vector<wchar_t> edge_chars;
+    std::vector<uint32_t> edge_targets;
+    bool compiled = false;
+
+    // Longest key starting at each input position, or NONE
+    std::vector<uint32_t> match_keys;
+    std::wstring buffer;
+};
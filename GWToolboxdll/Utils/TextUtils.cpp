@@ -1,6 +1,11 @@
 #include "stdafx.h"
 #include "TextUtils.h"
 
+#include <emmintrin.h>
+
+#include <Utf8.h>
+#include <Utils/StaticTable.h>
+
 namespace {
     constexpr auto diacritics = std::to_array<const wchar_t*>({
         L"A\x0041\x0410\x24B6\xFF21\x00C0\x00C1\x00C2\x1EA6\x1EA4\x1EAA\x1EA8\x00C3\x0100\x0102\x1EB0\x1EAE\x1EB4\x1EB2\x0226\x01E0\x00C4\x01DE\x1EA2\x00C5\x01FA\x01CD\x0200\x0202\x1EA0\x1EAC\x1EB6\x1E00\x0104\x023A\x2C6F",
@@ -56,7 +61,144 @@ namespace {
         L"y\u0079\u24E8\uFF59\u1EF3\u00FD\u0177\u1EF9\u0233\u1E8F\u00FF\u1EF7\u1E99\u1EF5\u01B4\u024F\u1EFF\u0443",
         L"z\u007A\u24E9\uFF5A\u017A\u1E91\u017C\u017E\u1E93\u1E95\u01B6\u0225\u0240\u2C6C\uA763"
     });
-    std::map<wchar_t, wchar_t> diacritics_charmap;
+    constexpr StaticTable::CharMap<StaticTable::CountPages(diacritics)> diacritics_charmap(diacritics);
+    static_assert(diacritics_charmap.Covers(diacritics));
+
+    constexpr wchar_t AsciiToLower(const wchar_t c) { return c >= L'A' && c <= L'Z' ? static_cast<wchar_t>(c + (L'a' - L'A')) : c; }
+
+    // RemoveDiacritics then ToLower in one lookup; only used outside ASCII, where ToLower changes nothing
+    constexpr auto search_fold_charmap = [] {
+        StaticTable::CharMap<StaticTable::CountPages(diacritics)> charmap;
+        for (const auto row : diacritics) {
+            for (auto c = row + 1; *c; c++) {
+                charmap.Set(*c, AsciiToLower(row[0]));
+            }
+        }
+        return charmap;
+    }();
+    static_assert([] {
+        for (const auto row : diacritics) {
+            for (auto c = row + 1; *c; c++) {
+                if (search_fold_charmap(*c) != AsciiToLower(diacritics_charmap(*c))) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }());
+
+    // Lowercases A-Z and leaves everything else alone, which is what std::tolower does in the "C" locale toolbox runs in.
+    // in and out may be the same.
+    void AsciiToLower(const char* in, char* out, const size_t n)
+    {
+        const auto bias = _mm_set1_epi8(static_cast<char>(0x80));
+        // Signed compare of c - 'A' with the sign bit flipped is an unsigned c - 'A' < 26
+        const auto limit = _mm_set1_epi8(static_cast<char>(0x80 + 26));
+        const auto offset = _mm_set1_epi8('A');
+        const auto to_lower = _mm_set1_epi8(static_cast<char>('a' - 'A'));
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            const auto is_upper = _mm_cmplt_epi8(_mm_xor_si128(_mm_sub_epi8(v, offset), bias), limit);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_add_epi8(v, _mm_and_si128(is_upper, to_lower)));
+        }
+        for (; i < n; i++) {
+            out[i] = in[i] >= 'A' && in[i] <= 'Z' ? static_cast<char>(in[i] + ('a' - 'A')) : in[i];
+        }
+    }
+
+    void AsciiToLower(const wchar_t* in, wchar_t* out, const size_t n)
+    {
+        const auto bias = _mm_set1_epi16(static_cast<short>(0x8000));
+        const auto limit = _mm_set1_epi16(static_cast<short>(0x8000 + 26));
+        const auto offset = _mm_set1_epi16(static_cast<short>(L'A'));
+        const auto to_lower = _mm_set1_epi16(static_cast<short>(L'a' - L'A'));
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            const auto is_upper = _mm_cmplt_epi16(_mm_xor_si128(_mm_sub_epi16(v, offset), bias), limit);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_add_epi16(v, _mm_and_si128(is_upper, to_lower)));
+        }
+        for (; i < n; i++) {
+            out[i] = AsciiToLower(in[i]);
+        }
+    }
+
+    // Copies in to out, lowercasing ASCII if asked to, and passing everything else through charmap
+    template <typename CharMap>
+    void MapChars(const std::wstring_view in, wchar_t* out, const CharMap& charmap, const bool lower_ascii)
+    {
+        size_t i = 0;
+        while (i < in.size()) {
+            const auto ascii = utf8::AsciiPrefix(in.substr(i));
+            if (lower_ascii) {
+                AsciiToLower(in.data() + i, out + i, ascii);
+            }
+            else {
+                std::copy_n(in.data() + i, ascii, out + i);
+            }
+            i += ascii;
+            for (; i < in.size() && in[i] >= 0x80; i++) {
+                out[i] = charmap(in[i]);
+            }
+        }
+    }
+
+    // Drops anything in [brackets] or (parentheses) along with the character before them. Everything it looks for is ASCII,
+    // so on UTF-8 it gives the same result as on UTF-16, except where the character before is a surrogate pair in UTF-16, of
+    // which only the second half is dropped; returns false for that.
+    template <typename Char>
+    bool SanitizePlayerNameImpl(const std::basic_string_view<Char> str, std::basic_string<Char>& result)
+    {
+        result.clear();
+        result.reserve(str.size());
+        Char remove_char_token = 0;
+
+        const auto pop_previous = [&result] {
+            if (result.empty()) {
+                return true;
+            }
+            if constexpr (sizeof(Char) == 1) {
+                auto start = result.size() - 1;
+                while (start && (static_cast<uint8_t>(result[start]) & 0xC0) == 0x80) {
+                    start--;
+                }
+                if (result.size() - start == 4) {
+                    return false;
+                }
+                result.resize(start);
+            }
+            else {
+                result.pop_back();
+            }
+            return true;
+        };
+
+        for (const auto c : str) {
+            if (remove_char_token) {
+                if (c == remove_char_token) {
+                    remove_char_token = 0;  // End removal mode if closing character is found
+                }
+                continue;  // Skip characters inside the brackets/parentheses
+            }
+            if (c == static_cast<Char>('[')) {
+                remove_char_token = static_cast<Char>(']');  // Set to skip until the closing bracket
+                if (!pop_previous()) {  // Remove the space before the opening bracket if needed
+                    return false;
+                }
+                continue;
+            }
+            if (c == static_cast<Char>('(')) {
+                remove_char_token = static_cast<Char>(')');  // Set to skip until the closing parenthesis
+                if (!pop_previous()) {
+                    return false;
+                }
+                continue;
+            }
+            result.push_back(c);  // Add valid character to result
+        }
+        return true;
+    }
 
     time_t filetime_to_timet(const FILETIME& ft)
     {
@@ -104,20 +246,24 @@ namespace TextUtils {
 
     std::string ToLower(std::string s)
     {
-        std::ranges::transform(s, s.begin(), [](const char c) {
-            return std::tolower(c, std::locale());
-        });
+        AsciiToLower(s.data(), s.data(), s.size());
         return s;
     }
 
     std::wstring ToLower(std::wstring s)
     {
-        std::ranges::transform(s, s.begin(), [](const wchar_t c) {
-            return std::tolower(c, std::locale());
-        });
+        AsciiToLower(s.data(), s.data(), s.size());
         return s;
     }
 
+    void ToLower(const std::wstring_view s, std::wstring& out)
+    {
+        out.resize_and_overwrite(s.size(), [s](wchar_t* buffer, const size_t size) {
+            AsciiToLower(s.data(), buffer, size);
+            return size;
+        });
+    }
+
     std::string HtmlEncode(const std::string_view s)
     {
         if (s.empty()) {
@@ -213,9 +359,24 @@ namespace TextUtils {
     // Convert an UTF8 string to a wide Unicode String
     std::wstring StringToWString(const std::string_view str)
     {
+        std::wstring dest;
+        StringToWString(str, dest);
+        return dest;
+    }
+
+    void StringToWString(const std::string_view str, std::wstring& out)
+    {
+        out.clear();
         // @Cleanup: ASSERT used incorrectly here; value passed could be from anywhere!
         if (str.empty()) {
-            return {};
+            return;
+        }
+        // Valid UTF-8 is converted without asking the OS
+        if (const auto length = utf8::DecodedLength(str); length != utf8::invalid) {
+            out.resize_and_overwrite(length, [str](wchar_t* buffer, size_t) {
+                return utf8::Decode(str, buffer);
+            });
+            return;
         }
         // NB: GW uses code page 0 (CP_ACP)
         constexpr auto try_code_pages = {CP_UTF8, CP_ACP};
@@ -223,20 +384,34 @@ namespace TextUtils {
             const auto size_needed = MultiByteToWideChar(code_page, MB_ERR_INVALID_CHARS, str.data(), static_cast<int>(str.size()), nullptr, 0);
             if (!size_needed)
                 continue;
-            std::wstring dest(size_needed, 0);
-            ASSERT(MultiByteToWideChar(code_page, 0, str.data(), static_cast<int>(str.size()), dest.data(), size_needed));
-            return dest;
+            out.assign(size_needed, 0);
+            ASSERT(MultiByteToWideChar(code_page, 0, str.data(), static_cast<int>(str.size()), out.data(), size_needed));
+            return;
         }
         ASSERT("Failed to convert" && false);
-        return {};
     }
 
     // Convert a wide Unicode string to an UTF8 string
     std::string WStringToString(const std::wstring_view str)
     {
+        std::string dest;
+        WStringToString(str, dest);
+        return dest;
+    }
+
+    void WStringToString(const std::wstring_view str, std::string& out)
+    {
+        out.clear();
         // @Cleanup: ASSERT used incorrectly here; value passed could be from anywhere!
         if (str.empty()) {
-            return "";
+            return;
+        }
+        // Valid UTF-16 is converted without asking the OS
+        if (const auto length = utf8::EncodedLength(str); length != utf8::invalid) {
+            out.resize_and_overwrite(length, [str](char* buffer, size_t) {
+                return utf8::Encode(str, buffer);
+            });
+            return;
         }
         // NB: GW uses code page 0 (CP_ACP)
         constexpr auto try_code_pages = {CP_UTF8, CP_ACP};
@@ -244,12 +419,11 @@ namespace TextUtils {
             const auto size_needed = WideCharToMultiByte(code_page, WC_ERR_INVALID_CHARS, str.data(), static_cast<int>(str.size()), nullptr, 0, nullptr, nullptr);
             if (!size_needed)
                 continue;
-            std::string dest(size_needed, 0);
-            ASSERT(WideCharToMultiByte(code_page, 0, str.data(), static_cast<int>(str.size()), dest.data(), size_needed, nullptr, nullptr));
-            return dest;
+            out.assign(size_needed, 0);
+            ASSERT(WideCharToMultiByte(code_page, 0, str.data(), static_cast<int>(str.size()), out.data(), size_needed, nullptr, nullptr));
+            return;
         }
         ASSERT("Failed to convert" && false);
-        return {};
     }
 
     // Makes sure the file name doesn't have chars that won't be allowed on disk
@@ -306,58 +480,56 @@ namespace TextUtils {
 
     std::wstring RemoveDiacritics(const std::wstring_view s)
     {
-        if (diacritics_charmap.empty()) {
-            // Build static diacritics map if not already done so
-            for (size_t i = 0; i < diacritics.size(); i++) {
-                for (size_t j = 1; diacritics[i][j]; j++) {
-                    diacritics_charmap[diacritics[i][j]] = diacritics[i][0];
-                }
-            }
-        }
-        std::wstring out(s.length(), L'\0');
-        std::ranges::transform(s, out.begin(), [&](const wchar_t wc) -> wchar_t {
-            if (wc < 0x7f) {
-                return wc;
-            }
-            const auto it = diacritics_charmap.find(wc);
-            return it == diacritics_charmap.end() ? wc : it->second;
+        std::wstring out;
+        RemoveDiacritics(s, out);
+        return out;
+    }
+
+    void RemoveDiacritics(const std::wstring_view s, std::wstring& out)
+    {
+        out.resize_and_overwrite(s.size(), [s](wchar_t* buffer, const size_t size) {
+            MapChars(s, buffer, diacritics_charmap, false);
+            return size;
         });
+    }
+
+    std::wstring FoldForSearch(const std::wstring_view s)
+    {
+        std::wstring out;
+        FoldForSearch(s, out);
         return out;
     }
 
-    std::string SanitizePlayerName(const std::string_view str) {
-        return WStringToString(SanitizePlayerName(StringToWString(str)));
+    void FoldForSearch(const std::wstring_view s, std::wstring& out)
+    {
+        out.resize_and_overwrite(s.size(), [s](wchar_t* buffer, const size_t size) {
+            MapChars(s, buffer, search_fold_charmap, true);
+            return size;
+        });
     }
 
-    std::wstring SanitizePlayerName(const std::wstring_view str) {
-        std::wstring result;
-        wchar_t remove_char_token = 0;
+    std::string SanitizePlayerName(const std::string_view str) {
+        std::string out;
+        SanitizePlayerName(str, out);
+        return out;
+    }
 
-        for (const auto& wchar : str) {
-            if (remove_char_token) {
-                if (wchar == remove_char_token) {
-                    remove_char_token = 0;  // End removal mode if closing character is found
-                }
-                continue;  // Skip characters inside the brackets/parentheses
-            }
-            if (wchar == L'[') {
-                remove_char_token = L']';  // Set to skip until the closing bracket
-                if (!result.empty()) {
-                    result.pop_back();  // Remove the space before the opening bracket if needed
-                }
-                continue;
-            }
-            if (wchar == L'(') {
-                remove_char_token = L')';  // Set to skip until the closing parenthesis
-                if (!result.empty()) {
-                    result.pop_back();
-                }
-                continue;
-            }
-            result.push_back(wchar);  // Add valid character to result
+    void SanitizePlayerName(const std::string_view str, std::string& out) {
+        // Valid UTF-8 can be worked on as it is, most of the time
+        if (utf8::DecodedLength(str) != utf8::invalid && SanitizePlayerNameImpl(str, out)) {
+            return;
         }
+        out = WStringToString(SanitizePlayerName(StringToWString(str)));
+    }
 
-        return result;
+    std::wstring SanitizePlayerName(const std::wstring_view str) {
+        std::wstring out;
+        SanitizePlayerName(str, out);
+        return out;
+    }
+
+    void SanitizePlayerName(const std::wstring_view str, std::wstring& out) {
+        SanitizePlayerNameImpl(str, out);
     }
 
     // Extract first unencoded substring from gw encoded string. Pass second and third args to know where the player name was found in the original string.
@@ -3,6 +3,9 @@
 namespace TextUtils {
     std::string WStringToString(std::wstring_view str);
     std::wstring StringToWString(std::string_view str);
+    // Same as above, writing into out so that a buffer can be reused
+    void WStringToString(std::wstring_view str, std::string& out);
+    void StringToWString(std::string_view str, std::wstring& out);
     std::string UrlEncode(std::string_view s, char space_token = '+');
     std::string HtmlEncode(std::string_view s);
     std::string SanitiseFilename(std::string_view str);
@@ -18,10 +21,17 @@ namespace TextUtils {
     std::wstring ToSlug(std::wstring s);
     std::string ToLower(std::string s);
     std::wstring ToLower(std::wstring s);
+    void ToLower(std::wstring_view s, std::wstring& out);
     std::wstring RemoveDiacritics(std::wstring_view s);
+    void RemoveDiacritics(std::wstring_view s, std::wstring& out);
+    // Same as ToLower(RemoveDiacritics(s)), in one pass
+    std::wstring FoldForSearch(std::wstring_view s);
+    void FoldForSearch(std::wstring_view s, std::wstring& out);
 
     std::wstring SanitizePlayerName(const std::wstring_view str);
     std::string SanitizePlayerName(const std::string_view str);
+    void SanitizePlayerName(std::wstring_view str, std::wstring& out);
+    void SanitizePlayerName(std::string_view str, std::string& out);
     std::wstring GetPlayerNameFromEncodedString(const wchar_t* message, const wchar_t** start_pos_out = nullptr, const wchar_t** end_pos_out = nullptr);
 
     bool ParseInt(const char* str, int* val, int base = 10);
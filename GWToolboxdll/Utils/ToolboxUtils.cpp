@@ -197,6 +197,12 @@ namespace GW {
                 *(std::wstring*)param = s;
                 }, out, language_id);
         }
+        void AsyncDecodeInterned(const wchar_t* enc_str, StringPool::Handle* out, GW::Constants::Language language_id) {
+            *out = StringPool::empty;
+            AsyncDecodeStr(enc_str, [](void* param, const wchar_t* s) {
+                *(StringPool::Handle*)param = StringPool::Intern(s);
+                }, out, language_id);
+        }
     }
     namespace Agents {
         void AsyncGetAgentName(const Agent* agent, std::wstring& out) {
@@ -2,6 +2,8 @@
 #include <GWCA/Managers/UIMgr.h>
 #include <GWCA/Managers/StoCMgr.h>
 
+#include <Utils/StringPool.h>
+
 class StoCCallback {
     GW::HookEntry* hook_entry = nullptr;
     const GW::StoC::PacketCallback callback;
@@ -129,6 +131,8 @@ namespace GW {
     }
     namespace UI {
         void AsyncDecodeStr(const wchar_t* enc_str, std::wstring* out, GW::Constants::Language language_id = (GW::Constants::Language)0xff);
+        // Decodes into the string pool; out is empty until the decode finishes
+        void AsyncDecodeInterned(const wchar_t* enc_str, StringPool::Handle* out, GW::Constants::Language language_id = (GW::Constants::Language)0xff);
     }
     namespace Agents {
         void AsyncGetAgentName(const Agent* agent, std::wstring& out);
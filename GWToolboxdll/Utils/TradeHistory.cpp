@@ -0,0 +1,479 @@
+#include "stdafx.h"
+
+#include <Logger.h>
+#include <Modules/Resources.h>
+#include <Utils/TradeHistory.h>
+
+namespace {
+    constexpr uint32_t FILE_MAGIC = 0x48544254; // "TBTH"
+    constexpr uint32_t FILE_VERSION = 1;
+    constexpr uint32_t FILE_HEADER_SIZE = sizeof(FILE_MAGIC) + sizeof(FILE_VERSION);
+    // Same sender and message within this many seconds is treated as a repeat
+    constexpr uint32_t DUPLICATE_WINDOW_SECONDS = 5 * 60;
+    // Records older than this are dropped when the history is opened
+    constexpr uint32_t MAX_AGE_SECONDS = 180 * 24 * 60 * 60;
+    // Nothing more is written once the file reaches MAX_FILE_SIZE. Opening a file past COMPACT_AT_SIZE trims it back to COMPACT_TO_SIZE,
+    // oldest first, which leaves a session's worth of room before the cap.
+    constexpr uint32_t MAX_FILE_SIZE = 64 * 1024 * 1024;
+    constexpr uint32_t COMPACT_AT_SIZE = 56 * 1024 * 1024;
+    constexpr uint32_t COMPACT_TO_SIZE = 48 * 1024 * 1024;
+    // Messages held while the index loads; later ones are dropped rather than grow without bound if loading stalls
+    constexpr size_t MAX_PENDING_WRITES = 4096;
+    // Max number of indexed words a single word in a query can expand to when prefix matching
+    constexpr size_t MAX_PREFIX_EXPANSION = 256;
+    constexpr size_t MIN_WORD_LENGTH = 2;
+
+    struct RecordHeader {
+        uint32_t timestamp;
+        uint16_t name_len;
+        uint16_t message_len;
+    };
+    static_assert(sizeof(RecordHeader) == 8);
+
+    // Lower-case ascii words; anything outside ascii is kept as part of the word so utf8 names still index.
+    template <typename Fn>
+    void ForEachWord(const std::string_view text, Fn&& fn)
+    {
+        std::string word;
+        const auto emit = [&] {
+            if (word.size() >= MIN_WORD_LENGTH) {
+                fn(word);
+            }
+            word.clear();
+        };
+        for (const char c : text) {
+            const auto uc = static_cast<unsigned char>(c);
+            if (uc >= 0x80 || isalnum(uc)) {
+                word.push_back(static_cast<char>(tolower(uc)));
+            }
+            else {
+                emit();
+            }
+        }
+        emit();
+    }
+
+    uint64_t DuplicateKey(const std::string_view name, const std::string_view message)
+    {
+        const std::hash<std::string_view> hash;
+        return (static_cast<uint64_t>(hash(name)) << 32) ^ static_cast<uint64_t>(hash(message));
+    }
+
+    // A run of repeats of one message, each within DUPLICATE_WINDOW_SECONDS of the one before
+    struct SeenSpan {
+        uint32_t first;
+        uint32_t last;
+    };
+
+    struct Index {
+        // File offset of each record, by record id. Ids are assigned in the order records are written.
+        std::vector<uint32_t> offsets;
+        // Word -> ascending record ids. Ordered so that prefixes can be looked up with lower_bound.
+        std::map<std::string, std::vector<uint32_t>, std::less<>> postings;
+        // DuplicateKey -> every span the message has been seen over, sorted and more than the window apart.
+        // Search results bring back old messages out of order, so one timestamp per message isn't enough to spot them.
+        std::unordered_map<uint64_t, std::vector<SeenSpan>> seen_spans;
+
+        // Returns false if this is a repeat of a message already recorded around that time
+        bool IsNew(const uint32_t timestamp, const std::string_view name, const std::string_view message)
+        {
+            auto& spans = seen_spans[DuplicateKey(name, message)];
+            const auto it = std::ranges::lower_bound(spans, timestamp > DUPLICATE_WINDOW_SECONDS ? timestamp - DUPLICATE_WINDOW_SECONDS : 0, {}, &SeenSpan::last);
+            if (it == spans.end() || it->first > timestamp + DUPLICATE_WINDOW_SECONDS) {
+                spans.insert(it, {timestamp, timestamp});
+                return true;
+            }
+            it->first = std::min(it->first, timestamp);
+            it->last = std::max(it->last, timestamp);
+            if (const auto next = it + 1; next != spans.end() && next->first <= it->last + DUPLICATE_WINDOW_SECONDS) {
+                it->last = next->last;
+                spans.erase(next);
+            }
+            return false;
+        }
+
+        void Insert(const uint32_t offset, const std::string_view name, const std::string_view message)
+        {
+            const auto id = static_cast<uint32_t>(offsets.size());
+            offsets.push_back(offset);
+            const auto add_word = [&](const std::string& word) {
+                auto found = postings.find(word);
+                if (found == postings.end()) {
+                    found = postings.emplace(word, std::vector<uint32_t>{}).first;
+                }
+                if (found->second.empty() || found->second.back() != id) {
+                    found->second.push_back(id);
+                }
+            };
+            ForEachWord(name, add_word);
+            ForEachWord(message, add_word);
+        }
+    };
+
+    std::mutex history_mutex;
+    std::filesystem::path history_path;
+    FILE* history_file = nullptr;
+    Index index;
+    // Offset the next record will be written at, including any still in pending_writes
+    uint32_t write_offset = 0;
+    // Added but not yet on disk. Before the index is loaded, these haven't been indexed either.
+    std::vector<TradeHistory::Entry> pending_writes;
+    bool loaded = false;
+    // The log couldn't be opened; Add drops everything until the next Load
+    bool load_failed = false;
+    // Bumped on every Load/Unload so that a stale background load knows to throw its work away
+    uint32_t load_generation = 0;
+
+    uint32_t RecordSize(const TradeHistory::Entry& entry)
+    {
+        return static_cast<uint32_t>(sizeof(RecordHeader) + entry.name.size() + entry.message.size());
+    }
+
+    void FlushLocked()
+    {
+        if (!history_file || pending_writes.empty()) {
+            return;
+        }
+        fseek(history_file, 0, SEEK_END); // Required when switching from reading to writing
+        for (const auto& entry : pending_writes) {
+            const RecordHeader header = {entry.timestamp, static_cast<uint16_t>(entry.name.size()), static_cast<uint16_t>(entry.message.size())};
+            fwrite(&header, sizeof(header), 1, history_file);
+            fwrite(entry.name.data(), 1, entry.name.size(), history_file);
+            fwrite(entry.message.data(), 1, entry.message.size(), history_file);
+        }
+        fflush(history_file);
+        pending_writes.clear();
+    }
+
+    void AddLocked(TradeHistory::Entry&& entry)
+    {
+        if (!loaded) {
+            if (!load_failed && pending_writes.size() < MAX_PENDING_WRITES) {
+                pending_writes.push_back(std::move(entry));
+            }
+            return;
+        }
+        if (write_offset + RecordSize(entry) > MAX_FILE_SIZE) {
+            return; // Full until it's compacted on the next load
+        }
+        if (!index.IsNew(entry.timestamp, entry.name, entry.message)) {
+            return;
+        }
+        index.Insert(write_offset, entry.name, entry.message);
+        write_offset += RecordSize(entry);
+        pending_writes.push_back(std::move(entry));
+    }
+
+    // File offsets of the newest max_results records matching query, newest first
+    std::vector<uint32_t> FindMatchesLocked(const std::string_view query, const size_t max_results)
+    {
+        std::vector<uint32_t> offsets;
+        std::vector<std::vector<uint32_t>> candidates;
+        bool no_match = false;
+        ForEachWord(query, [&](const std::string& word) {
+            std::vector<uint32_t> ids;
+            size_t expanded = 0;
+            for (auto it = index.postings.lower_bound(word); it != index.postings.end() && it->first.starts_with(word) && expanded < MAX_PREFIX_EXPANSION; ++it, ++expanded) {
+                ids.insert(ids.end(), it->second.begin(), it->second.end());
+            }
+            if (expanded > 1) {
+                std::ranges::sort(ids);
+                const auto [first, last] = std::ranges::unique(ids);
+                ids.erase(first, last);
+            }
+            no_match |= ids.empty();
+            candidates.push_back(std::move(ids));
+        });
+        if (no_match) {
+            return offsets;
+        }
+
+        std::vector<uint32_t> matches;
+        if (candidates.empty()) {
+            const auto count = std::min(index.offsets.size(), max_results);
+            for (size_t i = index.offsets.size() - count; i < index.offsets.size(); i++) {
+                matches.push_back(static_cast<uint32_t>(i));
+            }
+        }
+        else {
+            // Intersect smallest first so the working set only shrinks
+            std::ranges::sort(candidates, [](const auto& a, const auto& b) { return a.size() < b.size(); });
+            matches = std::move(candidates[0]);
+            std::vector<uint32_t> tmp;
+            for (size_t i = 1; i < candidates.size() && !matches.empty(); i++) {
+                tmp.clear();
+                std::ranges::set_intersection(matches, candidates[i], std::back_inserter(tmp));
+                std::swap(matches, tmp);
+            }
+        }
+
+        offsets.reserve(std::min(matches.size(), max_results));
+        for (size_t i = matches.size(); i-- && offsets.size() < max_results;) {
+            offsets.push_back(index.offsets[matches[i]]);
+        }
+        return offsets;
+    }
+
+    bool ReadRecord(FILE* fp, TradeHistory::Entry& out)
+    {
+        RecordHeader header;
+        if (fread(&header, sizeof(header), 1, fp) != 1) {
+            return false;
+        }
+        out.timestamp = header.timestamp;
+        out.name.resize(header.name_len);
+        out.message.resize(header.message_len);
+        return (!header.name_len || fread(out.name.data(), header.name_len, 1, fp) == 1)
+               && (!header.message_len || fread(out.message.data(), header.message_len, 1, fp) == 1);
+    }
+
+    bool ReadFileHeader(FILE* fp)
+    {
+        uint32_t header[2] = {};
+        return fread(header, sizeof(header), 1, fp) == 1 && header[0] == FILE_MAGIC && header[1] == FILE_VERSION;
+    }
+
+    // Runs on a worker thread before indexing. Rewrites the log without records older than MAX_AGE_SECONDS, then drops the
+    // oldest written until what's left fits in COMPACT_TO_SIZE. Leaves the file alone if nothing has expired and it's under
+    // COMPACT_AT_SIZE.
+    void Compact(const std::filesystem::path& path)
+    {
+        FILE* fp = _wfopen(path.c_str(), L"rb");
+        if (!fp) {
+            return;
+        }
+        if (!ReadFileHeader(fp)) {
+            fclose(fp);
+            return;
+        }
+        const auto now = static_cast<uint32_t>(time(nullptr));
+        const auto cutoff = now > MAX_AGE_SECONDS ? now - MAX_AGE_SECONDS : 0;
+        const auto is_expired = [cutoff](const TradeHistory::Entry& entry) {
+            return entry.timestamp < cutoff;
+        };
+        // First pass: how much would survive the age limit
+        uint64_t kept_size = FILE_HEADER_SIZE;
+        uint64_t total_size = FILE_HEADER_SIZE;
+        TradeHistory::Entry entry;
+        while (ReadRecord(fp, entry)) {
+            total_size += RecordSize(entry);
+            if (!is_expired(entry)) {
+                kept_size += RecordSize(entry);
+            }
+        }
+        if (kept_size == total_size && total_size <= COMPACT_AT_SIZE) {
+            fclose(fp);
+            return;
+        }
+
+        auto tmp_path = path;
+        tmp_path += L".tmp";
+        FILE* out = _wfopen(tmp_path.c_str(), L"wb");
+        if (!out) {
+            fclose(fp);
+            return;
+        }
+        const uint32_t header[2] = {FILE_MAGIC, FILE_VERSION};
+        bool ok = fwrite(header, sizeof(header), 1, out) == 1;
+        fseek(fp, FILE_HEADER_SIZE, SEEK_SET);
+        while (ok && ReadRecord(fp, entry)) {
+            if (is_expired(entry)) {
+                continue;
+            }
+            if (kept_size > COMPACT_TO_SIZE) {
+                kept_size -= RecordSize(entry);
+                continue;
+            }
+            const RecordHeader record = {entry.timestamp, static_cast<uint16_t>(entry.name.size()), static_cast<uint16_t>(entry.message.size())};
+            ok = fwrite(&record, sizeof(record), 1, out) == 1
+                 && fwrite(entry.name.data(), 1, entry.name.size(), out) == entry.name.size()
+                 && fwrite(entry.message.data(), 1, entry.message.size(), out) == entry.message.size();
+        }
+        fclose(fp);
+        ok = fclose(out) == 0 && ok;
+        std::error_code ec;
+        if (ok) {
+            std::filesystem::rename(tmp_path, path, ec);
+            ok = !ec;
+        }
+        if (!ok) {
+            std::filesystem::remove(tmp_path, ec);
+            Log::Log("[TradeHistory] Failed to compact %ls\n", path.c_str());
+        }
+    }
+
+    // Runs on a worker thread. Scans the log and builds a fresh index without holding the lock.
+    uint32_t BuildIndex(const std::filesystem::path& path, Index& out)
+    {
+        FILE* fp = _wfopen(path.c_str(), L"rb");
+        if (!fp) {
+            return 0;
+        }
+        if (!ReadFileHeader(fp)) {
+            fclose(fp);
+            Log::Log("[TradeHistory] %ls has an unknown format, starting a new history\n", path.c_str());
+            return 0;
+        }
+        uint32_t offset = FILE_HEADER_SIZE;
+        TradeHistory::Entry entry;
+        while (ReadRecord(fp, entry)) {
+            if (out.IsNew(entry.timestamp, entry.name, entry.message)) {
+                out.Insert(offset, entry.name, entry.message);
+            }
+            offset += RecordSize(entry);
+        }
+        fclose(fp);
+        return offset;
+    }
+}
+
+void TradeHistory::Load(const std::filesystem::path& path)
+{
+    uint32_t generation;
+    {
+        std::lock_guard lock(history_mutex);
+        if (history_path == path) {
+            return;
+        }
+        FlushLocked();
+        if (history_file) {
+            fclose(history_file);
+            history_file = nullptr;
+        }
+        index = {};
+        loaded = false;
+        load_failed = false;
+        history_path = path;
+        generation = ++load_generation;
+    }
+    Resources::EnqueueWorkerTask([path, generation] {
+        Compact(path);
+        Index built;
+        uint32_t end_offset = BuildIndex(path, built);
+
+        std::lock_guard lock(history_mutex);
+        if (generation != load_generation) {
+            return; // Unloaded or pointed elsewhere while we were busy
+        }
+        std::error_code ec;
+        if (end_offset && std::filesystem::file_size(path, ec) != end_offset && !ec) {
+            std::filesystem::resize_file(path, end_offset, ec); // Drop a record that was only half written
+        }
+        if (!end_offset) {
+            FILE* fp = _wfopen(path.c_str(), L"wb");
+            if (fp) {
+                const uint32_t header[2] = {FILE_MAGIC, FILE_VERSION};
+                fwrite(header, sizeof(header), 1, fp);
+                fclose(fp);
+            }
+            end_offset = FILE_HEADER_SIZE;
+        }
+        // Append mode: every write goes to the end of the file, whatever the last read left the position at
+        history_file = _wfopen(path.c_str(), L"a+b");
+        if (!history_file) {
+            Log::Log("[TradeHistory] Failed to open %ls for writing\n", path.c_str());
+            load_failed = true;
+            pending_writes.clear();
+            return;
+        }
+        index = std::move(built);
+        write_offset = end_offset;
+        loaded = true;
+
+        // Merge in anything that arrived while we were indexing
+        auto early = std::move(pending_writes);
+        pending_writes.clear();
+        for (auto& entry : early) {
+            AddLocked(std::move(entry));
+        }
+        Log::Log("[TradeHistory] Indexed %zu trade messages\n", index.offsets.size());
+    });
+}
+
+void TradeHistory::Unload()
+{
+    std::lock_guard lock(history_mutex);
+    FlushLocked();
+    if (history_file) {
+        fclose(history_file);
+        history_file = nullptr;
+    }
+    index = {};
+    pending_writes.clear();
+    loaded = false;
+    load_failed = false;
+    history_path.clear();
+    load_generation++;
+}
+
+void TradeHistory::Flush()
+{
+    std::lock_guard lock(history_mutex);
+    FlushLocked();
+}
+
+void TradeHistory::Add(const uint32_t timestamp, const std::string_view name, const std::string_view message)
+{
+    if (name.empty() || message.empty()) {
+        return;
+    }
+    Entry entry;
+    entry.timestamp = timestamp;
+    entry.name = name.substr(0, 0xffff);
+    entry.message = message.substr(0, 0xffff);
+    std::lock_guard lock(history_mutex);
+    if (history_path.empty()) {
+        return;
+    }
+    AddLocked(std::move(entry));
+}
+
+std::vector<TradeHistory::Entry> TradeHistory::Search(const std::string_view query, const size_t max_results)
+{
+    std::vector<Entry> results;
+    std::vector<uint32_t> offsets;
+    std::filesystem::path path;
+    uint32_t generation;
+    {
+        std::lock_guard lock(history_mutex);
+        if (!loaded || !history_file) {
+            return results;
+        }
+        FlushLocked(); // Records are read back from disk
+        offsets = FindMatchesLocked(query, max_results);
+        path = history_path;
+        generation = load_generation;
+    }
+
+    // Read back through a handle of our own, so Add isn't held up by the disk
+    FILE* fp = _wfopen(path.c_str(), L"rb");
+    if (!fp) {
+        return results;
+    }
+    results.reserve(offsets.size());
+    for (const auto offset : offsets) {
+        Entry entry;
+        if (fseek(fp, static_cast<long>(offset), SEEK_SET) == 0 && ReadRecord(fp, entry)) {
+            results.push_back(std::move(entry));
+        }
+    }
+    fclose(fp);
+
+    std::lock_guard lock(history_mutex);
+    if (generation != load_generation) {
+        results.clear(); // Reopened, and maybe compacted, while we were reading
+    }
+    return results;
+}
+
+bool TradeHistory::IsLoaded()
+{
+    std::lock_guard lock(history_mutex);
+    return loaded;
+}
+
+size_t TradeHistory::Count()
+{
+    std::lock_guard lock(history_mutex);
+    return index.offsets.size();
+}
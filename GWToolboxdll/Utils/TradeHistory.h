@@ -0,0 +1,39 @@
+#pragma once
+
+/*
+Local on-disk store of every trade message seen, with an in-memory inverted index for offline search.
+
+Messages are appended to a binary log; only file offsets, the token index and the duplicate spans are held in memory. That's still
+around a hundred bytes per message, so a log near its size cap costs tens of megabytes of the game's address space, which is why
+TradeWindow leaves it off by default.
+The index is rebuilt from the log on a worker thread when the store is opened; anything added before that finishes is kept (up to a
+limit) and merged in. If the log can't be opened, nothing is kept until the next Load.
+Opening the store also drops records older than six months and, if the log has grown past its size cap, the oldest records until it's
+back under; once full, nothing more is written until the next open.
+*/
+namespace TradeHistory {
+    struct Entry {
+        uint32_t timestamp = 0;
+        std::string name;
+        std::string message;
+    };
+
+    // Open the history file and start indexing it in the background.
+    void Load(const std::filesystem::path& path);
+    // Flush pending writes and release the index.
+    void Unload();
+    // Write anything added since the last flush to disk. Cheap if there's nothing to do.
+    void Flush();
+
+    // Record a message. Repeats of the same sender + message within a few minutes are ignored, so the same message seen in local chat and
+    // on the trade feed is only stored once.
+    void Add(uint32_t timestamp, std::string_view name, std::string_view message);
+
+    // Newest-first messages containing every word in the query. Words match as prefixes, case insensitive. Empty query returns the latest messages.
+    // Reads from disk; call from a worker thread.
+    std::vector<Entry> Search(std::string_view query, size_t max_results = 100);
+
+    // True once the index has been built from disk.
+    bool IsLoaded();
+    size_t Count();
+}
@@ -0,0 +1,171 @@
+#include "stdafx.h"
+
+#include <Logger.h>
+#include <Utils/WebSocketSession.h>
+
+namespace {
+    using easywsclient::WebSocket;
+    using Clock = std::chrono::steady_clock;
+
+    // First retry after 30 seconds, as before the I/O thread, doubling up to 60 seconds between attempts.
+    constexpr auto BACKOFF_MIN = std::chrono::milliseconds(30000);
+    constexpr auto BACKOFF_MAX = std::chrono::milliseconds(60000);
+    // Upper bound on how long the I/O thread sleeps waiting for socket activity
+    constexpr int POLL_TIMEOUT_MS = 20;
+
+    void CloseSocket(WebSocket* ws)
+    {
+        if (!ws) {
+            return;
+        }
+        if (ws->getReadyState() == WebSocket::OPEN) {
+            ws->close();
+        }
+        for (size_t i = 0; i < 50 && ws->getReadyState() != WebSocket::CLOSED; i++) {
+            ws->poll(POLL_TIMEOUT_MS);
+        }
+        delete ws;
+    }
+}
+
+WebSocketSession::WebSocketSession(const size_t send_capacity)
+    : outgoing(send_capacity) { }
+
+WebSocketSession::~WebSocketSession()
+{
+    Stop();
+}
+
+void WebSocketSession::Connect(const std::string& _url)
+{
+    {
+        std::lock_guard lock(url_mutex);
+        url = _url;
+    }
+    if (!wants_connection.exchange(true)) {
+        // Fresh request rather than a retry; skip the backoff
+        state = State::Connecting;
+        reconnect_now = true;
+    }
+    if (!thread.joinable()) {
+        thread = std::jthread([this](const std::stop_token& stop_token) {
+            Run(stop_token);
+        });
+    }
+}
+
+void WebSocketSession::Disconnect()
+{
+    wants_connection = false;
+}
+
+void WebSocketSession::ReconnectNow()
+{
+    reconnect_now = true;
+}
+
+void WebSocketSession::Stop()
+{
+    wants_connection = false;
+    if (thread.joinable()) {
+        thread.request_stop();
+        thread.join();
+    }
+    state = State::Disconnected;
+}
+
+bool WebSocketSession::Send(std::string message)
+{
+    if (state != State::Open) {
+        return false;
+    }
+    return outgoing.try_push(std::move(message));
+}
+
+void WebSocketSession::Run(const std::stop_token& stop_token)
+{
+    WSAData wsa_data{};
+    const int wsa_res = WSAStartup(MAKEWORD(2, 2), &wsa_data);
+    if (wsa_res != 0) {
+        Log::Log("[WebSocketSession] Failed to call WSAStartup: %d\n", wsa_res);
+    }
+
+    WebSocket* ws = nullptr;
+    std::string connected_url;
+    std::string pending;
+    auto backoff = Clock::duration::zero();
+    auto next_attempt = Clock::now();
+
+    const auto on_disconnected = [&] {
+        CloseSocket(ws);
+        ws = nullptr;
+        state = State::Disconnected;
+        while (outgoing.try_pop(pending)) { } // Nobody to send these to; the consumer re-sends on reconnect if it needs to.
+    };
+    const auto schedule_retry = [&] {
+        backoff = backoff == Clock::duration::zero() ? Clock::duration(BACKOFF_MIN) : std::min<Clock::duration>(backoff * 2, BACKOFF_MAX);
+        next_attempt = Clock::now() + backoff;
+    };
+
+    while (!stop_token.stop_requested()) {
+        std::string target;
+        {
+            std::lock_guard lock(url_mutex);
+            target = url;
+        }
+        const bool wanted = wants_connection && wsa_res == 0;
+
+        if (ws && (!wanted || target != connected_url)) {
+            // Deliberately closed or pointed somewhere else; don't penalise the next attempt.
+            on_disconnected();
+            backoff = Clock::duration::zero();
+            next_attempt = Clock::now();
+        }
+
+        if (!ws) {
+            if (!wanted) {
+                state = State::Disconnected;
+            }
+            if (!wanted || (!reconnect_now.exchange(false) && Clock::now() < next_attempt)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                continue;
+            }
+            state = State::Connecting;
+            ws = WebSocket::from_url(target);
+            if (!ws) {
+                state = State::Disconnected;
+                schedule_retry();
+                Log::Log("[WebSocketSession] Couldn't connect to the host '%s', retrying in %lld ms\n", target.c_str(),
+                         std::chrono::duration_cast<std::chrono::milliseconds>(backoff).count());
+                continue;
+            }
+            connected_url = target;
+        }
+
+        if (ws->getReadyState() == WebSocket::OPEN) {
+            if (state != State::Open) {
+                state = State::Open;
+                ++connection_count;
+                backoff = Clock::duration::zero();
+            }
+            while (outgoing.try_pop(pending)) {
+                ws->send(pending);
+            }
+        }
+
+        ws->poll(POLL_TIMEOUT_MS);
+        ws->dispatch([this](const std::string& data) {
+            OnMessage(data);
+        });
+
+        if (ws->getReadyState() == WebSocket::CLOSED) {
+            on_disconnected();
+            schedule_retry();
+        }
+    }
+
+    on_disconnected();
+    if (wsa_res == 0) {
+        WSACleanup();
+    }
+}
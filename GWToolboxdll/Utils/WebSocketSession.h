@@ -0,0 +1,105 @@
+#pragma once
+
+#include <Utils/RingBuffer.h>
+
+/*
+Owns a websocket connection on its own I/O thread.
+
+The game thread only talks to the session through Connect/Disconnect/Send and the queue of parsed messages;
+connecting, polling, dispatching, reconnecting with backoff and closing all happen on the I/O thread,
+so a burst of incoming frames never costs the game thread more than draining a queue.
+*/
+class WebSocketSession {
+public:
+    enum class State { Disconnected, Connecting, Open };
+
+    WebSocketSession(const WebSocketSession&) = delete;
+    WebSocketSession& operator=(const WebSocketSession&) = delete;
+    virtual ~WebSocketSession();
+
+    // Keep a connection to this url open, reconnecting with backoff if it drops. Starts the I/O thread if needed.
+    void Connect(const std::string& url);
+    // Close the connection and stop reconnecting. The I/O thread idles until Connect is called again.
+    void Disconnect();
+    // Skip any pending backoff and try to connect straight away.
+    void ReconnectNow();
+    // Close the socket and join the I/O thread. Must be called before the owning module terminates.
+    void Stop();
+
+    // Queue a text frame for the I/O thread to send. Single producer: only call this from one thread (usually the game thread).
+    // Returns false if the socket isn't open or the send queue is full.
+    bool Send(std::string message);
+
+    [[nodiscard]] State GetState() const { return state; }
+    // Incremented whenever a connection is established; lets the consumer detect reconnects without a callback.
+    [[nodiscard]] uint32_t GetConnectionCount() const { return connection_count; }
+
+protected:
+    explicit WebSocketSession(size_t send_capacity = 32);
+
+    // Called on the I/O thread for every text frame received.
+    virtual void OnMessage(const std::string& data) = 0;
+    [[nodiscard]] bool StopRequested() const { return thread.get_stop_token().stop_requested(); }
+
+private:
+    void Run(const std::stop_token& stop_token);
+
+    std::mutex url_mutex;
+    std::string url;
+    std::atomic<bool> wants_connection = false;
+    std::atomic<bool> reconnect_now = false;
+    std::atomic<State> state = State::Disconnected;
+    std::atomic<uint32_t> connection_count = 0;
+    SpscRing<std::string> outgoing;
+    std::jthread thread;
+};
+
+// Session that parses each incoming frame into T on the I/O thread, then hands it to the game thread through a lock-free queue.
+template <typename T>
+class TypedWebSocketSession : public WebSocketSession {
+public:
+    // Runs on the I/O thread. Return false to drop the frame.
+    using Parser = std::function<bool(const std::string& data, T& out)>;
+
+    explicit TypedWebSocketSession(Parser parser, const size_t capacity = 256)
+        : parser(std::move(parser))
+        , incoming(capacity) { }
+
+    ~TypedWebSocketSession() override
+    {
+        Stop(); // The I/O thread writes to incoming, so it has to be gone before incoming is.
+    }
+
+    // Consumer side: calls fn for up to max_count parsed messages, returns how many were handled.
+    template <typename Fn>
+    size_t Drain(Fn&& fn, const size_t max_count = SIZE_MAX)
+    {
+        T msg;
+        size_t handled = 0;
+        while (handled < max_count && incoming.try_pop(msg)) {
+            fn(msg);
+            handled++;
+        }
+        return handled;
+    }
+
+protected:
+    void OnMessage(const std::string& data) override
+    {
+        T parsed;
+        if (!parser(data, parsed)) {
+            return;
+        }
+        // If the game thread has fallen behind, hold the socket rather than drop the message; tcp will buffer the rest.
+        while (!incoming.try_push(std::move(parsed))) {
+            if (StopRequested()) {
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+private:
+    Parser parser;
+    SpscRing<T> incoming;
+};
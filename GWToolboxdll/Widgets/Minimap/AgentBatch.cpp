@@ -0,0 +1,161 @@
+#include "stdafx.h"
+
+#include <emmintrin.h>
+
+#include <Widgets/Minimap/AgentBatch.h>
+
+namespace {
+    using AgentBatch::Tint;
+
+    // Colors::Add/Sub clamp each channel to [0, 255], which is exactly what saturating byte arithmetic does.
+    void BuildPalette(const uint32_t color, const uint32_t modifier, uint32_t (&palette)[4])
+    {
+        const __m128i c = _mm_cvtsi32_si128(static_cast<int>(color));
+        const __m128i m = _mm_cvtsi32_si128(static_cast<int>(modifier));
+        const __m128i center = _mm_cvtsi32_si128(static_cast<int>(IM_COL32(0, 0, 0, 50)));
+        palette[static_cast<size_t>(Tint::Base)] = color;
+        palette[static_cast<size_t>(Tint::Dark)] = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_subs_epu8(c, m)));
+        palette[static_cast<size_t>(Tint::Light)] = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_adds_epu8(c, m)));
+        palette[static_cast<size_t>(Tint::CircleCenter)] = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_subs_epu8(c, center)));
+    }
+}
+
+void AgentBatch::ShapeTemplate::AddVertex(const float vx, const float vy, const Tint t)
+{
+    x.push_back(vx);
+    y.push_back(vy);
+    tint.push_back(t);
+    extent = std::max(extent, std::sqrt(vx * vx + vy * vy));
+}
+
+void AgentBatch::AgentInstances::Clear()
+{
+    pos_x.clear();
+    pos_y.clear();
+    rot_cos.clear();
+    rot_sin.clear();
+    scale.clear();
+    color.clear();
+    modifier.clear();
+    shape.clear();
+}
+
+void AgentBatch::AgentInstances::Reserve(const size_t count)
+{
+    pos_x.reserve(count);
+    pos_y.reserve(count);
+    rot_cos.reserve(count);
+    rot_sin.reserve(count);
+    scale.reserve(count);
+    color.reserve(count);
+    modifier.reserve(count);
+    shape.reserve(count);
+}
+
+void AgentBatch::AgentInstances::Push(const uint8_t shape_index, const GW::Vec2f pos, const float cos, const float sin, const float size, const uint32_t _color, const uint32_t color_modifier)
+{
+    pos_x.push_back(pos.x);
+    pos_y.push_back(pos.y);
+    rot_cos.push_back(cos);
+    rot_sin.push_back(sin);
+    scale.push_back(size);
+    color.push_back(_color);
+    modifier.push_back(color_modifier);
+    shape.push_back(shape_index);
+}
+
+AgentBatch::ShapeTable AgentBatch::BuildShapeTable(const std::span<const ShapeTemplate> shapes)
+{
+    constexpr uint32_t tint_masks[] = {0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000};
+    ShapeTable table;
+    for (const auto& shape : shapes) {
+        table.first_vertex.push_back(static_cast<uint32_t>(table.vertices.size()));
+        table.vertex_count.push_back(static_cast<uint32_t>(shape.Size()));
+        table.max_vertex_count = std::max(table.max_vertex_count, static_cast<uint32_t>(shape.Size()));
+        for (size_t v = 0; v < shape.Size(); v++) {
+            table.vertices.push_back({shape.x[v], shape.y[v], tint_masks[static_cast<size_t>(shape.tint[v])]});
+        }
+    }
+    return table;
+}
+
+void AgentBatch::BuildInstanceRecords(const AgentInstances& instances, InstanceRecord* out)
+{
+    uint32_t palette[4];
+    for (size_t i = 0; i < instances.Size(); i++) {
+        BuildPalette(instances.color[i], instances.modifier[i], palette);
+        InstanceRecord& record = out[i];
+        record.x = instances.pos_x[i];
+        record.y = instances.pos_y[i];
+        record.axis_x = instances.rot_cos[i] * instances.scale[i];
+        record.axis_y = instances.rot_sin[i] * instances.scale[i];
+        record.color = palette[static_cast<size_t>(Tint::Base)];
+        record.dark = palette[static_cast<size_t>(Tint::Dark)];
+        record.light = palette[static_cast<size_t>(Tint::Light)];
+        record.center = palette[static_cast<size_t>(Tint::CircleCenter)];
+    }
+}
+
+size_t AgentBatch::EmitAgentVertices(const std::span<const ShapeTemplate> shapes, const AgentInstances& instances, D3DVertex* out, const size_t max_vertices)
+{
+    static_assert(sizeof(D3DVertex) == 16, "Kernel writes one vertex per 128-bit store");
+    const __m128 zero = _mm_setzero_ps();
+    size_t written = 0;
+    uint32_t palette[4];
+
+    for (size_t i = 0; i < instances.Size(); i++) {
+        const auto& shape = shapes[instances.shape[i]];
+        const size_t num_v = shape.Size();
+        if (written + num_v > max_vertices) {
+            break;
+        }
+        BuildPalette(instances.color[i], instances.modifier[i], palette);
+
+        // Fold rotation and scale into one 2x2 matrix: x' = vx * a - vy * b + px, y' = vx * b + vy * a + py
+        const float a = instances.rot_cos[i] * instances.scale[i];
+        const float b = instances.rot_sin[i] * instances.scale[i];
+        const float px = instances.pos_x[i];
+        const float py = instances.pos_y[i];
+        const __m128 va = _mm_set1_ps(a);
+        const __m128 vb = _mm_set1_ps(b);
+        const __m128 vpx = _mm_set1_ps(px);
+        const __m128 vpy = _mm_set1_ps(py);
+
+        const float* sx = shape.x.data();
+        const float* sy = shape.y.data();
+        const Tint* tint = shape.tint.data();
+        auto* dst = reinterpret_cast<float*>(out + written);
+
+        size_t v = 0;
+        for (; v + 4 <= num_v; v += 4, dst += 16) {
+            const __m128 x = _mm_loadu_ps(sx + v);
+            const __m128 y = _mm_loadu_ps(sy + v);
+            const __m128 rx = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(x, va), _mm_mul_ps(y, vb)), vpx);
+            const __m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, vb), _mm_mul_ps(y, va)), vpy);
+            const __m128 colors = _mm_castsi128_ps(_mm_setr_epi32(
+                static_cast<int>(palette[static_cast<size_t>(tint[v + 0])]),
+                static_cast<int>(palette[static_cast<size_t>(tint[v + 1])]),
+                static_cast<int>(palette[static_cast<size_t>(tint[v + 2])]),
+                static_cast<int>(palette[static_cast<size_t>(tint[v + 3])])));
+
+            // Transpose columns into {x, y, z = 0, color} rows
+            const __m128 xy_lo = _mm_unpacklo_ps(rx, ry);      // x0 y0 x1 y1
+            const __m128 xy_hi = _mm_unpackhi_ps(rx, ry);      // x2 y2 x3 y3
+            const __m128 zc_lo = _mm_unpacklo_ps(zero, colors); // 0 c0 0 c1
+            const __m128 zc_hi = _mm_unpackhi_ps(zero, colors); // 0 c2 0 c3
+            _mm_storeu_ps(dst + 0, _mm_movelh_ps(xy_lo, zc_lo));
+            _mm_storeu_ps(dst + 4, _mm_movehl_ps(zc_lo, xy_lo));
+            _mm_storeu_ps(dst + 8, _mm_movelh_ps(xy_hi, zc_hi));
+            _mm_storeu_ps(dst + 12, _mm_movehl_ps(zc_hi, xy_hi));
+        }
+        for (; v < num_v; v++) {
+            D3DVertex& vert = out[written + v];
+            vert.x = sx[v] * a - sy[v] * b + px;
+            vert.y = sx[v] * b + sy[v] * a + py;
+            vert.z = 0.f;
+            vert.color = palette[static_cast<size_t>(tint[v])];
+        }
+        written += num_v;
+    }
+    return written;
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <GWCA/GameContainers/GamePos.h>
+
+#include <Widgets/Minimap/D3DVertex.h>
+
+/*
+CPU side of the minimap agent pipeline, kept free of D3D and GWCA state so it can be driven headlessly.
+
+AgentRenderer classifies agents once per frame and appends one instance per shape to draw, in draw order, into an AgentInstances
+(structure of arrays). From there, one of two paths:
+
+- Instanced (shader model 3): every shape's vertices live once in a static ShapeTable, each instance is packed into a 32 byte
+  InstanceRecord, and the vertex shader does the expansion. One draw call per run of consecutive instances with the same shape.
+- Fallback: EmitAgentVertices expands every instance into triangles with an SSE2 kernel that rotates, scales and translates four
+  template vertices at a time and writes finished D3DVertex rows straight into the locked vertex buffer.
+*/
+namespace AgentBatch {
+    // Which colour a template vertex takes from its instance
+    enum class Tint : uint8_t { Base, Dark, Light, CircleCenter };
+
+    // A minimap shape in unit space, one column per component
+    struct ShapeTemplate {
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<Tint> tint;
+        float extent = 0.f; // Furthest vertex from the origin
+
+        void AddVertex(float vx, float vy, Tint t);
+        [[nodiscard]] size_t Size() const { return x.size(); }
+    };
+
+    struct AgentInstances {
+        std::vector<float> pos_x;
+        std::vector<float> pos_y;
+        std::vector<float> rot_cos;
+        std::vector<float> rot_sin;
+        std::vector<float> scale;
+        std::vector<uint32_t> color;
+        std::vector<uint32_t> modifier;
+        std::vector<uint8_t> shape;
+
+        void Clear();
+        void Reserve(size_t count);
+        void Push(uint8_t shape_index, GW::Vec2f pos, float cos, float sin, float size, uint32_t color, uint32_t color_modifier);
+        [[nodiscard]] size_t Size() const { return shape.size(); }
+    };
+
+    // Conservative bounds of what the minimap can currently show, in world coordinates
+    struct CullCircle {
+        GW::Vec2f center;
+        float radius = FLT_MAX;
+
+        [[nodiscard]] bool Overlaps(const GW::Vec2f pos, const float margin) const
+        {
+            const float reach = radius + margin;
+            return GW::GetSquareDistance(pos, center) <= reach * reach;
+        }
+    };
+
+    // Stream 1 of the instanced path; layout must match the vertex declaration in AgentRenderer and agent_instanced_vs.hlsl
+    struct InstanceRecord {
+        float x;
+        float y;
+        // size * (cos, sin): the shape's rotated and scaled x axis
+        float axis_x;
+        float axis_y;
+        uint32_t color;
+        uint32_t dark;
+        uint32_t light;
+        uint32_t center;
+    };
+    static_assert(sizeof(InstanceRecord) == 32);
+
+    // Stream 0 of the instanced path
+    struct ShapeTableVertex {
+        float x;
+        float y;
+        // One-hot mask selecting which of the instance's colours this vertex takes, as a D3DCOLOR: base = r, dark = g, light = b, center = a
+        uint32_t tint_mask;
+    };
+    static_assert(sizeof(ShapeTableVertex) == 12);
+
+    // All shapes back to back, for a static vertex buffer
+    struct ShapeTable {
+        std::vector<ShapeTableVertex> vertices;
+        std::vector<uint32_t> first_vertex; // By shape index
+        std::vector<uint32_t> vertex_count; // By shape index
+        uint32_t max_vertex_count = 0;
+    };
+
+    ShapeTable BuildShapeTable(std::span<const ShapeTemplate> shapes);
+    // Pack every instance into out, which must have room for instances.Size() records.
+    void BuildInstanceRecords(const AgentInstances& instances, InstanceRecord* out);
+
+    // Calls fn(shape_index, first_instance, count) for each run of consecutive instances that share a shape, in order.
+    template <typename Fn>
+    void ForEachShapeRun(const AgentInstances& instances, Fn&& fn)
+    {
+        const size_t count = instances.Size();
+        for (size_t first = 0; first < count;) {
+            size_t last = first + 1;
+            while (last < count && instances.shape[last] == instances.shape[first]) {
+                last++;
+            }
+            fn(instances.shape[first], first, last - first);
+            first = last;
+        }
+    }
+
+    // Expand instances into a triangle list. Writes at most max_vertices (whole shapes only); returns the number written.
+    size_t EmitAgentVertices(std::span<const ShapeTemplate> shapes, const AgentInstances& instances, D3DVertex* out, size_t max_vertices);
+}
@@ -1,5 +1,7 @@
 #include "stdafx.h"
 
+#include <bit>
+
 #include <GWCA/Context/MapContext.h>
 
 #include <GWCA/Constants/AgentIDs.h>
@@ -25,10 +27,13 @@
 #include <Widgets/Minimap/Minimap.h>
 
 #include "GWToolbox.h"
+#include "Shaders/agent_instanced_vs.h"
+#include "Shaders/vertex_colour_ps.h"
 
 constexpr auto AGENTCOLOR_INIFILENAME = L"AgentColors.ini";
 
 namespace {
+    using AgentBatch::Tint;
 
     GW::HookEntry ChatCmd_HookEntry;
     unsigned int GetAgentProfession(const GW::AgentLiving* agent)
@@ -504,60 +509,60 @@ AgentRenderer& AgentRenderer::Instance() { return *instance; }
 AgentRenderer::AgentRenderer()
 {
     instance = this;
-    shapes[Tear].AddVertex(1.8f, 0, Dark);      // A
-    shapes[Tear].AddVertex(0.7f, 0.7f, Dark);   // B
-    shapes[Tear].AddVertex(0.0f, 0.0f, Light);  // O
-    shapes[Tear].AddVertex(0.7f, 0.7f, Dark);   // B
-    shapes[Tear].AddVertex(0.0f, 1.0f, Dark);   // C
-    shapes[Tear].AddVertex(0.0f, 0.0f, Light);  // O
-    shapes[Tear].AddVertex(0.0f, 1.0f, Dark);   // C
-    shapes[Tear].AddVertex(-0.7f, 0.7f, Dark);  // D
-    shapes[Tear].AddVertex(0.0f, 0.0f, Light);  // O
-    shapes[Tear].AddVertex(-0.7f, 0.7f, Dark);  // D
-    shapes[Tear].AddVertex(-1.0f, 0.0f, Dark);  // E
-    shapes[Tear].AddVertex(0.0f, 0.0f, Light);  // O
-    shapes[Tear].AddVertex(-1.0f, 0.0f, Dark);  // E
-    shapes[Tear].AddVertex(-0.7f, -0.7f, Dark); // F
-    shapes[Tear].AddVertex(0.0f, 0.0f, Light);  // O
-    shapes[Tear].AddVertex(-0.7f, -0.7f, Dark); // F
-    shapes[Tear].AddVertex(0.0f, -1.0f, Dark);  // G
-    shapes[Tear].AddVertex(0.0f, 0.0f, Light);  // O
-    shapes[Tear].AddVertex(0.0f, -1.0f, Dark);  // G
-    shapes[Tear].AddVertex(0.7f, -0.7f, Dark);  // H
-    shapes[Tear].AddVertex(0.0f, 0.0f, Light);  // O
-    shapes[Tear].AddVertex(0.7f, -0.7f, Dark);  // H
-    shapes[Tear].AddVertex(1.8f, 0.0f, Dark);   // A
-    shapes[Tear].AddVertex(0.0f, 0.0f, Light);  // O
+    shapes[Tear].AddVertex(1.8f, 0, Tint::Dark);      // A
+    shapes[Tear].AddVertex(0.7f, 0.7f, Tint::Dark);   // B
+    shapes[Tear].AddVertex(0.0f, 0.0f, Tint::Light);  // O
+    shapes[Tear].AddVertex(0.7f, 0.7f, Tint::Dark);   // B
+    shapes[Tear].AddVertex(0.0f, 1.0f, Tint::Dark);   // C
+    shapes[Tear].AddVertex(0.0f, 0.0f, Tint::Light);  // O
+    shapes[Tear].AddVertex(0.0f, 1.0f, Tint::Dark);   // C
+    shapes[Tear].AddVertex(-0.7f, 0.7f, Tint::Dark);  // D
+    shapes[Tear].AddVertex(0.0f, 0.0f, Tint::Light);  // O
+    shapes[Tear].AddVertex(-0.7f, 0.7f, Tint::Dark);  // D
+    shapes[Tear].AddVertex(-1.0f, 0.0f, Tint::Dark);  // E
+    shapes[Tear].AddVertex(0.0f, 0.0f, Tint::Light);  // O
+    shapes[Tear].AddVertex(-1.0f, 0.0f, Tint::Dark);  // E
+    shapes[Tear].AddVertex(-0.7f, -0.7f, Tint::Dark); // F
+    shapes[Tear].AddVertex(0.0f, 0.0f, Tint::Light);  // O
+    shapes[Tear].AddVertex(-0.7f, -0.7f, Tint::Dark); // F
+    shapes[Tear].AddVertex(0.0f, -1.0f, Tint::Dark);  // G
+    shapes[Tear].AddVertex(0.0f, 0.0f, Tint::Light);  // O
+    shapes[Tear].AddVertex(0.0f, -1.0f, Tint::Dark);  // G
+    shapes[Tear].AddVertex(0.7f, -0.7f, Tint::Dark);  // H
+    shapes[Tear].AddVertex(0.0f, 0.0f, Tint::Light);  // O
+    shapes[Tear].AddVertex(0.7f, -0.7f, Tint::Dark);  // H
+    shapes[Tear].AddVertex(1.8f, 0.0f, Tint::Dark);   // A
+    shapes[Tear].AddVertex(0.0f, 0.0f, Tint::Light);  // O
 
     constexpr auto pi = DirectX::XM_PI;
     for (int i = 0; i < num_triangles; ++i) {
         const float angle1 = 2 * (i + 0) * pi / num_triangles;
         const float angle2 = 2 * (i + 1) * pi / num_triangles;
-        shapes[Circle].AddVertex(std::cos(angle1), std::sin(angle1), Dark);
-        shapes[Circle].AddVertex(std::cos(angle2), std::sin(angle2), Dark);
-        shapes[Circle].AddVertex(0.0f, 0.0f, Light);
+        shapes[Circle].AddVertex(std::cos(angle1), std::sin(angle1), Tint::Dark);
+        shapes[Circle].AddVertex(std::cos(angle2), std::sin(angle2), Tint::Dark);
+        shapes[Circle].AddVertex(0.0f, 0.0f, Tint::Light);
     }
 
     for (int i = 0; i < num_triangles; ++i) {
         const float angle1 = 2 * (i + 0) * pi / num_triangles;
         const float angle2 = 2 * (i + 1) * pi / num_triangles;
-        shapes[BigCircle].AddVertex(std::cos(angle1), std::sin(angle1), None);
-        shapes[BigCircle].AddVertex(std::cos(angle2), std::sin(angle2), None);
-        shapes[BigCircle].AddVertex(0.0f, 0.0f, CircleCenter);
-    }
-
-    shapes[Quad].AddVertex(1.0f, -1.0f, Dark);
-    shapes[Quad].AddVertex(1.0f, 1.0f, Dark);
-    shapes[Quad].AddVertex(0.0f, 0.0f, Light);
-    shapes[Quad].AddVertex(1.0f, 1.0f, Dark);
-    shapes[Quad].AddVertex(-1.0f, 1.0f, Dark);
-    shapes[Quad].AddVertex(0.0f, 0.0f, Light);
-    shapes[Quad].AddVertex(-1.0f, 1.0f, Dark);
-    shapes[Quad].AddVertex(-1.0f, -1.0f, Dark);
-    shapes[Quad].AddVertex(0.0f, 0.0f, Light);
-    shapes[Quad].AddVertex(-1.0f, -1.0f, Dark);
-    shapes[Quad].AddVertex(1.0f, -1.0f, Dark);
-    shapes[Quad].AddVertex(0.0f, 0.0f, Light);
+        shapes[BigCircle].AddVertex(std::cos(angle1), std::sin(angle1), Tint::Base);
+        shapes[BigCircle].AddVertex(std::cos(angle2), std::sin(angle2), Tint::Base);
+        shapes[BigCircle].AddVertex(0.0f, 0.0f, Tint::CircleCenter);
+    }
+
+    shapes[Quad].AddVertex(1.0f, -1.0f, Tint::Dark);
+    shapes[Quad].AddVertex(1.0f, 1.0f, Tint::Dark);
+    shapes[Quad].AddVertex(0.0f, 0.0f, Tint::Light);
+    shapes[Quad].AddVertex(1.0f, 1.0f, Tint::Dark);
+    shapes[Quad].AddVertex(-1.0f, 1.0f, Tint::Dark);
+    shapes[Quad].AddVertex(0.0f, 0.0f, Tint::Light);
+    shapes[Quad].AddVertex(-1.0f, 1.0f, Tint::Dark);
+    shapes[Quad].AddVertex(-1.0f, -1.0f, Tint::Dark);
+    shapes[Quad].AddVertex(0.0f, 0.0f, Tint::Light);
+    shapes[Quad].AddVertex(-1.0f, -1.0f, Tint::Dark);
+    shapes[Quad].AddVertex(1.0f, -1.0f, Tint::Dark);
+    shapes[Quad].AddVertex(0.0f, 0.0f, Tint::Light);
 
     constexpr size_t star_ntriangles = 16;
     constexpr float star_size_small = 1.f;
@@ -568,15 +573,15 @@ AgentRenderer::AgentRenderer()
 
         const float size1 = (i + 0) % 2 == 0 ? star_size_small : star_size_big;
         const float size2 = (i + 1) % 2 == 0 ? star_size_small : star_size_big;
-        shapes[Star].AddVertex(std::cos(angle1) * size1, std::sin(angle1) * size1, None);
-        shapes[Star].AddVertex(std::cos(angle2) * size2, std::sin(angle2) * size2, None);
-        shapes[Star].AddVertex(0.0f, 0.0f, CircleCenter);
+        shapes[Star].AddVertex(std::cos(angle1) * size1, std::sin(angle1) * size1, Tint::Base);
+        shapes[Star].AddVertex(std::cos(angle2) * size2, std::sin(angle2) * size2, Tint::Base);
+        shapes[Star].AddVertex(0.0f, 0.0f, Tint::CircleCenter);
     }
 
     max_shape_verts = 0;
     for (int shape = 0; shape < shape_size; ++shape) {
-        if (max_shape_verts < shapes[shape].vertices.size()) {
-            max_shape_verts = shapes[shape].vertices.size();
+        if (max_shape_verts < shapes[shape].Size()) {
+            max_shape_verts = shapes[shape].Size();
         }
     }
 }
@@ -620,11 +625,6 @@ void AgentRenderer::OnUIMessage(GW::HookStatus*, const GW::UI::UIMessage msgid,
     }
 }
 
-void AgentRenderer::Shape_t::AddVertex(const float x, const float y, const Color_Modifier mod)
-{
-    vertices.push_back(Shape_Vertex(x, y, mod));
-}
-
 void AgentRenderer::Initialize(IDirect3DDevice9* device)
 {
     if (initialized) {
@@ -633,12 +633,12 @@ void AgentRenderer::Initialize(IDirect3DDevice9* device)
     initialized = true;
     type = D3DPT_TRIANGLELIST;
     vertices_max = max_shape_verts * 0x200; // support for up to 512 agents, should be enough
-    vertices = nullptr;
     const HRESULT hr = device->CreateVertexBuffer(sizeof(D3DVertex) * vertices_max, 0,
                                                   D3DFVF_CUSTOMVERTEX, D3DPOOL_MANAGED, &buffer, nullptr);
     if (FAILED(hr)) {
         printf("AgentRenderer initialize error: HRESULT: 0x%lX\n", hr);
     }
+    use_instancing = InitializeInstancing(device);
 
     constexpr GW::UI::UIMessage hook_messages[] = {
         GW::UI::UIMessage::kShowAgentNameTag,
@@ -687,29 +687,38 @@ std::vector<const AgentRenderer::CustomAgent*>* AgentRenderer::GetCustomAgentsTo
     return &out;
 };
 
-void AgentRenderer::Render(IDirect3DDevice9* device)
+float AgentRenderer::GetMaxAgentExtent() const
 {
-    if (!initialized) {
-        Initialize(device);
-        initialized = true;
+    float max_size = std::max({size_default, size_player, size_signpost, size_item, size_boss, size_minion, size_marked_target});
+    for (const CustomAgent* ca : custom_agents) {
+        if (ca->active && ca->size_active) {
+            max_size = std::max(max_size, ca->size);
+        }
     }
-
-    const HRESULT res = buffer->Lock(0, sizeof(D3DVertex) * vertices_max, (VOID**)&vertices, D3DLOCK_DISCARD);
-    if (FAILED(res)) {
-        printf("AgentRenderer Lock() HRESULT: 0x%lX\n", res);
+    float max_extent = 0.f;
+    for (const auto& shape : shapes) {
+        max_extent = std::max(max_extent, shape.extent);
     }
+    return (max_size + std::max(agent_border_thickness, target_border_thickness)) * max_extent;
+}
 
-    vertices_count = 0;
+void AgentRenderer::BuildInstances()
+{
+    instances.Clear();
+    target_drawn = false;
 
     if (show_props_on_minimap) {
         const auto& props = GW::GetMapContext()->props->propArray;
+        const float prop_margin = size_item * shapes[Quad].extent;
         for (size_t i = 0; i < props.size(); i++) {
-            Enqueue(Quad, props[i], size_item, color_signpost);
+            if (cull_circle.Overlaps({props[i]->position.x, props[i]->position.y}, prop_margin)) {
+                Enqueue(Quad, props[i], size_item, color_signpost);
+            }
         }
     }
 
     // get stuff
-    GW::AgentArray* agents = GW::Agents::GetAgentArray();
+    const GW::AgentArray* agents = GW::Agents::GetAgentArray();
     if (!agents) {
         return;
     }
@@ -724,36 +733,10 @@ void AgentRenderer::Render(IDirect3DDevice9* device)
         target = target_ ? target_->GetAsAgentLiving() : nullptr;
     }
 
-    // 1. eoes
-    for (GW::Agent* agent_ptr : *agents) {
-        if (!agent_ptr) {
-            continue;
-        }
-        const GW::AgentLiving* agent = agent_ptr->GetAsAgentLiving();
-        if (!agent) {
-            continue;
-        }
-        if (agent->GetIsDead()) {
-            continue;
-        }
-        switch (agent->player_number) {
-            case GW::Constants::ModelID::EoE:
-                Enqueue(BigCircle, agent, GW::Constants::Range::Spirit, color_eoe);
-                break;
-            case GW::Constants::ModelID::QZ:
-                Enqueue(BigCircle, agent, GW::Constants::Range::Spirit, color_qz);
-                break;
-            case GW::Constants::ModelID::Winnowing:
-                Enqueue(BigCircle, agent, GW::Constants::Range::Spirit, color_winnowing);
-                break;
-            default:
-                break;
-        }
-    }
-    // 2. non-player agents
+    static std::vector<std::pair<const GW::AgentLiving*, Color>> eoes_to_draw;
+    eoes_to_draw.clear();
     static std::vector<std::pair<const GW::Agent*, const CustomAgent*>> custom_agents_to_draw;
     custom_agents_to_draw.clear();
-
     static std::vector<const GW::AgentLiving*> marked_targets_to_draw;
     marked_targets_to_draw.clear();
     static std::vector<const GW::AgentLiving*> players_to_draw;
@@ -763,9 +746,10 @@ void AgentRenderer::Render(IDirect3DDevice9* device)
     static std::vector<const GW::Agent*> other_agents_to_draw;
     other_agents_to_draw.clear();
 
-    target_drawn = false;
-
-    // some helper lambads
+    const float agent_margin = GetMaxAgentExtent();
+    const float eoe_margin = GW::Constants::Range::Spirit * shapes[BigCircle].extent;
+    const bool is_doa = GW::Map::GetMapID() == GW::Constants::MapID::Domain_of_Anguish;
+    const GW::Agent* observing = GW::Agents::GetObservingAgent();
 
     const auto add_custom_agents_to_draw = [this](const GW::Agent* agent) -> bool {
         const auto custom_agents_for_this_agent = GetCustomAgentsToDraw(agent);
@@ -778,69 +762,58 @@ void AgentRenderer::Render(IDirect3DDevice9* device)
         return true;
     };
 
-    const auto add_marked_target = [](const GW::AgentLiving* agent) -> bool {
-        if (!GetMarkedTarget(agent ? agent->agent_id : 0)) {
-            return false;
-        }
-        marked_targets_to_draw.push_back(agent);
-        return true;
-    };
-
-    const auto add_other_players_to_draw = [](const GW::AgentLiving* agent) -> bool {
-        if (!agent || !agent->IsPlayer() || agent == GW::Agents::GetObservingAgent()) {
-            return false;
-        }
-        players_to_draw.push_back(agent);
-        return true;
-    };
-
-    const auto add_dead_agent_to_draw = [](const GW::AgentLiving* agent) -> bool {
-        if (!agent || !agent->GetIsDead()) {
-            return false;
-        }
-        dead_agents_to_draw.push_back(agent);
-        return true;
-    };
-
-    auto sort_custom_agents_to_draw = [] {
-        std::ranges::sort(
-            custom_agents_to_draw,
-            [&](const std::pair<const GW::Agent*, const CustomAgent*>& pA,
-                const std::pair<const GW::Agent*, const CustomAgent*>& pB) {
-                return pA.second->index > pB.second->index;
-            });
-    };
-
-    // Sort through all agents, fill out arrays
+    // Single pass over the agent array: each agent lands in exactly one bucket, plus the eoe bucket if it's a spirit range.
     for (const auto agent : *agents) {
         if (!agent) {
             continue;
         }
+        const GW::AgentLiving* living = agent->GetAsAgentLiving();
+        // 1. eoes, drawn underneath everything including the player and target
+        if (living && !living->GetIsDead() && cull_circle.Overlaps(living->pos, eoe_margin)) {
+            switch (living->player_number) {
+                case GW::Constants::ModelID::EoE:
+                    eoes_to_draw.push_back({living, color_eoe});
+                    break;
+                case GW::Constants::ModelID::QZ:
+                    eoes_to_draw.push_back({living, color_qz});
+                    break;
+                case GW::Constants::ModelID::Winnowing:
+                    eoes_to_draw.push_back({living, color_winnowing});
+                    break;
+                default:
+                    break;
+            }
+        }
         if (agent == player) {
             continue; //  7. player
         }
         if (agent == target) {
             continue; // 4. target if it's a non-player, 6. target if it's a player
         }
+        if (!cull_circle.Overlaps(agent->pos, agent_margin)) {
+            continue; // Off the edge of the minimap
+        }
         if (agent->GetIsGadgetType()) {
             const auto gadget = agent->GetAsAgentGadget();
-            if (GW::Map::GetMapID() == GW::Constants::MapID::Domain_of_Anguish && gadget->extra_type == 7602) {
+            if (is_doa && gadget->extra_type == 7602) {
                 continue;
             }
             add_custom_agents_to_draw(gadget);
         }
-        else if (agent->GetIsLivingType()) {
-            const auto living = agent->GetAsAgentLiving();
+        else if (living) {
             if (!show_hidden_npcs && !GW::Agents::GetIsAgentTargettable(living)) {
                 continue;
             }
-            if (add_marked_target(living)) {
+            if (GetMarkedTarget(living->agent_id)) {
+                marked_targets_to_draw.push_back(living);
                 continue; // 8. marked targets
             }
-            if (add_other_players_to_draw(living)) {
+            if (living->IsPlayer() && living != observing) {
+                players_to_draw.push_back(living);
                 continue; // 5. players
             }
-            if (add_dead_agent_to_draw(living)) {
+            if (living->GetIsDead()) {
+                dead_agents_to_draw.push_back(living);
                 continue;
             }
             if (add_custom_agents_to_draw(living)) {
@@ -850,6 +823,11 @@ void AgentRenderer::Render(IDirect3DDevice9* device)
         other_agents_to_draw.push_back(agent);
     }
 
+    // 1. eoes
+    for (const auto& [agent, color] : eoes_to_draw) {
+        Enqueue(BigCircle, agent, GW::Constants::Range::Spirit, color);
+    }
+
     // Dead agents
     for (const auto agent : dead_agents_to_draw) {
         Enqueue(agent);
@@ -861,7 +839,9 @@ void AgentRenderer::Render(IDirect3DDevice9* device)
     }
 
     // 3. custom colored models
-    sort_custom_agents_to_draw();
+    std::ranges::sort(custom_agents_to_draw, [](const auto& pA, const auto& pB) {
+        return pA.second->index > pB.second->index;
+    });
     for (const auto& [fst, snd] : custom_agents_to_draw) {
         Enqueue(fst, snd);
     }
@@ -908,13 +888,189 @@ void AgentRenderer::Render(IDirect3DDevice9* device)
     if (player) {
         Enqueue(player);
     }
+}
+
+void AgentRenderer::Invalidate()
+{
+    VBuffer::Invalidate();
+    const auto release = [](auto*& resource) {
+        if (resource) {
+            resource->Release();
+        }
+        resource = nullptr;
+    };
+    release(shape_buffer);
+    release(shape_indices);
+    release(instance_buffer);
+    release(instance_declaration);
+    release(instance_vshader);
+    release(instance_pshader);
+    instance_capacity = 0;
+    use_instancing = false;
+}
+
+bool AgentRenderer::InitializeInstancing(IDirect3DDevice9* device)
+{
+    D3DCAPS9 caps;
+    if (device->GetDeviceCaps(&caps) != D3D_OK
+        || caps.VertexShaderVersion < D3DVS_VERSION(3, 0)
+        || caps.PixelShaderVersion < D3DPS_VERSION(3, 0)
+        || !(caps.DevCaps2 & D3DDEVCAPS2_STREAMOFFSET)) {
+        return false;
+    }
+
+    shape_table = AgentBatch::BuildShapeTable(shapes);
+    const auto& table_vertices = shape_table.vertices;
+    const UINT shape_bytes = table_vertices.size() * sizeof(AgentBatch::ShapeTableVertex);
+    void* mem = nullptr;
+    if (device->CreateVertexBuffer(shape_bytes, D3DUSAGE_WRITEONLY, 0, D3DPOOL_MANAGED, &shape_buffer, nullptr) != D3D_OK
+        || shape_buffer->Lock(0, shape_bytes, &mem, 0) != D3D_OK) {
+        return false;
+    }
+    memcpy(mem, table_vertices.data(), shape_bytes);
+    shape_buffer->Unlock();
+
+    // Every shape is a plain triangle list, so one identity index buffer serves them all via BaseVertexIndex
+    const UINT index_bytes = shape_table.max_vertex_count * sizeof(uint16_t);
+    if (device->CreateIndexBuffer(index_bytes, D3DUSAGE_WRITEONLY, D3DFMT_INDEX16, D3DPOOL_MANAGED, &shape_indices, nullptr) != D3D_OK
+        || shape_indices->Lock(0, index_bytes, &mem, 0) != D3D_OK) {
+        return false;
+    }
+    const auto indices = static_cast<uint16_t*>(mem);
+    for (uint32_t i = 0; i < shape_table.max_vertex_count; i++) {
+        indices[i] = static_cast<uint16_t>(i);
+    }
+    shape_indices->Unlock();
+
+    constexpr D3DVERTEXELEMENT9 decl[] = {
+        {0, 0, D3DDECLTYPE_FLOAT2, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_POSITION, 0},
+        {0, 8, D3DDECLTYPE_D3DCOLOR, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_COLOR, 0},
+        {1, 0, D3DDECLTYPE_FLOAT4, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_TEXCOORD, 0},
+        {1, 16, D3DDECLTYPE_D3DCOLOR, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_COLOR, 1},
+        {1, 20, D3DDECLTYPE_D3DCOLOR, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_COLOR, 2},
+        {1, 24, D3DDECLTYPE_D3DCOLOR, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_COLOR, 3},
+        {1, 28, D3DDECLTYPE_D3DCOLOR, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_COLOR, 4},
+        D3DDECL_END()
+    };
+    if (device->CreateVertexDeclaration(decl, &instance_declaration) != D3D_OK) {
+        return false;
+    }
+    if (device->CreateVertexShader(reinterpret_cast<const DWORD*>(&agent_instanced_vs), &instance_vshader) != D3D_OK) {
+        return false;
+    }
+    if (device->CreatePixelShader(reinterpret_cast<const DWORD*>(&vertex_colour_ps), &instance_pshader) != D3D_OK) {
+        return false;
+    }
+    return ReserveInstanceBuffer(device, 0x200);
+}
+
+bool AgentRenderer::ReserveInstanceBuffer(IDirect3DDevice9* device, const size_t count)
+{
+    if (count <= instance_capacity && instance_buffer) {
+        return true;
+    }
+    if (instance_buffer) {
+        instance_buffer->Release();
+        instance_buffer = nullptr;
+    }
+    instance_capacity = std::bit_ceil(count);
+    const UINT bytes = instance_capacity * sizeof(AgentBatch::InstanceRecord);
+    if (device->CreateVertexBuffer(bytes, D3DUSAGE_WRITEONLY, 0, D3DPOOL_MANAGED, &instance_buffer, nullptr) != D3D_OK) {
+        instance_capacity = 0;
+        return false;
+    }
+    return true;
+}
+
+bool AgentRenderer::RenderInstanced(IDirect3DDevice9* device)
+{
+    if (!ReserveInstanceBuffer(device, instances.Size())) {
+        return false;
+    }
+    AgentBatch::InstanceRecord* records = nullptr;
+    const UINT bytes = instances.Size() * sizeof(AgentBatch::InstanceRecord);
+    if (instance_buffer->Lock(0, bytes, reinterpret_cast<void**>(&records), D3DLOCK_DISCARD) != D3D_OK) {
+        return false;
+    }
+    AgentBatch::BuildInstanceRecords(instances, records);
+    instance_buffer->Unlock();
+
+    // The shader replaces the fixed function transform, so fold the minimap's matrices into one
+    D3DMATRIX world, view, proj;
+    device->GetTransform(D3DTS_WORLD, &world);
+    device->GetTransform(D3DTS_VIEW, &view);
+    device->GetTransform(D3DTS_PROJECTION, &proj);
+    DirectX::XMFLOAT4X4A world_view_proj;
+    XMStoreFloat4x4A(&world_view_proj, XMMatrixTranspose(
+                         XMLoadFloat4x4(reinterpret_cast<const DirectX::XMFLOAT4X4*>(&world))
+                         * XMLoadFloat4x4(reinterpret_cast<const DirectX::XMFLOAT4X4*>(&view))
+                         * XMLoadFloat4x4(reinterpret_cast<const DirectX::XMFLOAT4X4*>(&proj))));
+    if (device->SetVertexShaderConstantF(0, reinterpret_cast<const float*>(&world_view_proj), 4) != D3D_OK
+        || device->SetVertexDeclaration(instance_declaration) != D3D_OK
+        || device->SetVertexShader(instance_vshader) != D3D_OK
+        || device->SetPixelShader(instance_pshader) != D3D_OK) {
+        Log::Error("AgentRenderer: unable to set up instanced rendering, falling back to cpu vertices.");
+        device->SetVertexShader(nullptr);
+        device->SetPixelShader(nullptr);
+        device->SetFVF(D3DFVF_CUSTOMVERTEX);
+        return false;
+    }
+    device->SetIndices(shape_indices);
+    device->SetStreamSource(0, shape_buffer, 0, sizeof(AgentBatch::ShapeTableVertex));
+
+    // Draw order matters (later agents on top), so batch by runs of the same shape rather than by shape
+    AgentBatch::ForEachShapeRun(instances, [&](const uint8_t shape, const size_t first, const size_t count) {
+        const UINT num_vertices = shape_table.vertex_count[shape];
+        device->SetStreamSourceFreq(0, D3DSTREAMSOURCE_INDEXEDDATA | count);
+        device->SetStreamSource(1, instance_buffer, first * sizeof(AgentBatch::InstanceRecord), sizeof(AgentBatch::InstanceRecord));
+        device->SetStreamSourceFreq(1, D3DSTREAMSOURCE_INSTANCEDATA | 1u);
+        device->DrawIndexedPrimitive(D3DPT_TRIANGLELIST, shape_table.first_vertex[shape], 0, num_vertices, 0, num_vertices / 3);
+    });
+
+    device->SetStreamSourceFreq(0, 1);
+    device->SetStreamSourceFreq(1, 1);
+    device->SetStreamSource(1, nullptr, 0, 0);
+    device->SetIndices(nullptr);
+    device->SetVertexShader(nullptr);
+    device->SetPixelShader(nullptr);
+    device->SetFVF(D3DFVF_CUSTOMVERTEX);
+    return true;
+}
+
+void AgentRenderer::Render(IDirect3DDevice9* device)
+{
+    if (!initialized) {
+        Initialize(device);
+        initialized = true;
+    }
 
+    cull_circle = Minimap::GetVisibleWorldCircle();
+    BuildInstances();
+    if (!instances.Size()) {
+        return;
+    }
+    if (use_instancing) {
+        use_instancing = RenderInstanced(device);
+        if (use_instancing) {
+            return;
+        }
+    }
+    if (!buffer) {
+        return;
+    }
+
+    D3DVertex* vertices = nullptr;
+    const HRESULT res = buffer->Lock(0, sizeof(D3DVertex) * vertices_max, (VOID**)&vertices, D3DLOCK_DISCARD);
+    if (FAILED(res)) {
+        printf("AgentRenderer Lock() HRESULT: 0x%lX\n", res);
+        return;
+    }
+    const size_t vertices_count = AgentBatch::EmitAgentVertices(shapes, instances, vertices, vertices_max);
     buffer->Unlock();
 
     if (vertices_count != 0) {
         device->SetStreamSource(0, buffer, 0, sizeof(D3DVertex));
         device->DrawPrimitive(D3DPT_TRIANGLELIST, 0, vertices_count / 3);
-        vertices_count = 0;
     }
 }
 
@@ -1266,32 +1422,7 @@ void AgentRenderer::Enqueue(const Shape_e shape, const RenderPosition& pos, cons
     if ((color & IM_COL32_A_MASK) == 0) {
         return;
     }
-    const size_t num_v = shapes[shape].vertices.size();
-    ASSERT(vertices_count < vertices_max - num_v);
-
-    for (size_t i = 0; i < num_v; ++i) {
-        const Shape_Vertex& vert = shapes[shape].vertices[i];
-        const GW::Vec2f calc_pos = Rotate(vert, pos.rotation_cos, pos.rotation_sin) * size + pos.position;
-        switch (vert.modifier) {
-            case Dark:
-                vertices[i].color = Colors::Sub(color, modifier);
-                break;
-            case Light:
-                vertices[i].color = Colors::Add(color, modifier);
-                break;
-            case CircleCenter:
-                vertices[i].color = Colors::Sub(color, IM_COL32(0, 0, 0, 50));
-                break;
-            default:
-                vertices[i].color = color;
-                break;
-        }
-        vertices[i].z = 0.0f;
-        vertices[i].x = calc_pos.x;
-        vertices[i].y = calc_pos.y;
-    }
-    vertices += num_v;
-    vertices_count += num_v;
+    instances.Push(static_cast<uint8_t>(shape), pos.position, pos.rotation_cos, pos.rotation_sin, size, color, modifier);
 }
 
 void AgentRenderer::BuildCustomAgentsMap()
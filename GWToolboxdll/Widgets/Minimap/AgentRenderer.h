@@ -4,6 +4,7 @@
 
 #include <GWCA/GameContainers/GamePos.h>
 
+#include <Widgets/Minimap/AgentBatch.h>
 #include <Widgets/Minimap/VBuffer.h>
 
 namespace GW {
@@ -28,6 +29,7 @@ public:
     static AgentRenderer& Instance();
 
     void Render(IDirect3DDevice9* device) override;
+    void Invalidate() override;
 
     void DrawSettings();
     void LoadSettings(const ToolboxIni* ini, const char* section);
@@ -53,16 +55,6 @@ private:
 
     enum Shape_e { Tear, Circle, Quad, BigCircle, Star };
 
-    enum Color_Modifier {
-        None,
-        // rgb 0,0,0
-        Dark,
-        // user defined
-        Light,
-        // user defined
-        CircleCenter // alpha -50
-    };
-
     class CustomAgent {
         static unsigned int cur_ui_id;
 
@@ -103,19 +95,7 @@ private:
         bool size_active = false;
     };
 
-    struct Shape_Vertex : GW::Vec2f {
-        Shape_Vertex(const float x, const float y, const Color_Modifier mod)
-            : Vec2f(x, y), modifier(mod) { }
-
-        Color_Modifier modifier;
-    };
-
-    struct Shape_t {
-        std::vector<Shape_Vertex> vertices{};
-        void AddVertex(float x, float y, Color_Modifier mod);
-    };
-
-    Shape_t shapes[shape_size];
+    AgentBatch::ShapeTemplate shapes[shape_size];
 
     void Initialize(IDirect3DDevice9* device) override;
 
@@ -136,11 +116,31 @@ private:
     void Enqueue(Shape_e shape, const RenderPosition& pos, float size, Color color, Color modifier = 0);
 
     std::vector<const CustomAgent*>* GetCustomAgentsToDraw(const GW::Agent* agent);
-
-    D3DVertex* vertices = nullptr;    // vertices array
-    unsigned int vertices_count = 0;  // count of vertices
-    unsigned int vertices_max = 0;    // max number of vertices to draw in one call
-    unsigned int max_shape_verts = 0; // max number of triangles in a single shape
+    // Largest radius any agent could be drawn with this frame, including borders; used as the culling margin
+    float GetMaxAgentExtent() const;
+    // Classify every agent in one pass and fill instances in draw order. No D3D calls.
+    void BuildInstances();
+
+    // Draw instances with the vertex shader expanding shapes; false if it couldn't be set up. Leaves device state as the fixed function path expects.
+    bool RenderInstanced(IDirect3DDevice9* device);
+    bool InitializeInstancing(IDirect3DDevice9* device);
+    bool ReserveInstanceBuffer(IDirect3DDevice9* device, size_t count);
+
+    AgentBatch::AgentInstances instances;
+    AgentBatch::CullCircle cull_circle;
+    unsigned int vertices_max = 0;    // max number of vertices to draw in one call, fallback path only
+    unsigned int max_shape_verts = 0; // max number of vertices in a single shape
+
+    // Instanced path; no fixed agent cap, the instance buffer grows as needed
+    bool use_instancing = false;
+    AgentBatch::ShapeTable shape_table;
+    IDirect3DVertexBuffer9* shape_buffer = nullptr;
+    IDirect3DIndexBuffer9* shape_indices = nullptr; // 0..max_vertex_count - 1, shared by every shape
+    IDirect3DVertexBuffer9* instance_buffer = nullptr;
+    size_t instance_capacity = 0;
+    IDirect3DVertexDeclaration9* instance_declaration = nullptr;
+    IDirect3DVertexShader9* instance_vshader = nullptr;
+    IDirect3DPixelShader9* instance_pshader = nullptr;
 
     Color color_agent_modifier = 0;
     Color color_agent_damaged_modifier = 0;
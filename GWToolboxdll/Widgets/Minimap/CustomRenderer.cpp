@@ -65,7 +65,7 @@ CustomRenderer::CustomPolygon::CustomPolygon(const GW::Constants::MapID m, const
 void CustomRenderer::LoadSettings(const ToolboxIni* ini, const char* section)
 {
     color = Colors::Load(ini, section, "color_custom_markers", 0xFFFFFFFF);
-    Invalidate();
+    TouchAll();
     LoadMarkers();
 }
 
@@ -73,7 +73,13 @@ void CustomRenderer::LoadMarkers()
 {
     // clear current markers
     lines.clear();
+    for (const auto& marker : markers) {
+        geometry.Release(marker.chunk);
+    }
     markers.clear();
+    for (const auto& polygon : polygons) {
+        geometry.Release(polygon.chunk);
+    }
     polygons.clear();
 
     ASSERT(inifile.LoadIfExists(Resources::GetSettingFile(ini_filename).c_str()) == SI_OK);
@@ -228,7 +234,16 @@ void CustomRenderer::SaveMarkers()
 void CustomRenderer::Invalidate()
 {
     VBuffer::Invalidate();
-    linecircle.Invalidate();
+    geometry.Invalidate();
+}
+
+void CustomRenderer::TouchAll()
+{
+    // Everything that falls back to the default colour
+    for (auto& marker : markers) {
+        marker.Touch();
+    }
+    linecircle_version++;
 }
 
 void CustomRenderer::SetTooltipMapID(const GW::Constants::MapID& map_id)
@@ -259,7 +274,7 @@ CustomRenderer::CustomLine* CustomRenderer::AddCustomLine(const GW::GamePos& fro
 void CustomRenderer::DrawLineSettings()
 {
     if (Colors::DrawSettingHueWheel("Color", &color)) {
-        Invalidate();
+        TouchAll();
     }
     const float spacing = ImGui::GetStyle().ItemInnerSpacing.x;
     ImGui::PushID("lines");
@@ -348,7 +363,7 @@ void CustomRenderer::DrawLineSettings()
 void CustomRenderer::DrawMarkerSettings()
 {
     if (Colors::DrawSettingHueWheel("Color", &color)) {
-        Invalidate();
+        TouchAll();
     }
     const float spacing = ImGui::GetStyle().ItemInnerSpacing.x;
     ImGui::PushID("markers");
@@ -422,14 +437,12 @@ void CustomRenderer::DrawMarkerSettings()
         }
         ImGui::PopID();
         if (marker_changed) {
-            marker.Invalidate();
+            marker.Touch();
             markers_changed = true;
         }
         if (remove) {
+            geometry.Release(marker.chunk);
             markers.erase(markers.begin() + static_cast<int>(i));
-            for (auto& mark : markers) {
-                mark.Invalidate();
-            }
             markers_changed = true;
         }
     }
@@ -438,10 +451,6 @@ void CustomRenderer::DrawMarkerSettings()
         char buf[32];
         snprintf(buf, 32, "marker%zu", markers.size());
         markers.push_back(CustomMarker(buf));
-        // invalidate in crease vector size increased and reallocated array
-        for (auto& mark : markers) {
-            mark.Invalidate();
-        }
         markers_changed = true;
     }
 }
@@ -559,15 +568,13 @@ void CustomRenderer::DrawPolygonSettings()
 
         ImGui::PopID();
         if (remove) {
+            geometry.Release(polygon.chunk);
             polygons.erase(polygons.begin() + signed_idx);
-            for (auto& poly : polygons) {
-                poly.Invalidate();
-            }
             markers_changed = true;
             break;
         }
         if (polygon_changed) {
-            polygon.Invalidate();
+            polygon.Touch();
         }
         markers_changed |= polygon_changed;
     }
@@ -576,10 +583,6 @@ void CustomRenderer::DrawPolygonSettings()
         char buf[32];
         snprintf(buf, 32, "polygon%zu", polygons.size());
         polygons.emplace_back(buf);
-        // invalidate in crease vector size increased and reallocated array
-        for (auto& poly : polygons) {
-            poly.Invalidate();
-        }
         markers_changed = true;
     }
 }
@@ -641,185 +644,82 @@ void CustomRenderer::Terminate()
     lines.clear();
 }
 
-void CustomRenderer::CustomPolygon::Initialize(IDirect3DDevice9* device)
+void CustomRenderer::UpdateGeometry()
 {
-    if (filled && points.size() < max_points_filled) {
-        if (points.size() < 3) {
-            return; // can't draw a triangle with less than 3 vertices
-        }
-        type = D3DPT_TRIANGLELIST;
-
-        const auto poly = std::vector{{points}};
-        point_indices.clear();
-        point_indices = mapbox::earcut<unsigned>(poly);
-
-        const auto vertex_count = point_indices.size();
-        D3DVertex* _vertices = nullptr;
-
-        if (buffer) {
-            buffer->Release();
-        }
-        device->CreateVertexBuffer(
-            sizeof(D3DVertex) * vertex_count, 0, D3DFVF_CUSTOMVERTEX, D3DPOOL_MANAGED, &buffer, nullptr);
-        buffer->Lock(0, sizeof(D3DVertex) * vertex_count, reinterpret_cast<void**>(&_vertices), D3DLOCK_DISCARD);
-
-        for (auto i = 0u; i < point_indices.size(); i++) {
-            _vertices[i].x = points.at(point_indices.at(i)).x;
-            _vertices[i].y = points.at(point_indices.at(i)).y;
-            _vertices[i].z = 0.f;
-            _vertices[i].color = color;
+    for (auto& polygon : polygons) {
+        if (!geometry.IsCurrent(polygon.chunk, polygon.version)) {
+            BuildPolygonGeometry(polygon);
         }
-
-        buffer->Unlock();
     }
-    else {
-        if (points.size() < 2) {
-            return;
-        }
-        type = D3DPT_LINESTRIP;
-
-        const auto vertex_count = points.size() + 1;
-        D3DVertex* _vertices = nullptr;
-
-        if (buffer) {
-            buffer->Release();
+    for (auto& marker : markers) {
+        if (!geometry.IsCurrent(marker.chunk, marker.version)) {
+            BuildMarkerGeometry(marker);
         }
-        device->CreateVertexBuffer(
-            sizeof(D3DVertex) * vertex_count, 0, D3DFVF_CUSTOMVERTEX, D3DPOOL_MANAGED, &buffer, nullptr);
-        buffer->Lock(0, sizeof(D3DVertex) * vertex_count, reinterpret_cast<void**>(&_vertices), D3DLOCK_DISCARD);
-
-        for (auto i = 0u; i < points.size(); i++) {
-            _vertices[i].x = points.at(i).x;
-            _vertices[i].y = points.at(i).y;
-            _vertices[i].z = 0.f;
-            _vertices[i].color = color;
-        }
-
-        buffer->Unlock();
-    }
-    initialized = true;
-}
-
-void CustomRenderer::CustomPolygon::Render(IDirect3DDevice9* device)
-{
-    if (!initialized) {
-        Initialize(device);
     }
-    if (filled && points.size() < 3 || !filled && points.size() < 2) {
-        return;
-    }
-
-    if (visible && (map == GW::Constants::MapID::None || map == GW::Map::GetMapID())) {
-        const auto primitive_count = filled ? point_indices.size() / 3 : points.size() - 1;
-        device->SetFVF(D3DFVF_CUSTOMVERTEX);
-        device->SetStreamSource(0, buffer, 0, sizeof(D3DVertex));
-        device->DrawPrimitive(type, 0, primitive_count);
+    if (!geometry.IsCurrent(linecircle, linecircle_version)) {
+        BuildLineCircleGeometry();
     }
 }
 
-void CustomRenderer::CustomMarker::Initialize(IDirect3DDevice9* device)
+void CustomRenderer::BuildPolygonGeometry(CustomPolygon& polygon)
 {
-    const auto colour = (color & IM_COL32_A_MASK) == 0 ? CustomRenderer::color : color;
-    if (shape == Shape::FullCircle) {
-        type = D3DPT_TRIANGLEFAN;
-        count = 48;
-        const unsigned vertex_count = count + 2;
-        D3DVertex* _vertices = nullptr;
-
-        if (buffer) {
-            buffer->Release();
-        }
-        device->CreateVertexBuffer(
-            sizeof(D3DVertex) * vertex_count, 0, D3DFVF_CUSTOMVERTEX, D3DPOOL_MANAGED, &buffer, nullptr);
-        buffer->Lock(0, sizeof(D3DVertex) * vertex_count, reinterpret_cast<void**>(&_vertices), D3DLOCK_DISCARD);
-
-        _vertices[0].x = 0.0f;
-        _vertices[0].y = 0.0f;
-        _vertices[0].z = 0.0f;
-        _vertices[0].color = Colors::Sub(colour, Colors::ARGB(50, 0, 0, 0));
-        for (auto i = 1u; i < vertex_count; i++) {
-            constexpr auto pi = DirectX::XM_PI;
-            const float angle = (i - 1) * (2 * pi / static_cast<float>(count));
-            _vertices[i].x = std::cos(angle);
-            _vertices[i].y = std::sin(angle);
-            _vertices[i].z = 0.0f;
-            _vertices[i].color = colour;
-        }
-
-        buffer->Unlock();
-    }
-    else {
-        type = D3DPT_LINESTRIP;
-        count = 48;
-        const auto vertex_count = count + 1;
-        D3DVertex* _vertices = nullptr;
-
-        if (buffer) {
-            buffer->Release();
+    std::vector<D3DVertex> vertices;
+    D3DPRIMITIVETYPE primitive_type = D3DPT_LINESTRIP;
+    UINT primitive_count = 0;
+    if (polygon.filled && polygon.points.size() < CustomPolygon::max_points_filled) {
+        // can't draw a triangle with less than 3 vertices
+        if (polygon.points.size() >= 3) {
+            const auto poly = std::vector{{polygon.points}};
+            for (const auto index : mapbox::earcut<unsigned>(poly)) {
+                vertices.push_back({polygon.points[index].x, polygon.points[index].y, 0.f, polygon.color});
+            }
+            primitive_type = D3DPT_TRIANGLELIST;
+            primitive_count = vertices.size() / 3;
         }
-        device->CreateVertexBuffer(
-            sizeof(D3DVertex) * vertex_count, 0, D3DFVF_CUSTOMVERTEX, D3DPOOL_MANAGED, &buffer, nullptr);
-        buffer->Lock(0, sizeof(D3DVertex) * vertex_count, reinterpret_cast<void**>(&_vertices), D3DLOCK_DISCARD);
-
-        for (auto i = 0u; i < count; i++) {
-            constexpr auto pi = DirectX::XM_PI;
-            const float angle = i * (2 * pi / (count + 1));
-            _vertices[i].x = std::cos(angle);
-            _vertices[i].y = std::sin(angle);
-            _vertices[i].z = 0.0f;
-            _vertices[i].color = colour;
+    }
+    else if (polygon.points.size() >= 2) {
+        for (const auto& point : polygon.points) {
+            vertices.push_back({point.x, point.y, 0.f, polygon.color});
         }
-        _vertices[count] = _vertices[0];
-
-        buffer->Unlock();
+        primitive_count = vertices.size() - 1;
     }
-    initialized = true;
+    polygon.chunk = geometry.Set(polygon.chunk, polygon.version, primitive_type, primitive_count, vertices);
 }
 
-void CustomRenderer::CustomMarker::Render(IDirect3DDevice9* device)
+void CustomRenderer::BuildMarkerGeometry(CustomMarker& marker)
 {
-    if (!initialized) {
-        Initialize(device);
+    // Unit circle; Render scales and places it with the world transform
+    constexpr auto segments = 48u;
+    const auto colour = (marker.color & IM_COL32_A_MASK) == 0 ? color : marker.color;
+    std::vector<D3DVertex> vertices;
+    if (marker.IsFilled()) {
+        vertices.push_back({0.f, 0.f, 0.f, Colors::Sub(colour, Colors::ARGB(50, 0, 0, 0))});
+        for (auto i = 0u; i <= segments; i++) {
+            const float angle = i * (DirectX::XM_2PI / static_cast<float>(segments));
+            vertices.push_back({std::cos(angle), std::sin(angle), 0.f, colour});
+        }
+        marker.chunk = geometry.Set(marker.chunk, marker.version, D3DPT_TRIANGLEFAN, segments, vertices);
     }
-
-    if (!visible || (map != GW::Constants::MapID::None && map != GW::Map::GetMapID())) {
-        return;
+    else {
+        for (auto i = 0u; i < segments; i++) {
+            const float angle = i * (DirectX::XM_2PI / (segments + 1));
+            vertices.push_back({std::cos(angle), std::sin(angle), 0.f, colour});
+        }
+        vertices.push_back(vertices.front());
+        marker.chunk = geometry.Set(marker.chunk, marker.version, D3DPT_LINESTRIP, segments, vertices);
     }
-
-    const auto translate = DirectX::XMMatrixTranslation(pos.x, pos.y, 0.0f);
-    const auto scale = DirectX::XMMatrixScaling(size, size, 1.0f);
-    const auto world = scale * translate;
-    device->SetTransform(D3DTS_WORLD, reinterpret_cast<const D3DMATRIX*>(&world));
-
-    device->SetFVF(D3DFVF_CUSTOMVERTEX);
-    device->SetStreamSource(0, buffer, 0, sizeof(D3DVertex));
-    device->DrawPrimitive(type, 0, count);
 }
 
-void CustomRenderer::LineCircle::Initialize(IDirect3DDevice9* device)
+void CustomRenderer::BuildLineCircleGeometry()
 {
-    type = D3DPT_LINESTRIP;
-    count = 48; // poly count
-    const auto vertex_count = count + 1;
-    D3DVertex* _vertices = nullptr;
-
-    if (buffer) {
-        buffer->Release();
-    }
-    device->CreateVertexBuffer(
-        sizeof(D3DVertex) * vertex_count, 0, D3DFVF_CUSTOMVERTEX, D3DPOOL_MANAGED, &buffer, nullptr);
-    buffer->Lock(0, sizeof(D3DVertex) * vertex_count, reinterpret_cast<void**>(&_vertices), D3DLOCK_DISCARD);
-
-    for (size_t i = 0; i < count; i++) {
-        const float angle = i * (DirectX::XM_2PI / (count + 1));
-        _vertices[i].x = std::cos(angle);
-        _vertices[i].y = std::sin(angle);
-        _vertices[i].z = 0.0f;
-        _vertices[i].color = color; // 0xFF666677;
-    }
-    _vertices[count] = _vertices[0];
-
-    buffer->Unlock();
+    constexpr auto segments = 48u;
+    std::vector<D3DVertex> vertices;
+    for (auto i = 0u; i < segments; i++) {
+        const float angle = i * (DirectX::XM_2PI / (segments + 1));
+        vertices.push_back({std::cos(angle), std::sin(angle), 0.f, color});
+    }
+    vertices.push_back(vertices.front());
+    linecircle = geometry.Set(linecircle, linecircle_version, D3DPT_LINESTRIP, segments, vertices);
 }
 
 void CustomRenderer::Render(IDirect3DDevice9* device)
@@ -833,8 +733,6 @@ void CustomRenderer::Render(IDirect3DDevice9* device)
         GameWorldRenderer::TriggerSyncAllMarkers();
         marker_file_dirty = true;
         markers_changed = false;
-        Invalidate();
-        return;
     }
 
     DrawCustomMarkers(device);
@@ -863,12 +761,30 @@ void CustomRenderer::DrawCustomMarkers(IDirect3DDevice9* device)
         return;
     }
 
-    for (CustomPolygon& polygon : polygons) {
-        polygon.Render(device);
+    UpdateGeometry();
+    if (!geometry.Upload(device) || !geometry.Bind(device)) {
+        return;
+    }
+    const auto map_id = GW::Map::GetMapID();
+    const auto is_on_map = [map_id](const GW::Constants::MapID map) {
+        return map == GW::Constants::MapID::None || map == map_id;
+    };
+
+    for (const CustomPolygon& polygon : polygons) {
+        if (polygon.visible && is_on_map(polygon.map)) {
+            geometry.Draw(device, polygon.chunk);
+        }
     }
 
-    for (CustomMarker& marker : markers) {
-        marker.Render(device);
+    for (const CustomMarker& marker : markers) {
+        if (!marker.visible || !is_on_map(marker.map)) {
+            continue;
+        }
+        const auto translate = DirectX::XMMatrixTranslation(marker.pos.x, marker.pos.y, 0.0f);
+        const auto scale = DirectX::XMMatrixScaling(marker.size, marker.size, 1.0f);
+        const auto world = scale * translate;
+        device->SetTransform(D3DTS_WORLD, reinterpret_cast<const D3DMATRIX*>(&world));
+        geometry.Draw(device, marker.chunk);
     }
 
     if (GW::HeroFlagArray& flags = GW::GetGameContext()->world->hero_flags; flags.valid()) {
@@ -877,7 +793,7 @@ void CustomRenderer::DrawCustomMarkers(IDirect3DDevice9* device)
             const auto scale = DirectX::XMMatrixScaling(200.0f, 200.0f, 1.0f);
             const auto world = scale * translate;
             device->SetTransform(D3DTS_WORLD, reinterpret_cast<const D3DMATRIX*>(&world));
-            linecircle.Render(device);
+            geometry.Draw(device, linecircle);
         }
     }
     const GW::Vec3f allflag = GW::GetGameContext()->world->all_flag;
@@ -885,7 +801,7 @@ void CustomRenderer::DrawCustomMarkers(IDirect3DDevice9* device)
     const auto scale = DirectX::XMMatrixScaling(300.0f, 300.0f, 1.0f);
     const auto world = scale * translate;
     device->SetTransform(D3DTS_WORLD, reinterpret_cast<const D3DMATRIX*>(&world));
-    linecircle.Render(device);
+    geometry.Draw(device, linecircle);
 }
 
 void CustomRenderer::DrawCustomLines(const IDirect3DDevice9*)
@@ -2,6 +2,7 @@
 
 #include <GWCA/GameContainers/GamePos.h>
 
+#include <Widgets/Minimap/GeometryChunks.h>
 #include <Widgets/Minimap/VBuffer.h>
 
 namespace GW::Constants {
@@ -51,7 +52,7 @@ class CustomRenderer : public VBuffer {
         FullCircle
     };
 
-    struct CustomMarker final : VBuffer {
+    struct CustomMarker final {
         CustomMarker(float x, float y, float s, Shape sh, GW::Constants::MapID m, const char* _name);
         explicit CustomMarker(const char* name);
         GW::GamePos pos;
@@ -63,14 +64,17 @@ class CustomRenderer : public VBuffer {
         char name[128]{};
         Color color{0x00FFFFFF};
         Color color_sub{0x00FFFFFF};
-        void Render(IDirect3DDevice9* device) override;
         [[nodiscard]] bool IsFilled() const { return shape == Shape::FullCircle; }
+        // Call after changing anything that affects how the marker is drawn
+        void Touch() { version++; }
 
     private:
-        void Initialize(IDirect3DDevice9* device) override;
+        friend class CustomRenderer;
+        uint32_t version = 1;
+        GeometryChunks::ChunkId chunk = GeometryChunks::None;
     };
 
-    struct CustomPolygon final : VBuffer {
+    struct CustomPolygon final {
         CustomPolygon(GW::Constants::MapID m, const char* n);
         explicit CustomPolygon(const char* name);
 
@@ -85,11 +89,13 @@ class CustomRenderer : public VBuffer {
         Color color_sub{0x00FFFFFF};
         constexpr static auto max_points = 1800;
         constexpr static auto max_points_filled = 21;
-        void Render(IDirect3DDevice9* device) override;
+        // Call after changing anything that affects how the polygon is drawn
+        void Touch() { version++; }
 
     private:
-        void Initialize(IDirect3DDevice9* device) override;
-        std::vector<unsigned> point_indices{};
+        friend class CustomRenderer;
+        uint32_t version = 1;
+        GeometryChunks::ChunkId chunk = GeometryChunks::None;
     };
 
 public:
@@ -135,6 +141,12 @@ private:
     void Initialize(IDirect3DDevice9* device) override;
 
     void DrawCustomMarkers(IDirect3DDevice9* device);
+    // Rebuild the geometry of anything whose version moved since it was last built
+    void UpdateGeometry();
+    void TouchAll();
+    void BuildMarkerGeometry(CustomMarker& marker);
+    void BuildPolygonGeometry(CustomPolygon& polygon);
+    void BuildLineCircleGeometry();
     void DrawCustomLines(const IDirect3DDevice9* device);
     void EnqueueVertex(float x, float y, Color color);
     void SetTooltipMapID(const GW::Constants::MapID& map_id);
@@ -145,9 +157,10 @@ private:
         char tooltip_str[128]{};
     } map_id_tooltip;
 
-    class LineCircle : public VBuffer {
-        void Initialize(IDirect3DDevice9* device) override;
-    } linecircle;
+    // Markers, polygons and the hero flag circle
+    GeometryChunks geometry;
+    GeometryChunks::ChunkId linecircle = GeometryChunks::None;
+    uint32_t linecircle_version = 1;
 
     inline static Color color{0xFF00FFFF};
 
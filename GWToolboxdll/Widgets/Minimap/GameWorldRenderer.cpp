@@ -9,6 +9,7 @@
 #include <GWCA/Managers/RenderMgr.h>
 
 #include <Defines.h>
+#include <Utils/AltitudeCache.h>
 #include <Widgets/Minimap/GameWorldRenderer.h>
 #include <Widgets/Minimap/Minimap.h>
 #include <ImGuiAddons.h>
@@ -81,11 +82,10 @@ namespace {
         if (poly.vb)
             return true; // Already created the vertex buffer for this poly, which means altitudes have been done!
         auto& vertices = poly.vertices;
-        if (poly.vertices_processed == vertices.size())
-            return true;
+        if (vertices.empty())
+            return false;
         // altitudes (Z value) for each vertex can't be known until we are in the correct map,
         // so these are dynamically computed, one-time.
-        float altitude = ALTITUDE_UNKNOWN;
 
         // in order to properly query altitudes, we have to use the pathing map
         // to determine the number of Z planes in the current map.
@@ -93,50 +93,56 @@ namespace {
         if (!pathing_map || pathing_map->size() == 0)
             return false;
 
-        const auto z_plane0 = poly.vertices_zplanes[0];
-        GW::Map::QueryAltitude({vertices[0].x, vertices[0].y, z_plane0}, 5.f, altitude);
-        const auto altitude0 = altitude;
-        ++poly.vertices_processed;
-        vertices[0].z = altitude;
-
-        const auto z_planeZ = poly.vertices_zplanes[vertices.size() - 1];
-        GW::Map::QueryAltitude({vertices[vertices.size() - 1].x, vertices[vertices.size() - 1].y, z_planeZ}, 5.f, altitude);
-        const auto altitudeZ = altitude;
-        vertices[vertices.size() - 1].z = altitude;
+        // Fetch every vertex's own plane in one batch. If this frame's altitude budget runs out, carry on next frame;
+        // whatever was resolved stays cached, so no query is repeated.
+        std::vector<GW::GamePos> queries;
+        queries.reserve(vertices.size());
+        for (size_t i = 0; i < vertices.size(); i++) {
+            queries.emplace_back(vertices[i].x, vertices[i].y, poly.vertices_zplanes[i]);
+        }
+        if (AltitudeCache::Prefetch(queries) != 0)
+            return false;
 
+        const auto altitude0 = AltitudeCache::Get(queries.front());
+        const auto altitudeZ = AltitudeCache::Get(queries.back());
         const auto altitude_diff = altitudeZ - altitude0;
 
-        for (size_t i = poly.vertices_processed; i < vertices.size() - 1; i++, poly.vertices_processed++) {
-            // until we have a better solution, all Z planes will be queried per vertex
-            // to avoid a significant delay in the render thread, query one plane per frame
-            // until all have been queried. this might result in some renderables shifting
-            // not appearing for a while on first map load, but IMO is better than stalling.
-            // It seems to take, even in most extreme cases, less time than it takes for agents
-            // to appear.
-
-            // @Cleanup: zplane needs setting properly here!
-            const auto z_plane = poly.vertices_zplanes[i];
-            GW::Map::QueryAltitude({vertices[i].x, vertices[i].y, z_plane}, 5.f, altitude);
-
-            if (altitude < vertices[i].z) {
-                // recall that the Up camera component is inverted
-                vertices[i].z = altitude;
+        // A vertex far off the line between the two ends is probably on the wrong plane (e.g. under a bridge), so
+        // those are checked against every plane; batch those queries too.
+        std::vector<size_t> off_guess;
+        for (size_t i = 1; i < vertices.size() - 1; i++) {
+            const auto guessed_altitude = altitude0 + (altitude_diff * static_cast<float>(i) / static_cast<float>(vertices.size() - 1));
+            if (std::abs(AltitudeCache::Get(queries[i]) - guessed_altitude) > 20.f) {
+                off_guess.push_back(i);
             }
+        }
+        std::vector<GW::GamePos> plane_queries;
+        for (const auto i : off_guess) {
+            for (unsigned zplane = pathing_map->size() - 1; zplane >= 1; --zplane) {
+                plane_queries.emplace_back(vertices[i].x, vertices[i].y, zplane);
+            }
+        }
+        if (AltitudeCache::Prefetch(plane_queries) != 0)
+            return false;
 
+        vertices.front().z = altitude0;
+        vertices.back().z = altitudeZ;
+        for (size_t i = 1; i < vertices.size() - 1; i++) {
+            vertices[i].z = AltitudeCache::Get(queries[i]);
+        }
+        for (const auto i : off_guess) {
+            // recall that the Up camera component is inverted, so lower is higher
             const auto guessed_altitude = altitude0 + (altitude_diff * static_cast<float>(i) / static_cast<float>(vertices.size() - 1));
-            if (std::abs(altitude - guessed_altitude) > 20.f) {
-                auto min_diff = std::abs(altitude - guessed_altitude);
-                for (unsigned zplane = pathing_map->size() - 1; zplane >= 1; --zplane) {
-                    GW::Map::QueryAltitude({vertices[i].x, vertices[i].y, zplane}, 5.f, altitude);
-                    const auto cur_diff = std::abs(altitude - guessed_altitude);
-                    if (cur_diff < min_diff && altitude < vertices[i].z) {
-                        min_diff = cur_diff;
-                        vertices[i].z = altitude;
-                    }
+            auto min_diff = std::abs(vertices[i].z - guessed_altitude);
+            for (unsigned zplane = pathing_map->size() - 1; zplane >= 1; --zplane) {
+                const auto altitude = AltitudeCache::Get({vertices[i].x, vertices[i].y, zplane});
+                const auto cur_diff = std::abs(altitude - guessed_altitude);
+                if (cur_diff < min_diff && altitude < vertices[i].z) {
+                    min_diff = cur_diff;
+                    vertices[i].z = altitude;
                 }
             }
         }
-        ++poly.vertices_processed;
 
         // commit the completed vertices to vram
         auto res = device->CreateVertexBuffer(vertices.size() * sizeof(D3DVertex), D3DUSAGE_WRITEONLY, D3DFVF_CUSTOMVERTEX, D3DPOOL_MANAGED, &poly.vb, nullptr);
@@ -310,6 +316,7 @@ bool GameWorldRenderer::SetD3DTransform(IDirect3DDevice9* device)
 
 void GameWorldRenderer::Render(IDirect3DDevice9* device)
 {
+    AltitudeCache::BeginFrame();
     if (need_sync_markers) {
         // marker synchronisation is done when needed on the render thread, as it requires access
         // to the directX device for creating vertex buffers.
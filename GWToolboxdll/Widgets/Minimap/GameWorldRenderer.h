@@ -21,7 +21,6 @@ public:
             , filled(other.filled)
             , from_player_pos(other.from_player_pos)
             , use_dotted_effect(other.use_dotted_effect)
-            , vertices_processed(other.vertices_processed)
             , vb(other.vb)
         {
             other.vb = nullptr;
@@ -29,6 +28,8 @@ public:
             other.points.clear();
             vertices = std::move(other.vertices);
             other.vertices.clear();
+            vertices_zplanes = std::move(other.vertices_zplanes);
+            other.vertices_zplanes.clear();
         }
 
         // copy not allowed
@@ -43,11 +44,11 @@ public:
             other.vb = nullptr;
             points = std::move(other.points);
             vertices = std::move(other.vertices);
+            vertices_zplanes = std::move(other.vertices_zplanes);
 
             map_id = other.map_id;
             col = other.col;
             filled = other.filled;
-            vertices_processed = other.vertices_processed;
             from_player_pos = other.from_player_pos;
             use_dotted_effect = other.use_dotted_effect;
 
@@ -63,7 +64,6 @@ public:
         bool filled = false;
         bool from_player_pos = false;
         bool use_dotted_effect = false;
-        unsigned int vertices_processed = 0u;
         IDirect3DVertexBuffer9* vb = nullptr;
     };
 
@@ -0,0 +1,197 @@
+#include "stdafx.h"
+
+#include <bit>
+
+#include <Widgets/Minimap/GeometryChunks.h>
+
+GeometryChunks::Chunk* GeometryChunks::Find(const ChunkId id)
+{
+    if (id == None || id > chunks.size() || !chunks[id - 1].live) {
+        return nullptr;
+    }
+    return &chunks[id - 1];
+}
+
+const GeometryChunks::Chunk* GeometryChunks::Find(const ChunkId id) const
+{
+    if (id == None || id > chunks.size() || !chunks[id - 1].live) {
+        return nullptr;
+    }
+    return &chunks[id - 1];
+}
+
+bool GeometryChunks::IsCurrent(const ChunkId id, const uint32_t version) const
+{
+    const auto chunk = Find(id);
+    return chunk && chunk->version == version;
+}
+
+GeometryChunks::ChunkId GeometryChunks::Set(ChunkId id, const uint32_t version, const D3DPRIMITIVETYPE type, const UINT primitive_count, const std::span<const D3DVertex> vertices)
+{
+    Chunk* chunk = Find(id);
+    if (!chunk) {
+        if (!free_ids.empty()) {
+            id = free_ids.back();
+            free_ids.pop_back();
+        }
+        else {
+            chunks.emplace_back();
+            id = static_cast<ChunkId>(chunks.size());
+        }
+        chunk = &chunks[id - 1];
+        *chunk = {};
+        chunk->live = true;
+    }
+    chunk->vertices.assign(vertices.begin(), vertices.end());
+    chunk->type = type;
+    chunk->primitive_count = primitive_count;
+    chunk->version = version;
+    chunk->dirty = true;
+    any_dirty = true;
+    return id;
+}
+
+void GeometryChunks::Release(const ChunkId id)
+{
+    Chunk* chunk = Find(id);
+    if (!chunk) {
+        return;
+    }
+    // Its range in the buffer stays reserved until the next repack
+    chunk->live = false;
+    chunk->vertices = {};
+    free_ids.push_back(id);
+}
+
+void GeometryChunks::Clear()
+{
+    chunks.clear();
+    free_ids.clear();
+    buffer_used = 0;
+    any_dirty = false;
+}
+
+void GeometryChunks::Invalidate()
+{
+    if (buffer) {
+        buffer->Release();
+    }
+    buffer = nullptr;
+    buffer_capacity = 0;
+    buffer_used = 0;
+    for (auto& chunk : chunks) {
+        chunk.capacity = 0;
+        chunk.dirty = chunk.live;
+    }
+    any_dirty = true;
+}
+
+bool GeometryChunks::Write(const Chunk& chunk) const
+{
+    if (chunk.vertices.empty()) {
+        return true;
+    }
+    void* mem = nullptr;
+    const UINT bytes = chunk.vertices.size() * sizeof(D3DVertex);
+    if (buffer->Lock(chunk.first_vertex * sizeof(D3DVertex), bytes, &mem, 0) != D3D_OK) {
+        return false;
+    }
+    memcpy(mem, chunk.vertices.data(), bytes);
+    buffer->Unlock();
+    return true;
+}
+
+bool GeometryChunks::Repack(IDirect3DDevice9* device)
+{
+    UINT total = 0;
+    for (const auto& chunk : chunks) {
+        if (chunk.live) {
+            total += chunk.vertices.size();
+        }
+    }
+    if (!buffer || total > buffer_capacity) {
+        if (buffer) {
+            buffer->Release();
+            buffer = nullptr;
+        }
+        // Leave room to grow so that the next few edits can be appended rather than repacked
+        buffer_capacity = std::bit_ceil(std::max(total * 2, 256u));
+        if (device->CreateVertexBuffer(buffer_capacity * sizeof(D3DVertex), D3DUSAGE_WRITEONLY, D3DFVF_CUSTOMVERTEX, D3DPOOL_MANAGED, &buffer, nullptr) != D3D_OK) {
+            buffer_capacity = 0;
+            return false;
+        }
+    }
+    D3DVertex* mem = nullptr;
+    if (total && buffer->Lock(0, total * sizeof(D3DVertex), reinterpret_cast<void**>(&mem), 0) != D3D_OK) {
+        return false;
+    }
+    buffer_used = 0;
+    for (auto& chunk : chunks) {
+        if (!chunk.live) {
+            continue;
+        }
+        chunk.first_vertex = buffer_used;
+        chunk.capacity = chunk.vertices.size();
+        std::ranges::copy(chunk.vertices, mem + buffer_used);
+        buffer_used += chunk.capacity;
+        chunk.dirty = false;
+    }
+    if (total) {
+        buffer->Unlock();
+    }
+    return true;
+}
+
+bool GeometryChunks::Upload(IDirect3DDevice9* device)
+{
+    if (!any_dirty) {
+        return buffer != nullptr || chunks.empty();
+    }
+    // Dirty chunks are rewritten in place if they still fit, or moved to the free tail; only if that runs out do we repack.
+    UINT tail = buffer_used;
+    for (const auto& chunk : chunks) {
+        if (chunk.live && chunk.dirty && chunk.vertices.size() > chunk.capacity) {
+            tail += chunk.vertices.size();
+        }
+    }
+    any_dirty = false;
+    if (!buffer || tail > buffer_capacity) {
+        any_dirty = !Repack(device);
+        return !any_dirty;
+    }
+    for (auto& chunk : chunks) {
+        if (!chunk.live || !chunk.dirty) {
+            continue;
+        }
+        if (chunk.vertices.size() > chunk.capacity) {
+            chunk.first_vertex = buffer_used;
+            chunk.capacity = chunk.vertices.size();
+            buffer_used += chunk.capacity;
+        }
+        if (!Write(chunk)) {
+            any_dirty = true;
+            return false;
+        }
+        chunk.dirty = false;
+    }
+    return true;
+}
+
+bool GeometryChunks::Bind(IDirect3DDevice9* device) const
+{
+    if (!buffer) {
+        return false;
+    }
+    device->SetFVF(D3DFVF_CUSTOMVERTEX);
+    device->SetStreamSource(0, buffer, 0, sizeof(D3DVertex));
+    return true;
+}
+
+void GeometryChunks::Draw(IDirect3DDevice9* device, const ChunkId id) const
+{
+    const auto chunk = Find(id);
+    if (!chunk || chunk->dirty || !chunk->primitive_count) {
+        return;
+    }
+    device->DrawPrimitive(chunk->type, chunk->first_vertex, chunk->primitive_count);
+}
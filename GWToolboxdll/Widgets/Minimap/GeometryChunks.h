@@ -0,0 +1,61 @@
+#pragma once
+
+#include <Widgets/Minimap/D3DVertex.h>
+
+/*
+Retained geometry for the minimap: many small chunks (one per marker, polygon, ...) packed into a single vertex buffer.
+
+Each chunk remembers the version of the source data it was built from. Owners bump their own version when they change and
+call Set only when IsCurrent says the chunk is stale, so editing one marker rebuilds one chunk. Upload then rewrites just the
+ranges of chunks that changed; the buffer is only repacked when a grown chunk no longer fits.
+*/
+class GeometryChunks {
+public:
+    using ChunkId = uint32_t;
+    static constexpr ChunkId None = 0;
+
+    GeometryChunks() = default;
+    ~GeometryChunks() { Invalidate(); }
+    GeometryChunks(const GeometryChunks&) = delete;
+    GeometryChunks& operator=(const GeometryChunks&) = delete;
+
+    [[nodiscard]] bool IsCurrent(ChunkId id, uint32_t version) const;
+    // Replace the chunk's vertices, allocating a new chunk if id is None. Returns the chunk's id.
+    ChunkId Set(ChunkId id, uint32_t version, D3DPRIMITIVETYPE type, UINT primitive_count, std::span<const D3DVertex> vertices);
+    void Release(ChunkId id);
+    // Release every chunk. Ids handed out before are no longer valid.
+    void Clear();
+
+    // Push changed chunks to the device; call once per frame before Bind/Draw.
+    bool Upload(IDirect3DDevice9* device);
+    // Set our buffer as stream 0; call before a run of Draw calls.
+    bool Bind(IDirect3DDevice9* device) const;
+    void Draw(IDirect3DDevice9* device, ChunkId id) const;
+
+    // Drop the device buffer; chunks keep their vertices and are re-uploaded on the next Upload.
+    void Invalidate();
+
+private:
+    struct Chunk {
+        std::vector<D3DVertex> vertices;
+        D3DPRIMITIVETYPE type = D3DPT_TRIANGLELIST;
+        UINT primitive_count = 0;
+        uint32_t version = 0;
+        UINT first_vertex = 0;
+        UINT capacity = 0; // Vertices reserved for this chunk at first_vertex
+        bool live = false;
+        bool dirty = false;
+    };
+
+    Chunk* Find(ChunkId id);
+    [[nodiscard]] const Chunk* Find(ChunkId id) const;
+    bool Repack(IDirect3DDevice9* device);
+    bool Write(const Chunk& chunk) const;
+
+    std::vector<Chunk> chunks; // Index is id - 1
+    std::vector<ChunkId> free_ids;
+    IDirect3DVertexBuffer9* buffer = nullptr;
+    UINT buffer_capacity = 0; // In vertices
+    UINT buffer_used = 0;
+    bool any_dirty = false;
+};
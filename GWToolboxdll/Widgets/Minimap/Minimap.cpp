@@ -35,6 +35,7 @@
 #include <GWCA/Utilities/Scanner.h>
 #include <ImGuiAddons.h>
 #include <Logger.h>
+#include <Utils/AgentIndex.h>
 #include <Utils/GuiUtils.h>
 
 #include "Minimap.h"
@@ -599,6 +600,25 @@ namespace {
 
 float Minimap::Scale() const { return scale; }
 
+AgentBatch::CullCircle Minimap::GetVisibleWorldCircle()
+{
+    const GW::Agent* me = GW::Agents::GetObservingAgent();
+    if (me == nullptr || scale <= 0.f) {
+        return {}; // Unbounded; nothing gets culled
+    }
+    // The projection shows [-w, w] in view space; its centre is the view origin, so undo the camera translation, scale and rotation
+    // (as in InterfaceToWorldPoint) to find it in the world. The circle around that square is rotation invariant.
+    constexpr float w = 5000.0f;
+    GW::Vec2f v = translation;
+    v /= -scale;
+    const float angle = Instance().GetMapRotation() - DirectX::XM_PIDIV2;
+    const float x1 = v.x * std::cos(angle) - v.y * std::sin(angle);
+    const float y1 = v.x * std::sin(angle) + v.y * std::cos(angle);
+    v = GW::Vec2f(x1, y1);
+    v += me->pos;
+    return {v, w * std::numbers::sqrt2_v<float> / scale};
+}
+
 void Minimap::DrawHelp()
 {
     if (!ImGui::TreeNodeEx("Minimap", ImGuiTreeNodeFlags_FramePadding | ImGuiTreeNodeFlags_SpanAvailWidth)) {
@@ -1488,37 +1508,19 @@ void Minimap::Render(IDirect3DDevice9* device)
 
 void Minimap::SelectTarget(const GW::Vec2f pos)
 {
-    const auto* agents = GW::Agents::GetAgentArray();
-    if (agents == nullptr) {
-        return;
-    }
-    auto distance = 600.0f * 600.0f;
-    const GW::Agent* closest = nullptr;
-
-    for (const auto* agent : *agents) {
-        if (agent == nullptr) {
-            continue;
-        }
-        const auto* living = agent->GetAsAgentLiving();
-        if (living && living->GetIsDead()) {
-            continue;
-        }
-        if (agent->GetIsItemType()) {
-            continue;
-        }
-        const auto agent_is_locked_chest = agent->GetIsGadgetType() && agent->GetAsAgentGadget()->gadget_id == 8141;
-        if (agent->GetIsGadgetType() && !agent_is_locked_chest) {
-            continue; // allow locked chests
-        }
-        if (!GW::Agents::GetIsAgentTargettable(agent) && !agent_is_locked_chest) {
-            continue; // block all useless minis
+    AgentIndex::Filter filter;
+    filter.alive_only = true;
+    filter.predicate = [](const GW::Agent& agent) {
+        if (agent.GetIsItemType()) {
+            return false;
         }
-        const float new_distance = GetSquareDistance(pos, agent->pos);
-        if (distance > new_distance) {
-            distance = new_distance;
-            closest = agent;
+        const auto agent_is_locked_chest = agent.GetIsGadgetType() && agent.GetAsAgentGadget()->gadget_id == 8141;
+        if (agent.GetIsGadgetType() && !agent_is_locked_chest) {
+            return false; // allow locked chests
         }
-    }
+        return GW::Agents::GetIsAgentTargettable(&agent) || agent_is_locked_chest; // block all useless minis
+    };
+    const auto closest = AgentIndex::FindNearest(pos, 600.0f, filter);
 
     if (closest != nullptr) {
         GW::Agents::ChangeTarget(closest);
@@ -69,6 +69,8 @@ public:
     [[nodiscard]] float GetMapRotation() const;
     [[nodiscard]] static DirectX::XMFLOAT2 GetGwinchScale();
     [[nodiscard]] GW::Vec2f ShadowstepLocation() const;
+    // World-space circle enclosing everything the minimap can currently show
+    [[nodiscard]] static AgentBatch::CullCircle GetVisibleWorldCircle();
 
     // 0 is 'all' flag, 1 to 7 is each hero
     static bool FlagHero(uint32_t idx);
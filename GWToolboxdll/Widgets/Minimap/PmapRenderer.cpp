@@ -46,127 +46,104 @@ void PmapRenderer::DrawSettings()
     }
 }
 
+//#define WIREFRAME_MODE
+
 void PmapRenderer::Initialize(IDirect3DDevice9* device)
 {
-    //#define WIREFRAME_MODE
-
-    GW::PathingMapArray* path_map;
-    if (GW::Map::GetIsMapLoaded()) {
-        path_map = GW::Map::GetPathingMap();
-    }
-    else {
+    if (!GW::Map::GetIsMapLoaded()) {
         initialized = false;
         return; // no map loaded yet, so don't render anything
     }
-    const bool shadow_show = (color_mapshadow & IM_COL32_A_MASK) > 0;
-
-    // get the number of trapezoids, need it to allocate the vertex buffer
-    trapez_count_ = 0;
-    for (const GW::PathingMap& map : *path_map) {
-        trapez_count_ += map.trapezoid_count;
+    const auto path_map = GW::Map::GetPathingMap();
+    if (!path_map) {
+        initialized = false;
+        return;
     }
-    if (trapez_count_ == 0) {
+    const MapGeometry& geometry = GetMapGeometry(*path_map);
+    trapez_count_ = geometry.trapezoid_count;
+    if (geometry.vertices.empty()) {
         return;
     }
+    const bool shadow_show = (color_mapshadow & IM_COL32_A_MASK) > 0;
 
+    vert_count_ = geometry.vertices.size();
+    total_vert_count_ = shadow_show ? vert_count_ * 2 : vert_count_;
 #ifdef WIREFRAME_MODE
-
-    total_tri_count_ = tri_count_ = trapez_count_ * 4;
-    if (shadow_show) total_tri_count_ = tri_count_ * 2;
-
-    vert_count_ = tri_count_ * 2;
-    total_vert_count_ = total_tri_count_ * 2;
-
+    type = D3DPT_LINELIST;
+    tri_count_ = vert_count_ / 2;
 #else
-
-    total_tri_count_ = tri_count_ = trapez_count_ * 2;
-    if (shadow_show) {
-        total_tri_count_ = tri_count_ * 2;
-    }
-
-    vert_count_ = tri_count_ * 3;
-    total_vert_count_ = total_tri_count_ * 3;
-
+    type = D3DPT_TRIANGLELIST;
+    tri_count_ = vert_count_ / 3;
 #endif
-
-    D3DVertex* vertices = nullptr;
+    total_tri_count_ = shadow_show ? tri_count_ * 2 : tri_count_;
 
     // allocate new vertex buffer
     if (buffer) {
         buffer->Release();
+        buffer = nullptr;
     }
-    device->CreateVertexBuffer(sizeof(D3DVertex) * total_vert_count_, D3DUSAGE_WRITEONLY,
-                               D3DFVF_CUSTOMVERTEX, D3DPOOL_MANAGED, &buffer, nullptr);
-    buffer->Lock(0, sizeof(D3DVertex) * total_vert_count_,
-                 reinterpret_cast<void**>(&vertices), D3DLOCK_DISCARD);
-
-    D3DVertex* vertices_begin = vertices;
-
-#ifdef WIREFRAME_MODE
-    type = D3DPT_LINELIST;
-
-    // populate vertex buffer
-    for (autok = 0; k < (shadow_show ? 2 : 1); ++k) {
-        for (size_t i = 0; i < path_map.size(); i++) {
-            GW::PathingMap pmap = path_map[i];
-            for (size_t j = 0; j < pmap.trapezoid_count; ++j) {
-                GW::PathingTrapezoid& trap = pmap.trapezoids[j];
-                vertices[0].x = trap.XTL; vertices[0].y = trap.YT;
-                vertices[1].x = trap.XTR; vertices[1].y = trap.YT;
-
-                vertices[2].x = trap.XTR; vertices[2].y = trap.YT;
-                vertices[3].x = trap.XBR; vertices[3].y = trap.YB;
-
-                vertices[4].x = trap.XBR; vertices[4].y = trap.YB;
-                vertices[5].x = trap.XBL; vertices[5].y = trap.YB;
-
-                vertices[6].x = trap.XBL; vertices[6].y = trap.YB;
-                vertices[7].x = trap.XTL; vertices[7].y = trap.YT;
-
-                vertices += 8;
-            }
-        }
+    if (device->CreateVertexBuffer(sizeof(D3DVertex) * total_vert_count_, D3DUSAGE_WRITEONLY,
+                                   D3DFVF_CUSTOMVERTEX, D3DPOOL_MANAGED, &buffer, nullptr) != D3D_OK) {
+        return;
     }
-#else
-    type = D3DPT_TRIANGLELIST;
-
-    // populate vertex buffer
+    D3DVertex* vertices = nullptr;
+    if (buffer->Lock(0, sizeof(D3DVertex) * total_vert_count_, reinterpret_cast<void**>(&vertices), D3DLOCK_DISCARD) != D3D_OK) {
+        return;
+    }
+    // The shadow copy comes first so that the map is drawn over it
     for (auto k = 0; k < (shadow_show ? 2 : 1); ++k) {
-        for (const GW::PathingMap& pmap : *path_map) {
-            for (size_t j = 0; j < pmap.trapezoid_count; ++j) {
-                GW::PathingTrapezoid& trap = pmap.trapezoids[j];
-
-                vertices[0].x = trap.XTL;
-                vertices[0].y = trap.YT;
-                vertices[1].x = trap.XTR;
-                vertices[1].y = trap.YT;
-                vertices[2].x = trap.XBL;
-                vertices[2].y = trap.YB;
-
-                vertices[3].x = trap.XBL;
-                vertices[3].y = trap.YB;
-                vertices[4].x = trap.XTR;
-                vertices[4].y = trap.YT;
-                vertices[5].x = trap.XBR;
-                vertices[5].y = trap.YB;
-                vertices += 6;
-            }
+        const Color color = shadow_show && k == 0 ? color_mapshadow : color_map;
+        for (const GW::Vec2f& v : geometry.vertices) {
+            *vertices++ = {v.x, v.y, 0.0f, color};
         }
     }
-#endif
+    buffer->Unlock();
+}
 
-    vertices = vertices_begin;
-    for (auto i = 0u; i < total_vert_count_; i++) {
-        vertices[i].z = 0.0f;
-        if (shadow_show && i < vert_count_) {
-            vertices[i].color = color_mapshadow;
-        }
-        else {
-            vertices[i].color = color_map;
-        }
+const PmapRenderer::MapGeometry& PmapRenderer::GetMapGeometry(const GW::PathingMapArray& path_map)
+{
+    const auto map_id = GW::Map::GetMapID();
+    size_t trapezoid_count = 0;
+    for (const GW::PathingMap& map : path_map) {
+        trapezoid_count += map.trapezoid_count;
+    }
+    const auto found = std::ranges::find_if(map_cache, [&](const MapGeometry& cached) {
+        return cached.map_id == map_id && cached.trapezoid_count == trapezoid_count;
+    });
+    if (found != map_cache.end()) {
+        std::rotate(map_cache.begin(), found, found + 1);
+        return map_cache.front();
     }
 
-    buffer->Unlock();
+    MapGeometry geometry{map_id, trapezoid_count, {}};
+#ifdef WIREFRAME_MODE
+    geometry.vertices.reserve(trapezoid_count * 8);
+#else
+    geometry.vertices.reserve(trapezoid_count * 6);
+#endif
+    for (const GW::PathingMap& pmap : path_map) {
+        for (size_t j = 0; j < pmap.trapezoid_count; ++j) {
+            const GW::PathingTrapezoid& trap = pmap.trapezoids[j];
+#ifdef WIREFRAME_MODE
+            geometry.vertices.insert(geometry.vertices.end(), {
+                {trap.XTL, trap.YT}, {trap.XTR, trap.YT},
+                {trap.XTR, trap.YT}, {trap.XBR, trap.YB},
+                {trap.XBR, trap.YB}, {trap.XBL, trap.YB},
+                {trap.XBL, trap.YB}, {trap.XTL, trap.YT}
+            });
+#else
+            geometry.vertices.insert(geometry.vertices.end(), {
+                {trap.XTL, trap.YT}, {trap.XTR, trap.YT}, {trap.XBL, trap.YB},
+                {trap.XBL, trap.YB}, {trap.XTR, trap.YT}, {trap.XBR, trap.YB}
+            });
+#endif
+        }
+    }
+    if (map_cache.size() == map_cache_size) {
+        map_cache.pop_back();
+    }
+    map_cache.insert(map_cache.begin(), std::move(geometry));
+    return map_cache.front();
 }
 
 void PmapRenderer::Render(IDirect3DDevice9* device)
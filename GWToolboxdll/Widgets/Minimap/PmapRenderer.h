@@ -1,8 +1,14 @@
 #pragma once
 
+#include <GWCA/GameEntities/Pathing.h>
+
 #include <Color.h>
 #include <Widgets/Minimap/VBuffer.h>
 
+namespace GW::Constants {
+    enum class MapID : uint32_t;
+}
+
 class PmapRenderer : public VBuffer {
 public:
     // Triangle 1: (XTL, YT) (XTR, YT), (XBL, YB)
@@ -27,4 +33,14 @@ private:
     size_t total_tri_count_ = 0; // including shadow
     size_t vert_count_ = 0;
     size_t total_vert_count_ = 0; // including shadow
+
+    // Triangulated pathing of recently visited maps, most recent first, so zoning back in or changing colours doesn't triangulate again
+    struct MapGeometry {
+        GW::Constants::MapID map_id;
+        size_t trapezoid_count; // Cheap check that the pathing data is still what we triangulated
+        std::vector<GW::Vec2f> vertices;
+    };
+    static constexpr size_t map_cache_size = 6;
+    std::vector<MapGeometry> map_cache;
+    const MapGeometry& GetMapGeometry(const GW::PathingMapArray& path_map);
 };
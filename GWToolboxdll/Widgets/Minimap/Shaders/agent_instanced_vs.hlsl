@@ -0,0 +1,34 @@
+// World, view and projection for the minimap, pre-multiplied on the cpu.
+float4x4 world_view_proj : register(c0);
+
+
+// Stream 0 is the static shape table, stream 1 holds one AgentBatch::InstanceRecord per agent shape.
+struct VS_INPUT {
+    float2 shape_pos : POSITION0;
+    // One-hot: which of the instance's four colours this vertex takes
+    float4 tint : COLOR0;
+    // x, y: world position. z, w: size * (cos, sin) of the agent's rotation
+    float4 placement : TEXCOORD0;
+    float4 color : COLOR1;
+    float4 dark : COLOR2;
+    float4 light : COLOR3;
+    float4 center : COLOR4;
+};
+
+
+struct VS_OUTPUT {
+    float4 position : SV_POSITION;
+    float4 color : COLOR;
+};
+
+
+VS_OUTPUT main(VS_INPUT input) {
+    VS_OUTPUT output;
+    // Same expansion as AgentBatch::EmitAgentVertices: rotate and scale the unit shape, then move it into place.
+    const float2 axis = input.placement.zw;
+    const float2 world = float2(input.shape_pos.x * axis.x - input.shape_pos.y * axis.y,
+                                input.shape_pos.x * axis.y + input.shape_pos.y * axis.x) + input.placement.xy;
+    output.position = mul(float4(world, 0.0, 1.0), world_view_proj);
+    output.color = input.tint.r * input.color + input.tint.g * input.dark + input.tint.b * input.light + input.tint.a * input.center;
+    return output;
+}
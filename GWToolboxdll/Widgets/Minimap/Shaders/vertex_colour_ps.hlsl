@@ -0,0 +1,5 @@
+// Shader model 3 vertex shaders need a shader model 3 pixel shader; this one just passes the vertex colour through.
+float4 main(float4 color : COLOR) : SV_TARGET
+{
+    return color;
+}
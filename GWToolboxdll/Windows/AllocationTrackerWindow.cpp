@@ -0,0 +1,164 @@
+#include "stdafx.h"
+
+#include <Timer.h>
+#include <Utils/AllocationTracker.h>
+#include <Windows/AllocationTrackerWindow.h>
+
+namespace {
+    constexpr clock_t REFRESH_INTERVAL_MS = 1000;
+
+    struct ModuleRow {
+        AllocationTracker::ModuleStats stats;
+        float allocs_per_second = 0.f;
+        float kb_per_second = 0.f;
+    };
+
+    std::vector<ModuleRow> rows;
+    std::vector<AllocationTracker::CallSite> call_sites;
+    // Symbol lookups are slow; each address only needs resolving once
+    std::unordered_map<void*, std::string> call_site_names;
+    const char* selected_tag = nullptr;
+    clock_t last_refresh = 0;
+
+    void Refresh(const float seconds_elapsed)
+    {
+        std::unordered_map<const char*, AllocationTracker::ModuleStats> previous;
+        for (const auto& row : rows) {
+            previous.emplace(row.stats.tag, row.stats);
+        }
+        rows.clear();
+        for (const auto& stats : AllocationTracker::GetModuleStats()) {
+            ModuleRow row{stats};
+            const auto found = previous.find(stats.tag);
+            if (found != previous.end() && seconds_elapsed > 0.f) {
+                row.allocs_per_second = static_cast<float>(stats.total_count - found->second.total_count) / seconds_elapsed;
+                row.kb_per_second = static_cast<float>(stats.total_bytes - found->second.total_bytes) / 1024.f / seconds_elapsed;
+            }
+            rows.push_back(row);
+        }
+        std::ranges::sort(rows, std::greater{}, [](const ModuleRow& row) { return row.stats.live_bytes; });
+
+        call_sites.clear();
+        if (selected_tag) {
+            call_sites = AllocationTracker::GetCallSites(selected_tag);
+        }
+    }
+
+    const std::string& GetCallSiteName(void* address)
+    {
+        auto found = call_site_names.find(address);
+        if (found == call_site_names.end()) {
+            found = call_site_names.emplace(address, AllocationTracker::DescribeAddress(address)).first;
+        }
+        return found->second;
+    }
+}
+
+void AllocationTrackerWindow::Terminate()
+{
+    ToolboxWindow::Terminate();
+    AllocationTracker::SetEnabled(false);
+    rows.clear();
+    call_sites.clear();
+}
+
+void AllocationTrackerWindow::Update(const float)
+{
+    if (!AllocationTracker::IsEnabled()) {
+        return;
+    }
+    const auto elapsed = TIMER_DIFF(last_refresh);
+    if (last_refresh && elapsed < REFRESH_INTERVAL_MS) {
+        return;
+    }
+    Refresh(last_refresh ? static_cast<float>(elapsed) / 1000.f : 0.f);
+    last_refresh = TIMER_INIT();
+}
+
+void AllocationTrackerWindow::Draw(IDirect3DDevice9*)
+{
+    if (!visible) {
+        return;
+    }
+    ImGui::SetNextWindowSize(ImVec2(560.0f, 480.0f), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin(Name(), GetVisiblePtr(), GetWinFlags())) {
+        ImGui::End();
+        return;
+    }
+
+    bool enabled = AllocationTracker::IsEnabled();
+    if (ImGui::Checkbox("Track allocations", &enabled)) {
+        AllocationTracker::SetEnabled(enabled);
+        rows.clear();
+        call_sites.clear();
+        selected_tag = nullptr;
+        last_refresh = 0;
+    }
+    ImGui::ShowHelp("Counts every allocation toolbox makes from now on, charged to the module that was running at the time.\n"
+                    "Adds a little overhead to every allocation while enabled; turn it off when you're done.");
+    if (!enabled) {
+        ImGui::TextDisabled("Tracking is off.");
+        ImGui::End();
+        return;
+    }
+
+    size_t total_live = 0;
+    for (const auto& row : rows) {
+        total_live += row.stats.live_bytes;
+    }
+    ImGui::Text("Live since tracking started: %.1f KB", static_cast<float>(total_live) / 1024.f);
+
+    constexpr ImGuiTableFlags table_flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY | ImGuiTableFlags_Resizable | ImGuiTableFlags_BordersInnerV;
+    const float table_height = ImGui::GetContentRegionAvail().y * (selected_tag ? 0.55f : 1.f);
+    if (ImGui::BeginTable("allocation_modules", 5, table_flags, ImVec2(0.f, table_height))) {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("Module", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("Live KB", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableSetupColumn("Live allocs", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableSetupColumn("Allocs/s", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableSetupColumn("KB/s", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableHeadersRow();
+        for (const auto& row : rows) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            if (ImGui::Selectable(row.stats.tag, selected_tag == row.stats.tag, ImGuiSelectableFlags_SpanAllColumns)) {
+                selected_tag = selected_tag == row.stats.tag ? nullptr : row.stats.tag;
+                last_refresh = 0;
+            }
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", static_cast<float>(row.stats.live_bytes) / 1024.f);
+            ImGui::TableNextColumn();
+            ImGui::Text("%zu", row.stats.live_count);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.0f", row.allocs_per_second);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", row.kb_per_second);
+        }
+        ImGui::EndTable();
+    }
+
+    if (selected_tag) {
+        ImGui::Text("Top call sites for %s, by live bytes", selected_tag);
+        if (ImGui::BeginTable("allocation_call_sites", 4, table_flags)) {
+            ImGui::TableSetupScrollFreeze(0, 1);
+            ImGui::TableSetupColumn("Call site", ImGuiTableColumnFlags_WidthStretch);
+            ImGui::TableSetupColumn("Live KB", ImGuiTableColumnFlags_WidthFixed);
+            ImGui::TableSetupColumn("Live allocs", ImGuiTableColumnFlags_WidthFixed);
+            ImGui::TableSetupColumn("Total allocs", ImGuiTableColumnFlags_WidthFixed);
+            ImGui::TableHeadersRow();
+            for (const auto& site : call_sites) {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(GetCallSiteName(site.address).c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f", static_cast<float>(site.live_bytes) / 1024.f);
+                ImGui::TableNextColumn();
+                ImGui::Text("%zu", site.live_count);
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu", site.total_count);
+            }
+            ImGui::EndTable();
+        }
+    }
+    ImGui::End();
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <ToolboxWindow.h>
+
+class AllocationTrackerWindow : public ToolboxWindow {
+    AllocationTrackerWindow() = default;
+    ~AllocationTrackerWindow() override = default;
+
+public:
+    static AllocationTrackerWindow& Instance()
+    {
+        static AllocationTrackerWindow instance;
+        return instance;
+    }
+
+    [[nodiscard]] const char* Name() const override { return "Allocation Tracker"; }
+    [[nodiscard]] const char* Icon() const override { return ICON_FA_MEMORY; }
+
+    void Terminate() override;
+    void Update(float delta) override;
+    void Draw(IDirect3DDevice9* pDevice) override;
+};
@@ -31,8 +31,10 @@
 #include <Windows/TravelWindow.h>
 
 #include <Color.h>
+#include <Timer.h>
 #include <Modules/DialogModule.h>
 
+#include <Utils/BinarySnapshot.h>
 #include <Utils/ToolboxUtils.h>
 #include <Utils/TextUtils.h>
 
@@ -52,33 +54,6 @@ namespace {
         return (array[real_index] & flag) != 0;
     }
 
-    bool ArrayBoolAt(const std::vector<uint32_t>& array, const uint32_t index)
-    {
-        const uint32_t real_index = index / 32;
-        if (real_index >= array.size()) {
-            return false;
-        }
-        const uint32_t shift = index % 32;
-        const uint32_t flag = 1 << shift;
-        return (array[real_index] & flag) != 0;
-    }
-
-    void ArrayBoolSet(std::vector<uint32_t>& array, const uint32_t index, const bool is_set = true)
-    {
-        const uint32_t real_index = index / 32;
-        if (real_index >= array.size()) {
-            array.resize(real_index + 1, 0);
-        }
-        const uint32_t shift = index % 32;
-        const uint32_t flag = 1u << shift;
-        if (is_set) {
-            array[real_index] |= flag;
-        }
-        else {
-            array[real_index] ^= flag;
-        }
-    }
-
     const wchar_t* GetAccountEmail()
     {
         const auto c = GW::GetCharContext();
@@ -267,6 +242,9 @@ namespace {
 
     bool pending_sort = true;
     const char* completion_ini_filename = "character_completion.ini";
+    const char* completion_snapshot_filename = "character_completion.bin";
+    constexpr uint32_t COMPLETION_SNAPSHOT_MAGIC = 0x50434254; // "TBCP"
+    constexpr uint32_t COMPLETION_SNAPSHOT_VERSION = 1;
 
     bool hard_mode = false;
 
@@ -286,6 +264,34 @@ namespace {
     std::map<std::wstring, CharacterCompletion*> character_completion;
     GW::HookEntry OnPostUIMessage_Entry;
 
+    static_assert(_countof(encoded_minipet_names) <= UnlockBits::bit_count);
+    static_assert(_countof(encoded_festival_hat_names) <= UnlockBits::bit_count);
+
+    // character_completion turned sideways: for every skill or map, which characters have it. Answers "who hasn't done X yet"
+    // with a few word-wide ANDs instead of visiting every character. Rebuilt on the next query after anything marks it stale.
+    constexpr size_t MAX_INDEXED_CHARACTERS = 256;
+    using CharacterMask = FixedBitset<MAX_INDEXED_CHARACTERS>;
+
+    struct CompletionIndex {
+        bool stale = true;
+        // Non-pvp, non-pre-searing characters sorted by name; bit i of every mask below is characters[i]
+        std::vector<CharacterCompletion*> characters;
+        std::unordered_map<std::wstring, CharacterMask> by_account;
+        CharacterMask all;
+        std::vector<CharacterMask> skills;
+        std::vector<CharacterMask> mission;
+        std::vector<CharacterMask> mission_bonus;
+        std::vector<CharacterMask> mission_hm;
+        std::vector<CharacterMask> mission_bonus_hm;
+        std::vector<CharacterMask> vanquishes;
+        std::vector<CharacterMask> maps_unlocked;
+    } completion_index;
+
+    void InvalidateCompletionIndex()
+    {
+        completion_index.stale = true;
+    }
+
     std::map<Campaign, std::vector<OutpostUnlock*>> outposts;
     std::map<Campaign, std::vector<Mission*>> missions;
     std::map<Campaign, std::vector<Mission*>> vanquishes;
@@ -306,8 +312,7 @@ namespace {
     const char* PvPItemUpgradeTypeName(const uint32_t pvp_upgrade_item_id)
     {
         if (const auto& info = GW::Items::GetPvPItemUpgrade(pvp_upgrade_item_id)) {
-            const auto found = std::ranges::find_if(item_upgrades_by_file_id, [file_id = info->file_id](auto& check) { return check.file_id == file_id; });
-            if (found != item_upgrades_by_file_id.end()) {
+            if (const auto found = item_upgrades_by_file_id.find(info->file_id)) {
                 return found->completion_category;
             }
         }
@@ -340,12 +345,12 @@ namespace {
         std::wstring msg;
         const auto cc = character_completion[GetPlayerName()];
         auto& minipets_unlocked = cc->minipets_unlocked;
-        minipets_unlocked.clear();
+        minipets_unlocked.reset();
         while (std::regex_search(subject, m, displayed_miniatures)) {
             std::wstring miniature_encoded_name(m[1].str());
             for (size_t i = 0; i < _countof(encoded_minipet_names); i++) {
                 if (encoded_minipet_names[i] == miniature_encoded_name) {
-                    ArrayBoolSet(minipets_unlocked, i, true);
+                    minipets_unlocked.set(i);
                     break;
                 }
             }
@@ -356,7 +361,7 @@ namespace {
             std::wstring miniature_encoded_name(m[1].str());
             for (size_t i = 0; i < _countof(encoded_minipet_names); i++) {
                 if (encoded_minipet_names[i] == miniature_encoded_name) {
-                    ArrayBoolSet(minipets_unlocked, i, true);
+                    minipets_unlocked.set(i);
                     break;
                 }
             }
@@ -381,7 +386,7 @@ namespace {
         for (const auto btn : buttons) {
             for (size_t i = 0; i < _countof(encoded_festival_hat_names); i++) {
                 if (wcsstr(btn->message, encoded_festival_hat_names[i])) {
-                    ArrayBoolSet(unlocked, i, true);
+                    unlocked.set(i);
                     break;
                 }
             }
@@ -414,7 +419,7 @@ namespace {
         const std::wstring miniature_encoded_name(m[1].str());
         for (size_t i = 0; i < _countof(encoded_minipet_names); i++) {
             if (encoded_minipet_names[i] == miniature_encoded_name) {
-                ArrayBoolSet(minipets_unlocked, i, true);
+                minipets_unlocked.set(i);
                 Instance().CheckProgress();
                 break;
             }
@@ -448,6 +453,43 @@ namespace {
         }
     }
 
+    // Calls fn with the bitset that type is stored in; false for Heroes, which is a list of hero ids rather than bits
+    template <typename Completion, typename Fn>
+    bool VisitCompletionBits(Completion& cc, const CompletionType type, Fn&& fn)
+    {
+        switch (type) {
+            case CompletionType::Skills:
+                fn(cc.skills);
+                return true;
+            case CompletionType::Mission:
+                fn(cc.mission);
+                return true;
+            case CompletionType::MissionBonus:
+                fn(cc.mission_bonus);
+                return true;
+            case CompletionType::MissionHM:
+                fn(cc.mission_hm);
+                return true;
+            case CompletionType::MissionBonusHM:
+                fn(cc.mission_bonus_hm);
+                return true;
+            case CompletionType::Vanquishes:
+                fn(cc.vanquishes);
+                return true;
+            case CompletionType::MapsUnlocked:
+                fn(cc.maps_unlocked);
+                return true;
+            case CompletionType::MinipetsUnlocked:
+                fn(cc.minipets_unlocked);
+                return true;
+            case CompletionType::FestivalHats:
+                fn(cc.festival_hats);
+                return true;
+            default:
+                return false;
+        }
+    }
+
     bool ParseCompletionBuffer(const CompletionType type, const wchar_t* character_name = nullptr, uint32_t* buffer = nullptr, size_t len = 0)
     {
         bool from_game = false;
@@ -503,61 +545,29 @@ namespace {
             }
         }
         const auto this_character_completion = CompletionWindow::GetCharacterCompletion(character_name, true);
-        std::vector<uint32_t>* write_buf = nullptr;
-        switch (type) {
-            case CompletionType::Mission:
-                write_buf = &this_character_completion->mission;
-                break;
-            case CompletionType::MissionBonus:
-                write_buf = &this_character_completion->mission_bonus;
-                break;
-            case CompletionType::MissionHM:
-                write_buf = &this_character_completion->mission_hm;
-                break;
-            case CompletionType::MissionBonusHM:
-                write_buf = &this_character_completion->mission_bonus_hm;
-                break;
-            case CompletionType::Skills:
-                write_buf = &this_character_completion->skills;
-                break;
-            case CompletionType::Vanquishes:
-                write_buf = &this_character_completion->vanquishes;
-                break;
-            case CompletionType::Heroes: {
-                write_buf = &this_character_completion->heroes;
-                if (from_game) {
-                    // Writing from game memory, not from file
-                    std::vector<uint32_t>& write = *write_buf;
-                    const GW::HeroInfo* hero_arr = (GW::HeroInfo*)buffer;
-                    if (write.size() < len) {
-                        write.resize(len, 0);
-                    }
-                    for (size_t i = 0; i < len; i++) {
-                        write[i] = hero_arr[i].hero_id;
-                    }
-                    return true;
+        InvalidateCompletionIndex();
+        if (type == CompletionType::Heroes) {
+            std::vector<uint32_t>& write = this_character_completion->heroes;
+            if (write.size() < len) {
+                write.resize(len, 0);
+            }
+            if (from_game) {
+                // Writing from game memory, not from file
+                const GW::HeroInfo* hero_arr = (GW::HeroInfo*)buffer;
+                for (size_t i = 0; i < len; i++) {
+                    write[i] = hero_arr[i].hero_id;
                 }
             }
-            break;
-            case CompletionType::MapsUnlocked:
-                write_buf = &this_character_completion->maps_unlocked;
-                break;
-            case CompletionType::MinipetsUnlocked:
-                write_buf = &this_character_completion->minipets_unlocked;
-                break;
-            case CompletionType::FestivalHats:
-                write_buf = &this_character_completion->festival_hats;
-                break;
-            default: ASSERT("Invalid CompletionType" && false);
-        }
-        std::vector<uint32_t>& write = *write_buf;
-        if (write.size() < len) {
-            write.resize(len, 0);
-        }
-        for (size_t i = 0; i < len; i++) {
-            write[i] |= buffer[i];
+            else {
+                for (size_t i = 0; i < len; i++) {
+                    write[i] |= buffer[i];
+                }
+            }
+            return true;
         }
-        return true;
+        return VisitCompletionBits(*this_character_completion, type, [buffer, len](auto& bits) {
+            bits.merge_words({buffer, len});
+        });
     }
 
     bool only_show_account_chars = true;
@@ -586,6 +596,7 @@ namespace {
         if (loading != character_completion.end())
             return false;
         const auto chars = GW::AccountMgr::GetAvailableChars();
+        InvalidateCompletionIndex();
         if (chars && chars->size()) {
             for (const auto& character : *chars) {
                 if (character_completion.contains(character.player_name))
@@ -702,18 +713,18 @@ namespace {
             case GW::RegionType::ExplorableZone:
                 if (map->continent == GW::Continent::BattleIsles)
                     return true; // Fow, Uw
-                return !map->GetIsOnWorldMap() || ArrayBoolAt(completion->vanquishes, static_cast<uint32_t>(map_id));
+                return !map->GetIsOnWorldMap() || completion->vanquishes.test(std::to_underlying(map_id));
         }
 
-        if ((check & NormalMode) && !ArrayBoolAt(completion->mission, static_cast<uint32_t>(map_id)))
+        if ((check & NormalMode) && !completion->mission.test(std::to_underlying(map_id)))
             return false;
-        if ((check & HardMode) && !ArrayBoolAt(completion->mission_hm, static_cast<uint32_t>(map_id)))
+        if ((check & HardMode) && !completion->mission_hm.test(std::to_underlying(map_id)))
             return false;
         const bool has_bonus = map->campaign != Campaign::EyeOfTheNorth;
         if (has_bonus) {
-            if ((check & NormalMode) && !ArrayBoolAt(completion->mission_bonus, static_cast<uint32_t>(map_id)))
+            if ((check & NormalMode) && !completion->mission_bonus.test(std::to_underlying(map_id)))
                 return false;
-            if ((check & HardMode) && !ArrayBoolAt(completion->mission_bonus_hm, static_cast<uint32_t>(map_id)))
+            if ((check & HardMode) && !completion->mission_bonus_hm.test(std::to_underlying(map_id)))
                 return false;
         }
         return true;
@@ -943,23 +954,25 @@ void Mission::CheckProgress(const std::wstring& player_name)
         return;
     }
     const auto& player_completion = completion.at(player_name);
-    const std::vector<uint32_t>* missions_complete = &player_completion->mission;
-    const std::vector<uint32_t>* missions_bonus = &player_completion->mission_bonus;
+    const MapBits* missions_complete = &player_completion->mission;
+    const MapBits* missions_bonus = &player_completion->mission_bonus;
     if (hard_mode) {
         missions_complete = &player_completion->mission_hm;
         missions_bonus = &player_completion->mission_bonus_hm;
     }
-    map_unlocked = player_completion->maps_unlocked.empty() || ArrayBoolAt(player_completion->maps_unlocked, std::to_underlying(outpost));
-    is_completed = ArrayBoolAt(*missions_complete, std::to_underlying(outpost));
-    bonus = ArrayBoolAt(*missions_bonus, std::to_underlying(outpost));
+    map_unlocked = player_completion->maps_unlocked.none() || player_completion->maps_unlocked.test(std::to_underlying(outpost));
+    is_completed = missions_complete->test(std::to_underlying(outpost));
+    bonus = missions_bonus->test(std::to_underlying(outpost));
 
+    const auto complete_words = missions_complete->all_words();
     GW::Array<uint32_t> complete_arr;
-    complete_arr.m_buffer = const_cast<uint32_t*>(missions_complete->data());
-    complete_arr.m_capacity = complete_arr.m_size = missions_complete->size();
+    complete_arr.m_buffer = const_cast<uint32_t*>(complete_words.data());
+    complete_arr.m_capacity = complete_arr.m_size = complete_words.size();
 
+    const auto bonus_words = missions_bonus->all_words();
     GW::Array<uint32_t> bonus_arr;
-    bonus_arr.m_buffer = const_cast<uint32_t*>(missions_bonus->data());
-    bonus_arr.m_capacity = bonus_arr.m_size = missions_bonus->size();
+    bonus_arr.m_buffer = const_cast<uint32_t*>(bonus_words.data());
+    bonus_arr.m_capacity = bonus_arr.m_size = bonus_words.size();
 
     mission_state = ToolboxUtils::GetMissionState(outpost, complete_arr, bonus_arr);
 
@@ -973,7 +986,7 @@ void OutpostUnlock::CheckProgress(const std::wstring& player_name)
         return;
     }
     const auto& player_completion = completion.at(player_name);
-    is_completed = bonus = map_unlocked = ArrayBoolAt(player_completion->maps_unlocked, std::to_underlying(outpost));
+    is_completed = bonus = map_unlocked = player_completion->maps_unlocked.test(std::to_underlying(outpost));
 
     GetOutpostIcons(outpost, icons, 0);
 }
@@ -1225,7 +1238,7 @@ void PvESkill::CheckProgress(const std::wstring& player_name)
         return;
     }
     const auto& unlocked = skills.at(player_name)->skills;
-    is_completed = bonus = ArrayBoolAt(unlocked, std::to_underlying(skill_id));
+    is_completed = bonus = unlocked.test(std::to_underlying(skill_id));
 }
 
 FactionsPvESkill::FactionsPvESkill(const SkillID skill_id)
@@ -1265,7 +1278,7 @@ void Vanquish::CheckProgress(const std::wstring& player_name)
         return;
     }
     const auto& unlocked = completion.at(player_name)->vanquishes;
-    is_completed = bonus = ArrayBoolAt(unlocked, std::to_underlying(outpost));
+    is_completed = bonus = unlocked.test(std::to_underlying(outpost));
     mission_state = is_completed ? 0x7 : 0x0;
 
     GetOutpostIcons(outpost, icons, mission_state, true);
@@ -1341,11 +1354,11 @@ void CompletionWindow::Initialize()
 
     const auto& unlocked_pvp_item_upgrade_array = GW::Items::GetPvPItemUpgradesArray();
 
-    for (const auto& it : item_upgrades_by_file_id) {
+    for (const auto file_id : item_upgrades_by_file_id | std::views::keys) {
         // GW::Array<something> unlocked_pvp_item_upgrade_array
         for (size_t i = 0; i < unlocked_pvp_item_upgrade_array.size(); i++) {
             const auto& deets = unlocked_pvp_item_upgrade_array[i];
-            if (deets.file_id != it.file_id) {
+            if (deets.file_id != file_id) {
                 continue;
             }
             if (deets.is_dev) {
@@ -2134,6 +2147,7 @@ void CompletionWindow::Terminate()
         delete camp.second;
     }
     character_completion.clear();
+    completion_index = {};
 }
 
 void CompletionWindow::Draw(IDirect3DDevice9* device)
@@ -2793,19 +2807,210 @@ then press "Examine the Monument to Devotion.")");
     }
 }
 
+namespace {
+    // Every per-character completion buffer, in the order they're stored
+    struct CompletionField {
+        CompletionType type;
+        const char* ini_name;
+    };
+
+    constexpr CompletionField completion_fields[] = {
+        {CompletionType::Mission, "mission"},
+        {CompletionType::MissionBonus, "mission_bonus"},
+        {CompletionType::MissionHM, "mission_hm"},
+        {CompletionType::MissionBonusHM, "mission_bonus_hm"},
+        {CompletionType::Skills, "skills"},
+        {CompletionType::Vanquishes, "vanquishes"},
+        {CompletionType::Heroes, "heros"},
+        {CompletionType::MapsUnlocked, "maps_unlocked"},
+        {CompletionType::MinipetsUnlocked, "minipets_unlocked"},
+        {CompletionType::FestivalHats, "festival_hats"}
+    };
+
+    // The words to store for a field; bitsets are trimmed after their last set bit, so the stored layout is what it was when these were vectors
+    std::span<const uint32_t> GetCompletionWords(const CharacterCompletion& cc, const CompletionType type)
+    {
+        std::span<const uint32_t> words = cc.heroes;
+        VisitCompletionBits(cc, type, [&words](const auto& bits) {
+            words = bits.used_words();
+        });
+        return words;
+    }
+
+    // Older builds kept everything in character_completion.ini; still read it if there's no snapshot yet.
+    size_t ImportCompletionIni()
+    {
+        ToolboxIni completion_ini(false, false, false);
+        if (completion_ini.LoadFile(Resources::GetPath(completion_ini_filename).c_str()) < 0) {
+            return 0;
+        }
+
+        auto read_ini_to_buf = [&](const CompletionType type, const char* section, const char* ini_section, const std::wstring_view name_ws) {
+            char ini_key_buf[64];
+            snprintf(ini_key_buf, _countof(ini_key_buf), "%s_length", section);
+            const int len = completion_ini.GetLongValue(ini_section, ini_key_buf, 0);
+            if (len < 1) {
+                return;
+            }
+            snprintf(ini_key_buf, _countof(ini_key_buf), "%s_values", section);
+            const std::string val = completion_ini.GetValue(ini_section, ini_key_buf, "");
+            if (val.empty()) {
+                return;
+            }
+            std::vector<uint32_t> completion_buf(len);
+            ASSERT(GuiUtils::IniToArray(val, completion_buf.data(), len));
+            ParseCompletionBuffer(type, name_ws.data(), completion_buf.data(), completion_buf.size());
+        };
+
+        ToolboxIni::TNamesDepend entries;
+        completion_ini.GetAllSections(entries);
+        for (const ToolboxIni::Entry& entry : entries) {
+            const char* ini_section = entry.pItem;
+            const auto name_ws = TextUtils::StringToWString(ini_section);
+
+            const auto c = CompletionWindow::GetCharacterCompletion(name_ws.data(), true);
+            c->profession = static_cast<Profession>(completion_ini.GetLongValue(ini_section, "profession", 0));
+            c->account = TextUtils::StringToWString(completion_ini.GetValue(ini_section, "account", ""));
+            c->is_pvp = completion_ini.GetBoolValue(ini_section, "is_pvp", false);
+            c->is_pre_searing = completion_ini.GetBoolValue(ini_section, "is_pre_searing", false);
+
+            for (const auto& field : completion_fields) {
+                read_ini_to_buf(field.type, field.ini_name, ini_section, name_ws);
+            }
+        }
+        return entries.size();
+    }
+
+    void ExportCompletionIni()
+    {
+        ToolboxIni completion_ini(false, false, false);
+        auto write_buf_to_ini = [&completion_ini](const char* section, const std::span<const uint32_t> read, const std::string_view name) {
+            char ini_key_buf[64];
+            snprintf(ini_key_buf, _countof(ini_key_buf), "%s_length", section);
+            completion_ini.SetLongValue(name.data(), ini_key_buf, read.size());
+            std::string ini_str;
+            ASSERT(GuiUtils::ArrayToIni(read.data(), read.size(), &ini_str));
+            snprintf(ini_key_buf, _countof(ini_key_buf), "%s_values", section);
+            completion_ini.SetValue(name.data(), ini_key_buf, ini_str.c_str());
+        };
+
+        for (const auto& [entry_name, char_comp] : character_completion) {
+            if (entry_name.empty()) {
+                continue;
+            }
+            const std::string& name = char_comp->name_str;
+            completion_ini.SetLongValue(name.c_str(), "profession", std::to_underlying(char_comp->profession));
+            completion_ini.SetValue(name.c_str(), "account", TextUtils::WStringToString(char_comp->account).c_str());
+            completion_ini.SetBoolValue(name.c_str(), "is_pvp", char_comp->is_pvp);
+            completion_ini.SetBoolValue(name.c_str(), "is_pre_searing", char_comp->is_pre_searing);
+
+            for (const auto& field : completion_fields) {
+                write_buf_to_ini(field.ini_name, GetCompletionWords(*char_comp, field.type), name);
+            }
+
+            completion_ini.SetValue(name.c_str(), "hom_code", char_comp->hom_code.c_str());
+        }
+        const auto path = Resources::GetPath(completion_ini_filename);
+        if (Resources::SaveIniToFile(path, &completion_ini) == 0) {
+            Log::Info("Completion exported to %s", path.string().c_str());
+        }
+        else {
+            Log::Error("Failed to export completion to %s", path.string().c_str());
+        }
+    }
+
+    // Returns false if there's no usable snapshot, in which case nothing has been loaded.
+    bool LoadCompletionSnapshot(size_t& character_count)
+    {
+        std::vector<uint8_t> payload;
+        if (!BinarySnapshot::Load(Resources::GetPath(completion_snapshot_filename), COMPLETION_SNAPSHOT_MAGIC, COMPLETION_SNAPSHOT_VERSION, payload)) {
+            return false;
+        }
+        struct LoadedCharacter {
+            std::wstring name;
+            std::wstring account;
+            uint32_t profession = 0;
+            uint8_t is_pvp = 0;
+            uint8_t is_pre_searing = 0;
+            std::string hom_code;
+            std::array<std::vector<uint32_t>, std::size(completion_fields)> buffers;
+        };
+        // Read it all before touching anything, so a malformed snapshot can't leave half of it applied
+        BinarySnapshot::Reader reader(payload);
+        uint32_t count = 0;
+        reader.Read(count);
+        std::vector<LoadedCharacter> loaded;
+        for (uint32_t i = 0; i < count && reader.Ok(); i++) {
+            auto& c = loaded.emplace_back();
+            reader.ReadString(c.name);
+            reader.ReadString(c.account);
+            reader.Read(c.profession);
+            reader.Read(c.is_pvp);
+            reader.Read(c.is_pre_searing);
+            reader.ReadString(c.hom_code);
+            for (auto& buffer : c.buffers) {
+                reader.ReadArray(buffer);
+            }
+        }
+        if (!reader.Ok()) {
+            return false;
+        }
+        for (auto& loaded_character : loaded) {
+            const auto c = CompletionWindow::GetCharacterCompletion(loaded_character.name.c_str(), true);
+            c->profession = static_cast<Profession>(loaded_character.profession);
+            c->account = std::move(loaded_character.account);
+            c->is_pvp = loaded_character.is_pvp != 0;
+            c->is_pre_searing = loaded_character.is_pre_searing != 0;
+            c->hom_code = std::move(loaded_character.hom_code);
+            for (size_t i = 0; i < std::size(completion_fields); i++) {
+                auto& buffer = loaded_character.buffers[i];
+                if (!buffer.empty()) {
+                    ParseCompletionBuffer(completion_fields[i].type, loaded_character.name.c_str(), buffer.data(), buffer.size());
+                }
+            }
+        }
+        character_count = loaded.size();
+        return true;
+    }
+
+    bool SaveCompletionSnapshot()
+    {
+        BinarySnapshot::Writer writer;
+        uint32_t count = 0;
+        for (const auto& entry_name : character_completion | std::views::keys) {
+            count += entry_name.empty() ? 0 : 1;
+        }
+        writer.Write(count);
+        for (const auto& [entry_name, char_comp] : character_completion) {
+            if (entry_name.empty()) {
+                continue;
+            }
+            writer.WriteString(entry_name);
+            writer.WriteString(char_comp->account);
+            writer.Write(static_cast<uint32_t>(char_comp->profession));
+            writer.Write(static_cast<uint8_t>(char_comp->is_pvp));
+            writer.Write(static_cast<uint8_t>(char_comp->is_pre_searing));
+            writer.WriteString(char_comp->hom_code);
+            for (const auto& field : completion_fields) {
+                writer.WriteArray(GetCompletionWords(*char_comp, field.type));
+            }
+        }
+        return BinarySnapshot::Save(Resources::GetPath(completion_snapshot_filename), COMPLETION_SNAPSHOT_MAGIC, COMPLETION_SNAPSHOT_VERSION, writer.Data());
+    }
+}
+
 void CompletionWindow::DrawSettingsInternal()
 {
     ToolboxWindow::DrawSettingsInternal();
+    if (ImGui::Button("Export to ini")) {
+        ExportCompletionIni();
+    }
+    ImGui::ShowHelp("Completion is saved in a binary file; this writes a copy to character_completion.ini,\nwhich older versions of Toolbox and other tools can read.");
 }
 
 void CompletionWindow::LoadSettings(ToolboxIni* ini)
 {
     ToolboxWindow::LoadSettings(ini);
-    ToolboxIni completion_ini(false, false, false);
-    const auto success = completion_ini.LoadFile(Resources::GetPath(completion_ini_filename).c_str());
-    if (success < 0) {
-        return Log::Error("Failed to load completion ini");
-    }
 
     LOAD_BOOL(show_as_list);
     LOAD_BOOL(hide_unlocked_skills);
@@ -2815,45 +3020,14 @@ void CompletionWindow::LoadSettings(ToolboxIni* ini)
     LOAD_BOOL(hide_collected_hats);
     LOAD_BOOL(only_show_account_chars);
 
-    auto read_ini_to_buf = [&](const CompletionType type, const char* section, const char* ini_section, const std::wstring_view name_ws) {
-        char ini_key_buf[64];
-        snprintf(ini_key_buf, _countof(ini_key_buf), "%s_length", section);
-        const int len = completion_ini.GetLongValue(ini_section, ini_key_buf, 0);
-        if (len < 1) {
-            return;
-        }
-        snprintf(ini_key_buf, _countof(ini_key_buf), "%s_values", section);
-        const std::string val = completion_ini.GetValue(ini_section, ini_key_buf, "");
-        if (val.empty()) {
-            return;
-        }
-        std::vector<uint32_t> completion_buf(len);
-        ASSERT(GuiUtils::IniToArray(val, completion_buf.data(), len));
-        ParseCompletionBuffer(type, name_ws.data(), completion_buf.data(), completion_buf.size());
-    };
-
-    ToolboxIni::TNamesDepend entries;
-    completion_ini.GetAllSections(entries);
-    for (const ToolboxIni::Entry& entry : entries) {
-        const char* ini_section = entry.pItem;
-        const auto name_ws = TextUtils::StringToWString(ini_section);
-
-        const auto c = GetCharacterCompletion(name_ws.data(), true);
-        c->profession = static_cast<Profession>(completion_ini.GetLongValue(ini_section, "profession", 0));
-        c->account = TextUtils::StringToWString(completion_ini.GetValue(ini_section, "account", ""));
-        c->is_pvp = completion_ini.GetBoolValue(ini_section, "is_pvp", false);
-        c->is_pre_searing = completion_ini.GetBoolValue(ini_section, "is_pre_searing", false);
-
-        read_ini_to_buf(CompletionType::Mission, "mission", ini_section, name_ws);
-        read_ini_to_buf(CompletionType::MissionBonus, "mission_bonus", ini_section, name_ws);
-        read_ini_to_buf(CompletionType::MissionHM, "mission_hm", ini_section, name_ws);
-        read_ini_to_buf(CompletionType::MissionBonusHM, "mission_bonus_hm", ini_section, name_ws);
-        read_ini_to_buf(CompletionType::Skills, "skills", ini_section, name_ws);
-        read_ini_to_buf(CompletionType::Vanquishes, "vanquishes", ini_section, name_ws);
-        read_ini_to_buf(CompletionType::Heroes, "heros", ini_section, name_ws);
-        read_ini_to_buf(CompletionType::MapsUnlocked, "maps_unlocked", ini_section, name_ws);
-        read_ini_to_buf(CompletionType::MinipetsUnlocked, "minipets_unlocked", ini_section, name_ws);
-        read_ini_to_buf(CompletionType::FestivalHats, "festival_hats", ini_section, name_ws);
+    const auto load_started = TIMER_INIT();
+    size_t character_count = 0;
+    if (LoadCompletionSnapshot(character_count)) {
+        Log::Log("[Completion] Loaded %zu characters from %s in %d ms\n", character_count, completion_snapshot_filename, TIMER_DIFF(load_started));
+    }
+    else {
+        character_count = ImportCompletionIni();
+        Log::Log("[Completion] Imported %zu characters from %s in %d ms\n", character_count, completion_ini_filename, TIMER_DIFF(load_started));
     }
     RefreshAccountCharacters();
     ParseCompletionBuffer(CompletionType::Mission);
@@ -2932,7 +3106,6 @@ CompletionWindow* CompletionWindow::CheckProgress(const bool fetch_hom)
 void CompletionWindow::SaveSettings(ToolboxIni* ini)
 {
     ToolboxWindow::SaveSettings(ini);
-    ToolboxIni completion_ini(false, false, false);
     if (character_completion.empty() ||
         (character_completion.size() == 1 && character_completion.contains(L""))) {
         return;
@@ -2946,40 +3119,13 @@ void CompletionWindow::SaveSettings(ToolboxIni* ini)
     SAVE_BOOL(hide_collected_hats);
     SAVE_BOOL(only_show_account_chars);
 
-    auto write_buf_to_ini = [&completion_ini](const char* section, const std::vector<uint32_t>* read, const std::string_view name) {
-        char ini_key_buf[64];
-        snprintf(ini_key_buf, _countof(ini_key_buf), "%s_length", section);
-        completion_ini.SetLongValue(name.data(), ini_key_buf, read->size());
-        std::string ini_str;
-        ASSERT(GuiUtils::ArrayToIni(read->data(), read->size(), &ini_str));
-        snprintf(ini_key_buf, _countof(ini_key_buf), "%s_values", section);
-        completion_ini.SetValue(name.data(), ini_key_buf, ini_str.c_str());
-    };
-
-    for (const auto& [entry_name, char_comp] : character_completion) {
-        if (entry_name.empty()) {
-            continue;
-        }
-        const std::string& name = char_comp->name_str;
-        completion_ini.SetLongValue(name.c_str(), "profession", std::to_underlying(char_comp->profession));
-        completion_ini.SetValue(name.c_str(), "account", TextUtils::WStringToString(char_comp->account).c_str());
-        completion_ini.SetBoolValue(name.c_str(), "is_pvp", char_comp->is_pvp);
-        completion_ini.SetBoolValue(name.c_str(), "is_pre_searing", char_comp->is_pre_searing);
-
-        write_buf_to_ini("mission", &char_comp->mission, name);
-        write_buf_to_ini("mission_bonus", &char_comp->mission_bonus, name);
-        write_buf_to_ini("mission_hm", &char_comp->mission_hm, name);
-        write_buf_to_ini("mission_bonus_hm", &char_comp->mission_bonus_hm, name);
-        write_buf_to_ini("skills", &char_comp->skills, name);
-        write_buf_to_ini("vanquishes", &char_comp->vanquishes, name);
-        write_buf_to_ini("heros", &char_comp->heroes, name);
-        write_buf_to_ini("maps_unlocked", &char_comp->maps_unlocked, name);
-        write_buf_to_ini("minipets_unlocked", &char_comp->minipets_unlocked, name);
-        write_buf_to_ini("festival_hats", &char_comp->festival_hats, name);
-
-        completion_ini.SetValue(name.c_str(), "hom_code", char_comp->hom_code.c_str());
+    const auto save_started = TIMER_INIT();
+    if (SaveCompletionSnapshot()) {
+        Log::Log("[Completion] Saved %s in %d ms\n", completion_snapshot_filename, TIMER_DIFF(save_started));
+    }
+    else {
+        Log::Error("Failed to save %s", completion_snapshot_filename);
     }
-    completion_ini.SaveFile(Resources::GetPath(completion_ini_filename).c_str());
 }
 
 CharacterCompletion* CompletionWindow::GetCharacterCompletion(const wchar_t* character_name, const bool create_if_not_found)
@@ -2993,6 +3139,7 @@ CharacterCompletion* CompletionWindow::GetCharacterCompletion(const wchar_t* cha
         this_character_completion->name_str = TextUtils::WStringToString(character_name);
         this_character_completion->hom_achievements.character_name = character_name;
         character_completion[character_name] = this_character_completion;
+        InvalidateCompletionIndex();
         FetchHom(&this_character_completion->hom_achievements);
     }
     return this_character_completion;
@@ -3042,70 +3189,183 @@ bool CompletionWindow::IsAreaUnlocked(const wchar_t* player_name, const MapID ma
     const auto completion = GetCharacterCompletion(player_name, false);
     const auto map = completion ? GW::Map::GetMapInfo(map_id) : nullptr;
     if (!(map && completion)) return false;
-    return ArrayBoolAt(completion->maps_unlocked, static_cast<uint32_t>(map_id));
+    return completion->maps_unlocked.test(std::to_underlying(map_id));
 }
 
 bool CompletionWindow::IsSkillUnlocked(const wchar_t* player_name, const SkillID skill_id)
 {
     const auto completion = GetCharacterCompletion(player_name, false);
-    return completion && ArrayBoolAt(completion->skills, static_cast<uint32_t>(skill_id));
+    return completion && completion->skills.test(std::to_underlying(skill_id));
+}
+
+namespace {
+    const CompletionIndex* GetCompletionIndex()
+    {
+        auto& index = completion_index;
+        if (index.stale) {
+            index.stale = false;
+            index.characters.clear();
+            for (const auto cc : character_completion | std::views::values) {
+                if (cc && !(cc->is_pvp || cc->is_pre_searing)) {
+                    index.characters.push_back(cc);
+                }
+            }
+            std::ranges::sort(index.characters, [](const CharacterCompletion* a, const CharacterCompletion* b) {
+                return a->name_str.compare(b->name_str) < 0;
+            });
+            index.by_account.clear();
+            index.all.reset();
+            index.skills.assign(SkillBits::bit_count, {});
+            for (auto* columns : {&index.mission, &index.mission_bonus, &index.mission_hm, &index.mission_bonus_hm, &index.vanquishes, &index.maps_unlocked}) {
+                columns->assign(MapBits::bit_count, {});
+            }
+            if (index.characters.size() <= MAX_INDEXED_CHARACTERS) {
+                for (size_t i = 0; i < index.characters.size(); i++) {
+                    const auto cc = index.characters[i];
+                    index.all.set(i);
+                    index.by_account[cc->account].set(i);
+                    const auto add_column_bits = [i](const auto& bits, std::vector<CharacterMask>& columns) {
+                        bits.for_each_set([&](const size_t bit) {
+                            columns[bit].set(i);
+                        });
+                    };
+                    add_column_bits(cc->skills, index.skills);
+                    add_column_bits(cc->mission, index.mission);
+                    add_column_bits(cc->mission_bonus, index.mission_bonus);
+                    add_column_bits(cc->mission_hm, index.mission_hm);
+                    add_column_bits(cc->mission_bonus_hm, index.mission_bonus_hm);
+                    add_column_bits(cc->vanquishes, index.vanquishes);
+                    add_column_bits(cc->maps_unlocked, index.maps_unlocked);
+                }
+            }
+        }
+        // Too many characters to fit a mask; callers fall back to checking each one
+        return index.characters.size() <= MAX_INDEXED_CHARACTERS ? &index : nullptr;
+    }
+
+    const CharacterMask& GetColumn(const std::vector<CharacterMask>& columns, const size_t bit)
+    {
+        static const CharacterMask empty;
+        return bit < columns.size() ? columns[bit] : empty;
+    }
+
+    // Characters the GetCharactersWithout* queries should consider
+    CharacterMask GetEligibleCharacters(const CompletionIndex& index)
+    {
+        if (!only_show_account_chars) {
+            return index.all;
+        }
+        const auto email = GW::AccountMgr::GetAccountEmail();
+        const auto found = index.by_account.find(email ? email : L"");
+        return found != index.by_account.end() ? found->second : CharacterMask{};
+    }
+
+    std::vector<CharacterCompletion*> GetIndexedCharacters(const CompletionIndex& index, const CharacterMask& mask)
+    {
+        std::vector<CharacterCompletion*> out;
+        out.reserve(mask.count());
+        mask.for_each_set([&](const size_t i) {
+            out.push_back(index.characters[i]);
+        });
+        return out;
+    }
+
+    // Characters that have done all of whatever completing map_id needs
+    CharacterMask GetCharactersWithAreaComplete(const CompletionIndex& index, const MapID map_id, const CompletionCheck check, const GW::AreaInfo* map)
+    {
+        if (map_id == MapID::Tomb_of_the_Primeval_Kings) {
+            return index.all; // Topk special case
+        }
+        if (!map) {
+            return {};
+        }
+        const auto bit = std::to_underlying(map_id);
+        switch (map->type) {
+            case GW::RegionType::EliteMission:
+                return index.all;
+            case GW::RegionType::ExplorableZone:
+                if (map->continent == GW::Continent::BattleIsles || !map->GetIsOnWorldMap())
+                    return index.all; // Fow, Uw
+                return GetColumn(index.vanquishes, bit);
+        }
+        CharacterMask complete = index.all;
+        const bool has_bonus = map->campaign != Campaign::EyeOfTheNorth;
+        if (check & NormalMode) {
+            complete &= GetColumn(index.mission, bit);
+            if (has_bonus)
+                complete &= GetColumn(index.mission_bonus, bit);
+        }
+        if (check & HardMode) {
+            complete &= GetColumn(index.mission_hm, bit);
+            if (has_bonus)
+                complete &= GetColumn(index.mission_bonus_hm, bit);
+        }
+        return complete;
+    }
+
+    // Per-character fallback for when there are too many characters to index
+    template <typename Fn>
+    std::vector<CharacterCompletion*> GetCharactersWithout(Fn&& has_done)
+    {
+        std::vector<CharacterCompletion*> out;
+        const auto email = GW::AccountMgr::GetAccountEmail();
+        for (auto& it : character_completion) {
+            if (it.second->is_pvp || it.second->is_pre_searing)
+                continue;
+            if (only_show_account_chars && it.second->account != email)
+                continue;
+            if (!has_done(it.first.c_str()))
+                out.push_back(it.second);
+        }
+        std::ranges::sort(out, [](CharacterCompletion* a, CharacterCompletion* b) {
+            return a->name_str.compare(b->name_str) < 0;
+        });
+        return out;
+    }
 }
 
 std::vector<CharacterCompletion*> CompletionWindow::GetCharactersWithoutAreaComplete(MapID map_id, CompletionCheck check)
 {
-    std::vector<CharacterCompletion*> out;
     if (map_id == MapID::None)
-        return out;
+        return {};
     const auto info = GW::Map::GetMapInfo(map_id);
-    const auto email = GW::AccountMgr::GetAccountEmail();
-    for (auto& it : character_completion) {
-        if (it.second->is_pvp || it.second->is_pre_searing)
-            continue;
-        if (only_show_account_chars && it.second->account != email)
-            continue;
-        if (!::IsAreaComplete(it.first.c_str(), map_id, check, info))
-            out.push_back(it.second);
+    const auto index = GetCompletionIndex();
+    if (!index) {
+        return GetCharactersWithout([&](const wchar_t* player_name) {
+            return ::IsAreaComplete(player_name, map_id, check, info);
+        });
     }
-    std::ranges::sort(out, [](CharacterCompletion* a, CharacterCompletion* b) {
-        return a->name_str.compare(b->name_str) < 0;
-    });
-    return out;
+    auto without = GetEligibleCharacters(*index);
+    without.and_not(GetCharactersWithAreaComplete(*index, map_id, check, info));
+    return GetIndexedCharacters(*index, without);
 }
 
 std::vector<CharacterCompletion*> CompletionWindow::GetCharactersWithoutAreaUnlocked(MapID map_id)
 {
-    std::vector<CharacterCompletion*> out;
-    const auto email = GW::AccountMgr::GetAccountEmail();
-    for (auto& it : character_completion) {
-        if (it.second->is_pvp || it.second->is_pre_searing)
-            continue;
-        if (only_show_account_chars && it.second->account != email)
-            continue;
-        if (!IsAreaUnlocked(it.first.c_str(), map_id))
-            out.push_back(it.second);
+    const auto index = GetCompletionIndex();
+    if (!index) {
+        return GetCharactersWithout([map_id](const wchar_t* player_name) {
+            return IsAreaUnlocked(player_name, map_id);
+        });
     }
-    std::ranges::sort(out, [](CharacterCompletion* a, CharacterCompletion* b) {
-        return a->name_str.compare(b->name_str) < 0;
-    });
-    return out;
+    auto without = GetEligibleCharacters(*index);
+    if (GW::Map::GetMapInfo(map_id)) {
+        without.and_not(GetColumn(index->maps_unlocked, std::to_underlying(map_id)));
+    }
+    return GetIndexedCharacters(*index, without);
 }
 
 std::vector<CharacterCompletion*> CompletionWindow::GetCharactersWithoutSkillUnlocked(SkillID skill_id)
 {
-    std::vector<CharacterCompletion*> out;
-    const auto email = GW::AccountMgr::GetAccountEmail();
-    for (auto& it : character_completion) {
-        if (it.second->is_pvp || it.second->is_pre_searing)
-            continue;
-        if (only_show_account_chars && it.second->account != email)
-            continue;
-        if (!IsSkillUnlocked(it.first.c_str(), skill_id))
-            out.push_back(it.second);
+    const auto index = GetCompletionIndex();
+    if (!index) {
+        return GetCharactersWithout([skill_id](const wchar_t* player_name) {
+            return IsSkillUnlocked(player_name, skill_id);
+        });
     }
-    std::ranges::sort(out, [](CharacterCompletion* a, CharacterCompletion* b) {
-        return a->name_str.compare(b->name_str) < 0;
-    });
-    return out;
+    auto without = GetEligibleCharacters(*index);
+    without.and_not(GetColumn(index->skills, std::to_underlying(skill_id)));
+    return GetIndexedCharacters(*index, without);
 }
 
 
@@ -3116,8 +3376,8 @@ void MinipetAchievement::CheckProgress(const std::wstring& player_name)
     if (!cc.contains(player_name)) {
         return;
     }
-    const std::vector<uint32_t>& minipets_unlocked = cc.at(player_name)->minipets_unlocked;
-    is_completed = bonus = ArrayBoolAt(minipets_unlocked, encoded_name_index);
+    const UnlockBits& minipets_unlocked = cc.at(player_name)->minipets_unlocked;
+    is_completed = bonus = minipets_unlocked.test(encoded_name_index);
 }
 
 void WeaponAchievement::CheckProgress(const std::wstring& player_name)
@@ -3196,8 +3456,8 @@ void FestivalHat::CheckProgress(const std::wstring& player_name)
     if (!cc.contains(player_name)) {
         return;
     }
-    const std::vector<uint32_t>& unlocked = cc.at(player_name)->festival_hats;
-    is_completed = bonus = ArrayBoolAt(unlocked, encoded_name_index);
+    const UnlockBits& unlocked = cc.at(player_name)->festival_hats;
+    is_completed = bonus = unlocked.test(encoded_name_index);
 }
 
 size_t UnlockedPvPItemUpgrade::GetLoadedIcons(IDirect3DTexture9* icons_out[4])
@@ -3205,8 +3465,7 @@ size_t UnlockedPvPItemUpgrade::GetLoadedIcons(IDirect3DTexture9* icons_out[4])
     if (!icons_loaded) {
         const auto info = GW::Items::GetPvPItemUpgrade(encoded_name_index);
         if (info) {
-            const auto found = std::ranges::find_if(item_upgrades_by_file_id, [file_id = info->file_id](auto& check) { return check.file_id == file_id; });
-            if (found != item_upgrades_by_file_id.end()) {
+            if (const auto found = item_upgrades_by_file_id.find(info->file_id)) {
                 *icons = Resources::GetGuildWarsWikiImage(found->wiki_filename);
             }
         }
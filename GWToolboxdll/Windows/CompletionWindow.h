@@ -5,6 +5,7 @@
 #include <Modules/HallOfMonumentsModule.h>
 #include <ToolboxWindow.h>
 #include <Color.h>
+#include <Utils/FixedBitset.h>
 #include <Utils/GuiUtils.h>
 
 namespace Missions {
@@ -218,24 +219,32 @@ enum CompletionCheck : uint32_t {
     Both
 };
 
+// One bit per skill, map, minipet or festival hat, in the same word layout as the game's own unlock arrays
+using SkillBits = FixedBitset<4096>;
+using MapBits = FixedBitset<1024>;
+using UnlockBits = FixedBitset<256>;
+static_assert(SkillBits::bit_count >= static_cast<size_t>(GW::Constants::SkillID::Count));
+static_assert(MapBits::bit_count >= static_cast<size_t>(GW::Constants::MapID::Count));
+
 struct CharacterCompletion {
     GW::Constants::Profession profession = static_cast<GW::Constants::Profession>(0);
     bool is_pvp = false;
     bool is_pre_searing = false;
     std::wstring account;
     std::string name_str;
-    std::vector<uint32_t> skills{};
-    std::vector<uint32_t> mission{};
-    std::vector<uint32_t> mission_bonus{};
-    std::vector<uint32_t> mission_hm{};
-    std::vector<uint32_t> mission_bonus_hm{};
-    std::vector<uint32_t> vanquishes{};
+    SkillBits skills{};
+    MapBits mission{};
+    MapBits mission_bonus{};
+    MapBits mission_hm{};
+    MapBits mission_bonus_hm{};
+    MapBits vanquishes{};
+    // Hero ids, not bits
     std::vector<uint32_t> heroes{};
-    std::vector<uint32_t> maps_unlocked{};
+    MapBits maps_unlocked{};
     std::string hom_code;
     HallOfMonumentsAchievements hom_achievements;
-    std::vector<uint32_t> minipets_unlocked{};
-    std::vector<uint32_t> festival_hats{};
+    UnlockBits minipets_unlocked{};
+    UnlockBits festival_hats{};
 };
 
 // class used to keep a list of hotkeys, capture keyboard event and fire hotkeys as needed
@@ -25,6 +25,7 @@
 #include <Modules/Resources.h>
 #include <Windows/FriendListWindow.h>
 
+#include <Utils/BinarySnapshot.h>
 #include <Utils/ToolboxUtils.h>
 
 
@@ -94,8 +95,10 @@ namespace {
     }
 
 
-    ToolboxIni inifile{};
     const wchar_t* ini_filename = L"friends.ini";
+    const wchar_t* snapshot_filename = L"friends.bin";
+    constexpr uint32_t FRIENDS_SNAPSHOT_MAGIC = 0x52464254; // "TBFR"
+    constexpr uint32_t FRIENDS_SNAPSHOT_VERSION = 1;
     bool loading = false;     // Loading from disk?
     bool polling = false;     // Polling in progress?
     bool poll_queued = false; // Used to avoid overloading the thread queue.
@@ -144,7 +147,7 @@ namespace {
 
     GW::HookEntry FriendStatusUpdate_Entry;
 
-    void LoadCharnames(const char* section, std::unordered_map<std::wstring, uint8_t>* out)
+    void LoadCharnames(const ToolboxIni& inifile, const char* section, std::unordered_map<std::wstring, uint8_t>* out)
     {
         CSimpleIni::TNamesDepend values{};
         inifile.GetAllValues(section, "charname", values);
@@ -169,6 +172,114 @@ namespace {
     }
 
 
+    // A friend as it's kept on disk
+    struct StoredFriend {
+        std::string uuid;
+        std::wstring alias;
+        uint32_t type = 0;
+        std::unordered_map<std::wstring, uint8_t> charnames;
+    };
+
+    // Older builds kept friends in friends.ini; still read it if there's no snapshot yet.
+    std::vector<StoredFriend> ImportFriendsIni()
+    {
+        ToolboxIni inifile(false, true, false);
+        inifile.LoadFile(Resources::GetSettingFile(ini_filename).c_str());
+
+        std::vector<StoredFriend> stored;
+        ToolboxIni::TNamesDepend entries;
+        inifile.GetAllSections(entries);
+        for (const ToolboxIni::Entry& entry : entries) {
+            auto& f = stored.emplace_back();
+            f.uuid = entry.pItem;
+            f.alias = TextUtils::StringToWString(inifile.GetValue(entry.pItem, "alias", ""));
+            f.type = static_cast<uint32_t>(inifile.GetLongValue(entry.pItem, "type", static_cast<long>(GW::FriendType::Unknow)));
+            LoadCharnames(inifile, entry.pItem, &f.charnames);
+        }
+        return stored;
+    }
+
+    void ExportFriendsIni(const std::vector<StoredFriend>& stored)
+    {
+        ToolboxIni export_ini(false, true, false);
+        for (const auto& f : stored) {
+            const char* uuid = f.uuid.c_str();
+            export_ini.SetLongValue(uuid, "type", static_cast<long>(f.type), nullptr, false, true);
+            export_ini.SetValue(uuid, "alias", TextUtils::WStringToString(f.alias).c_str(), nullptr, true);
+            for (const auto& [charname, profession] : f.charnames) {
+                char charname_value[128] = {0};
+                snprintf(charname_value, 128, "%s,%d", TextUtils::WStringToString(charname).c_str(), profession);
+                export_ini.SetValue(uuid, "charname", charname_value);
+            }
+        }
+        const auto path = Resources::GetSettingFile(ini_filename);
+        if (Resources::SaveIniToFile(path, &export_ini) == 0) {
+            Log::Info("Friends exported to %s", path.string().c_str());
+        }
+        else {
+            Log::Error("Failed to export friends to %s", path.string().c_str());
+        }
+    }
+
+    bool LoadFriendsSnapshot(std::vector<StoredFriend>& stored)
+    {
+        std::vector<uint8_t> payload;
+        if (!BinarySnapshot::Load(Resources::GetSettingFile(snapshot_filename), FRIENDS_SNAPSHOT_MAGIC, FRIENDS_SNAPSHOT_VERSION, payload)) {
+            return false;
+        }
+        BinarySnapshot::Reader reader(payload);
+        uint32_t count = 0;
+        reader.Read(count);
+        stored.clear();
+        for (uint32_t i = 0; i < count && reader.Ok(); i++) {
+            auto& f = stored.emplace_back();
+            reader.ReadString(f.uuid);
+            reader.ReadString(f.alias);
+            reader.Read(f.type);
+            uint32_t charname_count = 0;
+            reader.Read(charname_count);
+            for (uint32_t j = 0; j < charname_count && reader.Ok(); j++) {
+                std::wstring charname;
+                uint8_t profession = 0;
+                reader.ReadString(charname);
+                reader.Read(profession);
+                f.charnames.emplace(std::move(charname), profession);
+            }
+        }
+        if (!reader.Ok()) {
+            stored.clear();
+            return false;
+        }
+        return true;
+    }
+
+    bool SaveFriendsSnapshot(const std::vector<StoredFriend>& stored)
+    {
+        BinarySnapshot::Writer writer;
+        writer.Write(static_cast<uint32_t>(stored.size()));
+        for (const auto& f : stored) {
+            writer.WriteString(f.uuid);
+            writer.WriteString(f.alias);
+            writer.Write(f.type);
+            writer.Write(static_cast<uint32_t>(f.charnames.size()));
+            for (const auto& [charname, profession] : f.charnames) {
+                writer.WriteString(charname);
+                writer.Write(profession);
+            }
+        }
+        return BinarySnapshot::Save(Resources::GetSettingFile(snapshot_filename), FRIENDS_SNAPSHOT_MAGIC, FRIENDS_SNAPSHOT_VERSION, writer.Data());
+    }
+
+    // Whatever is on disk, from the snapshot or failing that the old ini
+    std::vector<StoredFriend> LoadStoredFriends()
+    {
+        std::vector<StoredFriend> stored;
+        if (!LoadFriendsSnapshot(stored)) {
+            stored = ImportFriendsIni();
+        }
+        return stored;
+    }
+
     FriendListWindow::Friend* SetFriend(const uint8_t*, GW::FriendType, GW::FriendStatus, uint32_t, const wchar_t*, const wchar_t*);
     FriendListWindow::Friend* SetFriend(const GW::Friend*);
 
@@ -725,7 +836,8 @@ void FriendListWindow::Friend::StartWhisper() const
 // Get the character belonging to this friend (e.g. to find profession etc)
 FriendListWindow::Character* FriendListWindow::Friend::GetCharacter(const wchar_t* char_name)
 {
-    const auto it = characters.find(char_name);
+    // Names that were never interned can't be anyone's character
+    const auto it = characters.find(StringPool::Find(char_name));
     if (it == characters.end()) {
         return nullptr; // Not found
     }
@@ -739,8 +851,7 @@ FriendListWindow::Character* FriendListWindow::Friend::SetCharacter(const wchar_
     if (!existing) {
         Character c;
         c.SetName(char_name);
-        characters.emplace(c.getNameW(), c);
-        existing = GetCharacter(c.getNameW().c_str());
+        existing = &characters.emplace(c.GetNameHandle(), c).first->second;
         cached_charnames_hover = false;
     }
     if (profession && profession != existing->profession) {
@@ -784,7 +895,7 @@ std::string FriendListWindow::Friend::GetCharactersHover(const bool include_char
                  characters.begin();
              it2 != characters.end(); ++it2) {
             cached_charnames_hover_ws += L"\n  ";
-            cached_charnames_hover_ws += it2->first;
+            cached_charnames_hover_ws += it2->second.getNameW();
             if (it2->second.profession) {
                 cached_charnames_hover_ws += L" (";
                 cached_charnames_hover_ws += ProfNames[it2->second.profession];
@@ -843,8 +954,8 @@ bool FriendListWindow::RemoveFriend(const Friend* f)
         return false;
     }
     friends.erase(f->uuid);
-    for (const auto& char_key : f->characters | std::views::keys) {
-        uuid_by_name.erase(char_key);
+    for (const auto& character : f->characters | std::views::values) {
+        uuid_by_name.erase(character.getNameW());
     }
     uuid_by_name.erase(f->GetAliasW());
     delete f;
@@ -1266,6 +1377,12 @@ void FriendListWindow::DrawSettingsInternal()
         Colors::DrawSettingHueWheel("Friend name tag color", &friend_name_tag_color);
     }
     DrawChatSettings();
+    if (ImGui::Button("Export to ini")) {
+        Resources::EnqueueWorkerTask([] {
+            ExportFriendsIni(LoadStoredFriends());
+        });
+    }
+    ImGui::ShowHelp("Friends are saved in a binary file; this writes a copy to friends.ini,\nwhich older versions of Toolbox can read.");
 }
 
 void FriendListWindow::RegisterSettingsContent()
@@ -1354,7 +1471,7 @@ void FriendListWindow::LoadFromFile()
         return;
     }
     loading = true;
-    Log::Log("%s: Loading friends from ini\n", Name());
+    Log::Log("%s: Loading friends\n", Name());
     if (settings_thread.joinable()) {
         settings_thread.join();
     }
@@ -1366,27 +1483,20 @@ void FriendListWindow::LoadFromFile()
         }
         friends.clear();
 
-        inifile.Reset();
-        inifile.SetMultiKey(true);
-        inifile.LoadFile(Resources::GetSettingFile(ini_filename).c_str());
-
-        ToolboxIni::TNamesDepend entries;
-        inifile.GetAllSections(entries);
-        for (const ToolboxIni::Entry& entry : entries) {
+        const auto load_started = TIMER_INIT();
+        for (const auto& stored : LoadStoredFriends()) {
             auto lf = new Friend(this);
-            lf->uuid = entry.pItem;
+            lf->uuid = stored.uuid;
             lf->uuid_bytes = StringToGuid(lf->uuid);
-            lf->setAlias(TextUtils::StringToWString(inifile.GetValue(entry.pItem, "alias", "")));
-            lf->type = static_cast<GW::FriendType>(inifile.GetLongValue(entry.pItem, "type", static_cast<long>(lf->type)));
+            lf->setAlias(stored.alias);
+            lf->type = static_cast<GW::FriendType>(stored.type);
             if (lf->uuid.empty() || lf->GetAliasW().empty()) {
                 delete lf;
                 continue; // Error, alias or uuid empty.
             }
 
             // Grab char names
-            std::unordered_map<std::wstring, uint8_t> charnames;
-            LoadCharnames(entry.pItem, &charnames);
-            for (const auto& it : charnames) {
+            for (const auto& it : stored.charnames) {
                 lf->SetCharacter(it.first.c_str(), it.second);
             }
             if (lf->characters.empty()) {
@@ -1395,11 +1505,11 @@ void FriendListWindow::LoadFromFile()
             }
             friends.emplace(lf->uuid, lf);
             for (const auto& it : lf->characters) {
-                uuid_by_name[it.first] = lf;
+                uuid_by_name[it.second.getNameW()] = lf;
             }
             uuid_by_name[lf->GetAliasW()] = lf;
         }
-        Log::Log("%s: Loaded friends from ini\n", Name());
+        Log::Log("%s: Loaded %zu friends in %d ms\n", Name(), friends.size(), TIMER_DIFF(load_started));
         friends_list_checked = false;
         loading = false;
     });
@@ -1415,39 +1525,47 @@ void FriendListWindow::SaveToFile()
     }
     settings_thread = std::thread([this] {
         friends_changed = false;
-        inifile.Reset();
-        // Load the existing file in, and amend the info
-        inifile.LoadFile(Resources::GetSettingFile(ini_filename).c_str());
-        inifile.SetMultiKey(true);
         if (friends.empty()) {
             return; // Error, should have at least 1 friend
         }
+        // Load the existing file in, and amend the info. This allows multiple accounts to contribute to the friend list.
+        auto stored = LoadStoredFriends();
+        std::unordered_map<std::string, size_t> stored_by_uuid;
+        for (size_t i = 0; i < stored.size(); i++) {
+            stored_by_uuid.emplace(stored[i].uuid, i);
+        }
         //std::lock_guard<std::recursive_mutex> lock(friends_mutex);
         for (auto it = friends.begin(); it != friends.end(); ++it) {
-            // do something
             Friend& lf = *it->second;
-            const char* uuid = lf.uuid.c_str();
-            inifile.SetLongValue(uuid, "type", static_cast<long>(lf.type), nullptr, false, true);
-            inifile.SetValue(uuid, "alias", lf.GetAliasA().c_str(), nullptr, true);
-            // Append to existing charnames, but don't duplicate. This allows multiple accounts to contribute to the friend list.
-            std::unordered_map<std::wstring, uint8_t> charnames;
-            LoadCharnames(uuid, &charnames);
+            const auto found = stored_by_uuid.find(lf.uuid);
+            StoredFriend* sf = nullptr;
+            if (found != stored_by_uuid.end()) {
+                sf = &stored[found->second];
+            }
+            else {
+                sf = &stored.emplace_back();
+                sf->uuid = lf.uuid;
+                stored_by_uuid.emplace(lf.uuid, stored.size() - 1);
+            }
+            sf->type = static_cast<uint32_t>(lf.type);
+            sf->alias = lf.GetAliasW();
+            // Append to existing charnames, but don't duplicate.
             for (const auto& char_it : lf.characters) {
-                const auto& found = charnames.find(char_it.first);
-                // Note: Don't overwrite the profession
-                if (found == charnames.end() || char_it.second.profession != 0) {
-                    charnames.emplace(char_it.first, char_it.second.profession);
+                const auto& found_char = sf->charnames.find(char_it.second.getNameW());
+                // Note: Don't overwrite the profession with an unknown one
+                if (found_char == sf->charnames.end()) {
+                    sf->charnames.emplace(char_it.second.getNameW(), char_it.second.profession);
+                }
+                else if (char_it.second.profession != 0) {
+                    found_char->second = char_it.second.profession;
                 }
             }
-            inifile.DeleteValue(uuid, "charname", nullptr);
-            for (const auto& char_it : charnames) {
-                char charname[128] = {0};
-                snprintf(charname, 128, "%s,%d",
-                         TextUtils::WStringToString(char_it.first).c_str(),
-                         char_it.second);
-                inifile.SetValue(uuid, "charname", charname);
-            }
         }
-        ASSERT(inifile.SaveFile(Resources::GetSettingFile(ini_filename).c_str()) == SI_OK);
+        const auto save_started = TIMER_INIT();
+        if (!SaveFriendsSnapshot(stored)) {
+            Log::Error("Failed to save friend list");
+            return;
+        }
+        Log::Log("%s: Saved %zu friends in %d ms\n", Name(), stored.size(), TIMER_DIFF(save_started));
     });
 }
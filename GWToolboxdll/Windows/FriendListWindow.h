@@ -6,6 +6,7 @@
 #include <Utils/GuiUtils.h>
 #include <ToolboxWindow.h>
 #include <Utils/TextUtils.h>
+#include <Utils/StringPool.h>
 
 class FriendListWindow final : public ToolboxWindow {
 public:
@@ -18,32 +19,29 @@ public:
     // Structs because we don't case about public or private; this whole struct is private to this module anyway.
     struct Character {
     private:
-        std::wstring name;
-        std::string name_str;
+        StringPool::Handle name = StringPool::empty;
 
     public:
         uint8_t profession = 0;
 
-        const std::string& GetNameA()
+        [[nodiscard]] const std::string& GetNameA() const
         {
-            if (name_str.empty() && !name.empty()) {
-                name_str = TextUtils::WStringToString(name);
-            }
-            return name_str;
+            return StringPool::Get(name);
         }
 
         [[nodiscard]] const std::wstring& getNameW() const
+        {
+            return StringPool::GetW(name);
+        }
+
+        [[nodiscard]] StringPool::Handle GetNameHandle() const
         {
             return name;
         }
 
-        void SetName(std::wstring _name)
+        void SetName(const std::wstring_view _name)
         {
-            if (name == _name) {
-                return;
-            }
-            name = std::move(_name);
-            name_str.clear();
+            name = StringPool::Intern(_name);
         }
     };
 
@@ -76,7 +74,8 @@ public:
         Character* current_char = nullptr;
         GuiUtils::EncString* current_map_name = nullptr;
         uint32_t current_map_id = 0;
-        std::unordered_map<std::wstring, Character> characters{};
+        // Keyed by interned character name
+        std::unordered_map<StringPool::Handle, Character> characters{};
         GW::FriendStatus status = GW::FriendStatus::Offline;
         GW::FriendType type = GW::FriendType::Unknow;
         clock_t last_update = 0;
@@ -30,6 +30,7 @@
 #include <Windows/HeroBuildsWindow.h>
 #include <Windows/Hotkeys.h>
 #include <Windows/PconsWindow.h>
+#include <Utils/AgentIndex.h>
 #include <Utils/TextUtils.h>
 #include "HotkeysWindow.h"
 
@@ -636,23 +637,16 @@ bool TBHotkey::IsInRangeOfNPC() const
     if (!(in_range_of_npc_id && in_range_of_distance > 0.f)) {
         return true;
     }
-    const auto agents = GW::Agents::GetAgentArray();
-    const auto me = agents ? GW::Agents::GetControlledCharacter() : nullptr;
+    const auto me = GW::Agents::GetControlledCharacter();
     if (!me)
         return false;
-    for (const auto agent : *agents) {
-        if (!(agent && agent->type == 0xDB)) {
-            continue;
-        }
-        const auto* living = agent->GetAsAgentLiving();
-        if (living->login_number || living->player_number != static_cast<uint16_t>(in_range_of_npc_id)) {
-            continue;
-        }
-        if (GetDistance(agent->pos, me->pos) < in_range_of_distance) {
-            return true;
-        }
-    }
-    return false;
+    AgentIndex::Filter filter;
+    filter.type = AgentIndex::Filter::Type::Living;
+    filter.model_id = static_cast<uint16_t>(in_range_of_npc_id);
+    filter.predicate = [](const GW::Agent& agent) {
+        return agent.type == 0xDB && !agent.GetAsAgentLiving()->login_number;
+    };
+    return AgentIndex::AnyInRadius(me->pos, in_range_of_distance, filter);
 }
 
 HotkeySendChat::HotkeySendChat(const ToolboxIni* ini, const char* section)
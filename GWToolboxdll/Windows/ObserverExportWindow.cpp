@@ -190,7 +190,7 @@ nlohmann::json ObserverExportWindow::ToJSON_V_1_0()
         }
         json["guilds"]["by_id"][guild_id_s]["guild_id"] = guild->guild_id;
         json["guilds"]["by_id"][guild_id_s]["key"] = guild->key.k;
-        json["guilds"]["by_id"][guild_id_s]["name"] = guild->name;
+        json["guilds"]["by_id"][guild_id_s]["name"] = StringPool::Get(guild->name);
         json["guilds"]["by_id"][guild_id_s]["tag"] = guild->tag;
         json["guilds"]["by_id"][guild_id_s]["wrapped_tag"] = guild->wrapped_tag;
         json["guilds"]["by_id"][guild_id_s]["rank"] = guild->rank;
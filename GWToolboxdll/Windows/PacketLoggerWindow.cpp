@@ -24,6 +24,9 @@
 #include <GWToolbox.h>
 #include <Utils/TextUtils.h>
 #include <Utils/ToolboxUtils.h>
+#include <Utils/PacketCapture.h>
+#include <Timer.h>
+
 namespace {
     wchar_t* GetMessageCore()
     {
@@ -116,24 +119,6 @@ namespace {
 
     using StoCHandlerArray = GW::Array<StoCHandler>;
 
-    enum class FieldType {
-        Ignore,
-        AgentId,
-        Float,
-        Vect2,
-        Vect3,
-        Byte,
-        Word,
-        Dword,
-        Blob,
-        String16,
-        Array8,
-        Array16,
-        Array32,
-        NestedStruct,
-        Count
-    };
-
     bool log_message_content = false;
     bool log_npc_dialogs = false;
 
@@ -253,277 +238,245 @@ namespace {
     }
 
 
-    FieldType GetField(const uint32_t type, const uint32_t size, const uint32_t count)
+    // Binary capture; see Utils/PacketCapture.h
+    bool capture_to_file = false;
+    int capture_file_mb = 64;
+    // The writer maps the whole file and the viewer reads it all into memory, in a 32 bit process
+    constexpr int max_capture_file_mb = 256;
+    int capture_max_files = 4;
+    PacketCapture::Writer capture_writer;
+    PacketCapture::Schema capture_schema;
+    // Oldest first, including those left from earlier sessions, so the rolling limit counts them too
+    std::deque<std::filesystem::path> capture_files;
+    std::filesystem::path capture_files_folder;
+    clock_t capture_file_started = 0;
+    bool capture_failed = false;
+
+    void FindCaptureFiles(const std::filesystem::path& folder)
     {
-        switch (type) {
-        case 0:
-            return FieldType::AgentId;
-        case 1:
-            return FieldType::Float;
-        case 2:
-            return FieldType::Vect2;
-        case 3:
-            return FieldType::Vect3;
-        case 4:
-        case 8:
-            switch (count) {
-            case 1:
-                return FieldType::Byte;
-            case 2:
-                return FieldType::Word;
-            case 4:
-                return FieldType::Dword;
-            }
-        case 5:
-        case 9:
-            return FieldType::Blob;
-        case 6:
-        case 10:
-            return FieldType::Ignore;
-        case 7:
-            return FieldType::String16;
-        case 11:
-            switch (size) {
-            case 1:
-                return FieldType::Array8;
-            case 2:
-                return FieldType::Array32;
-            case 4:
-                return FieldType::Array32;
+        capture_files_folder = folder;
+        capture_files.clear();
+        std::vector<std::filesystem::path> found;
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(folder, ec)) {
+            if (entry.is_regular_file(ec) && entry.path().extension() == L".gwcap") {
+                found.push_back(entry.path());
             }
-        case 12:
-            return FieldType::NestedStruct;
         }
-
-        return FieldType::Count;
+        // Named by the time they were started
+        std::ranges::sort(found);
+        capture_files.assign(found.begin(), found.end());
     }
 
-    void PrintIndent(const uint32_t indent)
+    bool OpenNextCaptureFile()
     {
-        char buffer[64];
-        ASSERT(indent <= sizeof(buffer) - 1);
-        for (auto i = 0u; i < indent; i++) {
-            buffer[i] = ' ';
+        capture_writer.Close();
+        if (capture_failed) {
+            return false;
+        }
+        if (capture_schema.size() != game_server_handler.size()) {
+            // Every file carries the game's field layouts so it can be decoded without the game
+            capture_schema.Clear();
+            for (uint32_t i = 0; i < game_server_handler.size(); i++) {
+                const auto& handler = game_server_handler[i];
+                capture_schema.Add(i, {handler.fields, handler.field_count});
+            }
         }
-        buffer[indent] = 0;
-        printf("%s", buffer);
-    }
-
-    void GetHexS(char* buf, const uint8_t byte)
-    {
-        const uint8_t h = byte >> 4 & 0xfu;
-        const uint8_t l = byte >> 0 & 0xfu;
-        if (h < 10) {
-            buf[0] = h + '0';
+        const auto folder = Resources::GetPath(L"packet_captures");
+        SYSTEMTIME time;
+        GetLocalTime(&time);
+        wchar_t filename[64];
+        swprintf(filename, _countof(filename), L"capture-%04d%02d%02d-%02d%02d%02d-%03d.gwcap",
+                 time.wYear, time.wMonth, time.wDay, time.wHour, time.wMinute, time.wSecond, time.wMilliseconds);
+        const auto path = folder / filename;
+        if (capture_files_folder != folder) {
+            FindCaptureFiles(folder);
         }
-        else {
-            buf[0] = h - 10 + 'A';
+        if (!Resources::EnsureFolderExists(folder) || !capture_writer.Open(path.c_str(), capture_schema, static_cast<size_t>(capture_file_mb) * 1024 * 1024)) {
+            Log::Error("Failed to open packet capture file %ls", path.c_str());
+            capture_failed = true;
+            return false;
         }
-        if (l < 10) {
-            buf[1] = l + '0';
+        capture_file_started = TIMER_INIT();
+        capture_files.push_back(path);
+        while (capture_files.size() > static_cast<size_t>(capture_max_files)) {
+            DeleteFileW(capture_files.front().c_str());
+            capture_files.pop_front();
         }
-        else {
-            buf[1] = l - 10 + 'A';
-        }
-        buf[2] = 0;
+        return true;
     }
 
-    template <typename T>
-    void Serialize(uint8_t** bytes, T* val)
+    void ClosePacketCapture()
     {
-        uint8_t* b = *bytes;
-        // if we want to allign
-        // b = (uint8_t*)(((uintptr_t)b + (sizeof(T) - 1)) & ~(sizeof(T) - 1));
-        memcpy(val, b, sizeof(T));
-        *bytes = b + sizeof(T);
+        capture_writer.Close();
+        capture_failed = false;
     }
 
-    void PrintString(const int length, const wchar_t* str)
+    // Called from the packet hook, so kept to sizing the packet and a copy
+    void CapturePacket(const PacketCapture::Direction direction, const uint32_t header, const std::span<const uint32_t> fields, const uint8_t* packet)
     {
-        for (auto i = 0; i < length && str[i]; i++) {
-            printf(i > 0 ? " %04x" : "%04x", str[i]);
+        if (!capture_writer.IsOpen() && !OpenNextCaptureFile()) {
+            return;
+        }
+        bool truncated = false;
+        const auto size = fields.empty() ? sizeof(uint32_t) : PacketCapture::MeasurePacket(fields, packet, &truncated);
+        PacketCapture::RecordHeader record{};
+        record.size = static_cast<uint32_t>(size);
+        record.time_ms = static_cast<uint32_t>(TIMER_DIFF(capture_file_started));
+        record.packet_header = static_cast<uint16_t>(header);
+        record.direction = direction;
+        record.flags = truncated ? PacketCapture::RecordFlag_Truncated : 0;
+        if (capture_writer.Append(record, packet)) {
+            return;
+        }
+        if (OpenNextCaptureFile()) {
+            record.time_ms = 0;
+            capture_writer.Append(record, packet);
         }
     }
 
-    void PrintField(const FieldType field, const uint32_t count, uint8_t** bytes, const uint32_t indent)
+    // Offline viewer; records are only formatted when selected. The reader is read only once loaded, so workers can index it.
+    struct CaptureViewer {
+        std::vector<uint8_t> bytes;
+        PacketCapture::Reader reader;
+        std::vector<size_t> index;
+        size_t selected = static_cast<size_t>(-1);
+        std::string selected_text;
+    };
+
+    std::shared_ptr<CaptureViewer> capture_viewer;
+    bool capture_viewer_loading = false;
+    // Bumped for every index built, so only the latest one is shown
+    uint32_t capture_viewer_index_generation = 0;
+    char capture_viewer_path[MAX_PATH] = "";
+    char capture_viewer_headers[128] = "";
+    PacketCapture::Filter capture_viewer_filter;
+
+    // Indexes the loaded capture against the current filter on a worker; the old index stays up until it's done
+    void ReindexCaptureViewer()
     {
-        switch (field) {
-        case FieldType::AgentId: {
-            PrintIndent(indent);
-            uint32_t agent_id;
-            Serialize<uint32_t>(bytes, &agent_id);
-            printf("AgentId(%u)\n", agent_id);
-            break;
-        }
-        case FieldType::Float: {
-            PrintIndent(indent);
-            float f;
-            Serialize<float>(bytes, &f);
-            printf("Float(%f)\n", f);
-            break;
-        }
-        case FieldType::Vect2: {
-            PrintIndent(indent);
-            float x, y;
-            Serialize<float>(bytes, &x);
-            Serialize<float>(bytes, &y);
-            printf("Vect2(%f, %f)\n", x, y);
-            break;
-        }
-        case FieldType::Vect3: {
-            PrintIndent(indent);
-            float x, y, z;
-            Serialize<float>(bytes, &x);
-            Serialize<float>(bytes, &y);
-            Serialize<float>(bytes, &z);
-            printf("Vect3(%f, %f, %f)\n", x, y, z);
-            break;
-        }
-        case FieldType::Byte: {
-            PrintIndent(indent);
-            uint32_t val;
-            Serialize<uint32_t>(bytes, &val);
-            printf("Byte(%u)\n", val);
-            break;
-        }
-        case FieldType::Word: {
-            PrintIndent(indent);
-            uint32_t val;
-            Serialize<uint32_t>(bytes, &val);
-            printf("Word(%u)\n", val);
-            break;
+        const auto generation = ++capture_viewer_index_generation;
+        const auto viewer = capture_viewer;
+        if (!viewer) {
+            return;
         }
-        case FieldType::Dword: {
-            PrintIndent(indent);
-            uint32_t val;
-            Serialize<uint32_t>(bytes, &val);
-            printf("Dword(%u)\n", val);
-            break;
+        Resources::EnqueueWorkerTask([viewer, filter = capture_viewer_filter, generation] {
+            auto index = viewer->reader.Index(filter);
+            Resources::EnqueueMainTask([viewer, index = std::move(index), generation]() mutable {
+                if (generation != capture_viewer_index_generation || viewer != capture_viewer) {
+                    return;
+                }
+                viewer->index = std::move(index);
+                viewer->selected = static_cast<size_t>(-1);
+                viewer->selected_text.clear();
+            });
+        });
+    }
+
+    void LoadCaptureFile(const std::filesystem::path& path)
+    {
+        if (capture_viewer_loading) {
+            return;
         }
-        case FieldType::Blob: {
-            PrintIndent(indent);
-            printf("Blob(%u) => ", count);
-            for (auto i = 0u; i < count; i++) {
-                char buf[3];
-                GetHexS(buf, **bytes);
-                printf("%s ", buf);
-                ++*bytes;
+        capture_viewer_loading = true;
+        const auto generation = ++capture_viewer_index_generation;
+        Resources::EnqueueWorkerTask([path, filter = capture_viewer_filter, generation] {
+            auto viewer = std::make_shared<CaptureViewer>();
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            if (file.is_open()) {
+                viewer->bytes.resize(static_cast<size_t>(file.tellg()));
+                file.seekg(0);
+                file.read(reinterpret_cast<char*>(viewer->bytes.data()), static_cast<std::streamsize>(viewer->bytes.size()));
             }
-            printf("\n");
-            break;
-        }
-        case FieldType::String16: {
-            PrintIndent(indent);
-            const auto str = reinterpret_cast<wchar_t*>(*bytes);
-            const size_t length = wcsnlen(str, count);
-            printf("String(%zu) \"", length);
-            PrintString(length, str);
-            printf("\"\n");
-            *bytes += count * 2;
-            break;
-        }
-        case FieldType::Array8: {
-            PrintIndent(indent);
-            uint32_t length;
-            uint8_t* end = *bytes + count;
-            Serialize<uint32_t>(bytes, &length);
-            printf("Array8(%u) {\n", length);
-            uint8_t val;
-            for (size_t i = 0; i < length; i++) {
-                Serialize<uint8_t>(bytes, &val);
-                PrintIndent(indent + 4);
-                printf("[%zu] => %u,\n", i, val);
+            if (!file.good() || !viewer->reader.Open(viewer->bytes)) {
+                viewer = nullptr;
             }
-            printf("}\n");
-            *bytes = end;
-            break;
-        }
-        case FieldType::Array16: {
-            PrintIndent(indent);
-            uint32_t length = count;
-            Serialize<uint32_t>(bytes, &length);
-            uint8_t* end = *bytes + count * 2;
-            printf("Array16(%u of %u) {\n", length, count);
-            if (length < 64) {
-                uint16_t val;
-                for (size_t i = 0; i < length; i++) {
-                    Serialize<uint16_t>(bytes, &val);
-                    PrintIndent(indent + 4);
-                    printf("[%zu] => %u,\n", i, val);
-                }
+            else {
+                viewer->index = viewer->reader.Index(filter);
             }
-            printf("}\n");
-            *bytes = end;
-            break;
-        }
-        case FieldType::Array32: {
-            PrintIndent(indent);
-            uint32_t length = count;
-            Serialize<uint32_t>(bytes, &length);
-            uint8_t* end = *bytes + count * 4;
-            printf("Array32(%u of %u) {\n", length, count);
-            if (length < 128) {
-                uint32_t val;
-                for (size_t i = 0; i < length; i++) {
-                    Serialize<uint32_t>(bytes, &val);
-                    PrintIndent(indent + 4);
-                    printf("[%zu] => %u,\n", i, val);
+            Resources::EnqueueMainTask([viewer, path, generation] {
+                capture_viewer_loading = false;
+                if (!viewer) {
+                    Log::Error("Failed to read packet capture %ls", path.c_str());
+                    return;
                 }
-            }
-            printf("}\n");
-            *bytes = end;
-            break;
+                capture_viewer = viewer;
+                if (generation != capture_viewer_index_generation) {
+                    ReindexCaptureViewer(); // Filter changed while loading
+                }
+            });
+        });
+    }
+
+    void SelectCaptureRecord(CaptureViewer& viewer, const size_t row)
+    {
+        viewer.selected = row;
+        viewer.selected_text.clear();
+        PacketCapture::Record record;
+        if (row >= viewer.index.size() || !viewer.reader.Read(viewer.index[row], record)) {
+            return;
         }
-        default:
-            break;
+        const auto fields = viewer.reader.GetSchema().GetFields(record.header.packet_header);
+        if (record.header.direction == PacketCapture::Direction::StoC && !fields.empty()) {
+            PacketCapture::FormatPacket(fields, record.data, viewer.selected_text);
         }
+        if (record.header.flags & PacketCapture::RecordFlag_Truncated) {
+            viewer.selected_text.append("(truncated)\n");
+        }
+        PacketCapture::FormatHex(record.data, viewer.selected_text);
     }
 
-    void PrintNestedField(uint32_t* fields, const uint32_t n_fields,
-        const uint32_t repeat, uint8_t** bytes, const uint32_t indent)
+    void DrawCaptureViewer()
     {
-        for (uint32_t rep = 0; rep < repeat; rep++) {
-            PrintIndent(indent);
-            printf("[%u] => {\n", rep);
-            for (auto i = 0u; i < n_fields; i++) {
-                const uint32_t field = fields[i];
-                const uint32_t type = field >> 0 & 0xF;
-                const uint32_t size = field >> 4 & 0xF;
-                const uint32_t count = field >> 8 & 0xFFFF;
-
-                // Just to make it easier to print
-                const FieldType field_type = GetField(type, size, count);
-
-                // Used to skip field that are not printable, for instance the array end
-                if (field_type == FieldType::Ignore) {
-                    continue;
-                }
-
-                if (field_type != FieldType::NestedStruct) {
-                    PrintField(field_type, count, bytes, indent + 4);
-                }
-                else {
-                    const uint32_t next_field_index = i + 1;
-
-                    uint32_t struct_count;
-                    Serialize<uint32_t>(bytes, &struct_count);
-
-                    PrintIndent(indent + 4);
-                    printf("NextedStruct(%u) {\n", struct_count);
-                    PrintNestedField(fields + next_field_index,
-                        n_fields - next_field_index, struct_count, bytes, indent + 8);
-                    PrintIndent(indent + 4);
-                    printf("}\n");
+        ImGui::InputText("Capture file", capture_viewer_path, sizeof(capture_viewer_path));
+        ImGui::SameLine();
+        if (ImGui::Button(capture_viewer_loading ? "Loading..." : "Load") && capture_viewer_path[0]) {
+            LoadCaptureFile(TextUtils::StringToWString(capture_viewer_path));
+        }
+        bool filter_changed = false;
+        if (ImGui::InputText("Packet headers", capture_viewer_headers, sizeof(capture_viewer_headers))) {
+            filter_changed = capture_viewer_filter.SetPacketHeaders(capture_viewer_headers);
+        }
+        ImGui::ShowHelp("e.g. 12, 30-35, 0x94\nLeave empty to show every packet");
+        filter_changed |= ImGui::Checkbox("StoC", &capture_viewer_filter.show_stoc);
+        ImGui::SameLine();
+        filter_changed |= ImGui::Checkbox("CtoS", &capture_viewer_filter.show_ctos);
 
-                    // This isn't necessary, but Guild Wars always have the nested struct at the end and once max
-                    break;
+        if (filter_changed) {
+            ReindexCaptureViewer();
+        }
+        if (!capture_viewer) {
+            return;
+        }
+        auto& viewer = *capture_viewer;
+        ImGui::Text("%zu packets shown", viewer.index.size());
+        const float height = ImGui::GetTextLineHeightWithSpacing() * 12;
+        if (ImGui::BeginChild("capture_records", ImVec2(0, height), true)) {
+            ImGuiListClipper clipper;
+            clipper.Begin(static_cast<int>(viewer.index.size()));
+            while (clipper.Step()) {
+                for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+                    PacketCapture::Record record;
+                    if (!viewer.reader.Read(viewer.index[static_cast<size_t>(row)], record)) {
+                        continue;
+                    }
+                    char label[96];
+                    snprintf(label, sizeof(label), "%10u ms  %s  %4u (0x%X)  %u bytes###capture_row_%d", record.header.time_ms,
+                             record.header.direction == PacketCapture::Direction::StoC ? "StoC" : "CtoS",
+                             record.header.packet_header, record.header.packet_header, record.header.size, row);
+                    if (ImGui::Selectable(label, viewer.selected == static_cast<size_t>(row))) {
+                        SelectCaptureRecord(viewer, static_cast<size_t>(row));
+                    }
                 }
             }
-            PrintIndent(indent);
-            printf("}\n");
+        }
+        ImGui::EndChild();
+        if (!viewer.selected_text.empty()) {
+            ImGui::TextUnformatted(viewer.selected_text.c_str());
         }
     }
 
+
 }
 
 
@@ -532,7 +485,13 @@ void PacketLoggerWindow::CtoSHandler(const GW::HookStatus*, void* packet) const
     if (!logger_enabled) {
         return;
     }
-    printf(PrefixTimestamp("CtoS packet(%u 0x%X) {\n").c_str(), *static_cast<uint32_t*>(packet), *static_cast<uint32_t*>(packet));
+    const auto header = *static_cast<uint32_t*>(packet);
+    if (capture_to_file) {
+        // No field layout for outgoing packets; the header is all that's recorded
+        CapturePacket(PacketCapture::Direction::CtoS, header, {}, static_cast<const uint8_t*>(packet));
+        return;
+    }
+    printf(PrefixTimestamp("CtoS packet(%u 0x%X) {\n").c_str(), header, header);
 }
 
 void PacketLoggerWindow::PacketHandler(GW::HookStatus* status, GW::Packet::StoC::PacketBase* packet) const
@@ -559,16 +518,18 @@ void PacketLoggerWindow::PacketHandler(GW::HookStatus* status, GW::Packet::StoC:
     }
 
     const StoCHandler handler = game_server_handler.at(packet->header);
-    auto packet_raw = reinterpret_cast<uint8_t*>(packet);
-
-    uint8_t** bytes = &packet_raw;
-    uint32_t header;
-    Serialize<uint32_t>(bytes, &header);
-    ASSERT(packet->header == header);
+    const auto fields = std::span<const uint32_t>(handler.fields, handler.field_count);
+    const auto packet_raw = reinterpret_cast<const uint8_t*>(packet);
 
+    if (capture_to_file) {
+        CapturePacket(PacketCapture::Direction::StoC, packet->header, fields, packet_raw);
+        return;
+    }
     if (log_packet_content) {
+        std::string content;
+        PacketCapture::FormatPacket(fields, {packet_raw, PacketCapture::MeasurePacket(fields, packet_raw)}, content);
         printf(PrefixTimestamp("StoC packet(%u 0x%X) {\n").c_str(), packet->header, packet->header);
-        PrintNestedField(handler.fields + 1, handler.field_count - 1, 1, bytes, 4);
+        printf("%s", content.c_str());
         printf("} endpacket(%u 0x%X)\n", packet->header, packet->header);
     }
     else {
@@ -743,6 +704,15 @@ void PacketLoggerWindow::Draw(IDirect3DDevice9*)
     }
     ImGui::ShowHelp("Export current map info to disk");
     */
+    if (ImGui::Checkbox("Capture to file", &capture_to_file) && !capture_to_file) {
+        ClosePacketCapture();
+    }
+    ImGui::ShowHelp("Instead of printing packets to the debug console, append them raw to a rolling set of capture files in the packet_captures folder.\n"
+                    "Much cheaper than logging packet content; open the files below to inspect them.");
+    if (capture_to_file) {
+        ImGui::SameLine();
+        ImGui::TextDisabled("%zu KB written", capture_writer.GetUsed() / 1024);
+    }
     ImGui::Checkbox("Log NPC Dialogs", &log_npc_dialogs);
     ImGui::ShowHelp("Log encoded strings and their translated output to debug console");
     if (ImGui::CollapsingHeader("Ignored Packets")) {
@@ -807,6 +777,12 @@ void PacketLoggerWindow::Draw(IDirect3DDevice9*)
             }
         }
     }
+    if (ImGui::CollapsingHeader("Capture Viewer")) {
+        if (!capture_viewer_path[0] && !capture_files.empty()) {
+            snprintf(capture_viewer_path, sizeof(capture_viewer_path), "%s", TextUtils::WStringToString(capture_files.back().wstring()).c_str());
+        }
+        DrawCaptureViewer();
+    }
     return ImGui::End();
 }
 
@@ -898,6 +874,8 @@ void PacketLoggerWindow::SaveSettings(ToolboxIni* ini)
     SAVE_BOOL(timestamp_show_hours);
     SAVE_BOOL(timestamp_show_seconds);
     SAVE_BOOL(timestamp_show_milliseconds);
+    ini->SetLongValue(Name(), VAR_NAME(capture_file_mb), capture_file_mb);
+    ini->SetLongValue(Name(), VAR_NAME(capture_max_files), capture_max_files);
 
     std::bitset<packet_max> ignored_packets_bitset;
     for (size_t i = 0; i < packet_max; i++) {
@@ -911,6 +889,8 @@ void PacketLoggerWindow::SaveSettings(ToolboxIni* ini)
 void PacketLoggerWindow::LoadSettings(ToolboxIni* ini)
 {
     ToolboxWindow::LoadSettings(ini);
+    capture_file_mb = std::clamp<int>(ini->GetLongValue(Name(), VAR_NAME(capture_file_mb), capture_file_mb), 1, max_capture_file_mb);
+    capture_max_files = std::clamp<int>(ini->GetLongValue(Name(), VAR_NAME(capture_max_files), capture_max_files), 1, 100);
 
 
 
@@ -936,9 +916,11 @@ void PacketLoggerWindow::Disable()
         GW::StoC::RemoveCallback(i, &hook_entry);
     }
     logger_enabled = false;
+    ClosePacketCapture();
 }
 void PacketLoggerWindow::Terminate() {
     ClearMessageLog();
+    ClosePacketCapture();
 }
 void PacketLoggerWindow::Enable()
 {
@@ -963,4 +945,8 @@ void PacketLoggerWindow::DrawSettingsInternal()
     ImGui::Checkbox("Show minutes", &timestamp_show_minutes);
     ImGui::Checkbox("Show seconds", &timestamp_show_seconds);
     ImGui::Checkbox("Show milliseconds", &timestamp_show_milliseconds);
+    ImGui::InputInt("Capture file size (MB)", &capture_file_mb);
+    capture_file_mb = std::clamp(capture_file_mb, 1, max_capture_file_mb);
+    ImGui::InputInt("Capture files to keep", &capture_max_files);
+    capture_max_files = std::clamp(capture_max_files, 1, 100);
 }
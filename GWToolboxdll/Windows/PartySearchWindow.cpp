@@ -31,14 +31,7 @@
 #include <GWToolbox.h>
 #include <Utils/TextUtils.h>
 
-// Every connection cost 30 seconds.
-// You have 2 tries.
-// After that, you can try every 30 seconds.
-static constexpr uint32_t COST_PER_CONNECTION_MS = 30 * 1000;
-static constexpr uint32_t COST_PER_CONNECTION_MAX_MS = 60 * 1000;
-using easywsclient::WebSocket;
 using nlohmann::json;
-using json_vec = std::vector<json>;
 
 static constexpr char ws_host[] = "wss://lfg.gwtoolbox.com";
 static constexpr char https_host[] = "https://lfg.gwtoolbox.com";
@@ -184,7 +177,7 @@ bool PartySearchWindow::TBParty::FromRegionParty(const GW::PartySearch* party)
     message = TextUtils::WStringToString(party->message);
     primary = party->primary;
     secondary = party->secondary;
-    player_name = TextUtils::WStringToString(party->party_leader);
+    player_name = StringPool::Intern(party->party_leader);
     Log::Log("Party %d updated\n", concat_party_id);
     return true;
 #pragma warning (pop)
@@ -209,7 +202,7 @@ bool PartySearchWindow::TBParty::FromPlayerInMap(const GW::Player* player)
     region_id = static_cast<uint8_t>(GW::Map::GetRegion());
     primary = player->primary;
     secondary = player->secondary;
-    player_name = TextUtils::WStringToString(player->name);
+    player_name = StringPool::Intern(player->name);
     Log::Log("Party %d updated\n", concat_party_id);
     return true;
 #pragma warning (pop)
@@ -238,7 +231,7 @@ bool PartySearchWindow::TBParty::FromLocalParty(GW::PartyInfo* party)
     region_id = static_cast<uint8_t>(GW::Map::GetRegion());
     primary = player->primary;
     secondary = player->secondary;
-    player_name = TextUtils::WStringToString(player->name);
+    player_name = StringPool::Intern(player->name);
     Log::Log("Party %d updated\n", concat_party_id);
     return true;
 #pragma warning (pop)
@@ -249,20 +242,7 @@ void PartySearchWindow::Initialize()
     ToolboxWindow::Initialize();
 
     party_advertisements.reserve(100);
-    messages = CircularBuffer<Message>(100);
 
-    should_stop = false;
-    worker = std::thread([this] {
-        while (!should_stop) {
-            if (thread_jobs.empty()) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            }
-            else {
-                thread_jobs.front()();
-                thread_jobs.pop();
-            }
-        }
-    });
     // local messages
     GW::StoC::RegisterPostPacketCallback(&OnMessageLocal_Entry, GAME_SMSG_PARTY_SEARCH_REMOVE, OnRegionPartyUpdated);
     GW::StoC::RegisterPostPacketCallback(&OnMessageLocal_Entry, GAME_SMSG_PARTY_SEARCH_SIZE, OnRegionPartyUpdated);
@@ -467,35 +447,18 @@ void PartySearchWindow::OnRegionPartyUpdated(GW::HookStatus*, GW::Packet::StoC::
 void PartySearchWindow::SignalTerminate()
 {
     ToolboxWindow::SignalTerminate();
-    should_stop = true;
-    if (worker.joinable()) {
-        worker.join();
-    }
-    DeleteWebSocket(ws_window);
-    ws_window = nullptr;
-    if (wsaData.wVersion) {
-        WSACleanup();
-        wsaData = { 0 };
-    }
+    ws_window.Stop();
 }
 
 void PartySearchWindow::Update(const float)
 {
-    if (ws_window && ws_window->getReadyState() == WebSocket::CLOSED) {
-        delete ws_window;
-        ws_window = nullptr;
-    }
-    if (ws_window && ws_window->getReadyState() != WebSocket::CLOSED) {
-        ws_window->poll();
-    }
     constexpr bool maintain_socket = false; // (visible && !collapsed) || (print_game_chat && GW::UI::GetCheckboxPreference(GW::UI::CheckboxPreference_ChannelTrade) == 0);
     if constexpr (maintain_socket) {
-        AsyncWindowConnect();
+        ws_window.Connect(ws_host);
     }
-    if (ws_window && ws_window->getReadyState() == WebSocket::OPEN) {
-        ws_window->close();
+    else if (ws_window.GetState() == WebSocketSession::State::Open) {
+        ws_window.Disconnect();
         messages.clear();
-        window_rate_limiter = RateLimiter(); // Deliberately closed; reset rate limiter.
     }
     fetch();
     if (refresh_parties && clock() > refresh_parties) {
@@ -529,23 +492,20 @@ bool PartySearchWindow::parse_json_message(const json& js, Message* msg)
     return true;
 }
 
-void PartySearchWindow::fetch()
+bool PartySearchWindow::parse_socket_message(const std::string& data, Message& msg)
 {
-    if (!ws_window || ws_window->getReadyState() != WebSocket::OPEN) {
-        return;
+    const json res = json::parse(data.c_str(), nullptr, false);
+    if (res == json::value_t::discarded) {
+        Log::Log("ERROR: Failed to parse res JSON from response in PartySearchWindow socket\n");
+        return false;
     }
+    return parse_json_message(res, &msg);
+}
 
-    ws_window->dispatch([this](const std::string& data) {
-        const json& res = json::parse(data.c_str(), nullptr, false);
-        if (res == json::value_t::discarded) {
-            Log::Log("ERROR: Failed to parse res JSON from response in ws_window->dispatch\n");
-            return;
-        }
+void PartySearchWindow::fetch()
+{
+    ws_window.Drain([this](const Message& msg) {
         // Add to message feed
-        Message msg;
-        if (!parse_json_message(res, &msg)) {
-            return; // Not valid message object
-        }
         messages.add(msg);
 
         // Check alerts
@@ -698,19 +658,18 @@ void PartySearchWindow::Draw(IDirect3DDevice9*)
                 snprintf(label, 64, "%s/%s %s",
                          GetProfessionAcronym(static_cast<GW::Constants::Profession>(party->primary)),
                          GetProfessionAcronym(static_cast<GW::Constants::Profession>(party->secondary)),
-                         party->player_name.c_str());
+                         StringPool::Get(party->player_name).c_str());
             }
             else {
                 snprintf(label, 64, "%s %s",
                          GetProfessionAcronym(static_cast<GW::Constants::Profession>(party->primary)),
-                         party->player_name.c_str());
+                         StringPool::Get(party->player_name).c_str());
             }
 
             if (ImGui::Button(label, ImVec2(playernamewidth, 0))) {
-                std::wstring leader_name = TextUtils::StringToWString(party->player_name);
                 // open whisper to player
-                GW::GameThread::Enqueue([leader_name] {
-                    SendUIMessage(GW::UI::UIMessage::kOpenWhisper, (wchar_t*)leader_name.data(), nullptr);
+                GW::GameThread::Enqueue([leader_name = party->player_name] {
+                    SendUIMessage(GW::UI::UIMessage::kOpenWhisper, (wchar_t*)StringPool::GetW(leader_name).data(), nullptr);
                 });
             }
             ImGui::SameLine(partycountleft);
@@ -814,42 +773,3 @@ void PartySearchWindow::ParseBuffer(const char* text, std::vector<std::string>&
         words.push_back(word);
     }
 }
-
-void PartySearchWindow::AsyncWindowConnect(const bool force)
-{
-    if (ws_window) {
-        return;
-    }
-    if (ws_window_connecting) {
-        return;
-    }
-    if (!force && !window_rate_limiter.AddTime(COST_PER_CONNECTION_MS, COST_PER_CONNECTION_MAX_MS)) {
-        return;
-    }
-    int res;
-    if (!wsaData.wVersion && (res = WSAStartup(MAKEWORD(2, 2), &wsaData)) != 0) {
-        printf("Failed to call WSAStartup: %d\n", res);
-        return;
-    }
-    ws_window_connecting = true;
-    thread_jobs.push([this] {
-        if ((ws_window = WebSocket::from_url(ws_host)) == nullptr) {
-            printf("Couldn't connect to the host '%s'", ws_host);
-        }
-        ws_window_connecting = false;
-    });
-}
-
-void PartySearchWindow::DeleteWebSocket(WebSocket* ws)
-{
-    if (!ws) {
-        return;
-    }
-    if (ws->getReadyState() == WebSocket::OPEN) {
-        ws->close();
-    }
-    while (ws->getReadyState() != WebSocket::CLOSED) {
-        ws->poll();
-    }
-    delete ws;
-}
@@ -1,8 +1,9 @@
 #pragma once
 
-#include <CircurlarBuffer.h>
 #include <ToolboxWindow.h>
-#include <Utils/RateLimiter.h>
+#include <Utils/RingBuffer.h>
+#include <Utils/WebSocketSession.h>
+#include <Utils/StringPool.h>
 
 class PartySearchWindow : public ToolboxWindow {
 public:
@@ -47,7 +48,6 @@ private:
         TBParty()
         {
             message[0] = 0;
-            player_name[0] = 0;
         }
 
         static uint32_t IdFromRegionParty(uint32_t party_id);
@@ -68,15 +68,13 @@ private:
         uint8_t primary = 0;
         uint8_t secondary = 0;
         std::string message;
-        std::string player_name;
+        StringPool::Handle player_name = StringPool::empty;
     };
 
     GW::HookEntry OnMessageLocal_Entry;
 
     std::unordered_map<std::wstring, TBParty*> party_advertisements{};
 
-    WSAData wsaData = {0};
-
     bool show_alert_window = false;
     std::recursive_mutex party_mutex;
 
@@ -92,11 +90,6 @@ private:
     char search_buffer[256] = {0};
     std::vector<std::string> alert_words{};
     std::vector<std::string> searched_words{};
-    // tasks to be done async by the worker thread
-    std::queue<std::function<void()>> thread_jobs{};
-    bool should_stop = false;
-    std::thread worker;
-    bool ws_window_connecting = false;
 
     clock_t refresh_parties = 0;
     bool display_party_types[6] = {true, true, true, false, true, true};
@@ -104,10 +97,9 @@ private:
     bool ignore_party_types[6] = {false, false, false, false, false, false};
     uint32_t max_party_size = 0;
 
-    easywsclient::WebSocket* ws_window = nullptr;
-    RateLimiter window_rate_limiter;
+    TypedWebSocketSession<Message> ws_window{parse_socket_message};
 
-    CircularBuffer<Message> messages;
+    Ring<Message> messages{100};
 
     TBParty* GetParty(uint32_t party_id, wchar_t** leader_out = nullptr) const;
     TBParty* GetPartyByName(const std::wstring& leader);
@@ -115,11 +107,11 @@ private:
     void ClearParties();
     void FillParties();
     void DrawAlertsWindowContent(bool ownwindow);
-    void AsyncWindowConnect(bool force = false);
     void fetch();
     static bool parse_json_message(const nlohmann::json& js, Message* msg);
+    // Runs on the websocket I/O thread
+    static bool parse_socket_message(const std::string& data, Message& msg);
     static void ParseBuffer(const char* text, std::vector<std::string>& words);
-    static void DeleteWebSocket(easywsclient::WebSocket* ws);
     bool IsLfpAlert(std::string& message) const;
     static void OnRegionPartyUpdated(GW::HookStatus*, GW::Packet::StoC::PacketBase* packet);
 };
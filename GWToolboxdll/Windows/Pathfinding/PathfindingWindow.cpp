@@ -258,7 +258,8 @@ bool PathfindingWindow::CalculatePath(const GW::GamePos& from, const GW::GamePos
                 Log::Error("Pathing failed; astar.m_path not ready");
             }
             const auto& points = astr.m_path.points();
-            auto waypoints = new std::vector<GW::GamePos>();
+            // Shared rather than raw, so the list is still freed if shutdown cancels the task before it runs
+            const auto waypoints = std::make_shared<std::vector<GW::GamePos>>();
             waypoints->reserve(points.size());
             for (const auto& p : points) {
                 waypoints->emplace_back(p);
@@ -266,7 +267,6 @@ bool PathfindingWindow::CalculatePath(const GW::GamePos& from, const GW::GamePos
 
             Resources::EnqueueMainTask([waypoints, callback, args] {
                 callback(*waypoints, args);
-                delete waypoints;
             });
         }
         pending_worker_task = false;
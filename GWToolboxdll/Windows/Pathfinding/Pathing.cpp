@@ -5,6 +5,8 @@
 #include <GWCA/Context/MapContext.h>
 
 #include <Logger.h>
+#include <Utils/AltitudeCache.h>
+#include <Utils/Scheduler.h>
 #include "MathUtility.h"
 #include "Pathing.h"
 
@@ -14,28 +16,18 @@ namespace {
     // Grab a copy of map_context->sub1->pathing_map_block for processing on a different thread - Blocks until copy is complete
     Pathing::Error CopyPathingMapBlocks(std::vector<uint32_t>& block)
     {
-        volatile Pathing::Error res = Pathing::Error::Unknown;
-        std::mutex mutex;
-        auto block_pt = &block;
-        // Enqueue
-        GW::GameThread::Enqueue([block_pt, &res, &mutex] {
-            const std::lock_guard lock(mutex);
+        auto res = Pathing::Error::Unknown;
+        Scheduler::RunAndWait([&block, &res] {
             GW::MapContext* mapContext = GW::GetMapContext();
             if (!mapContext) {
                 res = Pathing::Error::InvalidMapContext;
                 return;
             }
-            GW::Array<uint32_t>& block = mapContext->sub1->pathing_map_block;
-            if (block.m_size)
-                block_pt->assign(block.m_buffer, block.m_buffer + block.m_size);
+            const GW::Array<uint32_t>& map_block = mapContext->sub1->pathing_map_block;
+            if (map_block.m_size)
+                block.assign(map_block.m_buffer, map_block.m_buffer + map_block.m_size);
             res = Pathing::Error::OK;
         });
-        // Wait
-        do {
-            const std::lock_guard lock(mutex);
-            if (res != Pathing::Error::Unknown)
-                break;
-        } while (true);
         return res;
     }
 
@@ -109,9 +101,8 @@ namespace Pathing {
     // Gets height of map at current position and layer
     static float height(const Vec2f& p, int layer)
     {
-        float height = .0f;
-        Map::QueryAltitude(GamePos(p.x, p.y, layer), 5, height);
-        return height;
+        // Neighbouring trapezoids share corners, so most of these are cache hits
+        return AltitudeCache::Get(GamePos(p.x, p.y, layer));
     }
 
     SimplePT::adjacentSide SimplePT::TouchingHeight(const SimplePT& rhs, float max_height_diff) const
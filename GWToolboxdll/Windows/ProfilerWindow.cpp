@@ -0,0 +1,171 @@
+#include "stdafx.h"
+
+#include <Defines.h>
+#include <Modules/Resources.h>
+#include <Utils/FrameProfiler.h>
+#include <Windows/ProfilerWindow.h>
+
+namespace {
+    int capture_frames = 300;
+    bool include_packets = true;
+    // Labels under this p99 are hidden so the table isn't a wall of zeros
+    float hide_below_ms = 0.01f;
+
+    enum Column : ImGuiID { Column_Label, Column_Phase, Column_Last, Column_P50, Column_P99, Column_Max };
+
+    std::vector<FrameProfiler::Stats> sorted_stats;
+
+    void SortStats(const ImGuiTableSortSpecs* specs)
+    {
+        if (!specs || !specs->SpecsCount) {
+            return;
+        }
+        const auto& spec = specs->Specs[0];
+        const bool ascending = spec.SortDirection == ImGuiSortDirection_Ascending;
+        std::ranges::stable_sort(sorted_stats, [&](const FrameProfiler::Stats& a, const FrameProfiler::Stats& b) {
+            int cmp;
+            switch (spec.ColumnUserID) {
+                case Column_Label:
+                    cmp = strcmp(a.label, b.label);
+                    break;
+                case Column_Phase:
+                    cmp = static_cast<int>(a.phase) - static_cast<int>(b.phase);
+                    break;
+                case Column_Last:
+                    cmp = a.last_ms < b.last_ms ? -1 : a.last_ms > b.last_ms;
+                    break;
+                case Column_P50:
+                    cmp = a.p50_ms < b.p50_ms ? -1 : a.p50_ms > b.p50_ms;
+                    break;
+                case Column_Max:
+                    cmp = a.max_ms < b.max_ms ? -1 : a.max_ms > b.max_ms;
+                    break;
+                default:
+                    cmp = a.p99_ms < b.p99_ms ? -1 : a.p99_ms > b.p99_ms;
+                    break;
+            }
+            return ascending ? cmp < 0 : cmp > 0;
+        });
+    }
+
+    std::filesystem::path GetTracePath()
+    {
+        const auto now = std::time(nullptr);
+        tm local_time{};
+        localtime_s(&local_time, &now);
+        wchar_t filename[64];
+        wcsftime(filename, _countof(filename), L"profiler_trace_%Y%m%d_%H%M%S.json", &local_time);
+        return Resources::GetPath(filename);
+    }
+}
+
+void ProfilerWindow::Terminate()
+{
+    ToolboxWindow::Terminate();
+    FrameProfiler::SetEnabled(false);
+}
+
+void ProfilerWindow::Update(const float)
+{
+    // Only pay for timing while someone is looking at it, or a capture is still running
+    FrameProfiler::SetEnabled(visible || FrameProfiler::IsCapturing());
+}
+
+void ProfilerWindow::Draw(IDirect3DDevice9*)
+{
+    if (!visible) {
+        return;
+    }
+    ImGui::SetNextWindowSize(ImVec2(520.0f, 400.0f), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin(Name(), GetVisiblePtr(), GetWinFlags())) {
+        ImGui::End();
+        return;
+    }
+
+    ImGui::Text("Toolbox time last frame: %.2f ms", FrameProfiler::GetLastFrameTotal());
+    ImGui::SameLine();
+    if (ImGui::Button("Reset")) {
+        FrameProfiler::Reset();
+    }
+    ImGui::SameLine();
+    if (FrameProfiler::IsCapturing()) {
+        ImGui::TextDisabled("Capturing...");
+    }
+    else if (ImGui::Button("Capture trace")) {
+        FrameProfiler::StartCapture(static_cast<size_t>(capture_frames), GetTracePath());
+    }
+    ImGui::ShowHelp("Records every timed call for the next few hundred frames and saves it as Chrome trace json in the toolbox folder.\n"
+                    "Open it with chrome://tracing or ui.perfetto.dev.");
+
+    constexpr ImGuiTableFlags table_flags = ImGuiTableFlags_Sortable | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY | ImGuiTableFlags_Resizable | ImGuiTableFlags_BordersInnerV;
+    if (ImGui::BeginTable("profiler_table", 6, table_flags)) {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_WidthStretch, 0.f, Column_Label);
+        ImGui::TableSetupColumn("Phase", ImGuiTableColumnFlags_WidthFixed, 0.f, Column_Phase);
+        ImGui::TableSetupColumn("Last", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending, 0.f, Column_Last);
+        ImGui::TableSetupColumn("p50", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending, 0.f, Column_P50);
+        ImGui::TableSetupColumn("p99", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending | ImGuiTableColumnFlags_DefaultSort, 0.f, Column_P99);
+        ImGui::TableSetupColumn("Max", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending, 0.f, Column_Max);
+        ImGui::TableHeadersRow();
+
+        sorted_stats.clear();
+        for (const auto& stat : FrameProfiler::GetStats()) {
+            if (stat.p99_ms < hide_below_ms && stat.max_ms < hide_below_ms) {
+                continue;
+            }
+            if (!include_packets && stat.phase == FrameProfiler::Phase::Packet) {
+                continue;
+            }
+            sorted_stats.push_back(stat);
+        }
+        SortStats(ImGui::TableGetSortSpecs());
+
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(sorted_stats.size()));
+        while (clipper.Step()) {
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                const auto& stat = sorted_stats[i];
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(stat.label);
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(FrameProfiler::GetPhaseName(stat.phase));
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", stat.last_ms);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", stat.p50_ms);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", stat.p99_ms);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", stat.max_ms);
+            }
+        }
+        ImGui::EndTable();
+    }
+    ImGui::End();
+}
+
+void ProfilerWindow::LoadSettings(ToolboxIni* ini)
+{
+    ToolboxWindow::LoadSettings(ini);
+    LOAD_UINT(capture_frames);
+    LOAD_BOOL(include_packets);
+    LOAD_FLOAT(hide_below_ms);
+}
+
+void ProfilerWindow::SaveSettings(ToolboxIni* ini)
+{
+    ToolboxWindow::SaveSettings(ini);
+    SAVE_UINT(capture_frames);
+    SAVE_BOOL(include_packets);
+    SAVE_FLOAT(hide_below_ms);
+}
+
+void ProfilerWindow::DrawSettingsInternal()
+{
+    ToolboxWindow::DrawSettingsInternal();
+    ImGui::SliderInt("Frames per trace capture", &capture_frames, 30, 3000);
+    ImGui::Checkbox("Show StoC packet callbacks", &include_packets);
+    ImGui::ShowHelp("Time spent in toolbox and plugin callbacks for each packet header, not including Guild Wars' own handling.");
+    ImGui::DragFloat("Hide entries faster than (ms)", &hide_below_ms, 0.001f, 0.f, 1.f, "%.3f");
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <ToolboxWindow.h>
+
+class ProfilerWindow : public ToolboxWindow {
+    ProfilerWindow() = default;
+    ~ProfilerWindow() override = default;
+
+public:
+    static ProfilerWindow& Instance()
+    {
+        static ProfilerWindow instance;
+        return instance;
+    }
+
+    [[nodiscard]] const char* Name() const override { return "Profiler"; }
+    [[nodiscard]] const char* Icon() const override { return ICON_FA_STOPWATCH; }
+
+    void Terminate() override;
+    void Update(float delta) override;
+    void Draw(IDirect3DDevice9* pDevice) override;
+
+    void LoadSettings(ToolboxIni* ini) override;
+    void SaveSettings(ToolboxIni* ini) override;
+    void DrawSettingsInternal() override;
+};
@@ -277,7 +277,12 @@ bool SettingsWindow::DrawSettingsSection(const char* section)
     for (const auto& setting_callback : settings_section->second) {
         //if (i && is_showing) ImGui::Separator();
         ImGui::PushID(i);
+        const bool edited_before = GImGui->ActiveIdHasBeenEditedThisFrame;
         setting_callback.callback(settings_section->first, is_showing);
+        if (!edited_before && GImGui->ActiveIdHasBeenEditedThisFrame && setting_callback.module) {
+            // Something in this module's settings was changed; get it saved without waiting for exit
+            setting_callback.module->MarkSettingsDirty();
+        }
         i++;
         ImGui::PopID();
     }
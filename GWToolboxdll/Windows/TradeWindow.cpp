@@ -18,24 +18,21 @@
 #include <GWCA/Managers/PartyMgr.h>
 
 #include <Logger.h>
+#include <Timer.h>
 #include <Utils/GuiUtils.h>
 
 #include <Modules/Resources.h>
 #include <Windows/TradeWindow.h>
 #include <GWToolbox.h>
+#include <Utils/RingBuffer.h>
 #include <Utils/TextUtils.h>
+#include <Utils/TradeHistory.h>
+#include <Utils/WebSocketSession.h>
 
 namespace {
     GW::HookEntry ChatCmd_HookEntry;
-    // Every connection cost 30 seconds.
-    // You have 2 tries.
-    // After that, you can try every 30 seconds.
-    constexpr uint32_t COST_PER_CONNECTION_MS = 30 * 1000;
-    constexpr uint32_t COST_PER_CONNECTION_MAX_MS = 60 * 1000;
     static const char* months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
-    using easywsclient::WebSocket;
     using nlohmann::json;
-    using json_vec = std::vector<json>;
 
     constexpr char ws_host_kmd[] = "wss://kamadan.gwtoolbox.com";
     constexpr char https_host_kmd[] = "https://kamadan.gwtoolbox.com";
@@ -54,13 +51,20 @@ namespace {
         std::string message;
     };
 
+    // Either a live message from the feed, or the server's answer to a search query
+    struct TradeEvent {
+        bool is_search_result = false;
+        bool search_failed = false;
+        std::string query;
+        Message message;
+        std::vector<Message> results;
+    };
+
     GW::HookEntry OnMessageLocal_Entry;
     GW::HookEntry OnPartySearch_Entry;
     GW::PartySearch player_party_search = { 0 };
     char player_party_search_text[64] = { 0 };
 
-    WSAData wsaData = { 0 };
-
     bool is_kamadan_chat = true;
     bool refresh_footer = false;
 
@@ -79,6 +83,11 @@ namespace {
     // if enabled, will also apply the trade alerts filter to incoming local trade chat messages.
     bool filter_local_trade = false;
 
+    // if enabled, every Kamadan/local trade message seen is kept on disk and searched locally before the server answers.
+    // Off by default; the search index for a full history takes tens of megabytes.
+    bool keep_trade_history = false;
+    clock_t trade_history_flushed = 0;
+
     static constexpr auto ALERT_BUF_SIZE = 1024 * 16;
     char alert_buf[ALERT_BUF_SIZE]{};
     // set when the alert_buf was modified
@@ -93,19 +102,37 @@ namespace {
     std::vector<std::string> alert_words{};
     std::vector<std::string> searched_words{};
 
-    CircularBuffer<Message> messages;
-
-    bool ws_window_connecting = false;
-
-    easywsclient::WebSocket* ws_window = nullptr;
+    Ring<Message> messages(100);
 
-    RateLimiter window_rate_limiter;
+    std::filesystem::path GetTradeHistoryPath()
+    {
+        return Resources::GetPath(L"trade_history.dat");
+    }
 
     void search(const std::string& query, const bool print_results_in_chat = false)
     {
         pending_query_string = query.empty() ? " " : query;
         print_search_results = print_results_in_chat;
         pending_query_sent = 0;
+        if (!(keep_trade_history && is_kamadan_chat)) {
+            return;
+        }
+        // Show what we have locally as soon as it's read; the server's results replace these when they arrive.
+        Resources::EnqueueWorkerTask([query, expected = pending_query_string] {
+            auto local_results = TradeHistory::Search(query, 100);
+            if (local_results.empty()) {
+                return;
+            }
+            Resources::EnqueueMainTask([expected, local_results = std::move(local_results)] {
+                if (pending_query_string != expected) {
+                    return; // Answered by the server, or another search has been made since
+                }
+                messages.clear();
+                for (auto it = local_results.rbegin(); it != local_results.rend(); ++it) {
+                    messages.add({it->timestamp, it->name, it->message});
+                }
+            });
+        });
     }
 
     bool parse_json_message(const json& js, Message* msg)
@@ -139,6 +166,41 @@ namespace {
         return true;
     }
 
+    // Runs on the websocket I/O thread; only touches its arguments.
+    bool parse_trade_event(const std::string& data, TradeEvent& out)
+    {
+        const json res = json::parse(data.c_str(), nullptr, false);
+        if (res == json::value_t::discarded) {
+            Log::Log("ERROR: Failed to parse res JSON from response in TradeWindow socket\n");
+            return false;
+        }
+        if (!(res.contains("query") && res["query"].is_string())) {
+            return parse_json_message(res, &out.message);
+        }
+        out.is_search_result = true;
+        out.query = res["query"].get<std::string>();
+        if (!(res.contains("num_results") && res["num_results"].is_number_unsigned())
+            || !(res.contains("results") && res["results"].is_array())) {
+            out.search_failed = true;
+            return true;
+        }
+        const auto& results = res["results"];
+        out.results.reserve(results.size());
+        for (const auto& result : results) {
+            Message msg;
+            if (parse_json_message(result, &msg)) {
+                out.results.push_back(std::move(msg));
+            }
+        }
+        return true;
+    }
+
+    TypedWebSocketSession<TradeEvent> ws_window(parse_trade_event);
+    // Whether Update currently wants the socket open
+    bool ws_window_wanted = false;
+    // Last value of ws_window.GetConnectionCount() seen by fetch, used to spot a (re)connect
+    uint32_t ws_window_connection_count = 0;
+
 
     void CHAT_CMD_FUNC(CmdPricecheck)
     {
@@ -161,11 +223,12 @@ namespace {
 
 void TradeWindow::OnMessageLocal(GW::HookStatus* status, const GW::Packet::StoC::MessageLocal* pak)
 {
-    if (pak->channel != GW::Chat::CHANNEL_TRADE || status->blocked || !filter_alerts) {
+    if (pak->channel != GW::Chat::CHANNEL_TRADE || status->blocked) {
         return;
     }
+    const bool record_history = keep_trade_history && !GetInAscalonAE1(false);
     // Only filter incoming trade messages if the user wants them filtered.
-    if (!filter_local_trade) {
+    if (!(filter_alerts && filter_local_trade) && !record_history) {
         return;
     }
     const wchar_t* message = GetMessageCore();
@@ -197,6 +260,15 @@ void TradeWindow::OnMessageLocal(GW::HookStatus* status, const GW::Packet::StoC:
 
     // std::string temp(start, end);
     std::string message_utf8 = TextUtils::WStringToString(std::wstring(start, end));
+    if (record_history) {
+        const wchar_t* sender = GW::PlayerMgr::GetPlayerName(pak->player_number);
+        if (sender) {
+            TradeHistory::Add(static_cast<uint32_t>(time(nullptr)), TextUtils::WStringToString(sender), message_utf8);
+        }
+    }
+    if (!(filter_alerts && filter_local_trade)) {
+        return;
+    }
     if (!Instance().IsTradeAlert(message_utf8)) {
         status->blocked = true;
     }
@@ -206,20 +278,6 @@ void TradeWindow::Initialize()
 {
     ToolboxWindow::Initialize();
 
-    messages = CircularBuffer<Message>(100);
-
-    should_stop = false;
-    worker = new std::thread([this] {
-        while (!should_stop) {
-            if (thread_jobs.empty()) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            }
-            else {
-                thread_jobs.front()();
-                thread_jobs.pop();
-            }
-        }
-    });
     GW::Chat::CreateCommand(&ChatCmd_HookEntry, L"pc", CmdPricecheck);
     // local messages
     GW::StoC::RegisterPacketCallback<GW::Packet::StoC::MessageLocal>(&OnMessageLocal_Entry, OnMessageLocal);
@@ -243,19 +301,9 @@ void TradeWindow::Initialize()
 void TradeWindow::Terminate()
 {
     ToolboxWindow::Terminate();
-    should_stop = true;
-    if (worker) {
-        ASSERT(worker->joinable());
-        worker->join();
-        delete worker;
-        worker = nullptr;
-    }
-    DeleteWebSocket(ws_window);
-    ws_window = nullptr;
-    if (wsaData.wVersion) {
-        WSACleanup();
-        wsaData = { 0 };
-    }
+    ws_window.Stop();
+    ws_window_wanted = false;
+    TradeHistory::Unload();
     GW::Chat::DeleteCommand(&ChatCmd_HookEntry);
 }
 bool TradeWindow::GetInKamadanAE1(const bool check_district)
@@ -286,30 +334,34 @@ bool TradeWindow::GetInAscalonAE1(const bool check_district)
 
 void TradeWindow::Update(const float)
 {
-    if (ws_window && ws_window->getReadyState() == WebSocket::CLOSED) {
-        delete ws_window;
-        ws_window = nullptr;
-    }
-    if (ws_window && ws_window->getReadyState() != WebSocket::CLOSED) {
-        ws_window->poll();
-    }
     const bool search_pending = !pending_query_string.empty();
     const bool maintain_socket = (visible && !collapsed) || ((print_game_chat || print_game_chat_asc) && GetPreference(GW::UI::FlagPreference::ChannelTrade) == 0) || search_pending;
-    if (maintain_socket && !ws_window) {
-        AsyncWindowConnect();
+    if (maintain_socket && !ws_window_wanted) {
+        ws_window.Connect(is_kamadan_chat ? ws_host_kmd : ws_host_asc);
+        ws_window_wanted = true;
     }
-    if (!maintain_socket && ws_window && ws_window->getReadyState() == WebSocket::OPEN) {
-        ws_window->close();
+    if (!maintain_socket && ws_window_wanted) {
+        ws_window.Disconnect();
+        ws_window_wanted = false;
         messages.clear();
-        window_rate_limiter = RateLimiter(); // Deliberately closed; reset rate limiter.
     }
     fetch();
+    if (keep_trade_history && TIMER_DIFF(trade_history_flushed) > 10 * CLOCKS_PER_SEC) {
+        Resources::EnqueueWorkerTask(TradeHistory::Flush);
+        trade_history_flushed = TIMER_INIT();
+    }
 }
 
 void TradeWindow::fetch()
 {
-    if (!ws_window || ws_window->getReadyState() != WebSocket::OPEN) {
-        return;
+    const auto connection_count = ws_window.GetConnectionCount();
+    if (connection_count != ws_window_connection_count && ws_window.GetState() == WebSocketSession::State::Open) {
+        // (Re)connected; any query in flight was lost with the old socket
+        ws_window_connection_count = connection_count;
+        pending_query_sent = 0;
+        if (messages.size() == 0 && pending_query_string.empty()) {
+            search(""); // Initial draw, gets latest N messages
+        }
     }
     const bool search_pending = !pending_query_sent && !pending_query_string.empty();
     if (search_pending) {
@@ -320,52 +372,37 @@ void TradeWindow::fetch()
         // Send request
         json request;
         request["query"] = pending_query_string;
-        pending_query_sent = clock();
-        ws_window->send(request.dump());
+        if (ws_window.Send(request.dump())) {
+            pending_query_sent = clock();
+        }
     }
 
-    ws_window->dispatch([this](const std::string& data) {
-        const json& res = json::parse(data.c_str(), nullptr, false);
-        if (res == json::value_t::discarded) {
-            Log::Log("ERROR: Failed to parse res JSON from response in ws_window->dispatch\n");
-            return;
-        }
-        if (res.find("query") != res.end() && res["query"].is_string()) {
-            auto query_string = res["query"].get<std::string>();
+    ws_window.Drain([this](TradeEvent& evt) {
+        if (evt.is_search_result) {
+            const auto& query_string = evt.query;
             if (query_string != pending_query_string) {
                 return; // Different query has been made since this search.
             }
             pending_query_string.clear();
-            if (!(res.contains("num_results") && res["num_results"].is_number_unsigned())) {
+            if (evt.search_failed) {
                 Log::Log("ERROR: Failed to parse search results in TradeWindow::fetch\n");
                 print_search_results = false;
                 return;
             }
-            size_t num_results = res["num_results"].get<size_t>();
-            if (print_search_results && !num_results) {
-                Log::Warning("No results found for %s", query_string.c_str());
-                print_search_results = false;
-                return;
-            }
-            if (!(res.contains("results") && res["results"].is_array())) {
-                Log::Log("ERROR: Failed to parse search results in TradeWindow::fetch\n");
-                print_search_results = false;
-                return;
-            }
-            auto results = res["results"].get<json_vec>();
+            const auto& results = evt.results;
             messages.clear();
             if (print_search_results && !results.size()) {
                 Log::Warning("No results found for %s", query_string.c_str());
                 print_search_results = false;
                 return;
             }
-            size_t results_size = results.size();
+            const size_t results_size = results.size();
             for (size_t i = results_size - 1; i < results_size; i--) {
-                Message msg;
-                if (!parse_json_message(results[i], &msg)) {
-                    continue;
-                }
+                const Message& msg = results[i];
                 messages.add(msg);
+                if (keep_trade_history && is_kamadan_chat) {
+                    TradeHistory::Add(msg.timestamp, msg.name, msg.message);
+                }
                 if (print_search_results && i < 12) {
                     std::wstring name_ws = TextUtils::StringToWString(msg.name);
                     std::wstring msg_ws = TextUtils::StringToWString(msg.message);
@@ -382,9 +419,9 @@ void TradeWindow::fetch()
             return;
         }
         // Add to message feed
-        Message msg;
-        if (!parse_json_message(res, &msg)) {
-            return; // Not valid message object
+        const Message& msg = evt.message;
+        if (keep_trade_history && is_kamadan_chat) {
+            TradeHistory::Add(msg.timestamp, msg.name, msg.message);
         }
         bool add_to_window = searched_words.empty();
         if (!add_to_window) {
@@ -581,7 +618,10 @@ void TradeWindow::Draw(IDirect3DDevice9*)
     /* Main trade chat area */
     ImGui::BeginChild("trade_scroll", ImVec2(0, -20.0f - ImGui::GetStyle().ItemInnerSpacing.y));
     /* Connection checks */
-    if (!ws_window && !ws_window_connecting) {
+    const auto socket_state = ws_window.GetState();
+    // Results from the local history can still be shown while offline
+    const bool have_local_results = keep_trade_history && is_kamadan_chat && messages.size();
+    if (socket_state == WebSocketSession::State::Disconnected && !have_local_results) {
         char buf[255];
         snprintf(buf, 255, "The connection to %s has timed out.", is_kamadan_chat ? ws_host_kmd : ws_host_asc);
         ImGui::SetCursorPosX((ImGui::GetWindowWidth() - ImGui::CalcTextSize(buf).x) / 2);
@@ -589,10 +629,10 @@ void TradeWindow::Draw(IDirect3DDevice9*)
         ImGui::Text(buf);
         ImGui::SetCursorPosX((ImGui::GetWindowWidth() - ImGui::CalcTextSize("Click to reconnect").x) / 2);
         if (ImGui::Button("Click to reconnect")) {
-            AsyncWindowConnect(true);
+            ws_window.ReconnectNow();
         }
     }
-    else if (ws_window_connecting || (ws_window && ws_window->getReadyState() == WebSocket::CONNECTING)) {
+    else if (socket_state == WebSocketSession::State::Connecting && !have_local_results) {
         ImGui::SetCursorPosX((ImGui::GetWindowWidth() - ImGui::CalcTextSize("Connecting...").x) / 2);
         ImGui::SetCursorPosY(ImGui::GetWindowHeight() / 2);
         ImGui::Text("Connecting...");
@@ -724,6 +764,14 @@ void TradeWindow::DrawChatSettings(const bool ownwindow)
 
 void TradeWindow::DrawSettingsInternal()
 {
+    if (ImGui::Checkbox("Keep a local history of trade messages", &keep_trade_history)) {
+        keep_trade_history ? TradeHistory::Load(GetTradeHistoryPath()) : TradeHistory::Unload();
+    }
+    ImGui::ShowHelp("Kamadan and local trade messages are saved to disk and searched locally,\nso results show up instantly and still work when the trade server is offline.\nA long history can use tens of megabytes of memory for its search index.");
+    if (keep_trade_history) {
+        ImGui::SameLine();
+        ImGui::TextDisabled(TradeHistory::IsLoaded() ? "(%zu messages)" : "(loading...)", TradeHistory::Count());
+    }
     DrawAlertsWindowContent(false);
 }
 
@@ -735,6 +783,10 @@ void TradeWindow::LoadSettings(ToolboxIni* ini)
     LOAD_BOOL(filter_alerts);
     LOAD_BOOL(filter_local_trade);
     LOAD_BOOL(is_kamadan_chat);
+    LOAD_BOOL(keep_trade_history);
+    if (keep_trade_history) {
+        TradeHistory::Load(GetTradeHistoryPath());
+    }
 
     strncpy(player_party_search_text, ini->GetValue(Name(), "player_party_search_text", ""), _countof(player_party_search_text) - 1);
 
@@ -758,6 +810,7 @@ void TradeWindow::SaveSettings(ToolboxIni* ini)
     SAVE_BOOL(filter_alerts);
     SAVE_BOOL(filter_local_trade);
     SAVE_BOOL(is_kamadan_chat);
+    SAVE_BOOL(keep_trade_history);
 
     ini->SetValue(Name(), "player_party_search_text", player_party_search_text);
 
@@ -797,53 +850,12 @@ void TradeWindow::ParseBuffer(std::fstream stream, std::vector<std::string>& wor
     }
 }
 
-void TradeWindow::AsyncWindowConnect(const bool force)
-{
-    if (ws_window) {
-        return;
-    }
-    if (ws_window_connecting) {
-        return;
-    }
-    if (!force && !window_rate_limiter.AddTime(COST_PER_CONNECTION_MS, COST_PER_CONNECTION_MAX_MS)) {
-        return;
-    }
-    int res;
-    if (!wsaData.wVersion && (res = WSAStartup(MAKEWORD(2, 2), &wsaData)) != 0) {
-        printf("Failed to call WSAStartup: %d\n", res);
-        return;
-    }
-    ws_window_connecting = true;
-    thread_jobs.push([this] {
-        if ((ws_window = WebSocket::from_url(is_kamadan_chat ? ws_host_kmd : ws_host_asc)) == nullptr) {
-            printf("Couldn't connect to the host '%s'", is_kamadan_chat ? ws_host_kmd : ws_host_asc);
-        }
-        ws_window_connecting = false;
-        if (messages.size() == 0 && pending_query_string.empty()) {
-            search(""); // Initial draw, gets latest N messages
-        }
-    });
-}
-
-void TradeWindow::DeleteWebSocket(WebSocket* ws)
-{
-    if (!ws) {
-        return;
-    }
-    if (ws->getReadyState() == WebSocket::OPEN) {
-        ws->close();
-    }
-    while (ws->getReadyState() != WebSocket::CLOSED) {
-        ws->poll();
-    }
-    delete ws;
-}
-
 void TradeWindow::SwitchSockets()
 {
     refresh_footer = true;
-    DeleteWebSocket(ws_window);
-    ws_window = nullptr;
     messages.clear();
-    AsyncWindowConnect(true);
+    pending_query_sent = 0;
+    ws_window.Connect(is_kamadan_chat ? ws_host_kmd : ws_host_asc);
+    ws_window.ReconnectNow();
+    ws_window_wanted = true;
 }
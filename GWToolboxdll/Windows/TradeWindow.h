@@ -4,9 +4,7 @@
 
 #include <GWCA/GameEntities/Party.h>
 
-#include <CircurlarBuffer.h>
 #include <ToolboxWindow.h>
-#include <Utils/RateLimiter.h>
 
 class TradeWindow : public ToolboxWindow {
     TradeWindow() = default;
@@ -47,20 +45,10 @@ private:
     static bool GetInKamadanAE1(bool check_district = true);
     static bool GetInAscalonAE1(bool check_district = true);
 
-    // Since we are connecting in an other thread, the following attributes/methods avoid spamming connection requests
-    void AsyncWindowConnect(bool force = false);
-
-
     void fetch();
 
-    // tasks to be done async by the worker thread
-    std::queue<std::function<void()>> thread_jobs{};
-    bool should_stop = false;
-    std::thread* worker = nullptr;
-
     static void ParseBuffer(const char* text, std::vector<std::string>& words);
     static void ParseBuffer(std::fstream stream, std::vector<std::string>& words);
 
-    static void DeleteWebSocket(easywsclient::WebSocket* ws);
     void SwitchSockets();
 };
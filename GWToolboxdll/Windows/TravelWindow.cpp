@@ -297,9 +297,8 @@ namespace {
 
         // Shortcut words e.g "/tp doa" for domain of anguish
         const std::string first_word = compare.substr(0, compare.find(' '));
-        const auto& shorthand_outpost = shorthand_outpost_names.find(first_word);
-        if (shorthand_outpost != shorthand_outpost_names.end()) {
-            const OutpostAlias& outpost_info = shorthand_outpost->second;
+        if (const auto shorthand_outpost = shorthand_outpost_names.find(first_word)) {
+            const OutpostAlias& outpost_info = *shorthand_outpost;
             outpost = outpost_info.map_id;
             if (outpost_info.district != GW::Constants::District::Current) {
                 district = outpost_info.district;
@@ -399,11 +398,11 @@ namespace {
             return false;
         }
         // Shortcut words e.g "/tp ae" for american english
-        const auto& shorthand_outpost = shorthand_district_names.find(m[1].str());
-        if (shorthand_outpost == shorthand_district_names.end()) {
+        const auto shorthand_district = shorthand_district_names.find(m[1].str());
+        if (!shorthand_district) {
             return false;
         }
-        district = shorthand_outpost->second.district;
+        district = shorthand_district->district;
         if (m.size() > 2 && !TextUtils::ParseUInt(m[2].str().c_str(), &number)) {
             number = 0;
         }
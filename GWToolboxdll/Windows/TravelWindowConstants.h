@@ -1,7 +1,9 @@
 #pragma once
 
+#include <Utils/StaticTable.h>
+
 struct OutpostAlias {
-    OutpostAlias(const GW::Constants::MapID m, const GW::Constants::District d = GW::Constants::District::Current, const uint8_t n = 0)
+    constexpr OutpostAlias(const GW::Constants::MapID m, const GW::Constants::District d = GW::Constants::District::Current, const uint8_t n = 0)
         : map_id(m)
         , district(d)
         , district_number(n) { }
@@ -12,7 +14,7 @@ struct OutpostAlias {
 };
 
 struct DistrictAlias {
-    DistrictAlias(const GW::Constants::District d, const uint8_t n = 0)
+    constexpr DistrictAlias(const GW::Constants::District d, const uint8_t n = 0)
         : district(d)
         , district_number(n) { }
 
@@ -21,7 +23,7 @@ struct DistrictAlias {
 };
 
 // List of shorthand outpost names. This is checked for an exact match first.
-const std::map<const std::string, const OutpostAlias> shorthand_outpost_names = {
+constexpr StaticTable::PerfectHashMap shorthand_outpost_names(std::to_array<std::pair<std::string_view, OutpostAlias>>({
     {"bestarea", {GW::Constants::MapID::The_Deep}},
     {"toa", {GW::Constants::MapID::Temple_of_the_Ages}},
     {"doa", {GW::Constants::MapID::Domain_of_Anguish}},
@@ -41,11 +43,11 @@ const std::map<const std::string, const OutpostAlias> shorthand_outpost_names =
     {"ra", {GW::Constants::MapID::Random_Arenas_outpost}},
     {"fa", {GW::Constants::MapID::Fort_Aspenwood_Kurzick_outpost}},
     {"jq", {GW::Constants::MapID::The_Jade_Quarry_Kurzick_outpost}}
-};
+}));
+static_assert(shorthand_outpost_names.Covers());
 
 // List of shorthand district names. This is checked for an exact match.
-const std::map<const std::string, const DistrictAlias> shorthand_district_names =
-{
+constexpr StaticTable::PerfectHashMap shorthand_district_names(std::to_array<std::pair<std::string_view, DistrictAlias>>({
     {"ae", {GW::Constants::District::American}},
     {"int", {GW::Constants::District::International}},
     {"ee", {GW::Constants::District::EuropeEnglish}},
@@ -59,8 +61,9 @@ const std::map<const std::string, const DistrictAlias> shorthand_district_names
     {"ru", {GW::Constants::District::EuropeRussian}},
     {"kr", {GW::Constants::District::AsiaKorean}},
     {"cn", {GW::Constants::District::AsiaChinese}},
-    {"jp", {GW::Constants::District::AsiaJapanese}},
-};
+    {"jp", {GW::Constants::District::AsiaJapanese}}
+}));
+static_assert(shorthand_district_names.Covers());
 
 constexpr std::array presearing_map_ids = {
     GW::Constants::MapID::Ashford_Abbey_outpost,
@@ -0,0 +1,207 @@
+#include "stdafx.h"
+
+#include <HostTest.h>
+#include <Widgets/Minimap/AgentBatch.h>
+
+using namespace AgentBatch;
+
+namespace {
+    // Colors::Add/Sub, one channel at a time
+    uint32_t AddClamped(const uint32_t a, const uint32_t b, const int sign)
+    {
+        uint32_t out = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            const int sum = static_cast<int>(a >> shift & 0xFF) + sign * static_cast<int>(b >> shift & 0xFF);
+            out |= static_cast<uint32_t>(std::clamp(sum, 0, 255)) << shift;
+        }
+        return out;
+    }
+
+    uint32_t ReferenceColor(const Tint tint, const uint32_t color, const uint32_t modifier)
+    {
+        switch (tint) {
+            case Tint::Dark:
+                return AddClamped(color, modifier, -1);
+            case Tint::Light:
+                return AddClamped(color, modifier, 1);
+            case Tint::CircleCenter:
+                return AddClamped(color, IM_COL32(0, 0, 0, 50), -1);
+            default:
+                return color;
+        }
+    }
+
+    // What the SSE2 kernel replaced: one vertex at a time
+    size_t ReferenceEmit(const std::span<const ShapeTemplate> shapes, const AgentInstances& instances, std::vector<D3DVertex>& out, const size_t max_vertices)
+    {
+        for (size_t i = 0; i < instances.Size(); i++) {
+            const auto& shape = shapes[instances.shape[i]];
+            if (out.size() + shape.Size() > max_vertices) {
+                break;
+            }
+            const float a = instances.rot_cos[i] * instances.scale[i];
+            const float b = instances.rot_sin[i] * instances.scale[i];
+            for (size_t v = 0; v < shape.Size(); v++) {
+                out.push_back({
+                    shape.x[v] * a - shape.y[v] * b + instances.pos_x[i],
+                    shape.x[v] * b + shape.y[v] * a + instances.pos_y[i],
+                    0.f,
+                    ReferenceColor(shape.tint[v], instances.color[i], instances.modifier[i])
+                });
+            }
+        }
+        return out.size();
+    }
+
+    bool Near(const float a, const float b)
+    {
+        return std::abs(a - b) <= 1e-4f * std::max(1.f, std::abs(b));
+    }
+
+    // Shapes whose sizes cover every remainder of the four-wide kernel, including one smaller than a single batch
+    std::vector<ShapeTemplate> MakeShapes()
+    {
+        std::vector<ShapeTemplate> shapes;
+        for (const size_t size : {3u, 4u, 6u, 9u, 12u, 31u}) {
+            auto& shape = shapes.emplace_back();
+            for (size_t v = 0; v < size; v++) {
+                const float angle = 6.2831853f * static_cast<float>(v) / static_cast<float>(size);
+                shape.AddVertex(std::cos(angle) * (1.f + 0.1f * v), std::sin(angle), static_cast<Tint>(v % 4));
+            }
+        }
+        return shapes;
+    }
+
+    AgentInstances MakeInstances(const size_t count, const size_t shape_count)
+    {
+        AgentInstances instances;
+        uint32_t seed = 12345;
+        const auto next = [&seed] {
+            seed = seed * 1664525u + 1013904223u;
+            return seed;
+        };
+        for (size_t i = 0; i < count; i++) {
+            const float angle = static_cast<float>(next() % 6283) / 1000.f;
+            const GW::Vec2f pos = {static_cast<float>(next() % 20000) - 10000.f, static_cast<float>(next() % 20000) - 10000.f};
+            // Colours and modifiers near both ends of each channel, so the saturating paths are hit
+            instances.Push(static_cast<uint8_t>(next() % shape_count), pos, std::cos(angle), std::sin(angle), 20.f + static_cast<float>(next() % 200), next(), next() & 0x7F7F7F7F);
+        }
+        return instances;
+    }
+
+    void TestEmitMatchesReference(const size_t max_vertices)
+    {
+        const auto shapes = MakeShapes();
+        const auto instances = MakeInstances(500, shapes.size());
+
+        std::vector<D3DVertex> expected;
+        const size_t expected_count = ReferenceEmit(shapes, instances, expected, max_vertices);
+        // One spare vertex past the end, which the kernel must leave alone
+        std::vector<D3DVertex> out(max_vertices + 1, D3DVertex{-1.f, -1.f, -1.f, 0xDEADBEEF});
+        const size_t count = EmitAgentVertices(shapes, instances, out.data(), max_vertices);
+
+        CHECK(count == expected_count);
+        CHECK(count <= max_vertices);
+        bool matches = true;
+        for (size_t v = 0; v < std::min(count, expected_count); v++) {
+            matches &= Near(out[v].x, expected[v].x) && Near(out[v].y, expected[v].y) && out[v].z == 0.f && out[v].color == expected[v].color;
+        }
+        CHECK(matches);
+        CHECK(out[count].color == 0xDEADBEEF && out[count].z == -1.f);
+    }
+
+    void TestEmitStopsAtWholeShapes()
+    {
+        const auto shapes = MakeShapes();
+        AgentInstances instances;
+        instances.Push(5, {0.f, 0.f}, 1.f, 0.f, 1.f, 0xFFFFFFFF, 0); // 31 vertices
+        instances.Push(0, {0.f, 0.f}, 1.f, 0.f, 1.f, 0xFFFFFFFF, 0); // 3 vertices
+
+        std::vector<D3DVertex> out(64);
+        CHECK(EmitAgentVertices(shapes, instances, out.data(), 30) == 0);
+        CHECK(EmitAgentVertices(shapes, instances, out.data(), 31) == 31);
+        CHECK(EmitAgentVertices(shapes, instances, out.data(), 33) == 31);
+        CHECK(EmitAgentVertices(shapes, instances, out.data(), 34) == 34);
+        CHECK(EmitAgentVertices(shapes, AgentInstances{}, out.data(), 64) == 0);
+    }
+
+    void TestShapeTable()
+    {
+        const auto shapes = MakeShapes();
+        const auto table = BuildShapeTable(shapes);
+        CHECK(table.first_vertex.size() == shapes.size());
+        CHECK(table.vertex_count.size() == shapes.size());
+        CHECK(table.max_vertex_count == 31);
+
+        constexpr uint32_t tint_masks[] = {0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000};
+        bool matches = true;
+        uint32_t first = 0;
+        for (size_t s = 0; s < shapes.size(); s++) {
+            matches &= table.first_vertex[s] == first && table.vertex_count[s] == shapes[s].Size();
+            for (size_t v = 0; v < shapes[s].Size(); v++) {
+                const auto& vertex = table.vertices[first + v];
+                matches &= vertex.x == shapes[s].x[v] && vertex.y == shapes[s].y[v] && vertex.tint_mask == tint_masks[static_cast<size_t>(shapes[s].tint[v])];
+            }
+            first += static_cast<uint32_t>(shapes[s].Size());
+        }
+        CHECK(matches);
+        CHECK(table.vertices.size() == first);
+    }
+
+    // The vertex shader's expansion of a record has to land where the fallback path puts the same vertex
+    void TestInstanceRecords()
+    {
+        const auto shapes = MakeShapes();
+        const auto instances = MakeInstances(200, shapes.size());
+        std::vector<InstanceRecord> records(instances.Size());
+        BuildInstanceRecords(instances, records.data());
+
+        std::vector<D3DVertex> expected;
+        ReferenceEmit(shapes, instances, expected, SIZE_MAX);
+        bool matches = true;
+        size_t next_vertex = 0;
+        for (size_t i = 0; i < instances.Size(); i++) {
+            const auto& record = records[i];
+            const auto& shape = shapes[instances.shape[i]];
+            matches &= record.x == instances.pos_x[i] && record.y == instances.pos_y[i];
+            for (size_t v = 0; v < shape.Size(); v++) {
+                const auto& vertex = expected[next_vertex++];
+                const float x = shape.x[v] * record.axis_x - shape.y[v] * record.axis_y + record.x;
+                const float y = shape.x[v] * record.axis_y + shape.y[v] * record.axis_x + record.y;
+                const uint32_t palette[] = {record.color, record.dark, record.light, record.center};
+                matches &= Near(x, vertex.x) && Near(y, vertex.y) && palette[static_cast<size_t>(shape.tint[v])] == vertex.color;
+            }
+        }
+        CHECK(matches);
+    }
+
+    void TestShapeRuns()
+    {
+        AgentInstances instances;
+        for (const uint8_t shape : {2, 2, 2, 0, 1, 1, 2}) {
+            instances.Push(shape, {0.f, 0.f}, 1.f, 0.f, 1.f, 0, 0);
+        }
+        std::vector<std::array<size_t, 3>> runs;
+        ForEachShapeRun(instances, [&runs](const uint8_t shape, const size_t first, const size_t count) {
+            runs.push_back({shape, first, count});
+        });
+        const std::vector<std::array<size_t, 3>> expected = {{2, 0, 3}, {0, 3, 1}, {1, 4, 2}, {2, 6, 1}};
+        CHECK(runs == expected);
+
+        size_t calls = 0;
+        ForEachShapeRun(AgentInstances{}, [&calls](uint8_t, size_t, size_t) { calls++; });
+        CHECK(calls == 0);
+    }
+}
+
+int main()
+{
+    TestEmitMatchesReference(100000); // Room for everything
+    TestEmitMatchesReference(1000);
+    TestEmitMatchesReference(1001);
+    TestEmitStopsAtWholeShapes();
+    TestShapeTable();
+    TestInstanceRecords();
+    TestShapeRuns();
+    return HostTestResult("agent batch");
+}
@@ -0,0 +1,128 @@
+#include "stdafx.h"
+
+#include <bitset>
+
+#include <HostTest.h>
+#include <Utils/FixedBitset.h>
+
+namespace {
+    // CompletionWindow's SkillBits
+    using Bits = FixedBitset<4096>;
+    using Reference = std::bitset<Bits::bit_count>;
+
+    uint32_t seed = 99;
+
+    uint32_t Random(const uint32_t n)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        return (seed >> 8) % n;
+    }
+
+    bool Matches(const Bits& bits, const Reference& reference)
+    {
+        for (size_t i = 0; i < Bits::bit_count; i++) {
+            if (bits.test(i) != reference.test(i)) {
+                return false;
+            }
+        }
+        std::vector<size_t> set;
+        bits.for_each_set([&set](const size_t index) { set.push_back(index); });
+        bool in_order = std::ranges::is_sorted(set) && std::ranges::adjacent_find(set) == set.end();
+        bool all_set = std::ranges::all_of(set, [&reference](const size_t index) { return reference.test(index); });
+        return in_order && all_set && set.size() == reference.count() && bits.count() == reference.count() && bits.none() == reference.none();
+    }
+
+    // Sparse, so that whole words stay empty and used_words has something to trim
+    void RandomFill(Bits& bits, Reference& reference)
+    {
+        for (uint32_t n = Random(64); n; n--) {
+            const auto index = Random(Random(4) ? 200 : Bits::bit_count);
+            bits.set(index);
+            reference.set(index);
+        }
+    }
+
+    void TestBasics()
+    {
+        Bits bits;
+        CHECK(bits.none() && bits.count() == 0 && bits.used_words().empty());
+        CHECK(bits.all_words().size() == Bits::word_count);
+
+        bits.set(0);
+        bits.set(31);
+        bits.set(32);
+        bits.set(Bits::bit_count - 1);
+        CHECK(bits.test(0) && bits.test(31) && bits.test(32) && bits.test(Bits::bit_count - 1));
+        CHECK(!bits.test(1) && bits.count() == 4);
+        CHECK(bits.all_words()[0] == 0x80000001 && bits.all_words()[1] == 1);
+        CHECK(bits.used_words().size() == Bits::word_count);
+
+        // Past the end: ignored on set and unset on read
+        bits.set(Bits::bit_count);
+        bits.set(static_cast<size_t>(-1));
+        CHECK(!bits.test(Bits::bit_count) && bits.count() == 4);
+
+        bits.set(Bits::bit_count - 1, false);
+        CHECK(!bits.test(Bits::bit_count - 1) && bits.used_words().size() == 2);
+        bits.reset();
+        CHECK(bits.none() && bits == Bits{});
+    }
+
+    void TestMergeWords()
+    {
+        Bits bits;
+        bits.set(5);
+        const uint32_t game[] = {0x1, 0x0, 0x80000000};
+        bits.merge_words(game);
+        CHECK(bits.test(0) && bits.test(5) && bits.test(95) && bits.count() == 3);
+        CHECK(bits.used_words().size() == 3);
+
+        // A longer buffer than the bitset only merges what fits
+        std::vector<uint32_t> too_long(Bits::word_count + 4, 0xFFFFFFFF);
+        bits.merge_words(too_long);
+        CHECK(bits.count() == Bits::bit_count);
+        CHECK(!bits.none());
+    }
+
+    void TestMatchesBitset()
+    {
+        bool matches = true;
+        for (int round = 0; round < 500; round++) {
+            Bits a;
+            Bits b;
+            Reference ra;
+            Reference rb;
+            RandomFill(a, ra);
+            RandomFill(b, rb);
+            matches &= Matches(a, ra) && Matches(b, rb);
+            matches &= (a == b) == (ra == rb);
+
+            // used_words round trips through merge_words, as stored completion data does
+            Bits reloaded;
+            reloaded.merge_words(a.used_words());
+            matches &= reloaded == a;
+            matches &= a.used_words().empty() || a.used_words().back() != 0;
+
+            auto both = a;
+            both &= b;
+            matches &= Matches(both, ra & rb);
+            auto only_a = a;
+            only_a.and_not(b);
+            matches &= Matches(only_a, ra & ~rb);
+
+            const auto index = Random(Bits::bit_count);
+            a.set(index, false);
+            ra.reset(index);
+            matches &= Matches(a, ra);
+        }
+        CHECK(matches);
+    }
+}
+
+int main()
+{
+    TestBasics();
+    TestMergeWords();
+    TestMatchesBitset();
+    return HostTestResult("fixed bitset");
+}
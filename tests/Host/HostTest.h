@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdio>
+
+// Shared by the host tests: CHECK records a failure and carries on, and main returns HostTestResult(...).
+inline int host_test_failures = 0;
+
+#define CHECK(expr)                                                                  \
+    do {                                                                             \
+        if (!(expr)) {                                                               \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #expr); \
+            host_test_failures++;                                                    \
+        }                                                                            \
+    } while (0)
+
+inline int HostTestResult(const char* what)
+{
+    if (host_test_failures) {
+        fprintf(stderr, "%d check(s) failed\n", host_test_failures);
+        return 1;
+    }
+    printf("All %s checks passed\n", what);
+    return 0;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+/*
+Stands in for GWToolboxdll/stdafx.h when a host test builds toolbox sources on their own: the standard library, plus the few
+Windows and imgui definitions those sources lean on. Anything that needs the game, GWCA's managers or a device stays out of
+host tests.
+*/
+
+#include <cctype>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+// Stand-ins for the OS conversions that toolbox falls back to on input its own converters turn down. They convert nothing, and
+// count how often they're asked to, so a test can tell when a fallback was taken.
+inline int host_os_conversion_calls = 0;
+#define CP_ACP 0
+#define CP_UTF8 65001
+#define MB_ERR_INVALID_CHARS 0x08
+
+inline int WideCharToMultiByte(unsigned, unsigned long, const wchar_t*, int, char*, int, const char*, int*)
+{
+    host_os_conversion_calls++;
+    return 0;
+}
+
+inline int MultiByteToWideChar(unsigned, unsigned long, const char*, int, wchar_t*, int)
+{
+    host_os_conversion_calls++;
+    return 0;
+}
+#endif
+
+// d3d9types.h
+using D3DCOLOR = uint32_t;
+#define D3DFVF_XYZ 0x002
+#define D3DFVF_DIFFUSE 0x040
+
+// imgui.h, with the default (RGBA in memory) channel order
+#ifndef IM_COL32
+#define IM_COL32(R, G, B, A) (((uint32_t)(A) << 24) | ((uint32_t)(B) << 16) | ((uint32_t)(G) << 8) | ((uint32_t)(R) << 0))
+#endif
+
+#ifndef ASSERT
+#define ASSERT(expr) ((void)(!!(expr) || (fprintf(stderr, "%s:%u: ASSERT(%s) failed\n", __FILE__, (unsigned)__LINE__, #expr), abort(), 0)))
+#endif
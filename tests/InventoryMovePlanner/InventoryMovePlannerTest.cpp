@@ -0,0 +1,369 @@
+#include "stdafx.h"
+
+#include <HostTest.h>
+#include <Utils/InventoryMovePlanner.h>
+
+using namespace InventoryMovePlanner;
+
+// Found by argument-dependent lookup from std::vector's ==
+namespace InventoryMovePlanner {
+    bool operator==(const Move& a, const Move& b)
+    {
+        return a.item_id == b.item_id && a.bag_id == b.bag_id && a.slot == b.slot && a.quantity == b.quantity && a.onto_item_id == b.onto_item_id;
+    }
+}
+
+namespace {
+    // GW::Constants::Bag
+    constexpr uint32_t backpack = 1;
+    constexpr uint32_t bag_2 = 4;
+    constexpr uint32_t material_storage = 6;
+    constexpr uint32_t storage_1 = 8;
+    constexpr uint32_t storage_2 = 9;
+
+    constexpr StackKey dust = 1;
+    constexpr StackKey iron = 2;
+
+    BagState MakeBag(const uint32_t bag_id, const size_t slots, const uint16_t max_stack = 250)
+    {
+        BagState bag;
+        bag.bag_id = bag_id;
+        bag.max_stack = max_stack;
+        bag.slots.resize(slots);
+        return bag;
+    }
+
+    // What InventoryManager asks for when storing an item: its material slot, then stacks, then empty slots
+    Request StoreRequest(const uint32_t item_id, const StackKey stack_key, const uint16_t quantity, const std::optional<uint32_t> material_slot = std::nullopt)
+    {
+        Request request = {item_id, stack_key, quantity, {}};
+        if (material_slot) {
+            request.steps.push_back({Step::Type::FixedSlot, material_storage, material_storage, *material_slot});
+        }
+        request.steps.push_back({Step::Type::ExistingStacks, storage_1, storage_2});
+        request.steps.push_back({Step::Type::EmptySlots, storage_1, storage_2});
+        return request;
+    }
+
+    bool SlotIs(const Snapshot& snapshot, const uint32_t bag_id, const uint32_t slot, const uint32_t item_id, const StackKey stack_key, const uint16_t quantity)
+    {
+        const auto state = snapshot.GetSlot(bag_id, slot);
+        return state && state->item_id == item_id && state->stack_key == stack_key && state->quantity == quantity;
+    }
+
+    void TestTopsUpStacksBeforeEmptySlots()
+    {
+        auto pack = MakeBag(backpack, 5);
+        pack.slots[0] = {100, dust, 200};
+        auto storage = MakeBag(storage_1, 4);
+        storage.slots[2] = {200, dust, 230};
+        storage.slots[3] = {201, iron, 10};
+        Snapshot snapshot({pack, storage});
+
+        std::vector<Move> moves;
+        CHECK(snapshot.Plan(StoreRequest(100, dust, 1000), moves) == 200);
+        // 20 onto the existing stack, then the whole rest of the item into the lowest empty slot
+        const std::vector<Move> expected = {{100, storage_1, 2, 20, 200}, {100, storage_1, 0, 180, 0}};
+        CHECK(moves == expected);
+        CHECK(SlotIs(snapshot, storage_1, 2, 200, dust, 250));
+        CHECK(SlotIs(snapshot, storage_1, 0, 100, dust, 180));
+        CHECK(SlotIs(snapshot, backpack, 0, 0, 0, 0));
+        CHECK(SlotIs(snapshot, storage_1, 3, 201, iron, 10));
+    }
+
+    void TestLaterRequestsSeeEarlierMoves()
+    {
+        auto pack = MakeBag(backpack, 3);
+        pack.slots[0] = {100, dust, 100};
+        pack.slots[1] = {101, dust, 100};
+        pack.slots[2] = {102, dust, 100};
+        Snapshot snapshot({pack, MakeBag(storage_1, 2)});
+
+        std::vector<Move> moves;
+        for (const uint32_t item_id : {100u, 101u, 102u}) {
+            CHECK(snapshot.Plan(StoreRequest(item_id, dust, 1000), moves) == 100);
+        }
+        // The second item tops up the stack the first one made, and the third splits over that stack and the next empty slot
+        const std::vector<Move> expected = {{100, storage_1, 0, 100, 0}, {101, storage_1, 0, 100, 100}, {102, storage_1, 0, 50, 100}, {102, storage_1, 1, 50, 0}};
+        CHECK(moves == expected);
+        CHECK(SlotIs(snapshot, storage_1, 0, 100, dust, 250));
+        CHECK(SlotIs(snapshot, storage_1, 1, 102, dust, 50));
+        CHECK(SlotIs(snapshot, backpack, 1, 0, 0, 0));
+    }
+
+    void TestPartialMoveLeavesTheRest()
+    {
+        auto pack = MakeBag(backpack, 2);
+        pack.slots[0] = {100, dust, 200};
+        Snapshot snapshot({pack, MakeBag(storage_1, 2)});
+
+        std::vector<Move> moves;
+        CHECK(snapshot.Plan(StoreRequest(100, dust, 50), moves) == 50);
+        CHECK(moves.size() == 1);
+        // Part of a stack becomes a new item whose id isn't known yet
+        CHECK(SlotIs(snapshot, storage_1, 0, 0, dust, 50));
+        CHECK(SlotIs(snapshot, backpack, 0, 100, dust, 150));
+    }
+
+    void TestFixedSlot()
+    {
+        auto pack = MakeBag(backpack, 2);
+        pack.slots[0] = {100, dust, 200};
+        pack.slots[1] = {101, iron, 50};
+        auto materials = MakeBag(material_storage, 4, 1000);
+        materials.slots[1] = {300, dust, 900};
+        Snapshot snapshot({pack, materials, MakeBag(storage_1, 2)});
+
+        std::vector<Move> moves;
+        // Material storage holds 1000, and what doesn't fit carries on to the storage bags
+        CHECK(snapshot.Plan(StoreRequest(100, dust, 1000, 1), moves) == 200);
+        const std::vector<Move> expected = {{100, material_storage, 1, 100, 300}, {100, storage_1, 0, 100, 0}};
+        CHECK(moves == expected);
+        CHECK(SlotIs(snapshot, material_storage, 1, 300, dust, 1000));
+
+        // A material slot holding something else is skipped
+        moves.clear();
+        CHECK(snapshot.Plan(StoreRequest(101, iron, 1000, 1), moves) == 50);
+        CHECK(moves.size() == 1 && moves[0].bag_id == storage_1 && moves[0].slot == 1);
+    }
+
+    void TestUnstackableAndFullBags()
+    {
+        auto pack = MakeBag(backpack, 2);
+        pack.slots[0] = {100, 0, 1};
+        auto storage = MakeBag(storage_1, 2);
+        storage.slots[0] = {200, 0, 1};
+        storage.slots[1] = {201, dust, 10};
+        Snapshot snapshot({pack, storage});
+
+        // Nothing to stack onto and no empty slot
+        std::vector<Move> moves;
+        CHECK(snapshot.Plan(StoreRequest(100, 0, 1), moves) == 0);
+        CHECK(moves.empty());
+        CHECK(SlotIs(snapshot, backpack, 0, 100, 0, 1));
+
+        // An item the snapshot doesn't know moves nothing out of any slot
+        CHECK(snapshot.Plan(StoreRequest(999, dust, 5), moves) == 5);
+        CHECK(SlotIs(snapshot, storage_1, 1, 201, dust, 15));
+    }
+
+    void TestApply()
+    {
+        auto pack = MakeBag(backpack, 2);
+        pack.slots[0] = {100, dust, 200};
+        auto storage = MakeBag(storage_1, 2);
+        storage.slots[0] = {200, dust, 240};
+        const std::vector bags = {pack, storage};
+
+        std::vector<Move> moves;
+        Snapshot planned(bags);
+        planned.Plan(StoreRequest(100, dust, 1000), moves);
+
+        // Replaying queued moves onto a fresh snapshot gets to the same place
+        Snapshot replayed(bags);
+        for (const auto& move : moves) {
+            replayed.Apply(move);
+        }
+        for (const uint32_t slot : {0u, 1u}) {
+            CHECK(SlotIs(replayed, storage_1, slot, planned.GetSlot(storage_1, slot)->item_id, planned.GetSlot(storage_1, slot)->stack_key, planned.GetSlot(storage_1, slot)->quantity));
+        }
+        CHECK(SlotIs(replayed, backpack, 0, 0, 0, 0));
+
+        // A whole item that has already arrived isn't moved again
+        auto arrived = MakeBag(storage_1, 2);
+        arrived.slots[1] = {100, dust, 190};
+        Snapshot after({MakeBag(backpack, 2), arrived});
+        after.Apply({100, storage_1, 1, 190, 0});
+        CHECK(SlotIs(after, storage_1, 1, 100, dust, 190));
+        CHECK(SlotIs(after, storage_1, 0, 0, 0, 0));
+
+        CHECK(!after.GetSlot(storage_2, 0));
+        CHECK(!after.GetSlot(storage_1, 2));
+    }
+
+    // The planner before the snapshot kept any indexes: scan every slot for every step
+    class NaivePlanner {
+    public:
+        explicit NaivePlanner(std::vector<BagState> in_bags)
+            : bags(std::move(in_bags))
+        {
+            std::ranges::sort(bags, {}, &BagState::bag_id);
+        }
+
+        uint16_t Plan(const Request& request, std::vector<Move>& out)
+        {
+            SlotState* source = FindItem(request.item_id);
+            uint16_t remaining = source ? std::min(request.quantity, source->quantity) : request.quantity;
+            const uint16_t to_move = remaining;
+
+            const auto place = [&](BagState& bag, const uint32_t slot) {
+                auto& dest = bag.slots[slot];
+                if (&dest == source) {
+                    return;
+                }
+                uint16_t room = 0;
+                if (!dest.quantity) {
+                    room = bag.max_stack;
+                }
+                else if (request.stack_key && dest.stack_key == request.stack_key && dest.quantity < bag.max_stack) {
+                    room = static_cast<uint16_t>(bag.max_stack - dest.quantity);
+                }
+                const auto will_move = std::min(remaining, room);
+                if (!will_move) {
+                    return;
+                }
+                out.push_back({request.item_id, bag.bag_id, slot, will_move, dest.item_id});
+                bool whole = false;
+                if (source) {
+                    whole = source->quantity <= will_move;
+                    if (whole) {
+                        *source = {};
+                    }
+                    else {
+                        source->quantity -= will_move;
+                    }
+                }
+                if (!dest.quantity) {
+                    dest.item_id = whole ? request.item_id : 0;
+                    dest.stack_key = request.stack_key;
+                }
+                dest.quantity += will_move;
+                remaining -= will_move;
+            };
+
+            for (const auto& step : request.steps) {
+                const auto in_range = [&step](const BagState& bag) {
+                    return bag.bag_id >= step.bag_first && bag.bag_id <= step.bag_last;
+                };
+                switch (step.type) {
+                    case Step::Type::FixedSlot:
+                        for (auto& bag : bags) {
+                            if (bag.bag_id == step.bag_first && step.slot < bag.slots.size()) {
+                                place(bag, step.slot);
+                            }
+                        }
+                        break;
+                    case Step::Type::ExistingStacks: {
+                        if (!request.stack_key) {
+                            break;
+                        }
+                        // Only stacks that had room when the step started
+                        std::vector<std::pair<BagState*, uint32_t>> candidates;
+                        for (auto& bag : bags) {
+                            for (uint32_t slot = 0; in_range(bag) && slot < bag.slots.size(); slot++) {
+                                const auto& state = bag.slots[slot];
+                                if (state.quantity && state.stack_key == request.stack_key && state.quantity < bag.max_stack) {
+                                    candidates.emplace_back(&bag, slot);
+                                }
+                            }
+                        }
+                        for (const auto& [bag, slot] : candidates) {
+                            place(*bag, slot);
+                        }
+                    } break;
+                    case Step::Type::EmptySlots:
+                        for (auto& bag : bags) {
+                            for (uint32_t slot = 0; in_range(bag) && slot < bag.slots.size(); slot++) {
+                                if (!bag.slots[slot].quantity) {
+                                    place(bag, slot);
+                                }
+                            }
+                        }
+                        break;
+                }
+            }
+            return to_move - remaining;
+        }
+
+        [[nodiscard]] const std::vector<BagState>& Bags() const { return bags; }
+
+    private:
+        SlotState* FindItem(const uint32_t item_id)
+        {
+            for (auto& bag : bags) {
+                for (auto& state : bag.slots) {
+                    if (item_id && state.item_id == item_id) {
+                        return &state;
+                    }
+                }
+            }
+            return nullptr;
+        }
+
+        std::vector<BagState> bags;
+    };
+
+    void TestMatchesNaivePlanner()
+    {
+        uint32_t seed = 4242;
+        const auto next = [&seed](const uint32_t n) {
+            seed = seed * 1664525u + 1013904223u;
+            return (seed >> 8) % n;
+        };
+        constexpr uint32_t bag_ids[] = {backpack, 2, 3, bag_2, material_storage, storage_1, storage_2, 10};
+
+        bool plans_match = true;
+        bool slots_match = true;
+        for (int round = 0; round < 200; round++) {
+            std::vector<BagState> bags;
+            uint32_t next_item_id = 1;
+            for (const auto bag_id : bag_ids) {
+                auto bag = MakeBag(bag_id, 5 + next(20), bag_id == material_storage ? 1000 : 250);
+                for (auto& state : bag.slots) {
+                    if (next(3)) {
+                        const StackKey key = next(4);
+                        state = {next_item_id++, key, static_cast<uint16_t>(key ? 1 + next(bag.max_stack) : 1)};
+                    }
+                }
+                bags.push_back(std::move(bag));
+            }
+            // Bags given out of order, as the snapshot sorts them
+            std::ranges::reverse(bags);
+
+            Snapshot snapshot(bags);
+            NaivePlanner naive(bags);
+            for (int r = 0; r < 30; r++) {
+                Request request;
+                request.item_id = next(next_item_id + 5);
+                request.stack_key = next(4);
+                if (const auto found = std::ranges::find_if(naive.Bags(), [&](const BagState& bag) {
+                        return std::ranges::any_of(bag.slots, [&](const SlotState& s) { return s.item_id && s.item_id == request.item_id; });
+                    });
+                    found != naive.Bags().end()) {
+                    request.stack_key = std::ranges::find(found->slots, request.item_id, &SlotState::item_id)->stack_key;
+                }
+                request.quantity = static_cast<uint16_t>(1 + next(1200));
+                for (uint32_t s = 1 + next(3); s; s--) {
+                    const auto first = bag_ids[next(std::size(bag_ids))];
+                    const auto last = std::max(first, bag_ids[next(std::size(bag_ids))]);
+                    request.steps.push_back({static_cast<Step::Type>(next(3)), first, last, next(25)});
+                }
+
+                std::vector<Move> moves;
+                std::vector<Move> naive_moves;
+                plans_match &= snapshot.Plan(request, moves) == naive.Plan(request, naive_moves);
+                plans_match &= moves == naive_moves;
+            }
+            for (const auto& bag : naive.Bags()) {
+                for (uint32_t slot = 0; slot < bag.slots.size(); slot++) {
+                    const auto& s = bag.slots[slot];
+                    slots_match &= SlotIs(snapshot, bag.bag_id, slot, s.item_id, s.stack_key, s.quantity);
+                }
+            }
+        }
+        CHECK(plans_match);
+        CHECK(slots_match);
+    }
+}
+
+int main()
+{
+    TestTopsUpStacksBeforeEmptySlots();
+    TestLaterRequestsSeeEarlierMoves();
+    TestPartialMoveLeavesTheRest();
+    TestFixedSlot();
+    TestUnstackableAndFullBags();
+    TestApply();
+    TestMatchesNaivePlanner();
+    return HostTestResult("inventory move planner");
+}
@@ -0,0 +1,153 @@
+#include "stdafx.h"
+
+#include <HostTest.h>
+#include <Utils/IrcProtocol.h>
+
+using namespace IrcProtocol;
+
+namespace {
+    void TestParse()
+    {
+        Message message;
+        CHECK(Parse("@badge-info=;color=#FF0000;display-name=Mhenlo :mhenlo!mhenlo@mhenlo.tmi.twitch.tv PRIVMSG #gwtoolbox :hello there :)", message));
+        CHECK(message.tags == "badge-info=;color=#FF0000;display-name=Mhenlo");
+        CHECK(message.prefix == "mhenlo!mhenlo@mhenlo.tmi.twitch.tv");
+        CHECK(message.nick == "mhenlo" && message.user == "mhenlo" && message.host == "mhenlo.tmi.twitch.tv");
+        CHECK(message.command == "PRIVMSG");
+        CHECK(message.raw_params == "#gwtoolbox :hello there :)");
+        CHECK(message.param_count == 2);
+        CHECK(message.Param(0) == "#gwtoolbox");
+        CHECK(message.Trailing() == "hello there :)");
+        CHECK(message.Param(2).empty());
+        CHECK(message.GetTag("color") == "#FF0000");
+
+        // Server prefix, no user or host
+        CHECK(Parse(":tmi.twitch.tv 001 toolbox :Welcome, GLHF!", message));
+        CHECK(message.nick == "tmi.twitch.tv" && message.user.empty() && message.host.empty());
+        CHECK(message.command == "001" && message.Param(0) == "toolbox" && message.Trailing() == "Welcome, GLHF!");
+
+        // nick@host, and extra spaces between parts
+        CHECK(Parse(":nick@host   JOIN   #channel", message));
+        CHECK(message.nick == "nick" && message.user.empty() && message.host == "host");
+        CHECK(message.command == "JOIN" && message.param_count == 1 && message.Param(0) == "#channel");
+
+        CHECK(Parse("PING :tmi.twitch.tv", message));
+        CHECK(message.prefix.empty() && message.command == "PING" && message.Trailing() == "tmi.twitch.tv");
+
+        // An empty trailing param is still a param
+        CHECK(Parse("PRIVMSG #channel :", message));
+        CHECK(message.param_count == 2 && message.Trailing().empty());
+
+        CHECK(!Parse("", message));
+        CHECK(!Parse("@tags=1", message));
+        CHECK(!Parse(":prefix-only", message));
+        CHECK(!Parse(":!user@host PRIVMSG", message));
+    }
+
+    void TestParamLimit()
+    {
+        std::string line = "CMD";
+        for (int i = 0; i < 20; i++) {
+            line += " p" + std::to_string(i);
+        }
+        Message message;
+        CHECK(Parse(line, message));
+        CHECK(message.param_count == Message::max_params);
+        CHECK(message.Param(13) == "p13");
+        // The last one takes the rest of the line
+        CHECK(message.Trailing() == "p14 p15 p16 p17 p18 p19");
+    }
+
+    void TestTags()
+    {
+        constexpr std::string_view tags = "a=1;flag;empty=;msg=hi\\sthere\\:\\\\\\r\\n\\x;a=2;last=end\\";
+        CHECK(FindTag(tags, "a") == "1");
+        CHECK(FindTag(tags, "flag").empty());
+        CHECK(FindTag(tags, "empty").empty());
+        CHECK(FindTag(tags, "missing").empty());
+        CHECK(FindTag(tags, "fla").empty());
+        CHECK(FindTag("", "a").empty());
+
+        std::string value = "stale";
+        UnescapeTagValue(FindTag(tags, "msg"), value);
+        CHECK(value == "hi there;\\\r\nx");
+        // A lone trailing backslash is dropped
+        UnescapeTagValue(FindTag(tags, "last"), value);
+        CHECK(value == "end");
+        UnescapeTagValue("", value);
+        CHECK(value.empty());
+    }
+
+    // Feeds data in reads of at most chunk bytes, the way the socket does, collecting every line as it comes
+    std::vector<std::string> Feed(LineFramer& framer, const std::string_view data, const size_t chunk)
+    {
+        std::vector<std::string> lines;
+        for (size_t pos = 0; pos < data.size();) {
+            const auto space = framer.WriteSpace();
+            CHECK(!space.empty());
+            const auto length = std::min({chunk, space.size(), data.size() - pos});
+            memcpy(space.data(), data.data() + pos, length);
+            framer.Commit(length);
+            pos += length;
+            std::string_view line;
+            while (framer.NextLine(line)) {
+                lines.emplace_back(line);
+            }
+        }
+        return lines;
+    }
+
+    void TestFramer()
+    {
+        const std::string longest(LineFramer::max_line_length, 'x');
+        std::string stream;
+        std::vector<std::string> expected;
+        for (int i = 0; i < 200; i++) {
+            auto line = i % 50 == 7 ? longest : "PRIVMSG #channel :message " + std::to_string(i);
+            stream += line + (i % 3 ? "\r\n" : "\n");
+            // Blank lines are skipped
+            if (i % 10 == 0) {
+                stream += "\r\n";
+            }
+            expected.push_back(std::move(line));
+        }
+
+        // Every line comes out whole whichever way the reads split it
+        for (const size_t chunk : {1u, 7u, 512u, 4096u, 100000u}) {
+            LineFramer framer;
+            CHECK(Feed(framer, stream, chunk) == expected);
+        }
+
+        // A line without its end yet stays buffered
+        LineFramer framer;
+        CHECK(Feed(framer, "PING :a\r\nPING :b", 100).size() == 1);
+        CHECK(Feed(framer, "\r\n", 100) == std::vector<std::string>{"PING :b"});
+
+        framer.Clear();
+        CHECK(Feed(framer, "half a line", 100).empty());
+        framer.Clear();
+        CHECK(Feed(framer, "PING :c\n", 100) == std::vector<std::string>{"PING :c"});
+    }
+
+    void TestOverlongLine()
+    {
+        // Longer than the whole buffer: dropped, and the lines either side of it are unharmed
+        const std::string overlong(LineFramer::max_line_length * 5, 'y');
+        const std::string stream = "PING :before\r\n" + overlong + "\r\nPING :after\r\n";
+        for (const size_t chunk : {1000u, 100000u}) {
+            LineFramer framer;
+            const std::vector<std::string> expected = {"PING :before", "PING :after"};
+            CHECK(Feed(framer, stream, chunk) == expected);
+        }
+    }
+}
+
+int main()
+{
+    TestParse();
+    TestParamLimit();
+    TestTags();
+    TestFramer();
+    TestOverlongLine();
+    return HostTestResult("IRC protocol");
+}
@@ -0,0 +1,242 @@
+#include <Utils/PacketCapture.h>
+
+#include <cstdio>
+#include <cstring>
+
+using namespace PacketCapture;
+
+namespace {
+    int failures = 0;
+
+#define CHECK(expr)                                                           \
+    do {                                                                      \
+        if (!(expr)) {                                                        \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #expr); \
+            failures++;                                                       \
+        }                                                                     \
+    } while (0)
+
+    // type | size << 4 | count << 8, as the game lays out StoC packet fields
+    constexpr uint32_t Field(const uint32_t type, const uint32_t size, const uint32_t count) { return type | size << 4 | count << 8; }
+
+    constexpr uint32_t header_field = Field(8, 0, 4);
+    constexpr uint32_t agent_id_field = Field(0, 0, 0);
+    constexpr uint32_t dword_field = Field(4, 0, 4);
+    constexpr uint32_t string_field = Field(7, 0, 4);
+    constexpr uint32_t array32_field = Field(11, 4, 3);
+    constexpr uint32_t nested_field = Field(12, 0, 0);
+
+    void Append(std::vector<uint8_t>& out, const void* data, const size_t size)
+    {
+        const auto bytes = static_cast<const uint8_t*>(data);
+        out.insert(out.end(), bytes, bytes + size);
+    }
+
+    template <typename T>
+    void Append(std::vector<uint8_t>& out, const T& value)
+    {
+        Append(out, &value, sizeof(value));
+    }
+
+    // A capture file laid out the way Writer writes one
+    struct FileBuilder {
+        std::vector<uint8_t> bytes;
+
+        explicit FileBuilder(const Schema& schema)
+        {
+            std::vector<uint8_t> schema_bytes;
+            schema.Serialize(schema_bytes);
+            FileHeader header{};
+            memcpy(header.magic, file_magic, sizeof(file_magic));
+            header.version = file_version;
+            header.schema_offset = sizeof(FileHeader);
+            header.schema_size = static_cast<uint32_t>(schema_bytes.size());
+            header.records_offset = static_cast<uint32_t>((sizeof(FileHeader) + schema_bytes.size() + 3) & ~size_t{3});
+            header.start_time_ms = 1000;
+            Append(bytes, header);
+            Append(bytes, schema_bytes.data(), schema_bytes.size());
+            bytes.resize(header.records_offset);
+        }
+
+        void AddRecord(const uint16_t packet_header, const Direction direction, const uint32_t time_ms, const std::vector<uint8_t>& data)
+        {
+            const RecordHeader header = {static_cast<uint32_t>(data.size()), time_ms, packet_header, direction, 0};
+            Append(bytes, header);
+            Append(bytes, data.data(), data.size());
+            bytes.resize(bytes.size() + (RecordSpan(data.size()) - sizeof(RecordHeader) - data.size()));
+        }
+
+        void End() { bytes.resize(bytes.size() + sizeof(RecordHeader)); }
+    };
+
+    std::vector<uint8_t> Dwords(std::initializer_list<uint32_t> values)
+    {
+        std::vector<uint8_t> out;
+        for (const auto value : values) {
+            Append(out, value);
+        }
+        return out;
+    }
+
+    Schema MakeSchema()
+    {
+        Schema schema;
+        const uint32_t simple[] = {header_field, agent_id_field, dword_field};
+        const uint32_t with_string[] = {header_field, string_field, array32_field};
+        const uint32_t with_nested[] = {header_field, dword_field, nested_field, agent_id_field, dword_field};
+        schema.Add(1, simple);
+        schema.Add(2, with_string);
+        schema.Add(3, with_nested);
+        return schema;
+    }
+
+    void TestSchemaRoundTrip()
+    {
+        const auto schema = MakeSchema();
+        std::vector<uint8_t> bytes;
+        schema.Serialize(bytes);
+        Schema read;
+        CHECK(read.Deserialize(bytes));
+        CHECK(read.size() == schema.size());
+        for (uint32_t packet_header = 0; packet_header < schema.size(); packet_header++) {
+            const auto expected = schema.GetFields(packet_header);
+            const auto actual = read.GetFields(packet_header);
+            CHECK(std::equal(expected.begin(), expected.end(), actual.begin(), actual.end()));
+        }
+        CHECK(read.GetFields(100).empty());
+
+        // Cut short anywhere, it's rejected rather than read past the end
+        for (size_t size = 0; size < bytes.size(); size++) {
+            CHECK(!read.Deserialize(std::span(bytes).first(size)));
+            CHECK(read.size() == 0);
+        }
+    }
+
+    void TestFilter()
+    {
+        Filter filter;
+        CHECK(filter.SetPacketHeaders(" 1, 3-5 ,0x10"));
+        RecordHeader header{4, 0, 0, Direction::StoC, 0};
+        for (uint16_t packet_header = 0; packet_header < 20; packet_header++) {
+            header.packet_header = packet_header;
+            const bool expected = packet_header == 1 || (packet_header >= 3 && packet_header <= 5) || packet_header == 0x10;
+            CHECK(filter.Matches(header) == expected);
+        }
+        // Syntax errors leave the filter as it was
+        CHECK(!filter.SetPacketHeaders("1, x"));
+        CHECK(!filter.SetPacketHeaders("5-3"));
+        CHECK(!filter.SetPacketHeaders("0x10000"));
+        header.packet_header = 4;
+        CHECK(filter.Matches(header));
+
+        filter.show_stoc = false;
+        CHECK(!filter.Matches(header));
+        header.direction = Direction::CtoS;
+        CHECK(filter.Matches(header));
+        filter.min_time_ms = 10;
+        CHECK(!filter.Matches(header));
+
+        CHECK(filter.SetPacketHeaders(""));
+        CHECK(filter.packet_headers.empty());
+    }
+
+    void TestReader()
+    {
+        const auto schema = MakeSchema();
+        FileBuilder builder(schema);
+        builder.AddRecord(1, Direction::StoC, 5, Dwords({1, 42, 7}));
+        builder.AddRecord(2, Direction::CtoS, 10, {2, 0, 0, 0, 0xAA});
+        builder.AddRecord(1, Direction::StoC, 20, Dwords({1, 43, 8}));
+        builder.End();
+
+        Reader reader;
+        CHECK(reader.Open(builder.bytes));
+        CHECK(reader.GetFileHeader().start_time_ms == 1000);
+        CHECK(reader.GetSchema().size() == schema.size());
+
+        std::vector<Record> records;
+        Record record;
+        for (size_t offset = 0; reader.Next(offset, record);) {
+            records.push_back(record);
+        }
+        CHECK(records.size() == 3);
+        if (records.size() == 3) {
+            CHECK(records[1].header.size == 5 && records[1].data[4] == 0xAA);
+            CHECK(records[2].header.time_ms == 20);
+            Record again;
+            CHECK(reader.Read(records[2].offset, again) && again.header.time_ms == 20);
+        }
+
+        Filter filter;
+        CHECK(filter.SetPacketHeaders("1"));
+        CHECK(reader.Index(filter).size() == 2);
+        filter.show_stoc = false;
+        CHECK(reader.Index(filter).empty());
+
+        // A file cut off mid-record reads the records before it
+        const auto cut = std::span(builder.bytes).first(builder.bytes.size() - sizeof(RecordHeader) - 6);
+        CHECK(reader.Open(cut));
+        CHECK(reader.Index({}).size() == 2);
+
+        // Bad magic, version or schema bounds
+        auto corrupt = builder.bytes;
+        corrupt[0] = 'X';
+        CHECK(!reader.Open(corrupt));
+        corrupt = builder.bytes;
+        reinterpret_cast<FileHeader*>(corrupt.data())->schema_size = 0xFFFFFFF0;
+        CHECK(!reader.Open(corrupt));
+        CHECK(!reader.Open(std::span(builder.bytes).first(sizeof(FileHeader) - 1)));
+    }
+
+    void TestMeasureAndFormat()
+    {
+        const auto schema = MakeSchema();
+
+        // Header, string of 4 wchars, array32 of up to 3: length then 3 slots
+        auto packet = Dwords({2});
+        const uint16_t str[] = {'a', 'b', 0, 0};
+        Append(packet, str);
+        const auto array = Dwords({2, 11, 22, 0});
+        packet.insert(packet.end(), array.begin(), array.end());
+        CHECK(MeasurePacket(schema.GetFields(2), packet.data()) == packet.size());
+
+        std::string out;
+        FormatPacket(schema.GetFields(2), packet, out);
+        CHECK(out.find("String(2) \"0061 0062\"") != std::string::npos);
+        CHECK(out.find("Array32(2 of 3)") != std::string::npos);
+        CHECK(out.find("[1] => 22,") != std::string::npos);
+        CHECK(out.find("ends early") == std::string::npos);
+
+        // Nested structs repeat their fields however many times the packet says
+        const auto nested = Dwords({3, 9, 2, 100, 1, 101, 2});
+        CHECK(MeasurePacket(schema.GetFields(3), nested.data()) == nested.size());
+        out.clear();
+        FormatPacket(schema.GetFields(3), nested, out);
+        CHECK(out.find("NextedStruct(2)") != std::string::npos);
+        CHECK(out.find("AgentId(101)") != std::string::npos);
+
+        // Cut short, formatting says so instead of reading past the end
+        out.clear();
+        FormatPacket(schema.GetFields(3), std::span(nested).first(nested.size() - 6), out);
+        CHECK(out.find("<packet ends early>") != std::string::npos);
+
+        out.clear();
+        const uint8_t hex[] = {0x01, 0xAB};
+        FormatHex(hex, out);
+        CHECK(out == "01 AB\n");
+    }
+}
+
+int main()
+{
+    TestSchemaRoundTrip();
+    TestFilter();
+    TestReader();
+    TestMeasureAndFormat();
+    if (failures) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All packet capture checks passed\n");
+    return 0;
+}
@@ -0,0 +1,156 @@
+#include "stdafx.h"
+
+#include <thread>
+
+#include <HostTest.h>
+#include <Utils/RingBuffer.h>
+
+namespace {
+    void TestRingCapacity()
+    {
+        // Exactly what it's given, not rounded up to a power of two
+        Ring<int> ring(100);
+        CHECK(ring.capacity() == 100);
+        CHECK(ring.empty());
+        CHECK(Ring<int>(0).capacity() == 1);
+
+        for (int i = 0; i < 100; i++) {
+            ring.add(i);
+        }
+        CHECK(ring.full());
+        CHECK(ring.size() == 100);
+        CHECK(ring[0] == 0);
+        CHECK(ring[99] == 99);
+    }
+
+    void TestRingWraparound()
+    {
+        Ring<int> ring(100);
+        for (int i = 0; i < 250; i++) {
+            ring.add(i);
+        }
+        // Oldest first, with the first 150 overwritten
+        CHECK(ring.size() == 100);
+        for (size_t i = 0; i < ring.size(); i++) {
+            CHECK(ring[i] == static_cast<int>(150 + i));
+        }
+
+        const auto [first, second] = ring.spans();
+        CHECK(first.size() + second.size() == 100);
+        int expected = 150;
+        bool in_order = true;
+        for (const auto span : {first, second}) {
+            for (const auto value : span) {
+                in_order &= value == expected++;
+            }
+        }
+        CHECK(in_order);
+
+        ring.clear();
+        CHECK(ring.empty());
+        CHECK(ring.spans().first.empty() && ring.spans().second.empty());
+        ring.add(7);
+        CHECK(ring.size() == 1 && ring[0] == 7);
+    }
+
+    void TestSpscRing()
+    {
+        SpscRing<int> ring(5);
+        CHECK(ring.capacity() == 8);
+
+        // Many laps, so the cursors wrap the mask over and over
+        int next_push = 0;
+        int next_pop = 0;
+        bool in_order = true;
+        for (int lap = 0; lap < 100; lap++) {
+            while (ring.try_push(next_push)) {
+                next_push++;
+            }
+            CHECK(ring.size() == ring.capacity());
+            int value;
+            for (int i = 0; i < 3 && ring.try_pop(value); i++) {
+                in_order &= value == next_pop++;
+            }
+        }
+        int value;
+        while (ring.try_pop(value)) {
+            in_order &= value == next_pop++;
+        }
+        CHECK(in_order);
+        CHECK(next_pop == next_push);
+        CHECK(ring.empty());
+    }
+
+    void TestMpscRingSingleThread()
+    {
+        MpscRing<std::string> ring(3);
+        CHECK(ring.capacity() == 4);
+
+        // Element type that owns memory, as the logger's lines do
+        const std::string long_line(300, 'x');
+        CHECK(ring.try_push(long_line));
+        CHECK(ring.try_push(std::string("b")));
+        CHECK(ring.try_push(std::string("c")));
+        CHECK(ring.try_push(std::string("d")));
+        CHECK(!ring.try_push(std::string("full")));
+        CHECK(ring.size() == 4);
+
+        std::string out;
+        CHECK(ring.try_pop(out) && out == long_line);
+        CHECK(ring.try_push(std::string("e")));
+        for (const auto expected : {"b", "c", "d", "e"}) {
+            CHECK(ring.try_pop(out) && out == expected);
+        }
+        CHECK(!ring.try_pop(out));
+        CHECK(ring.empty());
+    }
+
+    void TestMpscRingThreads()
+    {
+        constexpr int producer_count = 4;
+        constexpr int per_producer = 100000;
+        MpscRing<uint64_t> ring(256);
+
+        std::vector<std::thread> producers;
+        for (int p = 0; p < producer_count; p++) {
+            producers.emplace_back([&ring, p] {
+                for (uint64_t i = 0; i < per_producer; i++) {
+                    while (!ring.try_push(static_cast<uint64_t>(p) << 32 | i)) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+
+        // Each producer's values come out in the order it pushed them, and none are lost or repeated
+        std::array<uint64_t, producer_count> next{};
+        bool in_order = true;
+        int popped = 0;
+        while (popped < producer_count * per_producer) {
+            uint64_t value;
+            if (!ring.try_pop(value)) {
+                std::this_thread::yield();
+                continue;
+            }
+            const auto p = static_cast<size_t>(value >> 32);
+            in_order &= p < producer_count && (value & 0xFFFFFFFF) == next[p]++;
+            popped++;
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+        CHECK(in_order);
+        CHECK(std::ranges::all_of(next, [](const uint64_t n) { return n == per_producer; }));
+        CHECK(ring.empty());
+    }
+}
+
+int main()
+{
+    TestRingCapacity();
+    TestRingWraparound();
+    TestSpscRing();
+    TestMpscRingSingleThread();
+    TestMpscRingThreads();
+    return HostTestResult("ring buffer");
+}
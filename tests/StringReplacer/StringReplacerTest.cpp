@@ -0,0 +1,137 @@
+#include "stdafx.h"
+
+#include <HostTest.h>
+#include <Utils/StringReplacer.h>
+
+namespace {
+    std::wstring ReplaceAll(StringReplacer& replacer, const std::wstring& input)
+    {
+        std::wstring out = L"untouched";
+        return replacer.Replace(input, out) ? out : input;
+    }
+
+    // Try every key at every position: leftmost, then longest, then first added
+    std::wstring ReferenceReplace(const std::vector<std::pair<std::wstring, std::wstring>>& replacements, const std::wstring& input)
+    {
+        std::wstring out;
+        for (size_t i = 0; i < input.size();) {
+            const std::pair<std::wstring, std::wstring>* best = nullptr;
+            for (const auto& replacement : replacements) {
+                if (!replacement.first.empty() && input.compare(i, replacement.first.size(), replacement.first) == 0 && (!best || best->first.size() < replacement.first.size())) {
+                    best = &replacement;
+                }
+            }
+            if (best) {
+                out += best->second;
+                i += best->first.size();
+            }
+            else {
+                out += input[i++];
+            }
+        }
+        return out;
+    }
+
+    void TestBasics()
+    {
+        StringReplacer replacer;
+        CHECK(replacer.empty());
+        std::wstring out = L"untouched";
+        CHECK(!replacer.Replace(L"nothing to do", out));
+
+        replacer.Add(L"", L"ignored");
+        CHECK(replacer.empty());
+        replacer.Add(L"Foo", L"A");
+        replacer.Add(L"Foo Bar", L"B");
+        replacer.Add(L"Bar", L"C");
+        replacer.Compile();
+        CHECK(!replacer.empty());
+
+        // Leftmost then longest
+        CHECK(ReplaceAll(replacer, L"Foo Bar") == L"B");
+        CHECK(ReplaceAll(replacer, L"Foo Baz Bar") == L"A Baz C");
+        CHECK(ReplaceAll(replacer, L"FooFoo") == L"AA");
+
+        // Nothing matched leaves out alone
+        out = L"untouched";
+        CHECK(!replacer.Replace(L"Fo Ba", out) && out == L"untouched");
+        CHECK(!replacer.Replace(L"", out) && out == L"untouched");
+    }
+
+    void TestReplacedTextIsNotRescanned()
+    {
+        StringReplacer replacer;
+        replacer.Add(L"a", L"ab");
+        replacer.Add(L"b", L"a");
+        CHECK(ReplaceAll(replacer, L"aabb") == L"ababaa");
+    }
+
+    void TestInputInsideOut()
+    {
+        StringReplacer replacer;
+        replacer.Add(L"Mhenlo", L"Healer");
+        std::wstring message = L"Mhenlo says hi to Mhenlo";
+        CHECK(replacer.Replace(message, message));
+        CHECK(message == L"Healer says hi to Healer");
+    }
+
+    void TestAddAfterCompile()
+    {
+        StringReplacer replacer;
+        replacer.Add(L"one", L"1");
+        replacer.Compile();
+        CHECK(ReplaceAll(replacer, L"one two") == L"1 two");
+        // Replace compiles again for keys added since
+        replacer.Add(L"two", L"2");
+        CHECK(ReplaceAll(replacer, L"one two") == L"1 2");
+
+        replacer.Clear();
+        CHECK(replacer.empty());
+        CHECK(ReplaceAll(replacer, L"one two") == L"one two");
+    }
+
+    // Keys that overlap each other and share suffixes, so matches hang off fail and dictionary links
+    void TestMatchesReference()
+    {
+        uint32_t seed = 777;
+        const auto next = [&seed](const uint32_t n) {
+            seed = seed * 1664525u + 1013904223u;
+            return (seed >> 8) % n;
+        };
+        const auto random_string = [&next](const size_t max_length) {
+            std::wstring s(next(static_cast<uint32_t>(max_length)) + 1, L'a');
+            for (auto& c : s) {
+                c = static_cast<wchar_t>(L'a' + next(3));
+            }
+            return s;
+        };
+
+        bool matches = true;
+        for (int round = 0; round < 300; round++) {
+            std::vector<std::pair<std::wstring, std::wstring>> replacements;
+            StringReplacer replacer;
+            for (uint32_t k = next(8) + 1; k; k--) {
+                auto from = random_string(5);
+                auto to = next(4) ? random_string(4) : std::wstring();
+                replacer.Add(from, to);
+                replacements.emplace_back(std::move(from), std::move(to));
+            }
+            replacer.Compile();
+            for (int i = 0; i < 20; i++) {
+                const auto input = random_string(40);
+                matches &= ReplaceAll(replacer, input) == ReferenceReplace(replacements, input);
+            }
+        }
+        CHECK(matches);
+    }
+}
+
+int main()
+{
+    TestBasics();
+    TestReplacedTextIsNotRescanned();
+    TestInputInsideOut();
+    TestAddAfterCompile();
+    TestMatchesReference();
+    return HostTestResult("string replacer");
+}
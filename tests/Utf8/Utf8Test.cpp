@@ -0,0 +1,270 @@
+#include "stdafx.h"
+
+#include <HostTest.h>
+#include <Utf8.h>
+
+namespace {
+    using WideChars = std::vector<wchar_t>;
+    using Bytes = std::vector<char>;
+
+    std::wstring_view View(const WideChars& chars, const size_t offset = 0) { return {chars.data() + offset, chars.size() - offset}; }
+    std::string_view View(const Bytes& bytes, const size_t offset = 0) { return {bytes.data() + offset, bytes.size() - offset}; }
+
+    // One code point at a time, as the RFC describes it
+    std::optional<Bytes> ReferenceEncode(const std::wstring_view str)
+    {
+        Bytes out;
+        for (size_t i = 0; i < str.size(); i++) {
+            uint32_t c = static_cast<uint16_t>(str[i]);
+            if (c >= 0xDC00 && c <= 0xDFFF) {
+                return std::nullopt;
+            }
+            if (c >= 0xD800 && c <= 0xDBFF) {
+                const uint32_t low = i + 1 < str.size() ? static_cast<uint16_t>(str[i + 1]) : 0;
+                if (low < 0xDC00 || low > 0xDFFF) {
+                    return std::nullopt;
+                }
+                c = 0x10000 + ((c - 0xD800) << 10 | (low - 0xDC00));
+                i++;
+            }
+            if (c < 0x80) {
+                out.push_back(static_cast<char>(c));
+            }
+            else if (c < 0x800) {
+                out.insert(out.end(), {static_cast<char>(0xC0 | c >> 6), static_cast<char>(0x80 | (c & 0x3F))});
+            }
+            else if (c < 0x10000) {
+                out.insert(out.end(), {static_cast<char>(0xE0 | c >> 12), static_cast<char>(0x80 | (c >> 6 & 0x3F)), static_cast<char>(0x80 | (c & 0x3F))});
+            }
+            else {
+                out.insert(out.end(), {static_cast<char>(0xF0 | c >> 18), static_cast<char>(0x80 | (c >> 12 & 0x3F)), static_cast<char>(0x80 | (c >> 6 & 0x3F)),
+                                       static_cast<char>(0x80 | (c & 0x3F))});
+            }
+        }
+        return out;
+    }
+
+    std::optional<WideChars> ReferenceDecode(const std::string_view str)
+    {
+        WideChars out;
+        for (size_t i = 0; i < str.size();) {
+            const uint32_t lead = static_cast<uint8_t>(str[i]);
+            size_t length;
+            uint32_t c;
+            if (lead < 0x80) {
+                length = 1;
+                c = lead;
+            }
+            else if ((lead & 0xE0) == 0xC0) {
+                length = 2;
+                c = lead & 0x1F;
+            }
+            else if ((lead & 0xF0) == 0xE0) {
+                length = 3;
+                c = lead & 0x0F;
+            }
+            else if ((lead & 0xF8) == 0xF0) {
+                length = 4;
+                c = lead & 0x07;
+            }
+            else {
+                return std::nullopt;
+            }
+            if (str.size() - i < length) {
+                return std::nullopt;
+            }
+            for (size_t k = 1; k < length; k++) {
+                const uint32_t next = static_cast<uint8_t>(str[i + k]);
+                if ((next & 0xC0) != 0x80) {
+                    return std::nullopt;
+                }
+                c = c << 6 | (next & 0x3F);
+            }
+            constexpr uint32_t shortest[] = {0, 0, 0x80, 0x800, 0x10000};
+            if (c < shortest[length] || c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF)) {
+                return std::nullopt;
+            }
+            if (c >= 0x10000) {
+                out.push_back(static_cast<wchar_t>(0xD800 + ((c - 0x10000) >> 10)));
+                out.push_back(static_cast<wchar_t>(0xDC00 + ((c - 0x10000) & 0x3FF)));
+            }
+            else {
+                out.push_back(static_cast<wchar_t>(c));
+            }
+            i += length;
+        }
+        return out;
+    }
+
+    uint32_t seed = 2024;
+
+    uint32_t Random(const uint32_t n)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        return (seed >> 8) % n;
+    }
+
+    // Long ASCII runs broken up by every width of code point, so the vector loops stop and restart at every offset
+    WideChars RandomText(const bool allow_invalid)
+    {
+        WideChars out;
+        for (uint32_t pieces = Random(12); pieces; pieces--) {
+            for (uint32_t run = Random(40); run; run--) {
+                out.push_back(static_cast<wchar_t>(0x20 + Random(0x5F)));
+            }
+            switch (Random(allow_invalid ? 6 : 4)) {
+                case 0:
+                    out.push_back(static_cast<wchar_t>(0x80 + Random(0x780))); // Two bytes
+                    break;
+                case 1:
+                    out.push_back(static_cast<wchar_t>(0x800 + Random(0xD000))); // Three bytes, below the surrogates
+                    break;
+                case 2:
+                    out.push_back(static_cast<wchar_t>(0xE000 + Random(0x2000))); // Three bytes, above them
+                    break;
+                case 3:
+                    out.push_back(static_cast<wchar_t>(0xD800 + Random(0x400)));
+                    out.push_back(static_cast<wchar_t>(0xDC00 + Random(0x400)));
+                    break;
+                default:
+                    out.push_back(static_cast<wchar_t>(0xD800 + Random(0x800))); // Unpaired
+                    break;
+            }
+        }
+        return out;
+    }
+
+    void TestAsciiPrefix()
+    {
+        bool matches = true;
+        for (int round = 0; round < 2000; round++) {
+            const auto text = RandomText(false);
+            const auto bytes = ReferenceEncode(View(text));
+            for (size_t offset = 0; offset < 16 && offset <= text.size(); offset++) {
+                const auto wide = View(text, offset);
+                const auto wide_expected = std::ranges::find_if(wide, [](const wchar_t c) { return static_cast<uint16_t>(c) >= 0x80; }) - wide.begin();
+                matches &= utf8::AsciiPrefix(wide) == static_cast<size_t>(wide_expected);
+            }
+            for (size_t offset = 0; offset < 16 && offset <= bytes->size(); offset++) {
+                const auto narrow = View(*bytes, offset);
+                const auto narrow_expected = std::ranges::find_if(narrow, [](const char c) { return (c & 0x80) != 0; }) - narrow.begin();
+                matches &= utf8::AsciiPrefix(narrow) == static_cast<size_t>(narrow_expected);
+            }
+        }
+        CHECK(matches);
+        CHECK(utf8::AsciiPrefix(std::string_view{}) == 0);
+        CHECK(utf8::AsciiPrefix(std::wstring_view{}) == 0);
+    }
+
+    void TestEncode()
+    {
+        bool matches = true;
+        int invalid = 0;
+        for (int round = 0; round < 5000; round++) {
+            const auto text = RandomText(true);
+            for (size_t offset = 0; offset < 8 && offset <= text.size(); offset++) {
+                const auto view = View(text, offset);
+                const auto expected = ReferenceEncode(view);
+                const auto length = utf8::EncodedLength(view);
+                if (!expected) {
+                    matches &= length == utf8::invalid;
+                    invalid++;
+                    continue;
+                }
+                matches &= length == expected->size();
+                // Guard bytes either side of what should be written
+                Bytes out(expected->size() + 2, '#');
+                matches &= utf8::Encode(view, out.data() + 1) == expected->size();
+                matches &= std::equal(expected->begin(), expected->end(), out.begin() + 1) && out.front() == '#' && out.back() == '#';
+            }
+        }
+        CHECK(matches);
+        CHECK(invalid > 0);
+    }
+
+    void TestDecode()
+    {
+        bool matches = true;
+        int invalid = 0;
+        for (int round = 0; round < 5000; round++) {
+            auto bytes = *ReferenceEncode(View(RandomText(false)));
+            // Break some: truncate, or overwrite a byte with anything at all
+            if (!bytes.empty() && Random(3) == 0) {
+                bytes[Random(static_cast<uint32_t>(bytes.size()))] = static_cast<char>(0x80 + Random(0x80));
+            }
+            if (!bytes.empty() && Random(5) == 0) {
+                bytes.pop_back();
+            }
+            for (size_t offset = 0; offset < 16 && offset <= bytes.size(); offset++) {
+                const auto view = View(bytes, offset);
+                const auto expected = ReferenceDecode(view);
+                const auto length = utf8::DecodedLength(view);
+                if (!expected) {
+                    matches &= length == utf8::invalid;
+                    invalid++;
+                    continue;
+                }
+                matches &= length == expected->size();
+                WideChars out(expected->size() + 2, L'#');
+                matches &= utf8::Decode(view, out.data() + 1) == expected->size();
+                matches &= std::equal(expected->begin(), expected->end(), out.begin() + 1) && out.front() == L'#' && out.back() == L'#';
+            }
+        }
+        CHECK(matches);
+        CHECK(invalid > 0);
+    }
+
+    void TestMalformedUtf8()
+    {
+        // Overlong, surrogates, past U+10FFFF, stray continuation, truncated
+        for (const std::string_view bad : {"\xC0\x80", "\xC1\xBF", "\xE0\x9F\xBF", "\xF0\x8F\xBF\xBF", "\xED\xA0\x80", "\xED\xBF\xBF", "\xF4\x90\x80\x80",
+                                            "\xF5\x80\x80\x80", "\xFF", "\x80", "abc\xE2\x82", "\xF0\x9F\x98"}) {
+            CHECK(utf8::DecodedLength(bad) == utf8::invalid);
+            CHECK(!ReferenceDecode(bad));
+        }
+        // The edges that are allowed
+        for (const std::string_view good : {"\xC2\x80", "\xDF\xBF", "\xE0\xA0\x80", "\xED\x9F\xBF", "\xEE\x80\x80", "\xEF\xBF\xBF", "\xF0\x90\x80\x80", "\xF4\x8F\xBF\xBF"}) {
+            CHECK(utf8::DecodedLength(good) != utf8::invalid);
+            CHECK(ReferenceDecode(good));
+        }
+    }
+
+    // The OS is only asked when the input is malformed
+    void TestFallbacks()
+    {
+        const auto calls_before = host_os_conversion_calls;
+        wchar_t wide[32];
+        CHECK(Utf8ToUnicode("Hello \xC3\xA9\xF0\x9F\x98\x80", wide, 32) == 10);
+        CHECK(wide[6] == 0xE9 && wide[7] == 0xD83D && wide[8] == 0xDE00 && wide[9] == 0);
+        // Same as MultiByteToWideChar, the terminator has to fit
+        CHECK(Utf8ToUnicode("abc", wide, 3) == 0);
+        CHECK(Utf8ToUnicode("abc", wide, 4) == 4);
+
+        const wchar_t text[] = {L'G', L'W', 0xE9, 0xD83D, 0xDE00};
+        char bytes[16];
+        auto encoded = Unicode16ToUtf8(bytes, sizeof(bytes), text, text + 5);
+        CHECK(encoded.count == 8 && std::string_view(encoded.bytes, 8) == "GW\xC3\xA9\xF0\x9F\x98\x80" && !encoded.allocated);
+        CHECK(Unicode16ToUtf8(bytes, 7, text, text + 5).count == 0);
+        CHECK(Unicode16ToUtf8(nullptr, 0, text, text + 5).count == 8);
+
+        auto allocated = Unicode16ToUtf8(text, text + 5);
+        CHECK(allocated.allocated && allocated.count == 8 && allocated.bytes[8] == 0);
+        CHECK(host_os_conversion_calls == calls_before);
+
+        const wchar_t lone[] = {L'a', 0xD800, L'b'};
+        Unicode16ToUtf8(bytes, sizeof(bytes), lone, lone + 3);
+        CHECK(host_os_conversion_calls == calls_before + 1);
+        Utf8ToUnicode("a\xC0\x80", wide, 32);
+        CHECK(host_os_conversion_calls == calls_before + 2);
+    }
+}
+
+int main()
+{
+    TestAsciiPrefix();
+    TestEncode();
+    TestDecode();
+    TestMalformedUtf8();
+    TestFallbacks();
+    return HostTestResult("UTF-8");
+}